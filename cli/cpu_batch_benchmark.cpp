@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ * This file uses ONNX Runtime (MIT License) - Copyright (c) Microsoft Corporation.
+ */
+
+// Throughput of a CPU task subgraph run one request at a time, as the CPU worker does for every
+// model, against micro-batched runs that gather queued requests along the batch dimension and
+// scatter the outputs back. The ONNX model needs a leading dimension with the same symbolic name on
+// every input and output (e.g. exported with dynamic_axes={"input": {0: "batch"}, "output": {0: "batch"}}),
+// and DXRT_CPU_MICRO_BATCH above 1 has to enable micro-batching; no device is needed.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/cpu_handle.h"
+#include "dxrt/extern/cxxopts.hpp"
+
+#define APP_NAME "DXRT " DXRT_VERSION " cpu_batch_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+#ifdef USE_ORT
+// buffers of one request in the batch 1 layout
+struct RequestBuffers
+{
+    vector<vector<uint8_t>> inputs;
+    vector<vector<uint8_t>> outputs;
+    vector<void*> inputPtrs;
+    vector<void*> outputPtrs;
+};
+
+static vector<RequestBuffers> makeRequests(const dxrt::CpuHandle& handle, int count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    vector<RequestBuffers> reqs(count);
+    for (auto& req : reqs)
+    {
+        for (int i = 0; i < handle._numInputs; i++)
+        {
+            req.inputs.emplace_back(handle._inputSizes[i]);
+            auto& data = req.inputs.back();
+            if (handle._inputDataTypes[i] == dxrt::DataType::FLOAT)
+            {
+                float* f = reinterpret_cast<float*>(data.data());
+                for (size_t k = 0; k < data.size() / sizeof(float); k++) f[k] = value(rng);
+            }
+            else
+            {
+                for (auto& b : data) b = static_cast<uint8_t>(byte(rng));
+            }
+            req.inputPtrs.push_back(data.data());
+        }
+        for (int i = 0; i < handle._numOutputs; i++)
+        {
+            req.outputs.emplace_back(handle._outputSizes[i]);
+            req.outputPtrs.push_back(req.outputs.back().data());
+        }
+    }
+    return reqs;
+}
+
+// largest difference between the outputs of two runs, as float for float outputs, else differing bytes
+static double compareOutputs(const dxrt::CpuHandle& handle, const vector<RequestBuffers>& a,
+    const vector<RequestBuffers>& b)
+{
+    double diff = 0;
+    for (size_t r = 0; r < a.size(); r++)
+    {
+        for (int i = 0; i < handle._numOutputs; i++)
+        {
+            const auto& x = a[r].outputs[i];
+            const auto& y = b[r].outputs[i];
+            if (handle._outputDataTypes[i] == dxrt::DataType::FLOAT)
+            {
+                const float* fx = reinterpret_cast<const float*>(x.data());
+                const float* fy = reinterpret_cast<const float*>(y.data());
+                for (size_t k = 0; k < x.size() / sizeof(float); k++)
+                    diff = std::max(diff, static_cast<double>(std::fabs(fx[k] - fy[k])));
+            }
+            else
+            {
+                for (size_t k = 0; k < x.size(); k++)
+                    if (x[k] != y[k]) diff = std::max(diff, 1.0);
+            }
+        }
+    }
+    return diff;
+}
+
+// one run per request over bindings kept per request buffer, as the CPU worker does without batching
+static double runSingle(dxrt::CpuHandle& handle, vector<RequestBuffers>& reqs, int iterations)
+{
+    Ort::Session& session = *handle._session;
+    vector<std::unique_ptr<dxrt::CpuIoBindingSlot>> slots;
+    for (auto& req : reqs)
+    {
+        slots.emplace_back(new dxrt::CpuIoBindingSlot(session));
+        auto& slot = *slots.back();
+        for (int i = 0; i < handle._numInputs; i++)
+        {
+            slot.inputValues.emplace_back(Ort::Value::CreateTensor(handle._memoryInfo, req.inputPtrs[i],
+                handle._inputSizes[i], handle._inputShapes[i].data(), handle._inputShapes[i].size(),
+                dxrt::convertONNXTensorElementDataType(handle._inputDataTypes[i])));
+            slot.binding.BindInput(handle._inputNames[i].c_str(), slot.inputValues.back());
+        }
+        for (int i = 0; i < handle._numOutputs; i++)
+        {
+            slot.outputValues.emplace_back(Ort::Value::CreateTensor(handle._memoryInfo, req.outputPtrs[i],
+                handle._outputSizes[i], handle._outputShapes[i].data(), handle._outputShapes[i].size(),
+                dxrt::convertONNXTensorElementDataType(handle._outputDataTypes[i])));
+            slot.binding.BindOutput(handle._outputNames[i].c_str(), slot.outputValues.back());
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++)
+    {
+        for (auto& slot : slots)
+            session.Run(Ort::RunOptions{nullptr}, slot->binding);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double runBatched(dxrt::CpuHandle& handle, vector<RequestBuffers>& reqs, int batch, int iterations)
+{
+    dxrt::CpuIoBindingCache cache;
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++)
+    {
+        for (size_t first = 0; first < reqs.size(); first += batch)
+        {
+            size_t last = std::min(reqs.size(), first + batch);
+            vector<vector<void*>> inputs;
+            vector<vector<void*>> outputs;
+            for (size_t r = first; r < last; r++)
+            {
+                inputs.push_back(reqs[r].inputPtrs);
+                outputs.push_back(reqs[r].outputPtrs);
+            }
+            handle.RunBatchBuffers(*handle._session, cache, inputs, outputs);
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+    string modelPath;
+    string batchList = "1,2,4,8,16";
+    int requests = 64;
+    int iterations = 20;
+    uint32_t seed = 1;
+
+    cxxopts::Options options("cpu_batch_benchmark", APP_NAME);
+    options.add_options()
+        ("m, model", "ONNX model of a CPU task with a batch dimension", cxxopts::value<string>(modelPath))
+        ("b, batch", "batch sizes to measure, comma separated", cxxopts::value<string>(batchList)->default_value(batchList))
+        ("r, requests", "requests in flight (distinct buffers)", cxxopts::value<int>(requests)->default_value("64"))
+        ("l, loops", "passes over all requests", cxxopts::value<int>(iterations)->default_value("20"))
+        ("seed", "random seed of the input data", cxxopts::value<uint32_t>(seed)->default_value("1"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    vector<int> batches;
+    std::stringstream list(batchList);
+    string item;
+    while (std::getline(list, item, ','))
+    {
+        int b = std::atoi(item.c_str());
+        if (b < 1)
+        {
+            cout << options.help() << endl;
+            return -1;
+        }
+        batches.push_back(b);
+    }
+    if (modelPath.empty() || batches.empty() || requests <= 0 || iterations <= 0)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+#ifdef USE_ORT
+    std::ifstream file(modelPath, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "cannot open " << modelPath << endl;
+        return -1;
+    }
+    vector<char> model((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    dxrt::CpuHandle handle(model.data(), static_cast<int64_t>(model.size()), "benchmark", 1, 1);
+    if (handle._maxBatch <= 1)
+    {
+        std::cerr << "micro-batching is off: run with DXRT_CPU_MICRO_BATCH above 1, and " << modelPath
+                  << " needs a leading dimension with the same symbolic name on every input and output" << endl;
+        return -1;
+    }
+    int maxBatch = 1;
+    for (int b : batches) maxBatch = std::max(maxBatch, b);
+    handle._maxBatch = maxBatch;
+
+    cout << APP_NAME << endl;
+    cout << "model=" << modelPath << ", requests=" << requests << ", loops=" << iterations << endl;
+    cout << handle << endl;
+
+    vector<RequestBuffers> reference = makeRequests(handle, requests, seed);
+    double singleSec = runSingle(handle, reference, iterations);
+    double total = static_cast<double>(requests) * iterations;
+
+    printf("%-10s %14s %12s %10s %12s\n", "batch", "requests/s", "us/request", "speedup", "max diff");
+    printf("%-10s %14.0f %12.1f %10.2f %12s\n", "single", total / singleSec, singleSec * 1e6 / total, 1.0, "-");
+    for (int b : batches)
+    {
+        vector<RequestBuffers> reqs = makeRequests(handle, requests, seed);
+        double sec = runBatched(handle, reqs, b, iterations);
+        printf("%-10d %14.0f %12.1f %10.2f %12.3g\n", b, total / sec, sec * 1e6 / total, singleSec / sec,
+            compareOutputs(handle, reference, reqs));
+    }
+    return 0;
+#else
+    std::cerr << APP_NAME << " is built without ONNX Runtime (USE_ORT)" << endl;
+    return -1;
+#endif
+}
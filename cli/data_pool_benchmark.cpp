@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Stress test of dxrt::CircularDataPool, the pool of Request and InferenceJob objects. Threads
+// keep picking and releasing objects in random order while a given share of the pool stays
+// checked out, as requests in flight do. The same run is repeated on the previous pool (one mutex
+// and a round-robin scan of the use flags). Every handed-out object is claimed through an owner
+// field, so an object given to two threads at once is counted, as are picks that find nothing
+// although the pool is not exhausted. No device is needed.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dxrt/circular_data_pool.h"
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+
+#define APP_NAME "DXRT " DXRT_VERSION " data_pool_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+class PoolItem
+{
+ public:
+    explicit PoolItem(int id) : _id(id) {}
+    int id() const { return _id; }
+    std::atomic<int> owner{-1};
+
+ private:
+    friend class dxrt::CircularDataPool<PoolItem>;
+    template <typename T> friend class LockedScanPool;
+    int _id;
+    std::atomic<bool> _use_flag{false};
+    std::shared_ptr<dxrt::MpmcQueue<int>> _poolFreeIds;
+    int _poolIndex = -1;
+};
+
+// The pool before the free-index ring: pick() scans the use flags round robin under one mutex
+template <typename T>
+class LockedScanPool
+{
+ public:
+    explicit LockedScanPool(int count)
+    {
+        for (int i = 0; i < count; ++i) _dataPool.emplace_back(std::make_shared<T>(i));
+    }
+
+    std::shared_ptr<T> pick()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < _dataPool.size(); ++i)
+        {
+            std::shared_ptr<T> data = _dataPool[_headIndex];
+            if (++_headIndex == _dataPool.size()) _headIndex = 0;
+            bool expected = false;
+            if (data->_use_flag.compare_exchange_strong(expected, true)) return data;
+        }
+        return nullptr;
+    }
+
+    static void release(T* obj) { obj->_use_flag.store(false); }
+
+ private:
+    std::vector<std::shared_ptr<T>> _dataPool;
+    size_t _headIndex = 0;
+    std::mutex _mutex;
+};
+
+struct RunResult
+{
+    double seconds = 0;
+    uint64_t picks = 0;
+    uint64_t misses = 0;      // pick() returned nothing
+    uint64_t duplicates = 0;  // object already owned by another thread
+};
+
+template <typename Pool>
+static RunResult runPool(int poolSize, int threads, int held, uint64_t picksPerThread)
+{
+    Pool pool(poolSize);
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> duplicates{0};
+    std::atomic<bool> go{false};
+
+    vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t] {
+            std::vector<std::shared_ptr<PoolItem>> mine;
+            std::mt19937 rng(t + 1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (uint64_t i = 0; i < picksPerThread; i++)
+            {
+                auto item = pool.pick();
+                if (!item)
+                {
+                    misses.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    int expected = -1;
+                    if (!item->owner.compare_exchange_strong(expected, t))
+                        duplicates.fetch_add(1, std::memory_order_relaxed);
+                    else
+                        mine.push_back(item);
+                }
+                // keep this thread's share of the pool checked out; requests finish out of order,
+                // so a random one is released beyond it
+                while (static_cast<int>(mine.size()) > held)
+                {
+                    size_t victim = rng() % mine.size();
+                    std::swap(mine[victim], mine.back());
+                    auto old = mine.back();
+                    mine.pop_back();
+                    old->owner.store(-1);
+                    Pool::release(old.get());
+                }
+            }
+            for (auto& item : mine)
+            {
+                item->owner.store(-1);
+                Pool::release(item.get());
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) w.join();
+
+    RunResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.picks = picksPerThread * threads;
+    result.misses = misses.load();
+    result.duplicates = duplicates.load();
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    int poolSize = 15000;
+    string threadList = "1,2,4,8,16,32";
+    int occupancy = 90;
+    uint64_t picks = 200000;
+
+    cxxopts::Options options("data_pool_benchmark", APP_NAME);
+    options.add_options()
+        ("s, size", "objects in the pool", cxxopts::value<int>(poolSize)->default_value("15000"))
+        ("t, threads", "thread counts, comma separated", cxxopts::value<string>(threadList)->default_value(threadList))
+        ("o, occupancy", "percent of the pool kept checked out", cxxopts::value<int>(occupancy)->default_value("90"))
+        ("n, picks", "picks per thread", cxxopts::value<uint64_t>(picks)->default_value("200000"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    vector<int> threads;
+    std::stringstream ss(threadList);
+    string item;
+    while (std::getline(ss, item, ','))
+    {
+        int t = std::atoi(item.c_str());
+        if (t < 1)
+        {
+            cout << options.help() << endl;
+            return -1;
+        }
+        threads.push_back(t);
+    }
+    if (threads.empty() || poolSize <= 0 || occupancy < 0 || occupancy >= 100 || picks == 0)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    cout << "pool=" << poolSize << ", occupancy=" << occupancy << "%, picks/thread=" << picks << endl;
+    printf("%-8s %8s %14s %14s %9s %10s %10s\n", "threads", "held", "scan picks/s", "ring picks/s",
+        "speedup", "misses", "duplicates");
+
+    int failures = 0;
+    for (int t : threads)
+    {
+        int held = static_cast<int>(static_cast<int64_t>(poolSize) * occupancy / 100 / t);
+        RunResult scan = runPool<LockedScanPool<PoolItem>>(poolSize, t, held, picks);
+        RunResult ring = runPool<dxrt::CircularDataPool<PoolItem>>(poolSize, t, held, picks);
+        uint64_t misses = scan.misses + ring.misses;
+        uint64_t duplicates = scan.duplicates + ring.duplicates;
+        if (misses > 0 || duplicates > 0) failures++;
+        printf("%-8d %8d %14.0f %14.0f %9.2f %10lu %10lu\n", t, held, scan.picks / scan.seconds,
+            ring.picks / ring.seconds, scan.seconds / ring.seconds,
+            static_cast<unsigned long>(misses), static_cast<unsigned long>(duplicates));
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " run(s) missed a free object or handed one out twice" << endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,549 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Contention benchmark of the DevicePool device picker. Submitter threads keep a window of
+// requests in flight on simulated devices that accept DXRT_NPU_FULL_MAX_LOAD requests each and
+// serve them one at a time, as RunAsync callers do. The picker of DevicePool (policy scan, load
+// credit taken with a CAS, mutexes only while every device is full) is compared with the previous
+// one (whole pick under one mutex, round-robin scan, every completion notifying under the lock).
+// Reports picks per second and time spent in the picker, and checks that no device is ever given
+// more than its full load and that every request completes.
+//
+// With -r, the devices get the given service times instead and closed-loop clients (one request
+// in flight each, as Run() callers) are replayed under each schedule policy: least-load and
+// least-expected-latency, which learns the service times from the completions. Reports request
+// latency and the share of requests each device served. No device is needed.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/device_schedule_policy.h"
+#include "dxrt/extern/cxxopts.hpp"
+
+#define APP_NAME "DXRT " DXRT_VERSION " device_pool_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+static int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Client;
+struct SimDevice;
+
+struct Job
+{
+    int taskId = 0;
+    int64_t submitNs = 0;
+    Client* client = nullptr;
+};
+
+// Submitter side of a request: the window of requests a thread may have in flight
+struct Client
+{
+    std::mutex lock;
+    std::condition_variable cv;
+    int inflight = 0;
+    vector<int64_t> latencyNs;  // submit to completion, written by the device threads
+    std::mutex latencyLock;
+};
+
+struct SimDevice
+{
+    int id = 0;
+    uint32_t serviceUs = 0;
+    int fullLoad = DXRT_NPU_FULL_MAX_LOAD;
+    std::atomic<int> load{0};
+    std::atomic<int> peakLoad{0};
+    std::atomic<uint64_t> served{0};
+
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<Job> queue;
+    bool stop = false;
+    std::thread thread;
+
+    // DeviceTaskLayer::tryPick()
+    bool tryPick()
+    {
+        int cur = load.load();
+        while (cur < fullLoad)
+        {
+            if (load.compare_exchange_weak(cur, cur + 1))
+            {
+                notePeak(cur + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void notePeak(int value)
+    {
+        int peak = peakLoad.load();
+        while (value > peak && !peakLoad.compare_exchange_weak(peak, value)) {}
+    }
+};
+
+class Picker
+{
+ public:
+    virtual ~Picker() = default;
+    virtual SimDevice* Pick(int taskId) = 0;
+    // releases the load credit of a completed request and wakes waiting submitters
+    virtual void Complete(SimDevice* device, int taskId, uint32_t serviceUs) = 0;
+};
+
+// DevicePool::PickOneDevice before the lock-free scan: one submitter at a time, the round-robin
+// start index is advanced on every pick and every completion notifies under the device mutex
+class LockedPicker : public Picker
+{
+ public:
+    explicit LockedPicker(vector<SimDevice*> devices) : _devices(devices) {}
+
+    SimDevice* Pick(int taskId) override
+    {
+        std::ignore = taskId;
+        std::lock_guard<std::mutex> method(_methodMutex);
+        std::unique_lock<std::mutex> lock(_deviceMutex);
+        int picked = -1;
+        _deviceCV.wait(lock, [&] {
+            picked = pickIndex();
+            return picked >= 0;
+        });
+        SimDevice* device = _devices[picked];
+        device->notePeak(++device->load);
+        if (++_curDevIdx > 1000000) _curDevIdx = 0;
+        return device;
+    }
+
+    void Complete(SimDevice* device, int taskId, uint32_t serviceUs) override
+    {
+        std::ignore = taskId;
+        std::ignore = serviceUs;
+        device->load--;
+        std::unique_lock<std::mutex> lock(_deviceMutex);
+        _deviceCV.notify_all();
+    }
+
+ private:
+    int pickIndex()
+    {
+        int index = -1;
+        int best = std::numeric_limits<int>::max();
+        int count = static_cast<int>(_devices.size());
+        int start = _curDevIdx % count;
+        for (int i = 0; i < count; i++)
+        {
+            int idx = (i + start) % count;
+            int load = _devices[idx]->load.load();
+            if (load < _devices[idx]->fullLoad && load < best)
+            {
+                best = load;
+                index = idx;
+            }
+        }
+        return index;
+    }
+
+    vector<SimDevice*> _devices;
+    std::mutex _methodMutex;
+    std::mutex _deviceMutex;
+    std::condition_variable _deviceCV;
+    int _curDevIdx = 0;
+};
+
+// DevicePool::PickOneDevice: tryPickDevice, then WaitDevice only while every device is full, each
+// blocked submitter on its own condition and a completion waking the oldest one of its device
+class LockFreePicker : public Picker
+{
+ public:
+    LockFreePicker(vector<SimDevice*> devices, std::shared_ptr<dxrt::DeviceSchedulePolicy> policy)
+    : _devices(devices), _policy(policy) {}
+
+    SimDevice* Pick(int taskId) override
+    {
+        SimDevice* pick = tryPick(taskId);
+        if (pick) return pick;
+
+        std::unique_lock<std::mutex> lock(_deviceMutex);
+        _waiters++;
+        Waiter waiter;
+        auto self = _queue.insert(_queue.end(), &waiter);
+        while ((pick = tryPick(taskId)) == nullptr)
+        {
+            waiter.wokenBy = -1;
+            waiter.cv.wait(lock, [&waiter] { return waiter.wokenBy >= 0; });
+        }
+        _queue.erase(self);
+        if (waiter.wokenBy >= 0 && _devices[waiter.wokenBy]->load.load() < _devices[waiter.wokenBy]->fullLoad)
+            wakeLocked(waiter.wokenBy);
+        _waiters--;
+        return pick;
+    }
+
+    void Complete(SimDevice* device, int taskId, uint32_t serviceUs) override
+    {
+        _policy->OnRequestComplete(device->id, taskId, serviceUs);
+        device->load--;
+        if (_waiters.load() == 0) return;
+        std::lock_guard<std::mutex> lock(_deviceMutex);
+        wakeLocked(device->id);
+    }
+
+ private:
+    struct Waiter
+    {
+        std::condition_variable cv;
+        int wokenBy = -1;
+    };
+
+    // one woken waiter per device at a time; every submitter may use every device here
+    void wakeLocked(int deviceId)
+    {
+        for (Waiter* waiter : _queue)
+        {
+            if (waiter->wokenBy == deviceId) return;
+        }
+        for (Waiter* waiter : _queue)
+        {
+            if (waiter->wokenBy < 0)
+            {
+                waiter->wokenBy = deviceId;
+                waiter->cv.notify_one();
+                return;
+            }
+        }
+    }
+
+    SimDevice* tryPick(int taskId)
+    {
+        thread_local vector<dxrt::DeviceCandidate> candidates;
+        for (size_t attempt = 0; attempt < _devices.size() + 1; attempt++)
+        {
+            candidates.clear();
+            for (auto device : _devices)
+                candidates.push_back({device->id, device->load.load(), device->fullLoad});
+            int picked = _policy->Select(candidates, taskId);
+            if (picked < 0) return nullptr;
+            if (_devices[picked]->tryPick()) return _devices[picked];
+        }
+        return nullptr;
+    }
+
+    vector<SimDevice*> _devices;
+    std::shared_ptr<dxrt::DeviceSchedulePolicy> _policy;
+    std::mutex _deviceMutex;
+    std::list<Waiter*> _queue;
+    std::atomic<int> _waiters{0};
+};
+
+struct RunResult
+{
+    double seconds = 0;
+    uint64_t requests = 0;
+    double pickMeanUs = 0;
+    double pickP99Us = 0;
+    double latencyMeanUs = 0;
+    double latencyP99Us = 0;
+    int peakLoad = 0;
+    bool complete = false;
+    vector<uint64_t> served;
+};
+
+static void deviceThread(SimDevice* device, Picker* picker)
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk(device->lock);
+            device->cv.wait(lk, [device] { return device->stop || !device->queue.empty(); });
+            if (device->queue.empty()) return;
+            job = device->queue.front();
+            device->queue.pop_front();
+        }
+        int64_t start = nowNs();
+        if (device->serviceUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(device->serviceUs));
+        int64_t end = nowNs();
+        device->served++;
+
+        picker->Complete(device, job.taskId, static_cast<uint32_t>((end - start) / 1000));
+        {
+            std::lock_guard<std::mutex> lk(job.client->latencyLock);
+            job.client->latencyNs.push_back(end - job.submitNs);
+        }
+        std::lock_guard<std::mutex> lk(job.client->lock);
+        job.client->inflight--;
+        job.client->cv.notify_one();
+    }
+}
+
+template <typename MakePicker>
+static RunResult runPicker(const vector<uint32_t>& serviceUs, int threads, int window, uint64_t requests,
+    MakePicker makePicker)
+{
+    vector<std::unique_ptr<SimDevice>> devices;
+    vector<SimDevice*> raw;
+    for (size_t i = 0; i < serviceUs.size(); i++)
+    {
+        devices.emplace_back(new SimDevice());
+        devices.back()->id = static_cast<int>(i);
+        devices.back()->serviceUs = serviceUs[i];
+        raw.push_back(devices.back().get());
+    }
+    std::unique_ptr<Picker> picker = makePicker(raw);
+    for (auto device : raw) device->thread = std::thread(deviceThread, device, picker.get());
+
+    vector<std::unique_ptr<Client>> clients;
+    for (int t = 0; t < threads; t++) clients.emplace_back(new Client());
+    vector<vector<int64_t>> pickNs(threads);
+    std::atomic<bool> go{false};
+
+    vector<std::thread> submitters;
+    for (int t = 0; t < threads; t++)
+    {
+        submitters.emplace_back([&, t] {
+            Client& client = *clients[t];
+            pickNs[t].reserve(requests);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (uint64_t i = 0; i < requests; i++)
+            {
+                {
+                    std::unique_lock<std::mutex> lk(client.lock);
+                    client.cv.wait(lk, [&] { return client.inflight < window; });
+                    client.inflight++;
+                }
+                Job job;
+                job.taskId = static_cast<int>(i % 4);
+                job.client = &client;
+                job.submitNs = nowNs();
+                SimDevice* device = picker->Pick(job.taskId);
+                pickNs[t].push_back(nowNs() - job.submitNs);
+                std::lock_guard<std::mutex> lk(device->lock);
+                device->queue.push_back(job);
+                device->cv.notify_one();
+            }
+            std::unique_lock<std::mutex> lk(client.lock);
+            client.cv.wait(lk, [&] { return client.inflight == 0; });
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& s : submitters) s.join();
+
+    RunResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.requests = requests * threads;
+
+    for (auto device : raw)
+    {
+        {
+            std::lock_guard<std::mutex> lk(device->lock);
+            device->stop = true;
+            device->cv.notify_one();
+        }
+        device->thread.join();
+        result.peakLoad = std::max(result.peakLoad, device->peakLoad.load());
+        result.served.push_back(device->served.load());
+    }
+
+    vector<int64_t> picks, latency;
+    for (int t = 0; t < threads; t++)
+    {
+        picks.insert(picks.end(), pickNs[t].begin(), pickNs[t].end());
+        latency.insert(latency.end(), clients[t]->latencyNs.begin(), clients[t]->latencyNs.end());
+    }
+    uint64_t served = 0;
+    for (auto s : result.served) served += s;
+    result.complete = served == result.requests && latency.size() == result.requests;
+
+    auto summarize = [](vector<int64_t>& ns, double& mean, double& p99) {
+        if (ns.empty()) return;
+        std::sort(ns.begin(), ns.end());
+        double sum = 0;
+        for (auto v : ns) sum += v;
+        mean = sum / ns.size() / 1e3;
+        p99 = ns[std::min(ns.size() - 1, ns.size() * 99 / 100)] / 1e3;
+    };
+    summarize(picks, result.pickMeanUs, result.pickP99Us);
+    summarize(latency, result.latencyMeanUs, result.latencyP99Us);
+    return result;
+}
+
+// one line per policy, the same clients and devices for each
+static int runReplay(const vector<uint32_t>& serviceUs, int clients, uint64_t requests)
+{
+    struct Entry
+    {
+        const char* name;
+        std::function<std::shared_ptr<dxrt::DeviceSchedulePolicy>()> make;
+    };
+    const int numDevices = static_cast<int>(serviceUs.size());
+    const vector<Entry> policies = {
+        {"least-load", [] { return std::make_shared<dxrt::LeastLoadSchedulePolicy>(); }},
+        {"least-expected-latency",
+            [numDevices] { return std::make_shared<dxrt::LeastExpectedLatencySchedulePolicy>(numDevices); }},
+    };
+
+    printf("%-24s %10s %10s %10s  %s\n", "policy", "req/s", "mean us", "p99 us", "share per device");
+    int failures = 0;
+    for (const auto& entry : policies)
+    {
+        RunResult r = runPicker(serviceUs, clients, 1, requests, [&](vector<SimDevice*> devices) {
+            return std::unique_ptr<Picker>(new LockFreePicker(devices, entry.make()));
+        });
+        bool ok = r.complete && r.peakLoad <= DXRT_NPU_FULL_MAX_LOAD;
+        if (!ok) failures++;
+        string share;
+        for (auto served : r.served)
+        {
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%5.1f%%", 100.0 * served / r.requests);
+            share += buf;
+        }
+        printf("%-24s %10.0f %10.1f %10.1f  %s%s\n", entry.name, r.requests / r.seconds, r.latencyMeanUs,
+            r.latencyP99Us, share.c_str(), ok ? "" : "  OVERLOADED OR LOST");
+    }
+    return failures;
+}
+
+static vector<int> parseList(const string& text)
+{
+    vector<int> values;
+    std::stringstream ss(text);
+    string item;
+    while (std::getline(ss, item, ','))
+    {
+        int v = std::atoi(item.c_str());
+        if (v < 0) return {};
+        values.push_back(v);
+    }
+    return values;
+}
+
+int main(int argc, char* argv[])
+{
+    string threadList = "1,2,4,8,16,32";
+    int numDevices = 4;
+    int serviceUs = 0;
+    int window = 16;
+    uint64_t requests = 20000;
+    string replayList;
+    int clients = 8;
+
+    cxxopts::Options options("device_pool_benchmark", APP_NAME);
+    options.add_options()
+        ("t, threads", "submitter thread counts, comma separated", cxxopts::value<string>(threadList)->default_value(threadList))
+        ("d, devices", "simulated devices", cxxopts::value<int>(numDevices)->default_value("4"))
+        ("s, service", "service time of a request in microseconds", cxxopts::value<int>(serviceUs)->default_value("0"))
+        ("w, window", "requests in flight per submitter", cxxopts::value<int>(window)->default_value("16"))
+        ("n, requests", "requests per submitter (500 with -r)", cxxopts::value<uint64_t>(requests)->default_value("20000"))
+        ("r, replay", "service times of the devices in microseconds, comma separated; replays the schedule policies", cxxopts::value<string>(replayList))
+        ("c, clients", "closed-loop clients of the replay", cxxopts::value<int>(clients)->default_value("8"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    if (!replayList.empty())
+    {
+        vector<int> times = parseList(replayList);
+        if (!cmd.count("requests")) requests = 500;
+        bool validTimes = !times.empty();
+        for (int t : times)
+            if (t < 1) validTimes = false;
+        if (!validTimes || clients < 1 || requests == 0)
+        {
+            cout << options.help() << endl;
+            return -1;
+        }
+
+        cout << APP_NAME << endl;
+        cout << "replay: service=" << replayList << "us, clients=" << clients << ", requests/client=" << requests
+             << ", cores=" << std::thread::hardware_concurrency() << endl;
+        int failures = runReplay(vector<uint32_t>(times.begin(), times.end()), clients, requests);
+        if (failures > 0)
+        {
+            std::cerr << failures << " run(s) exceeded the full load of a device or lost a request" << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    vector<int> threads = parseList(threadList);
+    bool validThreads = !threads.empty();
+    for (int t : threads)
+        if (t < 1) validThreads = false;
+    if (!validThreads || numDevices < 1 || serviceUs < 0 || window < 1 || requests == 0)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    cout << "devices=" << numDevices << ", full load=" << DXRT_NPU_FULL_MAX_LOAD << ", service="
+         << serviceUs << "us, window=" << window << ", requests/thread=" << requests
+         << ", cores=" << std::thread::hardware_concurrency() << endl;
+    printf("%-8s %12s %10s %10s %12s %10s %10s %9s %5s\n", "threads", "locked req/s", "pick us", "p99 us",
+        "cas req/s", "pick us", "p99 us", "speedup", "peak");
+
+    const vector<uint32_t> service(numDevices, static_cast<uint32_t>(serviceUs));
+    int failures = 0;
+    for (int t : threads)
+    {
+        RunResult locked = runPicker(service, t, window, requests, [](vector<SimDevice*> devices) {
+            return std::unique_ptr<Picker>(new LockedPicker(devices));
+        });
+        RunResult cas = runPicker(service, t, window, requests, [](vector<SimDevice*> devices) {
+            return std::unique_ptr<Picker>(new LockFreePicker(devices,
+                std::make_shared<dxrt::LeastLoadSchedulePolicy>()));
+        });
+        int peak = std::max(locked.peakLoad, cas.peakLoad);
+        bool ok = locked.complete && cas.complete && peak <= DXRT_NPU_FULL_MAX_LOAD;
+        if (!ok) failures++;
+        printf("%-8d %12.0f %10.2f %10.2f %12.0f %10.2f %10.2f %9.2f %5d%s\n", t,
+            locked.requests / locked.seconds, locked.pickMeanUs, locked.pickP99Us,
+            cas.requests / cas.seconds, cas.pickMeanUs, cas.pickP99Us, locked.seconds / cas.seconds, peak,
+            ok ? "" : "  OVERLOADED OR LOST");
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " run(s) exceeded the full load of a device or lost a request" << endl;
+        return -1;
+    }
+    return 0;
+}
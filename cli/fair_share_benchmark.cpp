@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Simulated NPU time shares of processes with different model sizes under the dxrtd scheduling
+// policies. Every process keeps a fixed number of requests queued (closed loop), the device runs
+// one request per core; no device or dxrtd is needed.
+
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "fair_share_queue.h"
+
+#define APP_NAME "DXRT " DXRT_VERSION " fair_share_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+struct SimProcess
+{
+    string name;
+    double modelUs = 0;
+    uint32_t weight = dxrt::FairShareQueue::DEFAULT_WEIGHT;
+    int depth = 4;
+
+    uint64_t done = 0;
+    double busyUs = 0;
+    double latencyUs = 0;
+};
+
+class SimPolicy
+{
+ public:
+    virtual ~SimPolicy() = default;
+    virtual void Push(int proc, int reqId, uint32_t costUs, uint32_t weight) = 0;
+    virtual bool Pop(int& proc, int& reqId) = 0;
+};
+
+// arrival order, as FIFOSchedulerService
+class SimFifo : public SimPolicy
+{
+ public:
+    void Push(int proc, int reqId, uint32_t, uint32_t) override { _queue.emplace_back(proc, reqId); }
+    bool Pop(int& proc, int& reqId) override
+    {
+        if (_queue.empty()) return false;
+        proc = _queue.front().first;
+        reqId = _queue.front().second;
+        _queue.pop_front();
+        return true;
+    }
+ private:
+    std::deque<std::pair<int, int> > _queue;
+};
+
+// one request per process in turn, as RoundRobinSchedulerService
+class SimRoundRobin : public SimPolicy
+{
+ public:
+    void Push(int proc, int reqId, uint32_t, uint32_t) override { _queues[proc].push_back(reqId); }
+    bool Pop(int& proc, int& reqId) override
+    {
+        if (_queues.empty()) return false;
+        auto it = _queues.lower_bound(_next);
+        if (it == _queues.end()) it = _queues.begin();
+        proc = it->first;
+        reqId = it->second.front();
+        it->second.pop_front();
+        if (it->second.empty()) it = _queues.erase(it);
+        else ++it;
+        _next = (it == _queues.end()) ? 0 : it->first;
+        return true;
+    }
+ private:
+    std::map<int, std::deque<int> > _queues;
+    int _next = 0;
+};
+
+// WeightedFairSchedulerService
+class SimFairShare : public SimPolicy
+{
+ public:
+    void Push(int proc, int reqId, uint32_t costUs, uint32_t weight) override { _queue.Push(proc, reqId, costUs, weight); }
+    bool Pop(int& proc, int& reqId) override { return _queue.Pop(proc, reqId); }
+ private:
+    dxrt::FairShareQueue _queue;
+};
+
+static bool parseProcesses(const string& spec, vector<SimProcess>& procs)
+{
+    std::stringstream list(spec);
+    string item;
+    while (std::getline(list, item, ','))
+    {
+        SimProcess p;
+        char name[64] = {0};
+        int n = sscanf(item.c_str(), "%63[^:]:%lf:%u:%d", name, &p.modelUs, &p.weight, &p.depth);
+        if (n < 2 || p.modelUs <= 0 || p.weight == 0 || p.depth <= 0)
+        {
+            std::cerr << "invalid process '" << item << "', expected name:model_ms[:weight[:depth]]" << endl;
+            return false;
+        }
+        p.name = name;
+        p.modelUs *= 1000;
+        procs.push_back(p);
+    }
+    return !procs.empty();
+}
+
+static void simulate(SimPolicy& policy, vector<SimProcess> procs, int cores, double durationUs, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> jitter(0.9, 1.1);
+
+    struct Pending { int proc; double submitUs; };
+    std::map<int, Pending> pending;
+    int nextReqId = 1;
+    auto submit = [&](int proc, double now) {
+        int reqId = nextReqId++;
+        pending[reqId] = Pending{proc, now};
+        policy.Push(proc, reqId, static_cast<uint32_t>(procs[proc].modelUs), procs[proc].weight);
+    };
+    for (size_t i = 0; i < procs.size(); i++)
+    {
+        for (int d = 0; d < procs[i].depth; d++) submit(static_cast<int>(i), 0);
+    }
+
+    // completion events: end time, request id
+    typedef std::pair<double, int> Event;
+    std::priority_queue<Event, vector<Event>, std::greater<Event> > running;
+    double now = 0;
+    int idle = cores;
+    while (now < durationUs)
+    {
+        int proc = 0;
+        int reqId = 0;
+        while (idle > 0 && policy.Pop(proc, reqId))
+        {
+            double service = procs[proc].modelUs * jitter(rng);
+            procs[proc].busyUs += service;
+            running.emplace(now + service, reqId);
+            idle--;
+        }
+        if (running.empty()) break;
+
+        Event e = running.top();
+        running.pop();
+        now = e.first;
+        idle++;
+        Pending p = pending[e.second];
+        pending.erase(e.second);
+        procs[p.proc].done++;
+        procs[p.proc].latencyUs += now - p.submitUs;
+        submit(p.proc, now);
+    }
+
+    double busyTotal = 0;
+    uint64_t weightTotal = 0;
+    for (auto& p : procs)
+    {
+        busyTotal += p.busyUs;
+        weightTotal += p.weight;
+    }
+    // Jain's index over the share each process got relative to its target
+    double sum = 0;
+    double sumSq = 0;
+    printf("  %-16s %8s %10s %10s %10s %14s\n", "process", "weight", "requests", "share(%)", "target(%)", "latency(ms)");
+    for (auto& p : procs)
+    {
+        double share = busyTotal > 0 ? p.busyUs / busyTotal : 0;
+        double target = static_cast<double>(p.weight) / weightTotal;
+        sum += share / target;
+        sumSq += (share / target) * (share / target);
+        printf("  %-16s %8u %10lu %10.1f %10.1f %14.2f\n", p.name.c_str(), p.weight, static_cast<unsigned long>(p.done),
+            share * 100, target * 100, p.done ? p.latencyUs / p.done / 1000 : 0);
+    }
+    printf("  fairness index %.3f\n\n", sumSq > 0 ? sum * sum / (procs.size() * sumSq) : 0);
+}
+
+int main(int argc, char* argv[])
+{
+    string spec = "camera:2:100:4,analytics:40:100:4";
+    string policyName = "all";
+    int cores = 3;
+    double seconds = 10;
+    uint32_t seed = 1;
+
+    cxxopts::Options options("fair_share_benchmark", APP_NAME);
+    options.add_options()
+        ("p, procs", "processes as name:model_ms[:weight[:depth]], comma separated",
+            cxxopts::value<string>(spec)->default_value(spec))
+        ("s, scheduler", "FIFO, RoundRobin, WFQ or all", cxxopts::value<string>(policyName)->default_value("all"))
+        ("c, cores", "NPU cores running requests in parallel", cxxopts::value<int>(cores)->default_value("3"))
+        ("t, time", "simulated seconds", cxxopts::value<double>(seconds)->default_value("10"))
+        ("seed", "random seed of the inference time jitter", cxxopts::value<uint32_t>(seed)->default_value("1"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    vector<SimProcess> procs;
+    if (!parseProcesses(spec, procs) || cores <= 0 || seconds <= 0 ||
+        (policyName != "FIFO" && policyName != "RoundRobin" && policyName != "WFQ" && policyName != "all"))
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    cout << "cores=" << cores << ", simulated " << seconds << "s" << endl << endl;
+    vector<string> names = {"FIFO", "RoundRobin", "WFQ"};
+    for (const auto& name : names)
+    {
+        if (policyName != "all" && policyName != name) continue;
+        std::unique_ptr<SimPolicy> policy;
+        if (name == "FIFO") policy.reset(new SimFifo());
+        else if (name == "RoundRobin") policy.reset(new SimRoundRobin());
+        else policy.reset(new SimFairShare());
+        cout << name << endl;
+        simulate(*policy, procs, cores, seconds * 1e6, seed);
+    }
+    return 0;
+}
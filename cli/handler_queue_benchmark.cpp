@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Contention benchmark of dxrt::HandlerQueueThread, the work queue behind the input, output,
+// NFH and CPU task workers. N producer threads push into a queue served by N worker threads,
+// for N from 1 to 32, and the same run is repeated on the previous implementation (one mutex,
+// std::queue, notify_all on every push). Reports throughput and push-to-handler latency and
+// checks every item is handled exactly once. No device is needed.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/handler_que_template.h"
+
+#define APP_NAME "DXRT " DXRT_VERSION " handler_queue_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+struct WorkItem
+{
+    uint64_t seq = 0;
+    int64_t pushNs = 0;
+};
+
+// The queue HandlerQueueThread used before the lock-free ring: every push and pop takes the
+// same mutex and every push wakes all workers.
+template <typename T>
+class LockedQueueThread
+{
+ public:
+    LockedQueueThread(std::string name, size_t numThreads, std::function<int(const T&, int)> handler)
+    : _name(name), _handler(handler), _numThreads(numThreads) {}
+
+    ~LockedQueueThread()
+    {
+        _stop.store(true);
+        {
+            std::unique_lock<std::mutex> lk(_lock);
+            _cv.notify_all();
+        }
+        for (auto& t : _threads) t.join();
+    }
+
+    void PushWork(const T& x)
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _que.push(x);
+        _cv.notify_all();
+    }
+
+    void Start()
+    {
+        for (size_t i = 0; i < _numThreads; i++)
+            _threads.emplace_back(&LockedQueueThread<T>::ThreadWork, this, static_cast<int>(i));
+    }
+
+ private:
+    void ThreadWork(int id)
+    {
+        while (!_stop.load(std::memory_order_acquire))
+        {
+            T item;
+            {
+                std::unique_lock<std::mutex> lk(_lock);
+                _cv.wait(lk, [this] { return _que.size() || _stop.load(std::memory_order_acquire); });
+                if (_stop.load(std::memory_order_acquire)) return;
+                item = _que.front();
+                _que.pop();
+            }
+            _handler(item, id);
+        }
+    }
+
+    std::string _name;
+    std::queue<T> _que;
+    std::vector<std::thread> _threads;
+    std::mutex _lock;
+    std::condition_variable _cv;
+    std::atomic<bool> _stop{false};
+    std::function<int(const T&, int)> _handler;
+    size_t _numThreads;
+};
+
+struct RunResult
+{
+    double seconds = 0;
+    double p50Us = 0;
+    double p99Us = 0;
+    bool complete = false;
+};
+
+static int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void busyWork(int iterations)
+{
+    volatile uint64_t x = 0;
+    for (int i = 0; i < iterations; i++) x = x + i;
+}
+
+template <template <typename> class Queue>
+static RunResult runQueue(int threads, uint64_t items, int work)
+{
+    vector<int64_t> latency(items, -1);
+    vector<std::atomic<uint8_t>> handled(items);
+    for (auto& h : handled) h.store(0, std::memory_order_relaxed);
+    std::atomic<uint64_t> done{0};
+    std::mutex doneLock;
+    std::condition_variable doneCv;
+
+    RunResult result;
+    {
+        Queue<WorkItem> queue("benchmark", threads, [&](const WorkItem& item, int) {
+            latency[item.seq] = nowNs() - item.pushNs;
+            handled[item.seq].fetch_add(1, std::memory_order_relaxed);
+            busyWork(work);
+            if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == items)
+            {
+                std::unique_lock<std::mutex> lk(doneLock);
+                doneCv.notify_all();
+            }
+            return 0;
+        });
+        queue.Start();
+
+        auto start = std::chrono::steady_clock::now();
+        vector<std::thread> producers;
+        for (int p = 0; p < threads; p++)
+        {
+            producers.emplace_back([&, p] {
+                for (uint64_t seq = p; seq < items; seq += threads)
+                {
+                    WorkItem item;
+                    item.seq = seq;
+                    item.pushNs = nowNs();
+                    queue.PushWork(item);
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+        {
+            std::unique_lock<std::mutex> lk(doneLock);
+            result.complete = doneCv.wait_for(lk, std::chrono::seconds(60), [&] { return done.load() == items; });
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    for (auto& h : handled)
+        if (h.load() != 1) result.complete = false;
+    std::sort(latency.begin(), latency.end());
+    result.p50Us = latency[items / 2] / 1e3;
+    result.p99Us = latency[std::min<uint64_t>(items - 1, items * 99 / 100)] / 1e3;
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    string threadList = "1,2,4,8,16,32";
+    uint64_t items = 200000;
+    int work = 0;
+
+    cxxopts::Options options("handler_queue_benchmark", APP_NAME);
+    options.add_options()
+        ("t, threads", "producer and worker thread counts, comma separated", cxxopts::value<string>(threadList)->default_value(threadList))
+        ("n, items", "items pushed per run", cxxopts::value<uint64_t>(items)->default_value("200000"))
+        ("w, work", "busy-loop iterations in the handler per item", cxxopts::value<int>(work)->default_value("0"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    vector<int> threads;
+    std::stringstream ss(threadList);
+    string item;
+    while (std::getline(ss, item, ','))
+    {
+        int t = std::atoi(item.c_str());
+        if (t < 1)
+        {
+            cout << options.help() << endl;
+            return -1;
+        }
+        threads.push_back(t);
+    }
+    if (threads.empty() || items == 0 || work < 0)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    cout << "items=" << items << ", work=" << work << ", cores=" << std::thread::hardware_concurrency() << endl;
+    printf("%-8s %14s %10s %10s %14s %10s %10s %9s\n", "threads", "locked it/s", "p50 us", "p99 us",
+        "ring it/s", "p50 us", "p99 us", "speedup");
+
+    int failures = 0;
+    for (int t : threads)
+    {
+        RunResult locked = runQueue<LockedQueueThread>(t, items, work);
+        RunResult ring = runQueue<dxrt::HandlerQueueThread>(t, items, work);
+        if (!locked.complete || !ring.complete) failures++;
+        printf("%-8d %14.0f %10.1f %10.1f %14.0f %10.1f %10.1f %9.2f%s\n", t,
+            items / locked.seconds, locked.p50Us, locked.p99Us,
+            items / ring.seconds, ring.p50Us, ring.p99Us, locked.seconds / ring.seconds,
+            (locked.complete && ring.complete) ? "" : "  LOST OR DUPLICATED");
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " run(s) did not handle every item exactly once" << endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Round trip and throughput of the dxrt_service IPC transports (message queue vs shared rings).
+// A forked echo server stands in for dxrtd, so no device is needed; dxrtd must not be running
+// because the server side recreates the service message queues.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/ipc_wrapper/ipc_client_wrapper.h"
+#include "dxrt/ipc_wrapper/ipc_server_wrapper.h"
+#include "dxrt/service_util.h"
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define APP_NAME "DXRT " DXRT_VERSION " ipc_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+#ifdef __linux__
+
+struct IpcBenchResult
+{
+    double msgsPerSec = 0;
+    double rttP50Us = 0;
+    double rttP99Us = 0;
+    double rttMaxUs = 0;
+};
+
+// Echo every request back to its sender until a CLOSE request arrives
+static int runEchoServer(dxrt::IPC_TYPE type, int readyFd)
+{
+    dxrt::IPCServerWrapper server(type);
+    char ready = server.Initialize() == 0 ? 1 : 0;
+    if (write(readyFd, &ready, 1) != 1 || ready == 0)
+    {
+        return -1;
+    }
+    close(readyFd);
+
+    while (true)
+    {
+        dxrt::IPCClientMessage request;
+        if (server.ReceiveFromClient(request) != 0)
+        {
+            continue;
+        }
+        if (request.code == dxrt::REQUEST_CODE::CLOSE)
+        {
+            break;
+        }
+        dxrt::IPCServerMessage response;
+        response.code = dxrt::RESPONSE_CODE::CONFIRM_TRANSFER_INPUT_AND_RUN;
+        response.msgType = request.msgType;
+        response.seqId = request.seqId;
+        response.data = request.data;
+        response.deviceId = request.deviceId;
+        server.SendToClient(response);
+    }
+    server.Close();
+    return 0;
+}
+
+static bool runClient(dxrt::IPC_TYPE type, int count, int depth, IpcBenchResult& result)
+{
+    dxrt::IPCClientWrapper client(type, getpid());
+    if (client.Initialize(false) != 0)
+    {
+        std::cerr << "failed to connect to the echo server" << endl;
+        return false;
+    }
+
+    dxrt::IPCClientMessage request;
+    request.code = dxrt::REQUEST_CODE::TRANSFER_INPUT_AND_RUN;
+    request.pid = getpid();
+    dxrt::IPCServerMessage response;
+
+    // Latency: one request in flight
+    int warmup = std::min(count / 10 + 1, 1000);
+    vector<double> rtt;
+    rtt.reserve(count);
+    for (int i = 0; i < warmup + count; i++)
+    {
+        request.data = i;
+        auto start = std::chrono::steady_clock::now();
+        if (client.SendToServer(request) != 0 || client.ReceiveFromServer(response) != 0)
+        {
+            std::cerr << "round trip " << i << " failed" << endl;
+            return false;
+        }
+        auto end = std::chrono::steady_clock::now();
+        if (i >= warmup)
+        {
+            rtt.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+    }
+    std::sort(rtt.begin(), rtt.end());
+    result.rttP50Us = rtt[rtt.size() / 2];
+    result.rttP99Us = rtt[std::min(rtt.size() - 1, rtt.size() * 99 / 100)];
+    result.rttMaxUs = rtt.back();
+
+    // Throughput: windows of depth requests, as the runtime does with several jobs in flight
+    auto start = std::chrono::steady_clock::now();
+    int sent = 0;
+    while (sent < count)
+    {
+        int window = std::min(depth, count - sent);
+        for (int i = 0; i < window; i++)
+        {
+            request.data = sent + i;
+            client.SendToServer(request);
+        }
+        for (int i = 0; i < window; i++)
+        {
+            if (client.ReceiveFromServer(response) != 0)
+            {
+                std::cerr << "throughput reply " << sent + i << " failed" << endl;
+                return false;
+            }
+        }
+        sent += window;
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.msgsPerSec = count / sec;
+
+    // one way: the server deletes the queues right after reading it
+    request.code = dxrt::REQUEST_CODE::CLOSE;
+    client.SendToServer(request);
+    client.Close();
+    return true;
+}
+
+static bool benchmark(dxrt::IPC_TYPE type, int count, int depth, IpcBenchResult& result)
+{
+    int pipeFd[2];
+    if (pipe(pipeFd) != 0)
+    {
+        perror("pipe");
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0)
+    {
+        close(pipeFd[0]);
+        _exit(runEchoServer(type, pipeFd[1]) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(pipeFd[1]);
+    char ready = 0;
+    bool ok = read(pipeFd[0], &ready, 1) == 1 && ready == 1;
+    close(pipeFd[0]);
+    if (!ok)
+    {
+        std::cerr << "echo server failed to initialize" << endl;
+    }
+    else
+    {
+        ok = runClient(type, count, depth, result);
+    }
+    if (!ok)
+    {
+        kill(pid, SIGTERM);
+    }
+    waitpid(pid, nullptr, 0);
+    return ok;
+}
+
+static void printResult(const string& name, const IpcBenchResult& r)
+{
+    printf("%-12s %14.0f %10.2f %10.2f %10.2f\n", name.c_str(), r.msgsPerSec, r.rttP50Us, r.rttP99Us, r.rttMaxUs);
+}
+
+int main(int argc, char* argv[])
+{
+    string type = "all";
+    int count = 100000;
+    int depth = 16;
+
+    cxxopts::Options options("ipc_benchmark", APP_NAME);
+    options.add_options()
+        ("t, type", "transport to measure: mq, shm or all", cxxopts::value<string>(type)->default_value("all"))
+        ("n, count", "messages per measurement", cxxopts::value<int>(count)->default_value("100000"))
+        ("d, depth", "requests in flight for the throughput measurement", cxxopts::value<int>(depth)->default_value("16"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+    if ((type != "mq" && type != "shm" && type != "all") || count <= 0 || depth <= 0)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+    if (dxrt::isDxrtServiceRunning())
+    {
+        std::cerr << "dxrtd is running; stop it first, the benchmark replaces its message queues" << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    cout << "count=" << count << ", depth=" << depth << endl;
+    printf("%-12s %14s %10s %10s %10s\n", "transport", "msgs/sec", "p50(us)", "p99(us)", "max(us)");
+
+    IpcBenchResult result;
+    if (type == "mq" || type == "all")
+    {
+        if (!benchmark(dxrt::IPC_TYPE::MESSAE_QUEUE, count, depth, result)) return -1;
+        printResult("mq", result);
+    }
+    if (type == "shm" || type == "all")
+    {
+        if (!benchmark(dxrt::IPC_TYPE::SHARED_RING, count, depth, result)) return -1;
+        printResult("shm", result);
+    }
+    return 0;
+}
+
+#else
+
+int main()
+{
+    cout << APP_NAME << ": only the linux transports can be measured" << endl;
+    return 0;
+}
+
+#endif  // __linux__
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Stress test of the device memory allocator (dxrt::Memory) as dxrtd drives it: processes keep
+// allocating and releasing per-request I/O regions of mixed sizes, forward and backward, at a
+// fixed occupancy. The same trace is replayed on a linear best-fit scan of the address map, the
+// allocator's previous search, to compare the cost and check both place every block identically.
+// No device is needed.
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/driver.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/memory.h"
+
+#define APP_NAME "DXRT " DXRT_VERSION " memory_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+struct TraceOp
+{
+    bool alloc;
+    bool backward;
+    uint64_t size;
+    size_t slot;    // index of the live block freed by a release
+};
+
+// Linear best-fit over the address map with merge on free
+class ScanAllocator
+{
+ public:
+    explicit ScanAllocator(uint64_t size) { _pool[0] = dxrt::MemoryNode{0, size, 0}; }
+
+    int64_t Allocate(uint64_t required, bool backward)
+    {
+        required = (required + dxrt::MemoryConfig::MEMORY_ALIGNMENT - 1) & ~(dxrt::MemoryConfig::MEMORY_ALIGNMENT - 1);
+        auto best = _pool.end();
+        uint64_t bestSize = UINT64_MAX;
+        if (backward)
+        {
+            for (auto it = _pool.rbegin(); it != _pool.rend(); ++it)
+            {
+                if (it->second.status == 0 && it->second.size >= required && it->second.size < bestSize)
+                {
+                    bestSize = it->second.size;
+                    best = std::prev(it.base());
+                }
+            }
+        }
+        else
+        {
+            for (auto it = _pool.begin(); it != _pool.end(); ++it)
+            {
+                if (it->second.status == 0 && it->second.size >= required && it->second.size < bestSize)
+                {
+                    bestSize = it->second.size;
+                    best = it;
+                }
+            }
+        }
+        if (best == _pool.end()) return -1;
+
+        uint64_t addr = best->first;
+        uint64_t size = best->second.size;
+        if (required < size)
+        {
+            if (backward)
+            {
+                best->second.size = size - required;
+                addr += size - required;
+            }
+            else
+            {
+                _pool[addr + required] = dxrt::MemoryNode{addr + required, size - required, 0};
+            }
+        }
+        _pool[addr] = dxrt::MemoryNode{addr, required, 1};
+        return static_cast<int64_t>(addr);
+    }
+
+    void Deallocate(uint64_t addr)
+    {
+        auto it = _pool.find(addr);
+        if (it == _pool.end()) return;
+        it->second.status = 0;
+        auto next = std::next(it);
+        if (next != _pool.end() && next->second.status == 0)
+        {
+            it->second.size += next->second.size;
+            _pool.erase(next);
+        }
+        if (it != _pool.begin())
+        {
+            auto prev = std::prev(it);
+            if (prev->second.status == 0)
+            {
+                prev->second.size += it->second.size;
+                _pool.erase(it);
+            }
+        }
+    }
+
+    uint64_t LargestFree() const
+    {
+        uint64_t largest = 0;
+        for (const auto& pair : _pool)
+        {
+            if (pair.second.status == 0 && pair.second.size > largest) largest = pair.second.size;
+        }
+        return largest;
+    }
+
+ private:
+    std::map<uint64_t, dxrt::MemoryNode> _pool;
+};
+
+// Random mix of allocations and releases that hovers around the target occupancy
+static vector<TraceOp> buildTrace(uint64_t memSize, int ops, double occupancy, int backwardPercent, uint32_t seed)
+{
+    std::mt19937_64 rng(seed);
+    // per-request I/O regions: mostly small tensors, some feature maps, a few large frames
+    std::discrete_distribution<int> sizeClass({60, 30, 10});
+    std::uniform_int_distribution<uint64_t> small(1024, 256 * 1024);
+    std::uniform_int_distribution<uint64_t> medium(256 * 1024, 4 * 1024 * 1024);
+    std::uniform_int_distribution<uint64_t> large(4 * 1024 * 1024, 32 * 1024 * 1024);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    vector<TraceOp> trace;
+    trace.reserve(ops);
+    vector<uint64_t> live;
+    uint64_t used = 0;
+    for (int i = 0; i < ops; i++)
+    {
+        bool alloc = live.empty() || used < memSize * occupancy * 0.9 ||
+            (used < memSize * occupancy && percent(rng) < 50);
+        if (alloc)
+        {
+            int cls = sizeClass(rng);
+            uint64_t size = cls == 0 ? small(rng) : cls == 1 ? medium(rng) : large(rng);
+            trace.push_back(TraceOp{true, percent(rng) < backwardPercent, size, 0});
+            live.push_back(size);
+            used += size;
+        }
+        else
+        {
+            size_t slot = std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng);
+            trace.push_back(TraceOp{false, false, 0, slot});
+            used -= live[slot];
+            live[slot] = live.back();
+            live.pop_back();
+        }
+    }
+    return trace;
+}
+
+struct ReplayResult
+{
+    double allocNs = 0;
+    double freeNs = 0;
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t failures = 0;
+    vector<int64_t> addrs;
+};
+
+// Replays the trace; a request larger than the largest free block counts as a failure and is
+// not passed to the allocator (dxrtd checks CanAllocateContiguous first for the same reason)
+template <typename Alloc, typename Free, typename Largest, typename Sample>
+static ReplayResult replay(const vector<TraceOp>& trace, Alloc alloc, Free release, Largest largest, Sample sample)
+{
+    ReplayResult result;
+    vector<int64_t> live;
+    std::chrono::steady_clock::duration allocTime{0};
+    std::chrono::steady_clock::duration freeTime{0};
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        const TraceOp& op = trace[i];
+        if (op.alloc)
+        {
+            int64_t addr = -1;
+            if (largest() >= op.size)
+            {
+                auto start = std::chrono::steady_clock::now();
+                addr = alloc(op.size, op.backward);
+                allocTime += std::chrono::steady_clock::now() - start;
+                result.allocs++;
+            }
+            if (addr < 0) result.failures++;
+            live.push_back(addr);
+            result.addrs.push_back(addr);
+        }
+        else
+        {
+            int64_t addr = live[op.slot];
+            live[op.slot] = live.back();
+            live.pop_back();
+            if (addr >= 0)
+            {
+                auto start = std::chrono::steady_clock::now();
+                release(static_cast<uint64_t>(addr));
+                freeTime += std::chrono::steady_clock::now() - start;
+                result.frees++;
+            }
+        }
+        sample(i);
+    }
+    result.allocNs = result.allocs ? std::chrono::duration<double, std::nano>(allocTime).count() / result.allocs : 0;
+    result.freeNs = result.frees ? std::chrono::duration<double, std::nano>(freeTime).count() / result.frees : 0;
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t memMb = 4096;
+    int ops = 200000;
+    int occupancyPercent = 85;
+    int backwardPercent = 50;
+    uint32_t seed = 1;
+    bool skipScan = false;
+
+    cxxopts::Options options("memory_benchmark", APP_NAME);
+    options.add_options()
+        ("m, memory", "device memory in MB", cxxopts::value<uint64_t>(memMb)->default_value("4096"))
+        ("n, ops", "allocations and releases to replay", cxxopts::value<int>(ops)->default_value("200000"))
+        ("o, occupancy", "target occupancy in percent", cxxopts::value<int>(occupancyPercent)->default_value("85"))
+        ("b, backward", "percent of backward allocations", cxxopts::value<int>(backwardPercent)->default_value("50"))
+        ("seed", "random seed of the trace", cxxopts::value<uint32_t>(seed)->default_value("1"))
+        ("skip-scan", "do not replay on the linear scan", cxxopts::value<bool>(skipScan)->default_value("false"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+    if (memMb == 0 || ops <= 0 || occupancyPercent <= 0 || occupancyPercent > 100 ||
+        backwardPercent < 0 || backwardPercent > 100)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    uint64_t memSize = memMb * 1024 * 1024;
+    vector<TraceOp> trace = buildTrace(memSize, ops, occupancyPercent / 100.0, backwardPercent, seed);
+    cout << APP_NAME << endl;
+    cout << "memory=" << memMb << "MB, ops=" << ops << ", occupancy=" << occupancyPercent
+         << "%, backward=" << backwardPercent << "%" << endl << endl;
+
+    dxrt::dxrt_device_info_t info;
+    info.mem_addr = 0;
+    info.mem_size = memSize;
+    dxrt::Memory memory(info, nullptr);
+
+    // fragmentation sampled every 1000 operations
+    double fragSum = 0;
+    double fragMax = 0;
+    size_t blocksMax = 0;
+    int samples = 0;
+    ReplayResult indexed = replay(trace,
+        [&memory](uint64_t size, bool backward) {
+            return backward ? memory.BackwardAllocate(size) : memory.Allocate(size);
+        },
+        [&memory](uint64_t addr) { memory.Deallocate(addr); },
+        [&memory]() { return memory.GetLargestFreeBlock(); },
+        [&](size_t i) {
+            if (i % 1000 != 0) return;
+            auto frag = memory.GetFragmentationInfo();
+            fragSum += frag.fragmentation_ratio;
+            fragMax = std::max(fragMax, frag.fragmentation_ratio);
+            blocksMax = std::max(blocksMax, frag.free_block_count);
+            samples++;
+        });
+    auto frag = memory.GetFragmentationInfo();
+
+    printf("%-14s %12s %12s %10s %10s\n", "allocator", "alloc(ns)", "free(ns)", "allocs", "failures");
+    printf("%-14s %12.0f %12.0f %10lu %10lu\n", "size index", indexed.allocNs, indexed.freeNs,
+        static_cast<unsigned long>(indexed.allocs), static_cast<unsigned long>(indexed.failures));
+
+    bool same = true;
+    if (!skipScan)
+    {
+        ScanAllocator scan(memSize);
+        ReplayResult linear = replay(trace,
+            [&scan](uint64_t size, bool backward) { return scan.Allocate(size, backward); },
+            [&scan](uint64_t addr) { scan.Deallocate(addr); },
+            [&scan]() { return scan.LargestFree(); },
+            [](size_t) {});
+        printf("%-14s %12.0f %12.0f %10lu %10lu\n", "linear scan", linear.allocNs, linear.freeNs,
+            static_cast<unsigned long>(linear.allocs), static_cast<unsigned long>(linear.failures));
+        same = linear.addrs == indexed.addrs;
+    }
+
+    cout << endl << "fragmentation (free - largest free) / free" << endl;
+    printf("  mean %.1f%%, max %.1f%%, final %.1f%%\n", samples ? fragSum / samples * 100 : 0, fragMax * 100,
+        frag.fragmentation_ratio * 100);
+    printf("  free blocks max %lu, final %lu; largest free %.1fMB of %.1fMB free\n",
+        static_cast<unsigned long>(blocksMax), static_cast<unsigned long>(frag.free_block_count),
+        frag.largest_free_block / 1048576.0, frag.total_free_size / 1048576.0);
+    if (!skipScan)
+    {
+        cout << "  placement " << (same ? "identical to" : "DIFFERS from") << " the linear scan" << endl;
+    }
+    return same ? 0 : -1;
+}
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Model load latency in service mode. Several processes load the same model at once through the
+// runtime's service client: one of them gets fresh rmap/weight regions, uploads them (a sleep of
+// the given length) and announces them, the others wait for that upload and share the regions;
+// every process then allocates its I/O regions in one batch, as RegisterTask does. The waiters are
+// served by ServiceLayer::AcquireModelMemory, which the service answers as soon as the upload is
+// announced, and by the previous client loop that asked again every 10 ms. A forked stand-in for
+// dxrtd answers the memory requests with the service's model memory table and parks requests like
+// it does, so no device is needed; dxrtd must not be running because the stand-in recreates the
+// service message queues.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/ipc_wrapper/ipc_server_wrapper.h"
+#include "dxrt/memory.h"
+#include "dxrt/model_memory_cache.h"
+#include "dxrt/multiprocess_memory.h"
+#include "dxrt/service_abstract_layer.h"
+#include "dxrt/service_util.h"
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define APP_NAME "DXRT " DXRT_VERSION " model_load_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+#ifdef __linux__
+
+static constexpr int DEVICE_ID = 0;
+static constexpr int POLL_MS = 10;  // interval of the previous client loop
+
+// Answers the memory requests of model loading the way dxrtd does, for one device
+static int runStandInService(uint64_t memMB, int readyFd)
+{
+    dxrt::IPCServerWrapper server(dxrt::IPCServerDefaultType());
+    char ready = server.Initialize() == 0 ? 1 : 0;
+    if (write(readyFd, &ready, 1) != 1 || ready == 0)
+    {
+        return -1;
+    }
+    close(readyFd);
+
+    dxrt::dxrt_device_info_t info{};
+    info.mem_addr = 0;
+    info.mem_size = memMB << 20;
+    dxrt::Memory mem(info, nullptr);
+    dxrt::ModelMemoryCache models;
+    std::map<std::pair<pid_t, int>, vector<uint64_t>> taskRegions;
+    std::list<dxrt::IPCClientMessage> parked;
+    auto alloc = [&mem](uint64_t size) { return mem.BackwardAllocate(size); };
+    auto dealloc = [&mem](uint64_t addr) { mem.Deallocate(addr); };
+
+    // true when the reply is final
+    auto acquire = [&](const dxrt::IPCClientMessage& request, dxrt::IPCServerMessage& reply) {
+        dxrt::ModelMemoryRegion region = models.Acquire(dxrt::GetModelMemoryKey(request), request.pid,
+            request.taskId, alloc, dealloc);
+        reply.code = dxrt::RESPONSE_CODE::CONFIRM_MEMORY_ALLOCATION;
+        reply.msgType = request.msgType;
+        reply.seqId = request.seqId;
+        reply.deviceId = request.deviceId;
+        reply.result = static_cast<uint32_t>(region.state);
+        reply.data = (static_cast<uint64_t>(region.rmapOffset) << 32) |
+            (static_cast<uint64_t>(region.weightOffset) & 0xFFFFFFFFULL);
+        return region.state == dxrt::ModelMemoryRegion::State::ALLOCATED ||
+               region.state == dxrt::ModelMemoryRegion::State::RESIDENT;
+    };
+    auto retryParked = [&]() {
+        for (auto it = parked.begin(); it != parked.end();)
+        {
+            dxrt::IPCServerMessage reply;
+            if (acquire(*it, reply))
+            {
+                server.SendToClient(reply);
+                it = parked.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    };
+
+    while (true)
+    {
+        dxrt::IPCClientMessage request;
+        if (server.ReceiveFromClient(request) != 0)
+        {
+            continue;
+        }
+        if (request.code == dxrt::REQUEST_CODE::CLOSE)
+        {
+            break;
+        }
+        switch (request.code)
+        {
+            case dxrt::REQUEST_CODE::ACQUIRE_MODEL_MEMORY:
+            {
+                dxrt::IPCServerMessage reply;
+                if (acquire(request, reply) || request.alloc.waitMs == 0)
+                    server.SendToClient(reply);
+                else
+                    parked.push_back(request);
+                break;
+            }
+            case dxrt::REQUEST_CODE::MODEL_MEMORY_READY:
+            {
+                models.MarkResident(dxrt::GetModelMemoryKey(request));
+                retryParked();
+                break;
+            }
+            case dxrt::REQUEST_CODE::GET_MEMORY_BATCH:
+            {
+                dxrt::IPCServerMessage reply;
+                reply.code = dxrt::RESPONSE_CODE::CONFIRM_MEMORY_ALLOCATION;
+                reply.msgType = request.msgType;
+                reply.seqId = request.seqId;
+                reply.deviceId = request.deviceId;
+                reply.alloc.count = request.alloc.count;
+                auto& regions = taskRegions[std::make_pair(request.pid, request.taskId)];
+                for (uint32_t i = 0; i < request.alloc.count; i++)
+                {
+                    reply.alloc.regions[i] = static_cast<uint64_t>(mem.Allocate(request.alloc.regions[i]));
+                    regions.push_back(reply.alloc.regions[i]);
+                }
+                server.SendToClient(reply);
+                break;
+            }
+            case dxrt::REQUEST_CODE::DEALLOCATE_TASK_MEMORY:
+            {
+                models.Release(request.pid, request.taskId, dealloc);
+                auto it = taskRegions.find(std::make_pair(request.pid, request.taskId));
+                if (it != taskRegions.end())
+                {
+                    for (uint64_t addr : it->second) mem.Deallocate(addr);
+                    taskRegions.erase(it);
+                }
+                retryParked();
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    server.Close();
+    return 0;
+}
+
+struct LoadSample
+{
+    int uploaded = 0;   // 1: this process uploaded the model
+    double ms = 0;
+};
+
+// One process loading the model: regions, upload or wait, then the I/O regions of its task
+static int runLoader(bool poll, int round, int uploadUs, int ioRegions, int startFd, int resultFd)
+{
+    auto mem = std::make_shared<dxrt::MultiprocessMemory>();
+    dxrt::ServiceLayer service(mem);
+    const int taskId = 0;
+
+    dxrt::ModelMemoryKey key;
+    key.digest[0] = static_cast<uint8_t>(round);
+    key.digest[1] = static_cast<uint8_t>(round >> 8);
+    key.rmapSize = 1 << 20;
+    key.weightSize = 64 << 20;
+    vector<uint64_t> ioSizes(ioRegions, 640 * 640 * 3);
+
+    // connect before the clock starts
+    uint64_t warm = mem->TryAllocate(DEVICE_ID, 64);
+    mem->Deallocate(DEVICE_ID, warm);
+    char go = 0;
+    if (read(startFd, &go, 1) != 1)
+    {
+        return -1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    dxrt::ModelMemoryRegion region;
+    if (poll)
+    {
+        while ((region = mem->AcquireModelMemory(DEVICE_ID, taskId, key, 0)).state ==
+               dxrt::ModelMemoryRegion::State::PENDING)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MS));
+        }
+    }
+    else
+    {
+        region = service.AcquireModelMemory(DEVICE_ID, taskId, key);
+    }
+    if (region.state == dxrt::ModelMemoryRegion::State::FAILED)
+    {
+        return -1;
+    }
+    LoadSample sample;
+    if (region.state == dxrt::ModelMemoryRegion::State::ALLOCATED)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(uploadUs));
+        service.SignalModelMemoryReady(DEVICE_ID, key);
+        sample.uploaded = 1;
+    }
+    if (service.AllocateBatch(DEVICE_ID, taskId, ioSizes, false).size() != ioSizes.size())
+    {
+        return -1;
+    }
+    sample.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    mem->DeallocateTaskMemory(DEVICE_ID, taskId);
+    return write(resultFd, &sample, sizeof(sample)) == sizeof(sample) ? 0 : -1;
+}
+
+struct ModeResult
+{
+    vector<double> uploader;
+    vector<double> waiters;
+};
+
+static bool runRound(bool poll, int round, int processes, int uploadUs, int ioRegions, ModeResult& result)
+{
+    int startPipe[2], resultPipe[2];
+    if (pipe(startPipe) != 0 || pipe(resultPipe) != 0)
+    {
+        perror("pipe");
+        return false;
+    }
+    vector<pid_t> children;
+    for (int p = 0; p < processes; p++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(startPipe[1]);
+            close(resultPipe[0]);
+            _exit(runLoader(poll, round, uploadUs, ioRegions, startPipe[0], resultPipe[1]) == 0 ? EXIT_SUCCESS
+                                                                                                : EXIT_FAILURE);
+        }
+        if (pid > 0) children.push_back(pid);
+    }
+    close(startPipe[0]);
+    close(resultPipe[1]);
+    // released together once every loader is connected
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    vector<char> go(children.size(), 1);
+    bool ok = write(startPipe[1], go.data(), go.size()) == static_cast<ssize_t>(go.size());
+    close(startPipe[1]);
+
+    int uploads = 0;
+    LoadSample sample;
+    for (size_t i = 0; ok && i < children.size(); i++)
+    {
+        if (read(resultPipe[0], &sample, sizeof(sample)) != sizeof(sample))
+        {
+            ok = false;
+            break;
+        }
+        uploads += sample.uploaded;
+        (sample.uploaded ? result.uploader : result.waiters).push_back(sample.ms);
+    }
+    close(resultPipe[0]);
+    for (pid_t pid : children)
+    {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) ok = false;
+    }
+    if (static_cast<int>(children.size()) != processes || uploads != 1) ok = false;
+    return ok;
+}
+
+static double mean(const vector<double>& v)
+{
+    double sum = 0;
+    for (double x : v) sum += x;
+    return v.empty() ? 0 : sum / v.size();
+}
+
+static double percentile(vector<double> v, int pct)
+{
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, v.size() * pct / 100)];
+}
+
+int main(int argc, char* argv[])
+{
+    int processes = 4;
+    int rounds = 20;
+    int uploadUs = 19000;
+    int ioRegions = 8;
+
+    cxxopts::Options options("model_load_benchmark", APP_NAME);
+    options.add_options()
+        ("p, processes", "processes loading the model at once", cxxopts::value<int>(processes)->default_value("4"))
+        ("n, rounds", "loads per mode", cxxopts::value<int>(rounds)->default_value("20"))
+        ("u, upload", "upload time of the model in us (64 MiB at 3.5 GB/s)",
+            cxxopts::value<int>(uploadUs)->default_value("19000"))
+        ("i, io", "I/O regions allocated per task", cxxopts::value<int>(ioRegions)->default_value("8"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+    if (processes < 2 || rounds < 1 || uploadUs < 0 || ioRegions < 1 || ioRegions > dxrt::IPC_ALLOC_BATCH_MAX)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+    if (dxrt::isDxrtServiceRunning())
+    {
+        std::cerr << "dxrtd is running; stop it first, the benchmark replaces its message queues" << endl;
+        return -1;
+    }
+
+    int readyPipe[2];
+    if (pipe(readyPipe) != 0)
+    {
+        perror("pipe");
+        return -1;
+    }
+    pid_t server = fork();
+    if (server == 0)
+    {
+        close(readyPipe[0]);
+        _exit(runStandInService(1024, readyPipe[1]) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    close(readyPipe[1]);
+    char ready = 0;
+    if (server < 0 || read(readyPipe[0], &ready, 1) != 1 || ready != 1)
+    {
+        std::cerr << "stand-in service failed to initialize" << endl;
+        if (server > 0) waitpid(server, nullptr, 0);
+        return -1;
+    }
+    close(readyPipe[0]);
+
+    cout << APP_NAME << endl;
+    cout << "processes=" << processes << ", rounds=" << rounds << ", upload=" << uploadUs << "us, io regions="
+         << ioRegions << endl;
+    printf("%-10s %14s %14s %14s %14s\n", "waiting", "uploader(ms)", "waiter(ms)", "waiter p99", "waiter max");
+
+    bool ok = true;
+    int round = 0;
+    for (bool poll : {true, false})
+    {
+        ModeResult result;
+        for (int r = 0; ok && r < rounds; r++)
+        {
+            ok = runRound(poll, round++, processes, uploadUs, ioRegions, result);
+        }
+        if (!ok)
+        {
+            std::cerr << "a load failed or the model was uploaded more than once" << endl;
+            break;
+        }
+        printf("%-10s %14.2f %14.2f %14.2f %14.2f\n", poll ? "poll" : "service", mean(result.uploader),
+            mean(result.waiters), percentile(result.waiters, 99), percentile(result.waiters, 100));
+    }
+
+    // one way: the stand-in deletes the queues right after reading it
+    {
+        dxrt::IPCClientWrapper client(dxrt::IPCClientDefaultType(), getpid());
+        dxrt::IPCClientMessage close;
+        close.code = dxrt::REQUEST_CODE::CLOSE;
+        close.pid = getpid();
+        if (client.Initialize(false) == 0)
+        {
+            client.SendToServer(close);
+            client.Close();
+        }
+    }
+    waitpid(server, nullptr, 0);
+    return ok ? 0 : -1;
+}
+
+#else
+
+int main()
+{
+    cout << APP_NAME << ": only the linux transports can be measured" << endl;
+    return 0;
+}
+
+#endif  // __linux__
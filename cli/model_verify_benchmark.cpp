@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Model load time for each DXRT_MODEL_VERIFY mode. A simulated device (DXRT_SIMULATOR latency
+// model, PCIe bandwidth given by -p) is loaded with random model regions of the given sizes the
+// way RegisterTask does: every region is written and then checked with DeviceCore::Verify.
+// Afterwards one byte of the device copy is flipped and every mode is asked to verify it again;
+// full must report it and no mode may reject an intact region. No device is needed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/device_core.h"
+#include "dxrt/driver_adapter/driver_adapter_factory.h"
+#include "dxrt/driver_adapter/simulator_driver_adapter.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/util.h"
+
+#define APP_NAME "DXRT " DXRT_VERSION " model_verify_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+struct ModeResult
+{
+    const char* name;
+    dxrt::ModelVerifyMode mode;
+    double writeMs = 0;
+    double verifyMs = 0;
+    bool intactPassed = true;
+    bool corruptionFound = false;
+};
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// verifies every region the way RegisterTask does; false if any region is rejected
+static bool verifyRegions(dxrt::DeviceCore& core, vector<dxrt::dxrt_meminfo_t>& regions, dxrt::ModelVerifyMode mode)
+{
+    bool passed = true;
+    for (auto& region : regions)
+    {
+        if (core.Verify(region, mode) != 0) passed = false;
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    string sizeList = "1,64";
+    uint32_t pcieMBps = 3500;
+    int loops = 3;
+    uint32_t seed = 1;
+
+    cxxopts::Options options("model_verify_benchmark", APP_NAME);
+    options.add_options()
+        ("s, sizes", "model region sizes in MiB, comma separated (e.g. rmap,weight)",
+            cxxopts::value<string>(sizeList)->default_value(sizeList))
+        ("p, pcie", "simulated PCIe bandwidth per DMA channel in MB/s",
+            cxxopts::value<uint32_t>(pcieMBps)->default_value("3500"))
+        ("l, loops", "loads timed per mode", cxxopts::value<int>(loops)->default_value("3"))
+        ("seed", "seed of the model data and of the corrupted offset",
+            cxxopts::value<uint32_t>(seed)->default_value("1"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    vector<uint32_t> sizes;
+    uint64_t totalBytes = 0;
+    std::stringstream ss(sizeList);
+    string item;
+    while (std::getline(ss, item, ','))
+    {
+        int mib = std::atoi(item.c_str());
+        if (mib < 1 || mib > 1024)
+        {
+            cout << options.help() << endl;
+            return -1;
+        }
+        sizes.push_back(static_cast<uint32_t>(mib) << 20);
+        totalBytes += sizes.back();
+    }
+    if (sizes.empty() || pcieMBps == 0 || loops < 1)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    vector<ModeResult> results = {
+        {"off", dxrt::ModelVerifyMode::OFF},
+        {"sampled", dxrt::ModelVerifyMode::SAMPLED},
+        {"full", dxrt::ModelVerifyMode::FULL},
+    };
+    try
+    {
+        dxrt::SimulatorConfig config = dxrt::SimulatorConfig::Parse("pcie_mbps=" + std::to_string(pcieMBps));
+        config.memSizeMB = std::max<uint64_t>(config.memSizeMB, (totalBytes >> 20) + 16);
+        dxrt::DeviceCore core(0, dxrt::DriverAdapterFactory::CreateSimulator(0, config));
+        core.Identify(0);
+
+        std::mt19937 rng(seed);
+        vector<vector<uint8_t>> images;
+        vector<dxrt::dxrt_meminfo_t> regions;
+        uint32_t offset = 0;
+        for (uint32_t size : sizes)
+        {
+            images.emplace_back(size);
+            for (auto& b : images.back()) b = static_cast<uint8_t>(rng());
+            dxrt::dxrt_meminfo_t region;
+            region.data = reinterpret_cast<uint64_t>(images.back().data());
+            region.base = core.info().mem_addr;
+            region.offset = offset;
+            region.size = size;
+            regions.push_back(region);
+            offset += size;
+        }
+
+        // one untimed load so the first mode does not pay for faulting in the device memory
+        for (auto& region : regions)
+        {
+            if (core.Write(region) != 0) throw std::runtime_error("device write failed");
+        }
+
+        cout << "regions=" << sizeList << " MiB, pcie=" << pcieMBps << " MB/s, loops=" << loops << endl;
+        for (auto& r : results)
+        {
+            for (int l = 0; l < loops; l++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (auto& region : regions)
+                {
+                    if (core.Write(region) != 0) throw std::runtime_error("device write failed");
+                }
+                r.writeMs += elapsedMs(start);
+                start = std::chrono::steady_clock::now();
+                if (!verifyRegions(core, regions, r.mode)) r.intactPassed = false;
+                r.verifyMs += elapsedMs(start);
+            }
+            r.writeMs /= loops;
+            r.verifyMs /= loops;
+        }
+
+        // flip one byte of the largest region, away from its head and tail
+        size_t target = 0;
+        for (size_t i = 1; i < regions.size(); i++)
+            if (regions[i].size > regions[target].size) target = i;
+        uint32_t corruptAt = regions[target].size / 4 + rng() % (regions[target].size / 2);
+        uint8_t flipped = images[target][corruptAt] ^ 0x5a;
+        dxrt::dxrt_meminfo_t patch = regions[target];
+        patch.data = reinterpret_cast<uint64_t>(&flipped);
+        patch.offset += corruptAt;
+        patch.size = 1;
+        if (core.Write(patch) != 0) throw std::runtime_error("device write failed");
+        cout << "corrupted byte at region " << target << " offset 0x" << std::hex << corruptAt << std::dec
+            << "; mismatch reports below are expected" << endl;
+        for (auto& r : results)
+            r.corruptionFound = !verifyRegions(core, regions, r.mode);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << endl;
+        return -1;
+    }
+
+    printf("%-10s %10s %10s %10s %10s %8s %10s\n", "mode", "write ms", "verify ms", "load ms",
+        "overhead", "intact", "corrupted");
+    int failures = 0;
+    const double baseMs = results[0].writeMs + results[0].verifyMs;
+    for (auto& r : results)
+    {
+        const double loadMs = r.writeMs + r.verifyMs;
+        printf("%-10s %10.1f %10.1f %10.1f %9.1f%% %8s %10s\n", r.name, r.writeMs, r.verifyMs, loadMs,
+            baseMs > 0 ? (loadMs / baseMs - 1) * 100 : 0.0, r.intactPassed ? "pass" : "REJECT",
+            r.corruptionFound ? "found" : "missed");
+        if (!r.intactPassed) failures++;
+        if (!r.corruptionFound && r.mode == dxrt::ModelVerifyMode::FULL)
+            failures++;
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " mode(s) rejected an intact model or missed the corrupted byte" << endl;
+        return -1;
+    }
+    return 0;
+}
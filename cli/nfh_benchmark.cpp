@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Throughput of the NPU format handler (NFH) encoders and decoders per layout: ALIGNED encode,
+// FORMATTED encode, ALIGNED decode and PRE_FORMATTER encode, on (pixels x channels) tensors.
+// Each is measured against a plain row-by-row memcpy + memset implementation, the handler's
+// previous loops, and its output must be bit-identical to it. The row kernels run with the
+// instruction set picked for this process; set DXRT_NFH_KERNEL=scalar|neon|avx2|avx512 to
+// measure a lower one. No device is needed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/npu_format_handler.h"
+#include "dxrt/npu_format_kernels.h"
+
+#define APP_NAME "DXRT " DXRT_VERSION " nfh_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using npu_format_handler::Bytes;
+using npu_format_handler::NpuFormatHandler;
+using npu_format_handler::cdiv;
+
+// --- reference implementations, one memcpy + memset per row ---
+
+static void refEncode(const uint8_t* src, uint8_t* dst, size_t rows, size_t col, size_t unit)
+{
+    size_t aligned = cdiv(static_cast<int>(col), static_cast<int>(unit)) * unit;
+    for (size_t r = 0; r < rows; r++)
+    {
+        memcpy(dst + r * aligned, src + r * col, col);
+        memset(dst + r * aligned + col, 0, aligned - col);
+    }
+}
+
+static void refEncodeFormatted(const uint8_t* src, uint8_t* dst, size_t rows, size_t channel, size_t unit)
+{
+    size_t groups = cdiv(static_cast<int>(channel), static_cast<int>(unit));
+    for (size_t g = 0; g < groups; g++)
+    {
+        size_t copy = std::min(unit, channel - g * unit);
+        for (size_t r = 0; r < rows; r++)
+        {
+            uint8_t* out = dst + (g * rows + r) * unit;
+            memcpy(out, src + r * channel + g * unit, copy);
+            memset(out + copy, 0, unit - copy);
+        }
+    }
+}
+
+static void refDecode(const uint8_t* src, uint8_t* dst, size_t rows, size_t col, size_t unit)
+{
+    size_t aligned = cdiv(static_cast<int>(col), static_cast<int>(unit)) * unit;
+    for (size_t r = 0; r < rows; r++)
+        memcpy(dst + r * col, src + r * aligned, col);
+}
+
+struct Case
+{
+    const char* layout;
+    size_t inSize;
+    size_t outSize;
+    std::function<void(uint8_t*, uint8_t*)> reference;
+    std::function<void(uint8_t*, uint8_t*)> handler;
+};
+
+// average seconds per call after one warm-up call
+static double timeCall(const std::function<void(uint8_t*, uint8_t*)>& fn, uint8_t* in, uint8_t* out, int loops)
+{
+    fn(in, out);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; i++) fn(in, out);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / loops;
+}
+
+static vector<int> parseList(const string& text)
+{
+    vector<int> values;
+    std::stringstream ss(text);
+    string item;
+    while (std::getline(ss, item, ','))
+    {
+        int v = std::atoi(item.c_str());
+        if (v <= 0) return {};
+        values.push_back(v);
+    }
+    return values;
+}
+
+int main(int argc, char* argv[])
+{
+    int pixels = 160 * 160;
+    string channelList = "3,16,24,64,80,255,256";
+    string elementList = "1,4";
+    int unit = 64;
+    int loops = 50;
+
+    cxxopts::Options options("nfh_benchmark", APP_NAME);
+    options.add_options()
+        ("p, pixels", "rows of the tensor (height x width)", cxxopts::value<int>(pixels)->default_value("25600"))
+        ("c, channels", "channel counts to measure, comma separated", cxxopts::value<string>(channelList)->default_value(channelList))
+        ("e, elements", "element sizes in bytes, comma separated", cxxopts::value<string>(elementList)->default_value(elementList))
+        ("u, unit", "align unit in elements", cxxopts::value<int>(unit)->default_value("64"))
+        ("l, loops", "timed calls per case", cxxopts::value<int>(loops)->default_value("50"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    vector<int> channels = parseList(channelList);
+    vector<int> elements = parseList(elementList);
+    if (channels.empty() || elements.empty() || pixels <= 0 || unit <= 0 || loops <= 0)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    cout << "pixels=" << pixels << ", unit=" << unit << ", loops=" << loops << ", kernel="
+         << npu_format_handler::kernels::isa_name(npu_format_handler::kernels::active_isa()) << endl;
+    printf("%-14s %4s %6s %10s %12s %12s %9s %7s\n",
+        "layout", "elem", "ch", "bytes", "ref GB/s", "nfh GB/s", "speedup", "match");
+
+    std::mt19937 rng(1);
+    int mismatches = 0;
+    for (int e : elements)
+    {
+        for (int c : channels)
+        {
+            const size_t rows = pixels;
+            const size_t col = static_cast<size_t>(c) * e;
+            const size_t unitBytes = static_cast<size_t>(unit) * e;
+            const size_t aligned = cdiv(static_cast<int>(col), static_cast<int>(unitBytes)) * unitBytes;
+            const size_t formattedCol = cdiv(static_cast<int>(col), unit) * unit;
+
+            vector<Case> cases;
+            cases.push_back({"aligned-enc", rows * col, rows * aligned,
+                [=](uint8_t* in, uint8_t* out) { refEncode(in, out, rows, col, unitBytes); },
+                [=](uint8_t* in, uint8_t* out) {
+                    Bytes i{static_cast<uint32_t>(rows * col), in}, o{static_cast<uint32_t>(rows * aligned), out};
+                    NpuFormatHandler::encode(i, o, static_cast<int>(col), static_cast<int>(unitBytes));
+                }});
+            // encode_formatted works on bytes: the channel of a multi-byte tensor is c * e
+            cases.push_back({"formatted-enc", rows * col, rows * formattedCol,
+                [=](uint8_t* in, uint8_t* out) { refEncodeFormatted(in, out, rows, col, unit); },
+                [=](uint8_t* in, uint8_t* out) {
+                    Bytes i{static_cast<uint32_t>(rows * col), in}, o{static_cast<uint32_t>(rows * formattedCol), out};
+                    NpuFormatHandler::encode_formatted(i, o, static_cast<int>(col), unit);
+                }});
+            cases.push_back({"aligned-dec", rows * aligned, rows * col,
+                [=](uint8_t* in, uint8_t* out) { refDecode(in, out, rows, col, unitBytes); },
+                [=](uint8_t* in, uint8_t* out) {
+                    Bytes i{static_cast<uint32_t>(rows * aligned), in}, o{static_cast<uint32_t>(rows * col), out};
+                    NpuFormatHandler::decode(i, o, static_cast<int>(col), static_cast<int>(unitBytes));
+                }});
+            // the whole tensor is one row padded to the unit
+            const size_t flat = rows * col;
+            const size_t flatAligned = cdiv(static_cast<int>(flat), unit) * static_cast<size_t>(unit);
+            cases.push_back({"preformatter", flat, flatAligned,
+                [=](uint8_t* in, uint8_t* out) { refEncode(in, out, 1, flat, unit); },
+                [=](uint8_t* in, uint8_t* out) {
+                    Bytes i{static_cast<uint32_t>(flat), in}, o{static_cast<uint32_t>(flatAligned), out};
+                    NpuFormatHandler::encode_preformatter(i, o, unit);
+                }});
+
+            for (auto& test : cases)
+            {
+                vector<uint8_t> input(test.inSize);
+                for (auto& b : input) b = static_cast<uint8_t>(rng());
+                // stale bytes in the outputs make a missed padding write visible
+                vector<uint8_t> expected(test.outSize, 0xA5);
+                vector<uint8_t> actual(test.outSize, 0x5A);
+
+                double refSec = timeCall(test.reference, input.data(), expected.data(), loops);
+                double nfhSec = timeCall(test.handler, input.data(), actual.data(), loops);
+                bool match = expected == actual;
+                if (!match) mismatches++;
+
+                double bytes = static_cast<double>(test.inSize + test.outSize);
+                printf("%-14s %4d %6d %10zu %12.2f %12.2f %9.2f %7s\n",
+                    test.layout, e, c, test.outSize, bytes / refSec / 1e9, bytes / nfhSec / 1e9,
+                    refSec / nfhSec, match ? "yes" : "NO");
+            }
+        }
+    }
+
+    if (mismatches > 0)
+    {
+        std::cerr << mismatches << " case(s) differ from the reference" << endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Checks the fused transpose encoders and decoder of the NPU format handler against the two-step
+// compositions EncodeInputs / DecodeOutputs are defined by:
+//   FORMATTED CHANNEL_FIRST_TO_LAST  encode_formatted + in-place transpose  vs encode_formatted_transposed
+//   ALIGNED   CHANNEL_FIRST_TO_LAST  transpose + encode                     vs encode_aligned_transposed
+//   ALIGNED   CHANNEL_LAST_TO_FIRST  decode_aligned + in-place transpose    vs decode_aligned_transposed
+// over channel counts that span several align-unit groups and every element size. The handler
+// only takes the fused path where is_formatted_transposed_exact / is_aligned_transposed_exact
+// allow it; the check fails if the fused output differs from the composition for such a shape.
+// No device is needed.
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/npu_format_handler.h"
+#include "dxrt/util.h"
+
+#define APP_NAME "DXRT " DXRT_VERSION " nfh_fused_check"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using npu_format_handler::Bytes;
+using npu_format_handler::NpuFormatHandler;
+using npu_format_handler::cdiv;
+
+struct Summary
+{
+    int shapes = 0;
+    int fused = 0;      // shapes the handler runs fused
+    int identical = 0;  // shapes where fused and two-step agree
+    int failures = 0;   // fused by the handler but different from the two-step result
+};
+
+static vector<int> parseList(const string& text)
+{
+    vector<int> values;
+    std::stringstream ss(text);
+    string item;
+    while (std::getline(ss, item, ','))
+    {
+        int v = std::atoi(item.c_str());
+        if (v <= 0) return {};
+        values.push_back(v);
+    }
+    return values;
+}
+
+static const char* dtypeName(deepx_rmapinfo::DataType dtype)
+{
+    switch (dtype)
+    {
+        case deepx_rmapinfo::DataType::UINT8: return "uint8";
+        case deepx_rmapinfo::DataType::UINT16: return "uint16";
+        case deepx_rmapinfo::DataType::INT32: return "int32";
+        case deepx_rmapinfo::DataType::FLOAT32: return "float32";
+        default: return "other";
+    }
+}
+
+static void report(Summary& summary, const char* path, deepx_rmapinfo::DataType dtype, int channel,
+    int pixels, int unit, bool fused, bool same, bool verbose)
+{
+    summary.shapes++;
+    if (fused) summary.fused++;
+    if (same) summary.identical++;
+    if (fused && !same) summary.failures++;
+    if (verbose || (fused && !same))
+    {
+        printf("%-18s %-8s %6d %7d %5d %7d %-9s %s\n", path, dtypeName(dtype), channel, pixels, unit,
+            cdiv(channel, unit), fused ? "fused" : "two-step", same ? "identical" : "differs");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    string channelList = "1,3,16,63,64,65,80,128,130,200,255,256";
+    string pixelList = "1,7,100,1600";
+    string unitList = "16,64";
+    bool verbose = false;
+
+    cxxopts::Options options("nfh_fused_check", APP_NAME);
+    options.add_options()
+        ("c, channels", "channel counts, comma separated", cxxopts::value<string>(channelList)->default_value(channelList))
+        ("p, pixels", "pixel counts (product of the other dims), comma separated", cxxopts::value<string>(pixelList)->default_value(pixelList))
+        ("u, units", "align units, comma separated", cxxopts::value<string>(unitList)->default_value(unitList))
+        ("v, verbose", "print every shape", cxxopts::value<bool>(verbose)->default_value("false"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    vector<int> channels = parseList(channelList);
+    vector<int> pixels = parseList(pixelList);
+    vector<int> units = parseList(unitList);
+    if (channels.empty() || pixels.empty() || units.empty())
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    const deepx_rmapinfo::DataType dtypes[] = {
+        deepx_rmapinfo::DataType::UINT8, deepx_rmapinfo::DataType::UINT16,
+        deepx_rmapinfo::DataType::INT32, deepx_rmapinfo::DataType::FLOAT32};
+
+    cout << APP_NAME << endl;
+    printf("%-18s %-8s %6s %7s %5s %7s %-9s %s\n", "path", "dtype", "ch", "pixels", "unit", "groups", "handler", "result");
+
+    std::mt19937 rng(1);
+    Summary formatted, alignedEnc, alignedDec;
+    for (auto dtype : dtypes)
+    {
+        const int e = dxrt::GetDataSize_rmapinfo_datatype(dtype);
+        for (int unit : units)
+        {
+            for (int c : channels)
+            {
+                for (int n : pixels)
+                {
+                    const size_t plain = static_cast<size_t>(c) * n * e;
+                    const size_t padded = static_cast<size_t>(cdiv(c, unit)) * unit * n * e;
+                    vector<uint8_t> src(plain);
+                    for (auto& b : src) b = static_cast<uint8_t>(rng());
+
+                    // FORMATTED CHANNEL_FIRST_TO_LAST: (c x n) channel-first input
+                    {
+                        vector<uint8_t> twoStep(padded, 0xA5), fused(padded, 0x5A);
+                        Bytes in{static_cast<uint32_t>(plain), src.data()};
+                        Bytes out{static_cast<uint32_t>(padded), twoStep.data()};
+                        NpuFormatHandler::encode_formatted(in, out, c, unit);
+                        NpuFormatHandler::bidirectional_transpose(twoStep.data(), twoStep.data(), c, n, e);
+                        Bytes fusedOut{static_cast<uint32_t>(padded), fused.data()};
+                        NpuFormatHandler::encode_formatted_transposed(in, fusedOut, c, n, e, unit);
+                        report(formatted, "formatted-c2l-enc", dtype, c, n, unit,
+                            NpuFormatHandler::is_formatted_transposed_exact(c, unit), twoStep == fused, verbose);
+                    }
+                    // ALIGNED CHANNEL_FIRST_TO_LAST: transpose, then align rows of c
+                    {
+                        vector<uint8_t> twoStep(padded, 0xA5), fused(padded, 0x5A);
+                        NpuFormatHandler::bidirectional_transpose(src.data(), twoStep.data(), c, n, e);
+                        int col = c;
+                        int alignUnit = unit;
+                        if (dtype == deepx_rmapinfo::DataType::FLOAT32)
+                        {
+                            col *= 4;
+                            alignUnit *= 4;
+                        }
+                        Bytes transposed{static_cast<uint32_t>(plain), twoStep.data()};
+                        Bytes out{static_cast<uint32_t>(padded), twoStep.data()};
+                        NpuFormatHandler::encode(transposed, out, col, alignUnit);
+                        Bytes in{static_cast<uint32_t>(plain), src.data()};
+                        Bytes fusedOut{static_cast<uint32_t>(padded), fused.data()};
+                        NpuFormatHandler::encode_aligned_transposed(in, fusedOut, c, n, e, unit);
+                        report(alignedEnc, "aligned-c2l-enc", dtype, c, n, unit,
+                            NpuFormatHandler::is_aligned_transposed_exact(c, dtype, unit), twoStep == fused, verbose);
+                    }
+                    // ALIGNED CHANNEL_LAST_TO_FIRST: NPU output of n rows of c aligned channels
+                    {
+                        vector<uint8_t> encoded(padded);
+                        for (auto& b : encoded) b = static_cast<uint8_t>(rng());
+                        vector<uint8_t> twoStep(plain, 0xA5), fused(plain, 0x5A);
+                        Bytes in{static_cast<uint32_t>(padded), encoded.data()};
+                        Bytes out{static_cast<uint32_t>(plain), twoStep.data()};
+                        NpuFormatHandler::decode_aligned(in, out, c, dtype, unit);
+                        NpuFormatHandler::bidirectional_transpose(twoStep.data(), twoStep.data(), n, c, e);
+                        Bytes fusedOut{static_cast<uint32_t>(plain), fused.data()};
+                        NpuFormatHandler::decode_aligned_transposed(in, fusedOut, c, dtype, {n, c},
+                            deepx_rmapinfo::Transpose::CHANNEL_LAST_TO_FIRST, unit);
+                        report(alignedDec, "aligned-l2c-dec", dtype, c, n, unit,
+                            NpuFormatHandler::is_aligned_transposed_exact(c, dtype, unit), twoStep == fused, verbose);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("\n%-18s %7s %7s %10s %9s\n", "path", "shapes", "fused", "identical", "failures");
+    const char* names[] = {"formatted-c2l-enc", "aligned-c2l-enc", "aligned-l2c-dec"};
+    const Summary* summaries[] = {&formatted, &alignedEnc, &alignedDec};
+    int failures = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        printf("%-18s %7d %7d %10d %9d\n", names[i], summaries[i]->shapes, summaries[i]->fused,
+            summaries[i]->identical, summaries[i]->failures);
+        failures += summaries[i]->failures;
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " fused shape(s) differ from the two-step composition" << endl;
+        return -1;
+    }
+    return 0;
+}
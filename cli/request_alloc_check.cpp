@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Checks that submitting an inference does not touch the heap once the pools are warm. Global
+// operator new is replaced by a counting one that only counts on the measuring thread while it
+// is inside the measured call. Without -m, requests of a synthetic task (one input, three
+// detector heads with long tensor names) are created the way InferenceJob::startJob does,
+// with their outputs mapped onto a user buffer, and recycled with Reset() while a window of them
+// is in flight; no device is needed. With -m, the model is run through InferenceEngine::RunAsync
+// and Wait, and the RunAsync calls are counted; this needs a device or DXRT_SIMULATOR. Every
+// pooled request is used during the warm-up, after which nothing may be allocated.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/inference_engine.h"
+#include "dxrt/objects_pool.h"
+#include "dxrt/request.h"
+#include "dxrt/task.h"
+
+#define APP_NAME "DXRT " DXRT_VERSION " request_alloc_check"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+static std::atomic<uint64_t> g_allocations{0};
+static thread_local bool t_counting = false;
+
+void* operator new(std::size_t size)
+{
+    if (t_counting) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    if (t_counting) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+// counts the allocations of this thread while it is alive
+class CountScope
+{
+ public:
+    explicit CountScope(bool enable) { t_counting = enable; }
+    ~CountScope() { t_counting = false; }
+};
+
+struct Result
+{
+    uint64_t calls = 0;
+    uint64_t allocations = 0;
+};
+
+static Result runSynthetic(uint64_t warmup, uint64_t calls, size_t window)
+{
+    dxrt::Task task;
+    dxrt::TaskData* data = task.getData();
+    data->_inputTensors.emplace_back("images_normalized_nhwc_input", vector<int64_t>{1, 640, 640, 3}, dxrt::DataType::UINT8);
+    data->_inputOffsets = {0};
+    const char* heads[] = {"/model.24/m.0/Conv_output_0", "/model.24/m.1/Conv_output_0", "/model.24/m.2/Conv_output_0"};
+    const int64_t grids[] = {80, 40, 20};
+    uint64_t offset = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        data->_outputTensors.emplace_back(heads[i], vector<int64_t>{1, 255, grids[i], grids[i]}, dxrt::DataType::FLOAT);
+        data->_outputOffsets.push_back(offset);
+        offset += 255 * grids[i] * grids[i] * 4;
+    }
+    vector<uint8_t> input(640 * 640 * 3);
+    vector<uint8_t> output(offset);
+    vector<uint8_t> userOutput(offset);
+
+    // ring of the requests in flight; a std::deque would allocate its own blocks
+    vector<dxrt::RequestPtr> inflight(window);
+    Result result;
+    for (uint64_t i = 0; i < warmup + calls; i++)
+    {
+        const bool measured = i >= warmup;
+        uint64_t before = g_allocations.load();
+        {
+            CountScope scope(measured);
+            // startJob: the request of the head task, its outputs mapped onto the user buffer
+            dxrt::RequestPtr req = dxrt::Request::Create(&task, input.data(), output.data(), nullptr, 0);
+            req->assignOutputs(data->_outputTensors, data->_outputOffsets, userOutput.data());
+            dxrt::RequestPtr& slot = inflight[i % window];
+            if (slot) slot->Reset();
+            slot = req;
+        }
+        if (measured)
+        {
+            result.calls++;
+            result.allocations += g_allocations.load() - before;
+        }
+    }
+    for (auto& req : inflight)
+        if (req) req->Reset();
+    return result;
+}
+
+static Result runModel(const string& modelPath, uint64_t warmup, uint64_t calls)
+{
+    dxrt::InferenceEngine ie(modelPath);
+    vector<uint8_t> input(ie.GetInputSize());
+    vector<uint8_t> output(ie.GetOutputSize());
+
+    Result result;
+    for (uint64_t i = 0; i < warmup + calls; i++)
+    {
+        const bool measured = i >= warmup;
+        uint64_t before = g_allocations.load();
+        int jobId;
+        {
+            CountScope scope(measured);
+            jobId = ie.RunAsync(input.data(), nullptr, output.data());
+        }
+        if (measured)
+        {
+            result.calls++;
+            result.allocations += g_allocations.load() - before;
+        }
+        ie.Wait(jobId);
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    string modelPath;
+    uint64_t warmup = dxrt::ObjectsPool::REQUEST_MAX_COUNT + 100;
+    uint64_t calls = 20000;
+    int window = 64;
+
+    cxxopts::Options options("request_alloc_check", APP_NAME);
+    options.add_options()
+        ("m, model", "run this model through RunAsync instead of the synthetic task", cxxopts::value<string>(modelPath))
+        ("w, warmup", "calls before counting, at least the request pool size",
+            cxxopts::value<uint64_t>(warmup)->default_value(std::to_string(warmup)))
+        ("n, calls", "counted calls", cxxopts::value<uint64_t>(calls)->default_value("20000"))
+        ("i, inflight", "synthetic requests in flight", cxxopts::value<int>(window)->default_value("64"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+    if (calls == 0 || window < 1)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    Result result;
+    const char* path;
+    try
+    {
+        if (modelPath.empty())
+        {
+            path = "Request::Create";
+            result = runSynthetic(warmup, calls, static_cast<size_t>(window));
+        }
+        else
+        {
+            path = "RunAsync";
+            result = runModel(modelPath, warmup, calls);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << endl;
+        return -1;
+    }
+
+    printf("%-16s %10s %10s %12s %12s\n", "path", "warmup", "calls", "allocations", "per call");
+    printf("%-16s %10lu %10lu %12lu %12.3f\n", path, static_cast<unsigned long>(warmup),
+        static_cast<unsigned long>(result.calls), static_cast<unsigned long>(result.allocations),
+        static_cast<double>(result.allocations) / result.calls);
+
+    if (result.allocations > 0)
+    {
+        std::cerr << result.allocations << " heap allocation(s) after warm-up" << endl;
+        return -1;
+    }
+    return 0;
+}
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <iomanip>
 
 #include "dxrt/dxrt_api.h"
 #include "dxrt/extern/cxxopts.hpp"
@@ -40,6 +41,7 @@ enum RunModelMode {
 };
 static RunModelMode mode;
 static int bounding = 0;
+static int64_t latencyIntervalSec = 0;
 
 // linux host info
 #ifdef __linux__
@@ -251,6 +253,43 @@ void PrintInfResult(const std::string& inputFile, const std::string& outputFile,
     std::cout << std::string(maxLength, '=') << std::endl;
 }
 
+void PrintStageLatency(const std::string& title, const std::vector<dxrt::LatencyStats>& stats)
+{
+    cout << title << endl;
+    cout << "  " << std::left << std::setw(16) << "stage" << std::right
+         << std::setw(10) << "count" << std::setw(12) << "mean(us)" << std::setw(12) << "p50(us)"
+         << std::setw(12) << "p99(us)" << std::setw(12) << "p99.9(us)" << std::setw(12) << "max(us)" << endl;
+    cout << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        const dxrt::LatencyStats& s = stats[i];
+        cout << "  " << std::left << std::setw(16) << dxrt::PipelineStageName(static_cast<dxrt::PipelineStage>(i))
+             << std::right << std::setw(10) << s.count << std::setw(12) << s.mean << std::setw(12) << s.p50
+             << std::setw(12) << s.p99 << std::setw(12) << s.p999 << std::setw(12) << s.max << endl;
+    }
+    cout.unsetf(std::ios::floatfield);
+    cout << std::setprecision(6);
+}
+
+static std::vector<dxrt::LatencyStats> getAllStageLatency(dxrt::InferenceEngine& ie)
+{
+    std::vector<dxrt::LatencyStats> stats;
+    for (int i = 0; i < static_cast<int>(dxrt::PipelineStage::COUNT); i++)
+        stats.push_back(ie.GetStageLatency(static_cast<dxrt::PipelineStage>(i)));
+    return stats;
+}
+
+// Prints the stage latencies of the last interval every latencyIntervalSec seconds
+static void printStageSnapshotIfDue(dxrt::InferenceEngine& ie, std::chrono::steady_clock::time_point& last)
+{
+    if (latencyIntervalSec <= 0)
+        return;
+    auto now = std::chrono::steady_clock::now();
+    if (now - last < std::chrono::seconds(latencyIntervalSec))
+        return;
+    last = now;
+    PrintStageLatency("* Stage Latency (last " + std::to_string(latencyIntervalSec) + "s)", ie.SnapshotStageLatency());
+}
 
 void SetRunModelMode(bool single, int targetFps)
 {
@@ -291,9 +330,11 @@ static float runBenchmarkByTime(int64_t& outLoops, dxrt::InferenceEngine& ie, vo
     });
 
     auto start = std::chrono::steady_clock::now();
+    auto lastSnapshot = start;
     for(;;) // no limit
     {
         ie.RunAsync(inputBuffer);
+        printStageSnapshotIfDue(ie, lastSnapshot);
 
         {
             std::unique_lock<std::mutex> lock(cb_mutex);
@@ -360,6 +401,7 @@ static float runAsyncTargetFPS(int64_t& outLoops, dxrt::InferenceEngine& ie, int
 
 
     auto start_clock = std::chrono::steady_clock::now();
+    auto lastSnapshot = start_clock;
     for(int64_t i = 0; ; ++i)
     {
 #ifdef TARGET_FPS_DEBUG
@@ -368,6 +410,7 @@ static float runAsyncTargetFPS(int64_t& outLoops, dxrt::InferenceEngine& ie, int
 
         (void)ie.RunAsync(inputBuffer, 0);
         run_count ++;
+        printStageSnapshotIfDue(ie, lastSnapshot);
 
 #ifdef TARGET_FPS_DEBUG
         auto elapsed = std::chrono::steady_clock::now() - loopStartTime;
@@ -477,6 +520,7 @@ int main(int argc, char *argv[])
         ("use-ort", "Enable ONNX Runtime for CPU tasks in the model graph\nIf disabled, only NPU tasks operate", cxxopts::value<bool>(use_ort)->default_value("false"))
 #endif
         ("profiler", "Enable profiler", cxxopts::value<bool>(profiler_enable)->default_value("false"))
+        ("latency-interval", "Print per-stage latency percentiles every N seconds while running\n(time-based benchmark and target-fps mode)", cxxopts::value<int64_t>(latencyIntervalSec)->default_value("0"))
         ("buffer-count", "Number of input/output buffers, count's range is 1~" + std::to_string(DXRT_TASK_MAX_LOAD_LIMIT), cxxopts::value<int>(buffer_count)->default_value(std::to_string(DXRT_TASK_MAX_LOAD_VALUE)))
         ("h, help", "Print usage" );
 
@@ -797,6 +841,8 @@ int main(int argc, char *argv[])
 
                 float fps = runAsyncTargetFPS(loops, ie, targetFps, inputBuf.data(), duration);
                 PrintInfResult(inputFile, outputFile, modelFile, ie.GetLatencyMean()/1000.0, ie.GetNpuInferenceTimeMean()/1000.0, fps, loops, mode, verbose);
+                if (verbose || latencyIntervalSec > 0)
+                    PrintStageLatency("* Stage Latency (" + std::to_string(loops) + " inputs)", getAllStageLatency(ie));
                 break;
             }
             case BENCHMARK_MODE: {
@@ -816,6 +862,8 @@ int main(int argc, char *argv[])
                     }
                 }
                 PrintInfResult(inputFile, outputFile, modelFile, ie.GetLatencyMean()/1000., ie.GetNpuInferenceTimeMean()/1000., fps, loops, mode, verbose);
+                if (verbose || latencyIntervalSec > 0)
+                    PrintStageLatency("* Stage Latency (" + std::to_string(loops) + " inputs)", getAllStageLatency(ie));
 
                 break;
             }
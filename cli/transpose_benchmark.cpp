@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ *
+ * This file uses cxxopts (MIT License) - Copyright (c) 2014 Jarryd Beck.
+ */
+
+// Cost of the NPU format handler transposes on the shapes models actually use. With -m, the
+// shapes are taken from the rmap info of a .dxnn file: every input with CHANNEL_FIRST_TO_LAST
+// and every output with CHANNEL_LAST_TO_FIRST, as EncodeInputs / DecodeOutputs transpose them;
+// otherwise a list of common detector and classifier shapes is used. The blocked out-of-place
+// transpose and the in-place transpose are both compared with an element-by-element loop, the
+// handler's previous implementation, and must produce identical bytes. No device is needed.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "dxrt/extern/cxxopts.hpp"
+#include "dxrt/model.h"
+#include "dxrt/npu_format_handler.h"
+#include "dxrt/npu_format_kernels.h"
+#include "dxrt/util.h"
+
+#define APP_NAME "DXRT " DXRT_VERSION " transpose_benchmark"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using npu_format_handler::NpuFormatHandler;
+
+struct Shape
+{
+    int row;
+    int col;
+    int elem;
+    string source;
+
+    bool operator<(const Shape& other) const
+    {
+        return std::tie(row, col, elem) < std::tie(other.row, other.col, other.elem);
+    }
+};
+
+// (row x col) matrices of the tensors EncodeInputs / DecodeOutputs transpose
+static vector<Shape> modelShapes(const string& path)
+{
+    dxrt::ModelDataBase model;
+    dxrt::LoadModelParam(model, path);
+
+    std::set<Shape> unique;
+    for (auto& info : model.deepx_rmap.rmap_info())
+    {
+        auto add = [&](deepx_rmapinfo::TensorInfo& tensor, bool input) {
+            const auto& shape = tensor.shape_encoded();
+            if (shape.empty()) return;
+            int last = static_cast<int>(shape.back());
+            int rest = 1;
+            for (size_t j = 0; j + 1 < shape.size(); j++) rest *= static_cast<int>(shape[j]);
+            int elem = dxrt::GetDataSize_rmapinfo_datatype(static_cast<deepx_rmapinfo::DataType>(tensor.dtype_encoded()));
+            // inputs go from (C x rest) to (rest x C), outputs from (rest x C) back to (C x rest)
+            Shape s = input ? Shape{last, rest, elem, info.name() + ":" + tensor.name()}
+                            : Shape{rest, last, elem, info.name() + ":" + tensor.name()};
+            unique.insert(s);
+        };
+        for (auto& tensor : info.inputs())
+            if (tensor.transpose() == deepx_rmapinfo::Transpose::CHANNEL_FIRST_TO_LAST) add(tensor, true);
+        for (auto& tensor : info.outputs())
+            if (tensor.transpose() == deepx_rmapinfo::Transpose::CHANNEL_LAST_TO_FIRST) add(tensor, false);
+    }
+    return vector<Shape>(unique.begin(), unique.end());
+}
+
+// "ROWxCOLxELEM,..."
+static vector<Shape> parseShapes(const string& text)
+{
+    vector<Shape> shapes;
+    std::stringstream ss(text);
+    string item;
+    while (std::getline(ss, item, ','))
+    {
+        Shape s{0, 0, 0, "list"};
+        if (sscanf(item.c_str(), "%dx%dx%d", &s.row, &s.col, &s.elem) != 3 ||
+            s.row <= 0 || s.col <= 0 || s.elem <= 0)
+        {
+            return {};
+        }
+        shapes.push_back(s);
+    }
+    return shapes;
+}
+
+static void naiveTranspose(const uint8_t* src, uint8_t* dst, size_t row, size_t col, size_t elem)
+{
+    for (size_t i = 0; i < row; i++)
+        for (size_t j = 0; j < col; j++)
+            memcpy(dst + (j * row + i) * elem, src + (i * col + j) * elem, elem);
+}
+
+template <typename F>
+static double timeLoops(F fn, int loops)
+{
+    fn();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; i++) fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / loops;
+}
+
+int main(int argc, char* argv[])
+{
+    string modelPath;
+    // RGB inputs of 224/320/640 models, YOLO heads (85 and 255 channels), a segmentation map
+    string shapeList = "3x50176x1,3x102400x1,3x409600x1,85x8400x4,8400x85x4,255x1600x1,1600x255x1,"
+                       "19x65536x4,64x6400x2";
+    int loops = 20;
+
+    cxxopts::Options options("transpose_benchmark", APP_NAME);
+    options.add_options()
+        ("m, model", "take the shapes from the rmap info of this model", cxxopts::value<string>(modelPath))
+        ("s, shapes", "ROWxCOLxELEM shapes, comma separated", cxxopts::value<string>(shapeList)->default_value(shapeList))
+        ("l, loops", "timed calls per shape", cxxopts::value<int>(loops)->default_value("20"))
+        ("h, help", "print usage");
+    auto cmd = options.parse(argc, argv);
+    if (cmd.count("help"))
+    {
+        cout << options.help() << endl;
+        return 0;
+    }
+
+    vector<Shape> shapes;
+    if (!modelPath.empty())
+    {
+        try
+        {
+            shapes = modelShapes(modelPath);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "cannot load " << modelPath << ": " << e.what() << endl;
+            return -1;
+        }
+        if (shapes.empty())
+        {
+            cout << modelPath << " has no transposed input or output" << endl;
+            return 0;
+        }
+    }
+    else
+    {
+        shapes = parseShapes(shapeList);
+    }
+    if (shapes.empty() || loops <= 0)
+    {
+        cout << options.help() << endl;
+        return -1;
+    }
+
+    cout << APP_NAME << endl;
+    cout << "loops=" << loops << ", kernel="
+         << npu_format_handler::kernels::isa_name(npu_format_handler::kernels::active_isa()) << endl;
+    printf("%-8s %-8s %4s %10s %12s %12s %12s %9s %9s %6s  %s\n", "row", "col", "elem", "bytes",
+        "naive ms", "blocked ms", "inplace ms", "blocked x", "inplace x", "match", "tensor");
+
+    std::mt19937 rng(1);
+    int mismatches = 0;
+    for (const auto& s : shapes)
+    {
+        const size_t bytes = static_cast<size_t>(s.row) * s.col * s.elem;
+        vector<uint8_t> src(bytes);
+        for (auto& b : src) b = static_cast<uint8_t>(rng());
+        vector<uint8_t> expected(bytes), blocked(bytes), inplace(bytes);
+
+        double naiveSec = timeLoops([&] { naiveTranspose(src.data(), expected.data(), s.row, s.col, s.elem); }, loops);
+        double blockedSec = timeLoops([&] {
+            NpuFormatHandler::bidirectional_transpose(src.data(), blocked.data(), s.row, s.col, s.elem);
+        }, loops);
+        // every call starts from the source again, the copy is timed separately and taken off
+        double copySec = timeLoops([&] { memcpy(inplace.data(), src.data(), bytes); }, loops);
+        double inplaceSec = timeLoops([&] {
+            memcpy(inplace.data(), src.data(), bytes);
+            NpuFormatHandler::bidirectional_transpose_inplace(inplace.data(), s.row, s.col, s.elem);
+        }, loops) - copySec;
+
+        bool match = expected == blocked && expected == inplace;
+        if (!match) mismatches++;
+        printf("%-8d %-8d %4d %10zu %12.3f %12.3f %12.3f %9.2f %9.2f %6s  %s\n", s.row, s.col, s.elem, bytes,
+            naiveSec * 1e3, blockedSec * 1e3, inplaceSec * 1e3, naiveSec / blockedSec,
+            inplaceSec > 0 ? naiveSec / inplaceSec : 0.0, match ? "yes" : "NO", s.source.c_str());
+    }
+
+    if (mismatches > 0)
+    {
+        std::cerr << mismatches << " shape(s) differ from the element-by-element transpose" << endl;
+        return -1;
+    }
+    return 0;
+}
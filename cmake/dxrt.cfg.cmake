@@ -8,6 +8,7 @@ else()
 	option(USE_SHARED_DXRT_LIB "Build for DXRT Shared Library" ON)
 endif()
 option(USE_DXRT_TEST "Use DXRT Unit Test" ON)
+option(DXRT_BUILD_BENCHMARKS "Build the cli benchmarks and checks (not installed)" OFF)
 
 option(USE_ORT "Use ONNX Runtime" ON)
 option(USE_PYTHON "Use Python" ON)
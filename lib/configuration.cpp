@@ -17,6 +17,7 @@
 #include "dxrt/device_info_status.h"
 #include "dxrt/device_pool.h"
 #include "dxrt/device_version.h"
+#include "dxrt/thread_affinity.h"
 #include "./resource/log_messages.h"
 #include <memory>
 #include <iostream>
@@ -594,4 +595,144 @@ int GetNfhOutputWorkerThreads() {
     return cached_value;
 }
 
+ModelVerifyMode GetModelVerifyMode() {
+    static const ModelVerifyMode cached_value = [] {
+        const char* env_value = std::getenv("DXRT_MODEL_VERIFY");
+        if (env_value == nullptr) return ModelVerifyMode::FULL;
+        std::string mode = toLower(env_value);
+        ModelVerifyMode value = ModelVerifyMode::FULL;
+        if (mode == "off" || mode == "0") value = ModelVerifyMode::OFF;
+        else if (mode == "sampled") value = ModelVerifyMode::SAMPLED;
+        else if (mode != "full")
+        {
+            std::cout << "[DXRT] Invalid DXRT_MODEL_VERIFY value, using default=full" << std::endl;
+            return value;
+        }
+        std::cout << "[DXRT] Using DXRT_MODEL_VERIFY=" << mode << " from environment" << std::endl;
+        return value;
+    }();
+    return cached_value;
+}
+
+bool GetIpcSharedRing() {
+    static const bool cached_value = [] {
+        const char* env_value = std::getenv("DXRT_IPC_TYPE");
+        if (env_value == nullptr) return false;
+        std::string type = toLower(env_value);
+        if (type == "shm" || type == "ring") return true;
+        if (type != "mq")
+        {
+            std::cout << "[DXRT] Invalid DXRT_IPC_TYPE value, using default=mq" << std::endl;
+        }
+        return false;
+    }();
+    return cached_value;
+}
+
+#define DXRT_CPU_MICRO_BATCH_DEFAULT 1
+
+int GetCpuMicroBatchSize() {
+    static const int cached_value = [] {
+        // Default: off, a batched run changes the shapes ONNX Runtime sees, so models opt in
+        const char* env_value = std::getenv("DXRT_CPU_MICRO_BATCH");
+        if (env_value == nullptr) return DXRT_CPU_MICRO_BATCH_DEFAULT;
+        int value = std::atoi(env_value);
+        if (value < 1 || value > 64)
+        {
+            std::cout << "[DXRT] Invalid DXRT_CPU_MICRO_BATCH value, using default=" << DXRT_CPU_MICRO_BATCH_DEFAULT << std::endl;
+            return DXRT_CPU_MICRO_BATCH_DEFAULT;
+        }
+        std::cout << "[DXRT] Using DXRT_CPU_MICRO_BATCH=" << value << " from environment" << std::endl;
+        return value;
+    }();
+    return cached_value;
+}
+
+int GetCpuMicroBatchWaitUs() {
+    static const int cached_value = [] {
+        // Default: only requests that are already queued are merged, no latency is added
+        const char* env_value = std::getenv("DXRT_CPU_MICRO_BATCH_WAIT_US");
+        if (env_value == nullptr) return 0;
+        int value = std::atoi(env_value);
+        if (value < 0 || value > 100000)
+        {
+            std::cout << "[DXRT] Invalid DXRT_CPU_MICRO_BATCH_WAIT_US value, using default=0" << std::endl;
+            return 0;
+        }
+        std::cout << "[DXRT] Using DXRT_CPU_MICRO_BATCH_WAIT_US=" << value << " from environment" << std::endl;
+        return value;
+    }();
+    return cached_value;
+}
+
+ThreadAffinityMode GetThreadAffinityMode() {
+    static const ThreadAffinityMode cached_value = [] {
+        const char* env_value = std::getenv("DXRT_THREAD_AFFINITY");
+        if (env_value == nullptr) return ThreadAffinityMode::OFF;
+        std::string mode = toLower(env_value);
+        if (mode == "numa") {
+            std::cout << "[DXRT] Using DXRT_THREAD_AFFINITY=" << mode << " from environment" << std::endl;
+            return ThreadAffinityMode::NUMA;
+        }
+        if (mode != "off" && mode != "0")
+        {
+            std::cout << "[DXRT] Invalid DXRT_THREAD_AFFINITY value, using default=off" << std::endl;
+        }
+        return ThreadAffinityMode::OFF;
+    }();
+    return cached_value;
+}
+
+static std::vector<int> getCpuListEnv(const char* name)
+{
+    const char* env_value = std::getenv(name);
+    if (env_value == nullptr || env_value[0] == '\0') return {};
+    std::vector<int> cpus = ParseCpuList(env_value);
+    if (cpus.empty())
+    {
+        std::cout << "[DXRT] Invalid " << name << " value, threads are not pinned" << std::endl;
+        return cpus;
+    }
+    std::cout << "[DXRT] Using " << name << "=" << env_value << " from environment" << std::endl;
+    return cpus;
+}
+
+const std::vector<int>& GetDeviceIoCpus() {
+    static const std::vector<int> cached_value = getCpuListEnv("DXRT_DEVICE_IO_CPUS");
+    return cached_value;
+}
+
+const std::vector<int>& GetNfhCpus() {
+    static const std::vector<int> cached_value = getCpuListEnv("DXRT_NFH_CPUS");
+    return cached_value;
+}
+
+const std::vector<int>& GetCpuTaskCpus() {
+    static const std::vector<int> cached_value = getCpuListEnv("DXRT_CPU_TASK_CPUS");
+    return cached_value;
+}
+
+int GetNfhParallelWorkerThreads() {
+    static int cached_value = -1;
+    if (cached_value == -1) {
+        // Default: leave one core to the NFH queue threads that also take part in the work
+        unsigned int cores = std::thread::hardware_concurrency();
+        int default_value = cores > 1 ? static_cast<int>(std::min(cores - 1, 4u)) : 0;
+        const char* env_value = std::getenv("NFH_PARALLEL_WORKER_THREADS");
+        if (env_value != nullptr) {
+            int env_int = std::atoi(env_value);
+            if (env_int >= 0 && env_int <= 32) {
+                cached_value = env_int;
+                std::cout << "[DXRT] Using NFH_PARALLEL_WORKER_THREADS=" << cached_value << " from environment" << std::endl;
+            } else {
+                cached_value = default_value;
+                std::cout << "[DXRT] Invalid NFH_PARALLEL_WORKER_THREADS value, using default=" << cached_value << std::endl;
+            }
+        } else {
+            cached_value = default_value;
+        }
+    }
+    return cached_value;
+}
+
 }  // namespace dxrt
@@ -12,6 +12,7 @@
 #include "dxrt/cpu_handle.h"
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <exception>
 #include <limits>
 #include <numeric>
@@ -43,6 +44,7 @@
 #include "dxrt/request.h"
 #include "dxrt/exception/exception.h"
 #include "dxrt/configuration.h"
+#include "dxrt/thread_affinity.h"
 #include "./resource/log_messages.h"
 
 #ifdef USE_ORT
@@ -149,6 +151,21 @@ std::pair<int, int> verson_parse(const string& str)
     return std::make_pair(major, minor);
 }
 
+// name of a symbolic leading dimension followed by fixed ones, e.g. "batch" of [batch, 80, 80, 3];
+// empty when the shape has none or the dimension is unnamed
+static string batchDimensionName(const Ort::ConstTensorTypeAndShapeInfo& info)
+{
+    std::vector<int64_t> shape = info.GetShape();
+    if (shape.empty() || shape[0] > 0 ||
+        !std::all_of(shape.begin() + 1, shape.end(), [](int64_t dim) { return dim > 0; }))
+    {
+        return "";
+    }
+    std::vector<const char*> names(shape.size(), nullptr);
+    info.GetSymbolicDimensions(names.data(), names.size());
+    return names[0] != nullptr ? names[0] : "";
+}
+
 bool version_check()
 {
     std::pair<int, int> ver = verson_parse(Ort::GetVersionString());
@@ -157,7 +174,7 @@ bool version_check()
 }
 
 
-CpuHandle::CpuHandle(void* data_, int64_t size_, string name_, size_t device_num_, int buffer_count_)
+CpuHandle::CpuHandle(const void* data_, int64_t size_, string name_, size_t device_num_, int buffer_count_)
 : _name(name_), _device_num(device_num_), _bufferCount(buffer_count_)
 {
     if (version_check() == false)
@@ -206,7 +223,12 @@ CpuHandle::CpuHandle(void* data_, int64_t size_, string name_, size_t device_num
     }
 
     // DataDumpBin("tmp.onnx", data_, size_);
-    _session = std::make_shared<Ort::Session>(_env, data_, size_, _sessionOptions);
+    {
+        // the session's thread pool is started here and inherits the cores of the CPU task workers
+        ScopedThreadPlacement placement(GetThreadPlacementCpus(ThreadRole::CPU_TASK));
+        _session = std::make_shared<Ort::Session>(_env, data_, size_, _sessionOptions);
+    }
+    _memoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
     Ort::AllocatorWithDefaultOptions allocator;
     // Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
     _numInputs = _session->GetInputCount();
@@ -240,6 +262,19 @@ CpuHandle::CpuHandle(void* data_, int64_t size_, string name_, size_t device_num
         _outputNames.push_back(move(string(_session->GetOutputNameAllocated(i, allocator).get())) );
         _outputNamesChar.push_back(_outputNames[i].c_str());
     }
+    // With DXRT_CPU_MICRO_BATCH above 1, a leading dimension with the same symbolic name on every
+    // input and output is the batch dimension: a request runs with batch 1 and the worker may merge
+    // queued requests into one run. Leading dimensions named apart need not mean the same thing.
+    bool batchable = GetCpuMicroBatchSize() > 1 && _numInputs > 0;
+    string batchName;
+    for (int i = 0; i < _numInputs + _numOutputs && batchable; i++)
+    {
+        Ort::TypeInfo typeInfo = i < _numInputs ? _session->GetInputTypeInfo(i) : _session->GetOutputTypeInfo(i - _numInputs);
+        string name = batchDimensionName(typeInfo.GetTensorTypeAndShapeInfo());
+        batchable = !name.empty() && (i == 0 || name == batchName);
+        batchName = name;
+    }
+
     for (int i = 0; i < _numInputs; i++)
     {
         Ort::TypeInfo typeInfo = _session->GetInputTypeInfo(i);
@@ -247,6 +282,10 @@ CpuHandle::CpuHandle(void* data_, int64_t size_, string name_, size_t device_num
         auto dataType = tensorInfo.GetElementType();
         _inputDataTypes.push_back(convertDataType(dataType));
         _inputShapes.push_back(tensorInfo.GetShape());
+        if (batchable)
+        {
+            _inputShapes.back()[0] = 1;
+        }
         auto size = dxrt::vectorProduct(_inputShapes.back()) * convertElementSize(dataType);
         _inputSize += size;
         _inputSizes.push_back(size);
@@ -262,6 +301,10 @@ CpuHandle::CpuHandle(void* data_, int64_t size_, string name_, size_t device_num
         auto dataType = tensorInfo.GetElementType();
         _outputDataTypes.push_back(convertDataType(dataType));
         _outputShapes.push_back(tensorInfo.GetShape());
+        if (batchable)
+        {
+            _outputShapes.back()[0] = 1;
+        }
 
         // Check if this output has dynamic shape
         bool isDynamic = DetectDynamicShape(_outputShapes.back());
@@ -291,6 +334,12 @@ CpuHandle::CpuHandle(void* data_, int64_t size_, string name_, size_t device_num
     if (_hasDynamicOutput) {
         LOG_DXRT_DBG << "Task " << name_ << " contains dynamic shape outputs" << std::endl;
     }
+    if (batchable) {
+        _maxBatch = GetCpuMicroBatchSize();
+        _batchWaitUs = GetCpuMicroBatchWaitUs();
+        LOG_DXRT_DBG << "Task " << name_ << " has batch dimension " << batchName << ", up to " << _maxBatch
+                     << " requests per run (wait " << _batchWaitUs << "us)" << std::endl;
+    }
     // To be replaced by a modeling method in the future
     if (_dynamicCpuThread) {
         if (size_ <= 64 * 1024) {
@@ -350,14 +399,12 @@ void CpuHandle::Run(RequestPtr req)
     RunWithSession(req, _session);
 }
 
-void CpuHandle::RunWithSession(RequestPtr req, std::shared_ptr<Ort::Session> session)
+void CpuHandle::RunWithSession(RequestPtr req, std::shared_ptr<Ort::Session> session, CpuIoBindingCache* cache)
 {
 #ifdef USE_PROFILER
     auto& profiler = dxrt::Profiler::GetInstance();
-    string processedPU = req->processed_pu();
-    int processedId = req->processed_id();
-    string profileInstanceName = processedPU + "[Job_" + std::to_string(req->job_id()) + "][" + req->task()->name() + "][Req_" + std::to_string(req->id()) + "]_t" + std::to_string(processedId);
-    profiler.Start(profileInstanceName);
+    dxrt::ProfilerClock::time_point profileStart;
+    if (profiler.IsEnabled()) profileStart = dxrt::ProfilerClock::now();
 #endif
 
     LOG_DXRT_DBG << "CpuHandleRun:" << req->id() << std::endl;
@@ -368,61 +415,27 @@ void CpuHandle::RunWithSession(RequestPtr req, std::shared_ptr<Ort::Session> ses
     // Otherwise, build tensors from task-local offsets based on output_buffer_base.
     if (req->outputs().empty())
     {
-        // req->getData()->output_buffer_base is the base address of continuous memory for this request
-        // task->outputs() applies task-local offsets to set data pointer for each tensor
-        req->setOutputs(task->outputs(req->getData()->output_buffer_base));
+        // req->getData()->output_buffer_base is the base address of continuous memory for this request;
+        // the task-local offsets set the data pointer of each tensor
+        TaskData* taskData = task->getData();
+        req->assignOutputs(taskData->_outputTensors, taskData->_outputOffsets, req->getData()->output_buffer_base);
     }
 
-    std::vector<Ort::Value> inputTensors, outputTensors;
-    Ort::MemoryInfo memoryInfo =
-        Ort::MemoryInfo::CreateCpu(
-            OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-
     LOG_DXRT_DBG << task->id() << " - _numInputs : " << std::to_string(_numInputs) << std::endl;
 
-    // Create input tensors for ONNX Runtime
-    // Use the input tensors directly from the request - they already have correct pointers
-    auto reqInputs = req->inputs();
-    if (!reqInputs.empty() && reqInputs.size() >= static_cast<size_t>(_numInputs))
-    {
-        for (int i = 0; i < _numInputs; i++)
-        {
-            auto& inputTensor = reqInputs[i];
-
-            LOG_DXRT_DBG << "CpuHandle Input[" << i << "]: " << _inputNames[i]
-                        << ", data_ptr: " << inputTensor.data()
-                        << ", size: " << _inputSizes[i] << std::endl;
-            LOG_DXRT_DBG << "_inputShape[" << i << "]: " << _inputShapes[i] << std::endl;
-
-            inputTensors.emplace_back(
-                Ort::Value::CreateTensor(
-                    memoryInfo,
-                    inputTensor.data(),          // Use tensor's data pointer directly
-                    _inputSizes[i],              // Use ONNX Runtime's tensor size
-                    _inputShapes[i].data(),
-                    _inputShapes[i].size(),
-                    convertONNXTensorElementDataType(_inputDataTypes[i])
-                )
-            );
-        }
-    }
-    else
+    // Bindings persist per worker thread and output buffer slot; only changed pointers are rebound.
+    // Static outputs are pre-bound to the request buffers, dynamic outputs are allocated by ORT.
+    CpuIoBindingCache localCache;
+    if (cache == nullptr)
     {
-        std::string err_msg = LogMessages::CPUHandle_NoInputTensorsAvailable(task->name(), reqInputs.size(), _numInputs);
-        throw InvalidOperationException(EXCEPTION_MESSAGE(err_msg));
-    }
-
-    // Create output tensors for ONNX Runtime using IO Binding
-    // This supports mixed static/dynamic outputs without size mismatch
-    Ort::IoBinding binding(*session);
-
-    // Bind inputs
-    for (int i = 0; i < _numInputs; ++i) {
-        binding.BindInput(_inputNames[i].c_str(), inputTensors[i]);
+        cache = &localCache;
     }
-
-    // Bind outputs: static pre-bind, dynamic let ORT allocate
-    SetupOutputsWithBinding(req, binding);
+    auto reqOutputs = req->outputs();
+    const void* outputBase = reqOutputs.empty() ? nullptr : reqOutputs.front().data();
+    CpuIoBindingSlot& slot = GetBindingSlot(*cache, *session, outputBase);
+    SetupInputsWithBinding(req, slot);
+    SetupOutputsWithBinding(req, reqOutputs, slot);
+    Ort::IoBinding& binding = slot.binding;
 
     LOG_DXRT_DBG << "session run start : " << req->id() << std::endl;
 
@@ -436,9 +449,90 @@ void CpuHandle::RunWithSession(RequestPtr req, std::shared_ptr<Ort::Session> ses
     LOG_DXRT_DBG << "session run end (IO binding mode) : " << req->id() << std::endl;
 
 #ifdef USE_PROFILER
-    profiler.End(profileInstanceName);
+    profiler.Record(dxrt::PROFILER_EVENT_CPU_TASK, profileStart, dxrt::ProfilerClock::now(),
+        dxrt::ProfilerArgs{req->job_id(), req->id(), req->processed_id(), req->taskData()->profiler_name_id()});
+#endif
+}
+void CpuHandle::RunBatchWithSession(const std::vector<RequestPtr>& reqs, std::shared_ptr<Ort::Session> session,
+    CpuIoBindingCache* cache)
+{
+#ifdef USE_PROFILER
+    auto& profiler = dxrt::Profiler::GetInstance();
+    dxrt::ProfilerClock::time_point profileStart;
+    if (profiler.IsEnabled()) profileStart = dxrt::ProfilerClock::now();
+#endif
+
+    LOG_DXRT_DBG << "CpuHandleRun: batch of " << reqs.size() << " from " << reqs.front()->id() << std::endl;
+    std::vector<std::vector<void*>> inputs(reqs.size());
+    std::vector<std::vector<void*>> outputs(reqs.size());
+    for (size_t r = 0; r < reqs.size(); r++)
+    {
+        auto& req = reqs[r];
+        if (req->outputs().empty())
+        {
+            TaskData* taskData = req->task()->getData();
+            req->assignOutputs(taskData->_outputTensors, taskData->_outputOffsets, req->getData()->output_buffer_base);
+        }
+        auto reqInputs = req->inputs();
+        if (reqInputs.size() < static_cast<size_t>(_numInputs))
+        {
+            std::string err_msg = LogMessages::CPUHandle_NoInputTensorsAvailable(req->task()->name(), reqInputs.size(), _numInputs);
+            throw InvalidOperationException(EXCEPTION_MESSAGE(err_msg));
+        }
+        auto reqOutputs = req->outputs();
+        if (reqOutputs.size() < static_cast<size_t>(_numOutputs))
+        {
+            std::string err_msg = LogMessages::CPUHandle_NoOutputTensorsAvailable(req->task()->name(), reqOutputs.size(), _numOutputs);
+            throw InvalidOperationException(EXCEPTION_MESSAGE(err_msg));
+        }
+        for (int i = 0; i < _numInputs; i++) inputs[r].push_back(reqInputs[i].data());
+        for (int i = 0; i < _numOutputs; i++) outputs[r].push_back(reqOutputs[i].data());
+    }
+
+    CpuIoBindingCache localCache;
+    RunBatchBuffers(*session, cache ? *cache : localCache, inputs, outputs);
+
+#ifdef USE_PROFILER
+    auto profileEnd = dxrt::ProfilerClock::now();
+    for (auto& req : reqs)
+    {
+        profiler.Record(dxrt::PROFILER_EVENT_CPU_TASK, profileStart, profileEnd,
+            dxrt::ProfilerArgs{req->job_id(), req->id(), req->processed_id(), req->taskData()->profiler_name_id()});
+    }
 #endif
 }
+
+void CpuHandle::RunBatchBuffers(Ort::Session& session, CpuIoBindingCache& cache,
+    const std::vector<std::vector<void*>>& inputs, const std::vector<std::vector<void*>>& outputs)
+{
+    int count = static_cast<int>(inputs.size());
+    if (count < 1 || count > _maxBatch || outputs.size() != inputs.size())
+    {
+        throw InvalidOperationException(EXCEPTION_MESSAGE("invalid CPU task batch of " + std::to_string(count)));
+    }
+    CpuIoBindingSlot& slot = GetBatchSlot(cache, session, count);
+
+    // gather along the batch dimension
+    for (int r = 0; r < count; r++)
+    {
+        for (int i = 0; i < _numInputs; i++)
+        {
+            std::memcpy(cache.inputStaging[i].data() + r * _inputSizes[i], inputs[r][i], _inputSizes[i]);
+        }
+    }
+
+    session.Run(Ort::RunOptions{nullptr}, slot.binding);
+
+    // scatter back to the batch 1 buffers of each request
+    for (int r = 0; r < count; r++)
+    {
+        for (int i = 0; i < _numOutputs; i++)
+        {
+            std::memcpy(outputs[r][i], cache.outputStaging[i].data() + r * _outputSizes[i], _outputSizes[i]);
+        }
+    }
+}
+
 void CpuHandle::Terminate()
 {
     _worker->Stop();
@@ -481,6 +575,7 @@ std::shared_ptr<Ort::Session> CpuHandle::CreateWorkerSession()
                  << ", total_cpu_tasks=" << totalActiveCpuTasks
                  << ", system_cores=" << systemCores << std::endl;
     */
+    ScopedThreadPlacement placement(GetThreadPlacementCpus(ThreadRole::CPU_TASK));
     return std::make_shared<Ort::Session>(_env, _modelData.data(), _modelSize, workerSessionOptions);
 }
 
@@ -491,31 +586,140 @@ bool CpuHandle::DetectDynamicShape(const std::vector<int64_t>& shape) const
 }
 
 
-void CpuHandle::SetupOutputsWithBinding(RequestPtr req, Ort::IoBinding& binding)
+CpuIoBindingSlot& CpuHandle::GetBindingSlot(CpuIoBindingCache& cache, Ort::Session& session, const void* outputBase)
 {
-    auto reqOutputs = req->outputs();
-    Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(
-        OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    if (cache.session != &session)
+    {
+        cache.slots.clear();
+        cache.batchSlots.clear();
+        cache.session = &session;
+    }
+    auto it = cache.slots.find(outputBase);
+    if (it != cache.slots.end())
+    {
+        return *it->second;
+    }
+
+    std::unique_ptr<CpuIoBindingSlot> slot;
+    if (cache.slots.size() >= static_cast<size_t>(std::max(_bufferCount, 1)))
+    {
+        // outputs outside the task buffers (e.g. user output buffers): reuse a binding, its outputs get rebound
+        slot = std::move(cache.slots.begin()->second);
+        cache.slots.erase(cache.slots.begin());
+    }
+    else
+    {
+        slot.reset(new CpuIoBindingSlot(session));
+        slot->inputPtrs.assign(_numInputs, nullptr);
+        slot->outputPtrs.assign(_numOutputs, nullptr);
+        for (int i = 0; i < _numInputs; ++i) slot->inputValues.emplace_back(nullptr);
+        for (int i = 0; i < _numOutputs; ++i) slot->outputValues.emplace_back(nullptr);
+        LOG_DXRT_DBG << "CpuHandle new binding slot " << cache.slots.size() << " for " << outputBase << std::endl;
+    }
+    CpuIoBindingSlot& ref = *slot;
+    cache.slots.emplace(outputBase, std::move(slot));
+    return ref;
+}
 
+CpuIoBindingSlot& CpuHandle::GetBatchSlot(CpuIoBindingCache& cache, Ort::Session& session, int count)
+{
+    if (cache.session != &session)
+    {
+        cache.slots.clear();
+        cache.batchSlots.clear();
+        cache.session = &session;
+    }
+    auto& slot = cache.batchSlots[count];
+    if (slot)
+    {
+        return *slot;
+    }
+
+    // staging is sized for the largest batch once, so the values of every batch size stay valid
+    if (cache.inputStaging.empty())
+    {
+        for (int i = 0; i < _numInputs; i++) cache.inputStaging.emplace_back(_inputSizes[i] * _maxBatch);
+        for (int i = 0; i < _numOutputs; i++) cache.outputStaging.emplace_back(_outputSizes[i] * _maxBatch);
+    }
+    slot.reset(new CpuIoBindingSlot(session));
+    for (int i = 0; i < _numInputs; i++)
+    {
+        std::vector<int64_t> shape = _inputShapes[i];
+        shape[0] = count;
+        slot->inputValues.emplace_back(Ort::Value::CreateTensor(_memoryInfo, cache.inputStaging[i].data(),
+            _inputSizes[i] * count, shape.data(), shape.size(), convertONNXTensorElementDataType(_inputDataTypes[i])));
+        slot->binding.BindInput(_inputNames[i].c_str(), slot->inputValues.back());
+    }
+    for (int i = 0; i < _numOutputs; i++)
+    {
+        std::vector<int64_t> shape = _outputShapes[i];
+        shape[0] = count;
+        slot->outputValues.emplace_back(Ort::Value::CreateTensor(_memoryInfo, cache.outputStaging[i].data(),
+            _outputSizes[i] * count, shape.data(), shape.size(), convertONNXTensorElementDataType(_outputDataTypes[i])));
+        slot->binding.BindOutput(_outputNames[i].c_str(), slot->outputValues.back());
+    }
+    LOG_DXRT_DBG << "CpuHandle new binding for batch " << count << std::endl;
+    return *slot;
+}
+
+void CpuHandle::SetupInputsWithBinding(RequestPtr req, CpuIoBindingSlot& slot)
+{
+    // Use the input tensors directly from the request - they already have correct pointers
+    auto reqInputs = req->inputs();
+    if (reqInputs.empty() || reqInputs.size() < static_cast<size_t>(_numInputs))
+    {
+        std::string err_msg = LogMessages::CPUHandle_NoInputTensorsAvailable(req->task()->name(), reqInputs.size(), _numInputs);
+        throw InvalidOperationException(EXCEPTION_MESSAGE(err_msg));
+    }
+
+    for (int i = 0; i < _numInputs; i++)
+    {
+        void* data = reqInputs[i].data();
+        if (data == slot.inputPtrs[i])
+        {
+            continue;
+        }
+        LOG_DXRT_DBG << "CpuHandle Input[" << i << "]: " << _inputNames[i]
+                    << ", data_ptr: " << data
+                    << ", size: " << _inputSizes[i] << std::endl;
+        slot.inputValues[i] = Ort::Value::CreateTensor(
+            _memoryInfo,
+            data,                        // Use tensor's data pointer directly
+            _inputSizes[i],              // Use ONNX Runtime's tensor size
+            _inputShapes[i].data(),
+            _inputShapes[i].size(),
+            convertONNXTensorElementDataType(_inputDataTypes[i]));
+        slot.binding.BindInput(_inputNames[i].c_str(), slot.inputValues[i]);
+        slot.inputPtrs[i] = data;
+    }
+}
+
+void CpuHandle::SetupOutputsWithBinding(RequestPtr req, Tensors& reqOutputs, CpuIoBindingSlot& slot)
+{
     for (int i = 0; i < _numOutputs; ++i) {
         if (_outputIsDynamic[i]) {
-            // Dynamic output: let ORT allocate using default memory info
-            binding.BindOutput(_outputNames[i].c_str(), memoryInfo);
+            // Dynamic output: let ORT allocate using default memory info, rebound every run so
+            // the value of the previous run is not reused with a stale shape
+            slot.binding.BindOutput(_outputNames[i].c_str(), _memoryInfo);
             LOG_DXRT_DBG << "CpuHandle Dynamic Output[" << i << "]: " << _outputNames[i]
                         << " - ORT will allocate with memory info" << std::endl;
         } else {
             // Static output: pre-bind to existing buffer
             if (i < static_cast<int>(reqOutputs.size())) {
-                auto& outputTensor = reqOutputs[i];
-                Ort::Value ortValue = Ort::Value::CreateTensor(
-                    memoryInfo,
-                    outputTensor.data(),
+                void* data = reqOutputs[i].data();
+                if (data == slot.outputPtrs[i]) {
+                    continue;
+                }
+                slot.outputValues[i] = Ort::Value::CreateTensor(
+                    _memoryInfo,
+                    data,
                     _outputSizes[i],
                     _outputShapes[i].data(),
                     _outputShapes[i].size(),
                     convertONNXTensorElementDataType(_outputDataTypes[i])
                 );
-                binding.BindOutput(_outputNames[i].c_str(), ortValue);
+                slot.binding.BindOutput(_outputNames[i].c_str(), slot.outputValues[i]);
+                slot.outputPtrs[i] = data;
                 LOG_DXRT_DBG << "CpuHandle Static Output[" << i << "]: " << _outputNames[i]
                             << " - pre-bound to buffer" << std::endl;
             } else {
@@ -554,7 +758,7 @@ void CpuHandle::UpdateRequestOutputsFromBinding(RequestPtr req, std::vector<Ort:
 #endif
 
 #else
-CpuHandle::CpuHandle(void* data_, int64_t size_, std::string name_, size_t device_num_, int buffer_count_)
+CpuHandle::CpuHandle(const void* data_, int64_t size_, std::string name_, size_t device_num_, int buffer_count_)
 : _name(name_), _device_num(device_num_), _bufferCount(buffer_count_)
 {
     std::ignore = size_;
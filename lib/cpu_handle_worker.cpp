@@ -23,6 +23,7 @@
 #include "dxrt/device.h"
 #include "dxrt/exception/exception.h"
 #include "dxrt/request_response_class.h"
+#include "dxrt/thread_affinity.h"
 
 #define MIN_EACH_CPU_TASK_THREADS 1
 #define MAX_EACH_CPU_TASK_THREADS 6
@@ -101,6 +102,7 @@ void CpuHandleWorker::ThreadWork(int id)
     size_t load;
     bool isDynamic = (static_cast<size_t>(id) >= _numThreads);
     LOG_DXRT_DBG << threadName << " : Entry ( dynamic : " << isDynamic <<")" << endl;
+    ApplyThreadPlacement(ThreadRole::CPU_TASK);
 
 #ifdef USE_ORT
     // Hybrid approach: Use shared session with worker-level synchronization
@@ -114,6 +116,8 @@ void CpuHandleWorker::ThreadWork(int id)
         //workerSession = _cpuHandle->CreateWorkerSession();
         LOG_DXRT_DBG << threadName << " : Using shared session in dynamic mode" << endl;
     }
+    // IoBindings of this thread, reused across requests on the same buffers
+    CpuIoBindingCache bindingCache;
 
 #endif
 
@@ -197,9 +201,15 @@ void CpuHandleWorker::ThreadWork(int id)
             req->set_processed_unit(getName(), 0, id);
             TASK_FLOW("["+to_string(req->job_id())+"] cpu worker "+to_string(id) +" wakeup, load: "+to_string(load));
             _queue.pop();
+            std::vector<std::shared_ptr<Request>> batch{req};
+            if (_cpuHandle->_maxBatch > 1)
+            {
+                collectBatch(lk, batch, id);
+            }
             if (DEBUG_DATA > 0)
             {
-                DataDumpBin(req->task()->name() + "_input.bin", req->inputs());
+                for (auto& r : batch)
+                    DataDumpBin(r->task()->name() + "_input.bin", r->inputs());
             }
             TASK_FLOW_START("["+to_string(req->job_id())+"]"+req->task()->name() +" thread "+to_string(id)+" run");
             lk.unlock();
@@ -210,37 +220,42 @@ void CpuHandleWorker::ThreadWork(int id)
             try
             {
 #ifdef USE_ORT
-                if (CpuHandle::_dynamicCpuThread && workerSession) {
-                    _cpuHandle->RunWithSession(req, workerSession);
+                auto session = (CpuHandle::_dynamicCpuThread && workerSession) ? workerSession : _cpuHandle->_session;
+                if (batch.size() > 1) {
+                    _cpuHandle->RunBatchWithSession(batch, session, &bindingCache);
                 } else {
-                    _cpuHandle->Run(req);
+                    _cpuHandle->RunWithSession(req, session, &bindingCache);
                 }
 #else
                 _cpuHandle->Run(req);
 #endif
                 TASK_FLOW_FINISH("["+to_string(req->job_id())+"]"+req->task()->name() +" thread "+to_string(id)+" run");
-                RequestResponse::ProcessResponse(req, response, -1);
+                for (auto& r : batch)
+                    RequestResponse::ProcessResponse(r, response, -1);
             }
             catch (const Exception &e)
             {
                 // print error message
                 LOG_DXRT_ERR(e.what());
                 TASK_FLOW_FINISH("["+to_string(req->job_id())+"]"+req->task()->name() +" thread "+to_string(id)+" run");
-                RequestResponse::ProcessResponse(req, response, -1);
+                for (auto& r : batch)
+                    RequestResponse::ProcessResponse(r, response, -1);
                 break;
             }
             catch (const std::exception &e)
             {
                 LOG_DXRT_ERR(std::string("std::exception: ") + e.what());
                 TASK_FLOW_FINISH("["+to_string(req->job_id())+"]"+req->task()->name() +" thread "+to_string(id)+" run");
-                RequestResponse::ProcessResponse(req, response, -1);
+                for (auto& r : batch)
+                    RequestResponse::ProcessResponse(r, response, -1);
                 break;
             }
             catch (...)
             {
                 LOG_DXRT_ERR("Unknown exception in CpuHandleWorker");
                 TASK_FLOW_FINISH("["+to_string(req->job_id())+"]"+req->task()->name() +" thread "+to_string(id)+" run");
-                RequestResponse::ProcessResponse(req, response, -1);
+                for (auto& r : batch)
+                    RequestResponse::ProcessResponse(r, response, -1);
                 break;
             }
 
@@ -254,6 +269,32 @@ void CpuHandleWorker::ThreadWork(int id)
     LOG_DXRT_DBG << threadName << " : End, loopCount" << loopCnt << endl;
 }
 
+// Takes the requests queued behind the first one of a batch, waiting up to the batch wait for more.
+// Called with _lock held.
+void CpuHandleWorker::collectBatch(std::unique_lock<std::mutex>& lk, std::vector<std::shared_ptr<Request>>& batch, int id)
+{
+    size_t maxBatch = static_cast<size_t>(_cpuHandle->_maxBatch);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(_cpuHandle->_batchWaitUs);
+    while (batch.size() < maxBatch)
+    {
+        if (_queue.empty())
+        {
+            if (_cpuHandle->_batchWaitUs <= 0 ||
+                !_cv.wait_until(lk, deadline, [this] { return !_queue.empty() || _stop.load(); }) ||
+                _stop.load())
+            {
+                break;
+            }
+            continue;
+        }
+        auto req = _queue.front();
+        _queue.pop();
+        req->set_processed_unit(getName(), 0, id);
+        batch.push_back(req);
+    }
+    LOG_DXRT_DBG << getName() << "_t" << id << " batch of " << batch.size() << endl;
+}
+
 int CpuHandleWorker::request(shared_ptr<Request> req)
 {
     if (_stop.load()) {
@@ -25,6 +25,8 @@
 #include "dxrt/util.h"
 #include "dxrt/datatype.h"
 #include "dxrt/runtime_event_dispatcher.h"
+#include "dxrt/latency_histogram.h"
+#include "dxrt/thread_affinity.h"
 #include "../resource/log_messages.h"
 
 #include <memory>
@@ -69,15 +71,27 @@ int AccDeviceTaskLayer::RegisterTask(TaskData* task)
     model.rmap.base = _core->info().mem_addr;
     model.weight.base = _core->info().mem_addr;
 
-    // Allocate model param regions (simple forward allocation)
-    model.weight.offset = _serviceLayer->BackwardAllocateForTask(id(), tId, model.weight.size);
-    model.rmap.offset = _serviceLayer->BackwardAllocateForTask(id(), tId, model.rmap.size);
-    if (model.rmap.offset > model.weight.offset)
+    // Model param regions are shared by every task (in any process) that loads identical rmap/weight
+    ModelMemoryKey modelKey = task->modelMemoryKey();
+    ModelMemoryRegion region = _serviceLayer->AcquireModelMemory(id(), tId, modelKey);
+    DXRT_ASSERT(region.state == ModelMemoryRegion::State::ALLOCATED || region.state == ModelMemoryRegion::State::RESIDENT,
+        "failed to allocate model parameter memory");
+    model.rmap.offset = static_cast<uint32_t>(region.rmapOffset);
+    model.weight.offset = static_cast<uint32_t>(region.weightOffset);
+    if (region.state == ModelMemoryRegion::State::RESIDENT && !modelKey.exact &&
+        (_core->Verify(model.rmap, ModelVerifyMode::FULL) != 0 || _core->Verify(model.weight, ModelVerifyMode::FULL) != 0))
     {
-        uint32_t temp_addr = model.rmap.offset;
-        model.rmap.offset = _serviceLayer->BackwardAllocateForTask(id(), tId, model.rmap.size);
-        _serviceLayer->DeAllocate(id(), temp_addr);
+        // A different model with the same sampled windows: load under the key of every byte.
+        // The reference to the other entry goes away with the task's model memory
+        LOG_DXRT_DBG << "Device " << id() << " task " << tId << " sampled model key matched other params" << std::endl;
+        modelKey = task->exactModelMemoryKey();
+        region = _serviceLayer->AcquireModelMemory(id(), tId, modelKey);
+        DXRT_ASSERT(region.state == ModelMemoryRegion::State::ALLOCATED || region.state == ModelMemoryRegion::State::RESIDENT,
+            "failed to allocate model parameter memory");
+        model.rmap.offset = static_cast<uint32_t>(region.rmapOffset);
+        model.weight.offset = static_cast<uint32_t>(region.weightOffset);
     }
+    const bool resident = (region.state == ModelMemoryRegion::State::RESIDENT);
 
     dxrt_request_acc_t inf{};
     memset(static_cast<void *>(&inf), 0x00, sizeof(dxrt_request_acc_t));
@@ -106,11 +120,19 @@ int AccDeviceTaskLayer::RegisterTask(TaskData* task)
         _npuInferenceAcc[tId] = inf;
     }
 
-    // Write model params
-    ret = _core->Write(model.rmap);
-    DXRT_ASSERT(ret == 0, "failed to write model rmap parameters" + std::to_string(ret));
-    ret = _core->Write(model.weight);
-    DXRT_ASSERT(ret == 0, "failed to write model weight parameters" + std::to_string(ret));
+    // Write model params, unless an identical model already put them on the device
+    if (resident)
+    {
+        LOG_DXRT_DBG << "Device " << id() << " task " << tId << " reuses resident model params at rmap 0x"
+                     << std::hex << model.rmap.offset << ", weight 0x" << model.weight.offset << std::dec << std::endl;
+    }
+    else
+    {
+        ret = _core->Write(model.rmap);
+        DXRT_ASSERT(ret == 0, "failed to write model rmap parameters" + std::to_string(ret));
+        ret = _core->Write(model.weight);
+        DXRT_ASSERT(ret == 0, "failed to write model weight parameters" + std::to_string(ret));
+    }
 
     // v8 PPCPU: Write PPU binary if exists
     if (task->_isPPCPU && task->_data && task->_data->size() >= 3) {
@@ -134,28 +156,20 @@ int AccDeviceTaskLayer::RegisterTask(TaskData* task)
         }
     }
 
-    // Verify (skip if size is 0)
+    // Verify (skip if size is 0); shared params are verified too
     {
         if (model.rmap.size > 0 && model.weight.size > 0) {
-            std::vector<std::vector<uint8_t>> readData;
-            readData.emplace_back(std::vector<uint8_t>(model.rmap.size));
-            readData.emplace_back(std::vector<uint8_t>(model.weight.size));
-            dxrt_meminfo_t cmd(model.rmap);
-            dxrt_meminfo_t weight(model.weight);
-            cmd.data = reinterpret_cast<uint64_t>(readData[0].data());
-            weight.data = reinterpret_cast<uint64_t>(readData[1].data());
-            if (cmd.size > 0 && _core->Read(cmd) == 0) {
-                ret += memcmp(reinterpret_cast<void*>(model.rmap.data), readData[0].data(), cmd.size);
-            }
-            if (weight.size > 0 && _core->Read(weight) == 0) {
-                ret += memcmp(reinterpret_cast<void*>(model.weight.data), readData[1].data(), weight.size);
-            }
+            const ModelVerifyMode verifyMode = GetModelVerifyMode();
+            ret += _core->Verify(model.rmap, verifyMode);
+            ret += _core->Verify(model.weight, verifyMode);
             DXRT_ASSERT(ret == 0, "failed to check data integrity of model parameters" + std::to_string(ret));
         } else {
             LOG_DXRT_DBG << "Device " << id() << " skipping verify (rmap.size=" << model.rmap.size
                          << ", weight.size=" << model.weight.size << ")" << std::endl;
         }
     }
+    if (!resident)
+        _serviceLayer->SignalModelMemoryReady(id(), modelKey);
 
     _inputTensorFormats[tId] = task->inputs(reinterpret_cast<void*>(inf.input.data));
     _outputTensorFormats[tId] = task->outputs(reinterpret_cast<void*>(inf.output.data));
@@ -192,10 +206,8 @@ int AccDeviceTaskLayer::Release(TaskData* task)
     int taskId = task->id();
 
 
-    dxrt_request_acc_t npu_inference_acc;
     {
         std::unique_lock<std::mutex> lock(_npuInferenceLock);
-        npu_inference_acc = _npuInferenceAcc[taskId];
         _npuInferenceAcc.erase(taskId);
         _npuModel.erase(taskId);
     }
@@ -204,8 +216,7 @@ int AccDeviceTaskLayer::Release(TaskData* task)
     {
         _npuMemoryCacheManager.unRegisterMemoryCache(taskId);
     }
-    _serviceLayer->DeAllocate(id(), npu_inference_acc.cmd_offset);
-    _serviceLayer->DeAllocate(id(), npu_inference_acc.weight_offset);
+    // The rmap/weight regions may be shared with other tasks; SignalTaskDeInit drops this task's reference
 
     return 0;
 }
@@ -225,7 +236,7 @@ int AccDeviceTaskLayer::InferenceRequestACC(RequestData* req, npu_bound_op bound
 
     void* reqInputPtr = nullptr;
     if (req->inputs.size() > 0)
-        reqInputPtr = req->encoded_inputs_ptr;
+        reqInputPtr = (req->dma_input_ptr != nullptr) ? req->dma_input_ptr : req->encoded_inputs_ptr;
 
     {
         SharedLock lock(_taskDataLock);
@@ -272,11 +283,10 @@ int AccDeviceTaskLayer::InferenceRequestACC(RequestData* req, npu_bound_op bound
         }
         npu_inference_acc.proc_id = getpid();
         npu_inference_acc.bound = boundOp;
-        {
-            ObjectsPool::GetInstance().GetRequestById(req->requestId)->setOutputs(
-                task->outputs(reinterpret_cast<void*>(npu_inference_acc.output.data)));
-        }
-        req->outputs = task->outputs(reinterpret_cast<void*>(req->output_buffer_base));
+        npu_inference_acc.sched_priority = req->sched_priority;
+        npu_inference_acc.deadline_us = req->deadline_us;
+        ObjectsPool::GetInstance().GetRequestById(req->requestId)->assignOutputs(
+            task->_outputTensors, task->_outputOffsets, req->output_buffer_base);
         {
             std::unique_lock<std::mutex> lock(_npuInferenceLock);
             _ongoingRequests[req->requestId] = npu_inference_acc;
@@ -317,7 +327,8 @@ int AccDeviceTaskLayer::InputHandler(const int& requestId, int ch)
     {
         TASK_FLOW("["+std::to_string(req->job_id())+"]"+req->taskData()->name()+" write input, load: "+std::to_string(load));
 #ifdef USE_PROFILER
-        profiler.Start("PCIe Write[Job_" + std::to_string(req->job_id()) + "][" + req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "](" + std::to_string(inferenceAcc.dma_ch)+")");
+        ProfilerClock::time_point writeStart;
+        if (profiler.IsEnabled()) writeStart = ProfilerClock::now();
 #endif
         int ret = core()->Write(inferenceAcc.input);
         if (ret < 0)
@@ -331,15 +342,17 @@ int AccDeviceTaskLayer::InputHandler(const int& requestId, int ch)
                 LogMessages::RuntimeDispatch_FailToWriteInput(ret, requestId, ch)
             );
         }
+        req->getData()->written_ns = LatencyClockNs();
 #ifdef USE_PROFILER
-        profiler.End("PCIe Write[Job_" + std::to_string(req->job_id()) + "][" + req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "](" + std::to_string(inferenceAcc.dma_ch)+")");
+        profiler.Record(PROFILER_EVENT_PCIE_WRITE, writeStart, ProfilerClock::now(),
+            ProfilerArgs{req->job_id(), req->id(), inferenceAcc.dma_ch, req->taskData()->profiler_name_id()});
 #endif
     }
 
     if (dxrt::DEBUG_DATA > 0)
     {
         DataDumpBin(req->taskData()->name() + "_encoder_input.bin", req->inputs());
-        DataDumpBin(req->taskData()->name() + "_input.bin", req->encoded_inputs_ptr(), req->taskData()->encoded_input_size());
+        DataDumpBin(req->taskData()->name() + "_input.bin", reinterpret_cast<void*>(inferenceAcc.input.data), req->taskData()->encoded_input_size());
     }
     TASK_FLOW("["+std::to_string(req->job_id())+"]"+req->taskData()->name()+" signal to service input");
 
@@ -367,12 +380,15 @@ int AccDeviceTaskLayer::OutputHandler(const dxrt_response_t& response, int ch)
         DXRT_ASSERT(false, "req is nullptr "+std::to_string(reqId));
     }
 
+    req->getData()->response_ns = LatencyClockNs();
     req->set_processed_unit("NPU_"+std::to_string(core()->id()), id(), response.dma_ch);
     dxrt_meminfo_t output = request_acc.output;
     if (SKIP_INFERENCE_IO != 1 || req->model_type() != 1)
     {
 #ifdef USE_PROFILER
         auto& profiler = Profiler::GetInstance();
+        const ProfilerArgs profile_args{req->job_id(), req->id(), static_cast<int32_t>(response.dma_ch),
+            req->taskData()->profiler_name_id()};
 
         // Record OutputHandler entry time (Framework Response Handling Delay)
         uint64_t output_handler_entry_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -380,6 +396,7 @@ int AccDeviceTaskLayer::OutputHandler(const dxrt_response_t& response, int ch)
 
         // Get response receive timestamp from OutputReceiverThread (before queueing)
         uint64_t response_recv_ns = 0;
+        if (profiler.IsEnabled())
         {
             std::lock_guard<std::mutex> lock(_responseTimestampLock);
             auto it = _responseReceiveTimestamps.find(reqId);
@@ -391,12 +408,9 @@ int AccDeviceTaskLayer::OutputHandler(const dxrt_response_t& response, int ch)
 
         // Measure Framework Response Handling Delay
         if (response_recv_ns > 0) {
-            auto queue_delay_tp = std::make_shared<TimePoint>();
-            queue_delay_tp->start = ProfilerClock::time_point(std::chrono::nanoseconds(response_recv_ns));
-            queue_delay_tp->end = ProfilerClock::time_point(std::chrono::nanoseconds(output_handler_entry_ns));
-            profiler.AddTimePoint("Framework Response Handling Delay[Job_" + std::to_string(req->job_id()) + "][" +
-                req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "]_" + std::to_string(response.dma_ch),
-                queue_delay_tp);
+            profiler.Record(PROFILER_EVENT_RESPONSE_DELAY,
+                ProfilerClock::time_point(std::chrono::nanoseconds(response_recv_ns)),
+                ProfilerClock::time_point(std::chrono::nanoseconds(output_handler_entry_ns)), profile_args);
         }
 
         // Calculate accurate NPU Core execution time using firmware timestamps
@@ -407,38 +421,34 @@ int AccDeviceTaskLayer::OutputHandler(const dxrt_response_t& response, int ch)
             if (wait_window - inf_time_ns > 1000000000ULL) {
                 uint64_t npu_start_ns = response.wait_end_time - inf_time_ns;
                 uint64_t npu_end_ns   = response.wait_end_time;
-                auto npu_tp = std::make_shared<TimePoint>();
-                npu_tp->start = ProfilerClock::time_point(std::chrono::nanoseconds(npu_start_ns));
-                npu_tp->end   = ProfilerClock::time_point(std::chrono::nanoseconds(npu_end_ns));
-                profiler.AddTimePoint("NPU Core[Job_" + std::to_string(req->job_id()) + "][" + req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "]_" + std::to_string(response.dma_ch), npu_tp);
+                profiler.Record(PROFILER_EVENT_NPU_CORE,
+                    ProfilerClock::time_point(std::chrono::nanoseconds(npu_start_ns)),
+                    ProfilerClock::time_point(std::chrono::nanoseconds(npu_end_ns)), profile_args);
             } else {
                 uint64_t center_ns = (response.wait_start_time + response.wait_end_time) / 2;
                 uint64_t npu_start_ns = center_ns - (inf_time_ns / 2);
                 uint64_t npu_end_ns   = center_ns + (inf_time_ns / 2);
-                auto npu_tp = std::make_shared<TimePoint>();
-                npu_tp->start = ProfilerClock::time_point(std::chrono::nanoseconds(npu_start_ns));
-                npu_tp->end   = ProfilerClock::time_point(std::chrono::nanoseconds(npu_end_ns));
-                profiler.AddTimePoint("NPU Core[Job_" + std::to_string(req->job_id()) + "][" + req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "]_" + std::to_string(response.dma_ch), npu_tp);
+                profiler.Record(PROFILER_EVENT_NPU_CORE,
+                    ProfilerClock::time_point(std::chrono::nanoseconds(npu_start_ns)),
+                    ProfilerClock::time_point(std::chrono::nanoseconds(npu_end_ns)), profile_args);
             }
         } else if (response_recv_ns > 0) { //case when service is off
             // Fallback: use response receive time to calculate NPU core time
             // This is more accurate than using OutputHandler entry time
             uint64_t inf_time_ns = static_cast<uint64_t>(response.inf_time) * 1000;
-            auto npu_tp = std::make_shared<TimePoint>();
-            npu_tp->end = ProfilerClock::time_point(std::chrono::nanoseconds(response_recv_ns));
-            npu_tp->start = ProfilerClock::time_point(std::chrono::nanoseconds(response_recv_ns - inf_time_ns));
-            profiler.AddTimePoint("NPU Core[Job_" + std::to_string(req->job_id()) + "][" + req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "]_" + std::to_string(response.dma_ch), npu_tp);
+            profiler.Record(PROFILER_EVENT_NPU_CORE,
+                ProfilerClock::time_point(std::chrono::nanoseconds(response_recv_ns - inf_time_ns)),
+                ProfilerClock::time_point(std::chrono::nanoseconds(response_recv_ns)), profile_args);
         }
 
         if (response.wait_timestamp > 0) {
-            auto wait_tp = std::make_shared<TimePoint>();
-            wait_tp->start = ProfilerClock::time_point(std::chrono::nanoseconds(response.wait_start_time));
-            wait_tp->end = ProfilerClock::time_point(std::chrono::nanoseconds(response.wait_end_time));
-            profiler.AddTimePoint("Service Process Wait[Job_" + std::to_string(req->job_id()) + "][" + req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "]_" + std::to_string(response.dma_ch), wait_tp);
+            profiler.Record(PROFILER_EVENT_SERVICE_WAIT,
+                ProfilerClock::time_point(std::chrono::nanoseconds(response.wait_start_time)),
+                ProfilerClock::time_point(std::chrono::nanoseconds(response.wait_end_time)), profile_args);
         }
 
-        profiler.Start("PCIe Read[Job_" + std::to_string(req->job_id()) + "][" + req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "](" + std::to_string(ch)+")");
-        // profiler.Start("PCIe Read(" + std::to_string(response.dma_ch)+")");
+        ProfilerClock::time_point readStart;
+        if (profiler.IsEnabled()) readStart = ProfilerClock::now();
 
 #endif
         int read_ch = ch;
@@ -503,8 +513,8 @@ int AccDeviceTaskLayer::OutputHandler(const dxrt_response_t& response, int ch)
 
 
 #ifdef USE_PROFILER
-        profiler.End("PCIe Read[Job_" + std::to_string(req->job_id()) + "][" + req->taskData()->name() + "][Req_" + std::to_string(req->id()) + "](" + std::to_string(ch)+")");
-        // profiler.End("PCIe Read(" + std::to_string(response.dma_ch)+")");
+        profiler.Record(PROFILER_EVENT_PCIE_READ, readStart, ProfilerClock::now(),
+            ProfilerArgs{req->job_id(), req->id(), ch, req->taskData()->profiler_name_id()});
 #endif
         //DXRT_ASSERT(ret2 == 0, "Failed to read output, errno="+ std::to_string(ret2) +
         //    ", reqId=" + std::to_string(reqId) + ",ch:" + std::to_string(id()));
@@ -550,6 +560,7 @@ void AccDeviceTaskLayer::OutputReceiverThread(int id)
     std::shared_ptr<TimePoint> tp = nullptr;
     std::ignore = tp;
     LOG_DXRT_DBG << core()->name() << " OutputReceiverThread "<<id<<": Entry" << std::endl;
+    ApplyThreadPlacement(ThreadRole::DEVICE_IO, deviceId);
 
     int termination_count = 0;
     static constexpr int DXRT_DEVICE_TERMINATE_CONFIRM_COUNT = 5;
@@ -605,6 +616,7 @@ void AccDeviceTaskLayer::OutputReceiverThread(int id)
         }
 #ifdef USE_PROFILER
         // Record timestamp when response is received from driver (before queueing)
+        if (Profiler::GetInstance().IsEnabled())
         {
             std::lock_guard<std::mutex> lock(_responseTimestampLock);
             _responseReceiveTimestamps[response.req_id] =
@@ -625,6 +637,7 @@ void AccDeviceTaskLayer::EventThread()
     std::string threadName = core()->name();
     int loopCnt = 0;
     LOG_DXRT_DBG << threadName << " : Entry" << std::endl;
+    ApplyThreadPlacement(ThreadRole::DEVICE_IO, id());
     dxrt_cmd_t cmd = dxrt::dxrt_cmd_t::DXRT_CMD_EVENT;
     while (_stop.load(std::memory_order_acquire) == false)
     {
@@ -834,6 +847,8 @@ void AccDeviceTaskLayer::StartThread()
     {
         LOG_DXRT_DBG << "Service layer is running. Skipping PPCPU firmware load." << std::endl;
     }
+    _inputHandlerQueue.SetPlacement(ThreadRole::DEVICE_IO, id());
+    _outputHandlerQueue.SetPlacement(ThreadRole::DEVICE_IO, id());
     _inputHandlerQueue.Start();
     _outputHandlerQueue.Start();
 }
@@ -880,6 +895,7 @@ void AccDeviceTaskLayer::ProcessResponseFromService(const dxrt::_dxrt_response_t
 {
 #ifdef USE_PROFILER
         // Record timestamp when response is received from driver (before queueing)
+        if (Profiler::GetInstance().IsEnabled())
         {
             std::lock_guard<std::mutex> lock(_responseTimestampLock);
             _responseReceiveTimestamps[response.req_id] =
@@ -10,8 +10,11 @@
 
 #include "dxrt/device_core.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 #include "dxrt/device_struct.h"
 #include "dxrt/device_version.h"
@@ -151,6 +154,55 @@ int DeviceCore::Read(_dxrt_meminfo_t &meminfo, int ch, bool ctrlCmd)
     return 0;
 }
 
+constexpr uint32_t DeviceCore::VERIFY_CHUNK_SIZE;
+constexpr uint32_t DeviceCore::VERIFY_SAMPLE_SIZE;
+constexpr int DeviceCore::VERIFY_SAMPLE_COUNT;
+
+int DeviceCore::Verify(const dxrt_meminfo_t &meminfo, ModelVerifyMode mode)
+{
+    if (mode == ModelVerifyMode::OFF || meminfo.size == 0) return 0;
+
+    const uint8_t* host = reinterpret_cast<const uint8_t*>(meminfo.data);
+    const uint32_t size = meminfo.size;
+    const bool sampled = (mode == ModelVerifyMode::SAMPLED);
+    // Bounded staging buffer: the region is never held twice on the host
+    const uint32_t chunk = std::min(sampled ? VERIFY_SAMPLE_SIZE : VERIFY_CHUNK_SIZE, size);
+    std::vector<uint8_t> readBuf(chunk);
+
+    const int steps = sampled ? VERIFY_SAMPLE_COUNT : static_cast<int>((static_cast<uint64_t>(size) + chunk - 1) / chunk);
+    uint64_t lastOffset = UINT64_MAX;
+    for (int i = 0; i < steps; i++)
+    {
+        // Sampled windows include the head and the tail of the region and are evenly spread in between
+        uint64_t offset = sampled
+            ? (static_cast<uint64_t>(size - chunk) * i) / (VERIFY_SAMPLE_COUNT - 1)
+            : static_cast<uint64_t>(i) * chunk;
+        if (offset == lastOffset) continue;
+        lastOffset = offset;
+        uint32_t len = static_cast<uint32_t>(std::min<uint64_t>(chunk, size - offset));
+
+        dxrt_meminfo_t part(meminfo);
+        part.offset = meminfo.offset + static_cast<uint32_t>(offset);
+        part.size = len;
+        part.data = reinterpret_cast<uint64_t>(readBuf.data());
+        int ret = Read(part);
+        if (ret != 0)
+        {
+            LOG_DXRT_DBG << "Device " << _id << " verify skipped, read back failed: " << ret << endl;
+            return 0;
+        }
+
+        if (memcmp(host + offset, readBuf.data(), len) != 0)
+        {
+            LOG_DXRT_ERR("Device " << _id << " model data mismatch at offset 0x" << std::hex
+                << meminfo.offset + offset << std::dec << " (" << len << " bytes)");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 int DeviceCore::Wait(void)
 {
     LOG_DXRT_DBG << "Device " << _id << " Wait" << endl;
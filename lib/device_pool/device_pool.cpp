@@ -10,6 +10,7 @@
 
 #include "dxrt/device_pool.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -17,10 +18,12 @@
 #include "dxrt/device_core.h"
 #include "dxrt/driver_adapter/driver_adapter.h"
 #include "dxrt/driver_adapter/driver_adapter_factory.h"
+#include "dxrt/driver_adapter/simulator_driver_adapter.h"
 #include "dxrt/filesys_support.h"
 #include "dxrt/service_layer_factory.h"
 #include "../resource/log_messages.h"
 #include "dxrt/configuration.h"
+#include "dxrt/inference_option.h"
 
 namespace dxrt {
 
@@ -49,6 +52,20 @@ void DevicePool::InitCores_once()
     _deviceCores.clear();
     int cnt = 0;
 
+    SimulatorConfig simConfig;
+    if (SimulatorConfig::LoadFromEnv(simConfig))
+    {
+        LOG_DXRT << "DXRT_SIMULATOR: using " << simConfig.numDevices << " simulated device(s)" << std::endl;
+        for (cnt = 0; cnt < simConfig.numDevices; cnt++)
+        {
+            std::unique_ptr<DriverAdapter> adapter(DriverAdapterFactory::CreateSimulator(cnt, simConfig));
+            std::shared_ptr<DeviceCore> device = std::make_shared<DeviceCore>(cnt, std::move(adapter));
+            device->Identify(cnt);
+            _deviceCores.emplace_back(std::move(device));
+        }
+        return;
+    }
+
     while (true)
     {
 #ifdef __linux__
@@ -130,51 +147,85 @@ void DevicePool::InitTaskLayers()
     std::call_once(_taskLayersFlag, &DevicePool::InitTaskLayers_once, this);
 }
 
-int DevicePool::pickDeviceIndex(const std::vector<int> &device_ids)
+void DevicePool::InitSchedulePolicies()
+{
+    std::call_once(_policiesFlag, [this]() {
+        InitTaskLayers();
+        _schedulePolicies.resize(InferenceOption::SCHEDULE_LEAST_EXPECTED_LATENCY + 1);
+        _schedulePolicies[InferenceOption::SCHEDULE_LEAST_LOAD] = std::make_shared<LeastLoadSchedulePolicy>();
+        _schedulePolicies[InferenceOption::SCHEDULE_LEAST_EXPECTED_LATENCY] =
+            std::make_shared<LeastExpectedLatencySchedulePolicy>(static_cast<int>(_taskLayers.size()));
+    });
+}
+
+void DevicePool::SetSchedulePolicy(uint32_t policy, std::shared_ptr<DeviceSchedulePolicy> impl)
 {
-    int device_index = -1;
-    int load = std::numeric_limits<int>::max();
-    int curDeviceLoad;
-    int device_id_size = device_ids.size();
-    int block_count = 0;
-    
-    // Round-robin starting index (don't increment here to avoid side effect in predicate)
-    int startIdx = _curDevIdx % device_id_size;
-    
-    for (int i = 0; i < device_id_size; i++)
+    InitTaskLayers();
+    InitSchedulePolicies();
+    if (policy >= _schedulePolicies.size() || impl == nullptr)
+    {
+        LOG_DXRT_ERR("DevicePool::SetSchedulePolicy: invalid policy " << policy);
+        return;
+    }
+    std::atomic_store(&_schedulePolicies[policy], impl);
+}
+
+std::shared_ptr<DeviceSchedulePolicy> DevicePool::GetSchedulePolicy(uint32_t policy)
+{
+    InitTaskLayers();
+    InitSchedulePolicies();
+    if (policy >= _schedulePolicies.size())
+    {
+        policy = InferenceOption::SCHEDULE_LEAST_LOAD;
+    }
+    return std::atomic_load(&_schedulePolicies[policy]);
+}
+
+void DevicePool::ReportServiceTime(int deviceId, int taskId, uint32_t serviceTimeUs)
+{
+    if (serviceTimeUs == 0) return;
+    InitSchedulePolicies();
+    for (auto &entry : _schedulePolicies)
+    {
+        auto policy = std::atomic_load(&entry);
+        if (policy) policy->OnRequestComplete(deviceId, taskId, serviceTimeUs);
+    }
+}
+
+void DevicePool::RemoveTask(int taskId)
+{
+    InitSchedulePolicies();
+    for (auto &entry : _schedulePolicies)
+    {
+        auto policy = std::atomic_load(&entry);
+        if (policy) policy->OnTaskRemoved(taskId);
+    }
+}
+
+int DevicePool::pickDeviceIndex(const std::vector<int> &device_ids, int taskId, DeviceSchedulePolicy &policy)
+{
+    // Reused per thread so the hot path does not allocate
+    thread_local std::vector<DeviceCandidate> candidates;
+    candidates.clear();
+
+    for (int device_id : device_ids)
     {
-        int idx = (i + startIdx) % device_id_size;
-        int device_id = device_ids[idx];
-        
         if (_taskLayers[device_id]->isBlocked())
         {
-            block_count++;
             LOG_DXRT_DBG << "Device " << device_id << " is blocked" << std::endl;
             continue;
         }
-        
-        curDeviceLoad = _taskLayers[device_id]->load();
-        int fullLoad = _taskLayers[device_id]->getFullLoad();
-        
-        LOG_DXRT_DBG << "Device " << device_id 
-                     << " load=" << curDeviceLoad 
-                     << " fullLoad=" << fullLoad << std::endl;
-        
-        // Select device if it has capacity and lowest load
-        if (curDeviceLoad < fullLoad && curDeviceLoad < load)
-        {
-            load = curDeviceLoad;
-            device_index = device_id;
-        }
+        candidates.push_back({device_id, _taskLayers[device_id]->load(), _taskLayers[device_id]->getFullLoad()});
     }
 
-    if (block_count >= device_id_size)
+    if (candidates.empty())
     {
         throw DeviceIOException(EXCEPTION_MESSAGE(LogMessages::AllDeviceBlocked()));
     }
-    
+
+    int device_index = policy.Select(candidates, taskId);
     if (device_index >= 0) {
-        LOG_DXRT_DBG << "Selected device: " << device_index << " with load=" << load << std::endl;
+        LOG_DXRT_DBG << "Selected device: " << device_index << " by " << policy.Name() << std::endl;
     } else {
         LOG_DXRT_DBG << "No available device (all at full load)" << std::endl;
     }
@@ -182,6 +233,29 @@ int DevicePool::pickDeviceIndex(const std::vector<int> &device_ids)
     return device_index;
 }
 
+std::shared_ptr<DeviceTaskLayer> DevicePool::tryPickDevice(const std::vector<int> &device_ids, int taskId,
+    DeviceSchedulePolicy &policy)
+{
+    // A failed credit reservation means another submitter took the last slot on that
+    // device between the scan and the CAS, so rescan; give up once every device had a chance
+    const size_t attempts = device_ids.size() + 1;
+    for (size_t i = 0; i < attempts; i++)
+    {
+        int picked = pickDeviceIndex(device_ids, taskId, policy);
+        if (picked < 0)
+        {
+            return nullptr;
+        }
+        if (_taskLayers[picked]->tryPick())
+        {
+            LOG_DXRT_DBG << "Successfully picked device " << picked
+                         << " with new load=" << _taskLayers[picked]->load() << std::endl;
+            return _taskLayers[picked];
+        }
+    }
+    return nullptr;
+}
+
 
 std::shared_ptr<DeviceTaskLayer> DevicePool::GetDeviceTaskLayer(int deviceId)
 {
@@ -194,10 +268,22 @@ std::shared_ptr<DeviceTaskLayer> DevicePool::GetDeviceTaskLayer(int deviceId)
 }
 
 std::shared_ptr<DeviceTaskLayer> DevicePool::PickOneDevice(const std::vector<int> &device_ids )
+{
+    return PickOneDevice(device_ids, -1, InferenceOption::SCHEDULE_LEAST_LOAD);
+}
+
+std::shared_ptr<DeviceTaskLayer> DevicePool::PickOneDevice(const std::vector<int> &device_ids, int taskId,
+    uint32_t policy)
 {
     InitTaskLayers();
-    std::lock_guard<std::mutex> lock(_methodMutex);
-    return WaitDevice(device_ids);
+    // Holding the shared_ptr keeps the policy alive if SetSchedulePolicy() swaps it meanwhile
+    auto impl = GetSchedulePolicy(policy);
+    auto pick = tryPickDevice(device_ids, taskId, *impl);
+    if (pick)
+    {
+        return pick;
+    }
+    return WaitDevice(device_ids, taskId, *impl);
 }
 std::shared_ptr<NFHLayer> DevicePool::PickOneNFHDevice(const std::vector<int> &device_ids_)
 {
@@ -207,75 +293,113 @@ std::shared_ptr<NFHLayer> DevicePool::PickOneNFHDevice(const std::vector<int> &d
     return _nfhLayers[deviceId];
 }
 
-// wait and awake
-std::shared_ptr<DeviceTaskLayer> DevicePool::WaitDevice(const std::vector<int> &device_ids)
+// wait and awake: slow path taken only when every candidate device is at full load
+std::shared_ptr<DeviceTaskLayer> DevicePool::WaitDevice(const std::vector<int> &device_ids, int taskId,
+    DeviceSchedulePolicy &policy)
 {
     std::unique_lock<std::mutex> lock(_deviceMutex);
-    
+
     LOG_DXRT_DBG << "Waiting for available device from " << device_ids.size() << " devices" << std::endl;
 
+    // Registering before the retry pairs with AwakeDevice(), which releases the load credit
+    // before reading _deviceWaiters: either it sees this waiter, or the retry sees the credit
+    struct WaiterGuard
+    {
+        std::atomic<int>& count;
+        explicit WaiterGuard(std::atomic<int>& c) : count(c) { ++count; }
+        ~WaiterGuard() { --count; }
+    } guard(_deviceWaiters);
+    DeviceWaiter waiter;
+    waiter.deviceIds = &device_ids;
+    auto self = _deviceWaitQueue.insert(_deviceWaitQueue.end(), &waiter);
+
     // 3000 second timeout to prevent deadlock
-    bool success = _deviceCV.wait_for(lock, std::chrono::seconds(3000), [this, &device_ids]{
-        // Try to pick a device without side effects in predicate
-        int picked = pickDeviceIndex(device_ids);
-        if (picked >= 0) {
-            _currentPickDevice = picked;
-            return true;
-        }
-        // No device available, keep waiting
-        LOG_DXRT_DBG << "No available device, waiting for notification..." << std::endl;
-        return false;
-    });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3000);
+    std::shared_ptr<DeviceTaskLayer> pick;
+    while ((pick = tryPickDevice(device_ids, taskId, policy)) == nullptr)
+    {
+        // the credit that woke this waiter went to a submitter on the fast path
+        waiter.wokenBy = -1;
+        if (!waiter.cv.wait_until(lock, deadline, [&waiter] { return waiter.wokenBy >= 0; }))
+        {
+            pick = tryPickDevice(device_ids, taskId, policy);
+            if (pick)
+            {
+                break;
+            }
+            _deviceWaitQueue.erase(self);
 
-    if (!success) {
-        std::string error_msg = "DevicePool: Timeout waiting for available device. Device IDs: ";
-        for (int id : device_ids) {
-            error_msg += std::to_string(id) + ",";
-        }
-        error_msg.pop_back();
-        
-        // Log current state of all devices
-        error_msg += "\\n  Current device states: ";
-        for (int id : device_ids) {
-            if (id < static_cast<int>(_taskLayers.size())) {
-                error_msg += "\\n    Device " + std::to_string(id) + 
-                             ": load=" + std::to_string(_taskLayers[id]->load()) +
-                             ", fullLoad=" + std::to_string(_taskLayers[id]->getFullLoad()) +
-                             ", blocked=" + std::string(_taskLayers[id]->isBlocked() ? "true" : "false");
+            std::string error_msg = "DevicePool: Timeout waiting for available device. Device IDs: ";
+            for (int id : device_ids) {
+                error_msg += std::to_string(id) + ",";
             }
+            error_msg.pop_back();
+
+            // Log current state of all devices
+            error_msg += "\\n  Current device states: ";
+            for (int id : device_ids) {
+                if (id < static_cast<int>(_taskLayers.size())) {
+                    error_msg += "\\n    Device " + std::to_string(id) +
+                                 ": load=" + std::to_string(_taskLayers[id]->load()) +
+                                 ", fullLoad=" + std::to_string(_taskLayers[id]->getFullLoad()) +
+                                 ", blocked=" + std::string(_taskLayers[id]->isBlocked() ? "true" : "false");
+                }
+            }
+
+            LOG_DXRT_ERR(error_msg);
+            throw std::runtime_error("Device allocation timeout - possible deadlock detected");
         }
-        
-        LOG_DXRT_ERR(error_msg);
-        throw std::runtime_error("Device allocation timeout - possible deadlock detected");
+        LOG_DXRT_DBG << "Woken by device " << waiter.wokenBy << ", retrying" << std::endl;
     }
 
-    auto pick = _taskLayers[_currentPickDevice];
-    pick->pick();  // Increment load counter
-    
-    // Update round-robin index after successful pick
-    // Prevent overflow by resetting after a large threshold
-    _curDevIdx++;
-    if (_curDevIdx > 1000000) {
-        _curDevIdx = 0;
+    _deviceWaitQueue.erase(self);
+    // completions skipped while this waiter was on its way, or a pick served by another device,
+    // can leave credits on the device that woke it: hand the wake on to the next waiter
+    if (waiter.wokenBy >= 0 && _taskLayers[waiter.wokenBy]->load() < _taskLayers[waiter.wokenBy]->getFullLoad())
+    {
+        wakeDeviceWaiterLocked(waiter.wokenBy);
     }
-    
-    LOG_DXRT_DBG << "Successfully picked device " << _currentPickDevice 
-                 << " with new load=" << pick->load() << std::endl;
-
     return pick;
 }
 
+bool DevicePool::wakeDeviceWaiterLocked(int devIndex)
+{
+    // one woken waiter per device at a time: it passes the wake on if credits are left, so a
+    // burst of completions does not wake waiters that would only find the credits taken
+    for (DeviceWaiter* waiter : _deviceWaitQueue)
+    {
+        if (waiter->wokenBy == devIndex)
+        {
+            return false;
+        }
+    }
+    for (DeviceWaiter* waiter : _deviceWaitQueue)
+    {
+        if (waiter->wokenBy < 0 &&
+            std::find(waiter->deviceIds->begin(), waiter->deviceIds->end(), devIndex) != waiter->deviceIds->end())
+        {
+            waiter->wokenBy = devIndex;
+            waiter->cv.notify_one();
+            return true;
+        }
+    }
+    return false;
+}
+
 void DevicePool::AwakeDevice(int devIndex)
 {
-    std::unique_lock<std::mutex> lock(_deviceMutex);
-    std::ignore = devIndex;
-    // Don't reset _curDevIdx to maintain round-robin scheduling
-    // _curDevIdx is incremented in WaitDevice() after successful pick
-    
-    LOG_DXRT_DBG << "Device " << devIndex 
-                 << " completed task, notifying waiting threads" << std::endl;
-    
-    _deviceCV.notify_all();
+    // Completions on an unsaturated pool skip the mutex entirely
+    if (_deviceWaiters.load() == 0)
+    {
+        return;
+    }
+
+    LOG_DXRT_DBG << "Device " << devIndex
+                 << " completed task, notifying a waiting thread" << std::endl;
+
+    // one credit was released, so one waiter of this device retries
+    std::lock_guard<std::mutex> lock(_deviceMutex);
+    wakeDeviceWaiterLocked(devIndex);
 }
 
 void DevicePool::InitNFHLayers_once()
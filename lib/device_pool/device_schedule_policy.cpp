@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "dxrt/device_schedule_policy.h"
+
+#include <limits>
+
+namespace dxrt {
+
+constexpr int LeastExpectedLatencySchedulePolicy::EMPTY_SLOT;
+constexpr int LeastExpectedLatencySchedulePolicy::REMOVED_SLOT;
+
+int LeastLoadSchedulePolicy::Select(const std::vector<DeviceCandidate>& candidates, int taskId)
+{
+    std::ignore = taskId;
+    int device_index = -1;
+    int load = std::numeric_limits<int>::max();
+    size_t count = candidates.size();
+    if (count == 0) return -1;
+
+    size_t startIdx = _rrIndex.fetch_add(1, std::memory_order_relaxed) % count;
+    for (size_t i = 0; i < count; i++)
+    {
+        const DeviceCandidate& c = candidates[(i + startIdx) % count];
+        if (c.load < c.fullLoad && c.load < load)
+        {
+            load = c.load;
+            device_index = c.deviceId;
+        }
+    }
+    return device_index;
+}
+
+LeastExpectedLatencySchedulePolicy::LeastExpectedLatencySchedulePolicy(int maxDevices)
+: _stats(new DeviceStats[maxDevices > 0 ? maxDevices : 1]), _maxDevices(maxDevices > 0 ? maxDevices : 1)
+{
+}
+
+void LeastExpectedLatencySchedulePolicy::updateEwma(std::atomic<uint32_t>& avg, uint32_t sample)
+{
+    // Concurrent completions may overwrite each other's update; the estimate only
+    // needs to track the trend, so a lost sample is cheaper than a CAS loop
+    uint32_t cur = avg.load(std::memory_order_relaxed);
+    if (cur == 0)
+    {
+        avg.store(sample, std::memory_order_relaxed);
+        return;
+    }
+    int64_t next = static_cast<int64_t>(cur) +
+        ((static_cast<int64_t>(sample) - static_cast<int64_t>(cur)) >> EWMA_SHIFT);
+    avg.store(static_cast<uint32_t>(next > 0 ? next : 1), std::memory_order_relaxed);
+}
+
+const LeastExpectedLatencySchedulePolicy::TaskSlot*
+LeastExpectedLatencySchedulePolicy::findSlot(const DeviceStats& stats, int taskId) const
+{
+    for (int i = 0; i < TASK_SLOTS; i++)
+    {
+        const TaskSlot& slot = stats.tasks[(static_cast<unsigned>(taskId) + i) % TASK_SLOTS];
+        int id = slot.taskId.load(std::memory_order_acquire);
+        if (id == taskId) return &slot;
+        if (id == EMPTY_SLOT) return nullptr;
+    }
+    return nullptr;
+}
+
+LeastExpectedLatencySchedulePolicy::TaskSlot*
+LeastExpectedLatencySchedulePolicy::findSlot(DeviceStats& stats, int taskId)
+{
+    return const_cast<TaskSlot*>(findSlot(static_cast<const DeviceStats&>(stats), taskId));
+}
+
+LeastExpectedLatencySchedulePolicy::TaskSlot*
+LeastExpectedLatencySchedulePolicy::findOrInsertSlot(DeviceStats& stats, int taskId)
+{
+    TaskSlot* slot = findSlot(stats, taskId);
+    if (slot) return slot;
+    // first free slot of the probe sequence, a tombstone of a released task or an empty one
+    for (int i = 0; i < TASK_SLOTS; i++)
+    {
+        TaskSlot& free = stats.tasks[(static_cast<unsigned>(taskId) + i) % TASK_SLOTS];
+        int id = free.taskId.load(std::memory_order_acquire);
+        if (id == taskId) return &free;
+        if (id == EMPTY_SLOT || id == REMOVED_SLOT)
+        {
+            if (free.taskId.compare_exchange_strong(id, taskId, std::memory_order_acq_rel))
+                return &free;
+            if (id == taskId) return &free;
+        }
+    }
+    // Table full of live tasks: the task falls back to the device-wide average
+    return nullptr;
+}
+
+uint32_t LeastExpectedLatencySchedulePolicy::EstimateUs(int deviceId, int taskId) const
+{
+    if (deviceId < 0 || deviceId >= _maxDevices) return 0;
+    const DeviceStats& stats = _stats[deviceId];
+    const TaskSlot* slot = findSlot(stats, taskId);
+    uint32_t est = slot ? slot->ewmaUs.load(std::memory_order_relaxed) : 0;
+    return est != 0 ? est : stats.ewmaUs.load(std::memory_order_relaxed);
+}
+
+int LeastExpectedLatencySchedulePolicy::Select(const std::vector<DeviceCandidate>& candidates, int taskId)
+{
+    int device_index = -1;
+    uint64_t best = std::numeric_limits<uint64_t>::max();
+    int bestLoad = std::numeric_limits<int>::max();
+    size_t count = candidates.size();
+    if (count == 0) return -1;
+
+    size_t startIdx = _rrIndex.fetch_add(1, std::memory_order_relaxed) % count;
+    for (size_t i = 0; i < count; i++)
+    {
+        const DeviceCandidate& c = candidates[(i + startIdx) % count];
+        if (c.load >= c.fullLoad || c.deviceId < 0 || c.deviceId >= _maxDevices) continue;
+
+        uint64_t deviceUs = _stats[c.deviceId].ewmaUs.load(std::memory_order_relaxed);
+        uint64_t expected = static_cast<uint64_t>(c.load) * deviceUs + EstimateUs(c.deviceId, taskId);
+        // Equal estimates (e.g. nothing measured yet) fall back to the lower load
+        if (expected < best || (expected == best && c.load < bestLoad))
+        {
+            best = expected;
+            bestLoad = c.load;
+            device_index = c.deviceId;
+        }
+    }
+    return device_index;
+}
+
+void LeastExpectedLatencySchedulePolicy::OnRequestComplete(int deviceId, int taskId, uint32_t serviceTimeUs)
+{
+    if (deviceId < 0 || deviceId >= _maxDevices || serviceTimeUs == 0) return;
+    DeviceStats& stats = _stats[deviceId];
+    updateEwma(stats.ewmaUs, serviceTimeUs);
+    TaskSlot* slot = findOrInsertSlot(stats, taskId);
+    if (slot) updateEwma(slot->ewmaUs, serviceTimeUs);
+}
+
+void LeastExpectedLatencySchedulePolicy::OnTaskRemoved(int taskId)
+{
+    for (int d = 0; d < _maxDevices; d++)
+    {
+        TaskSlot* slot = findSlot(_stats[d], taskId);
+        if (slot == nullptr) continue;
+        // the next task in the slot starts unmeasured
+        slot->ewmaUs.store(0, std::memory_order_relaxed);
+        int id = taskId;
+        slot->taskId.compare_exchange_strong(id, REMOVED_SLOT, std::memory_order_acq_rel);
+    }
+}
+
+}  // namespace dxrt
@@ -52,6 +52,20 @@ void DeviceTaskLayer::pick()
     ++_load;
 }
 
+bool DeviceTaskLayer::tryPick()
+{
+    const int fullLoad = getFullLoad();
+    int cur = _load.load();
+    while (cur < fullLoad)
+    {
+        if (_load.compare_exchange_weak(cur, cur + 1))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 int DeviceTaskLayer::infCnt()
 {
     return _inferenceCnt;
@@ -60,7 +74,18 @@ int DeviceTaskLayer::infCnt()
 
 int64_t DeviceTaskLayer::Allocate(uint64_t size)
 {
-    return _serviceLayer->Allocate(id(), size);
+    int64_t addr = static_cast<int64_t>(_serviceLayer->Allocate(id(), size));
+    // idle I/O slabs are given back when the device is full
+    if (addr == -1 && _npuMemoryCacheManager.trim() > 0)
+    {
+        addr = static_cast<int64_t>(_serviceLayer->Allocate(id(), size));
+    }
+    return addr;
+}
+
+int64_t DeviceTaskLayer::TryAllocate(uint64_t size)
+{
+    return static_cast<int64_t>(_serviceLayer->TryAllocate(id(), size));
 }
 
 void DeviceTaskLayer::Deallocate(uint64_t addr)
@@ -121,14 +146,9 @@ void DeviceTaskLayer::Deallocate_npuBuf(int64_t addr, int taskId)
 {
     LOG_DXRT_DBG << "Device " << id() << " deallocate: " << std::showbase << std::hex << addr << std::dec << std::endl;
 
-    if (_npuMemoryCacheManager.canGetCache(taskId))
-    {
-        _npuMemoryCacheManager.returnNpuMemoryCache(taskId, addr);
-    }
-    else
-    {
-        Deallocate(addr);
-    }
+    // also for a task unregistered meanwhile: its slab has to leave the cache's books; a region
+    // that never came from the cache is deallocated by the manager
+    _npuMemoryCacheManager.returnNpuMemoryCache(taskId, addr);
 }
 
 void DeviceTaskLayer::ProcessErrorFromService(dxrt_server_err_t err, int value)
@@ -20,6 +20,7 @@
 #include "dxrt/npu_format_handler.h"
 #include "dxrt/request_response_class.h"
 #include "dxrt/device_pool.h"
+#include "dxrt/latency_histogram.h"
 
 namespace dxrt
 {
@@ -36,6 +37,8 @@ NFHLayer::NFHLayer(std::shared_ptr<DeviceTaskLayer> devicePtr, bool isDynamic)
 {
     if (isDynamic)
     {
+        _inputHandler.SetPlacement(ThreadRole::NFH, _deviceId);
+        _outputHandler.SetPlacement(ThreadRole::NFH, _deviceId);
         _inputHandler.Start();
         _outputHandler.Start();
     }
@@ -88,6 +91,7 @@ static int processInputNfh(const NfhInputRequest& work, int threadId)
     // common encoding utility
     int enc = npu_format_handler::NpuFormatHandler::EncodeInputs(reqData, threadId);
     if (enc != 0) return enc;
+    reqData->encoded_ns = LatencyClockNs();
 
     return 0;
 }
@@ -154,6 +158,7 @@ int processOutputNfh(const NfhOutputRequest& work, int threadId)
     // common decoding utility
     int dec = npu_format_handler::NpuFormatHandler::DecodeOutputs(&work.req, &work.response, threadId);
     if (dec != 0) return dec;
+    work.req->getData()->decoded_ns = LatencyClockNs();
 
     return 0;
 }
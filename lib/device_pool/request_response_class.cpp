@@ -46,7 +46,8 @@ int RequestResponse::InferenceRequest(RequestPtr req)
             << req->requestor_name() << " -> " << req->task()->name()
             << std::endl;
 
-        auto device = DevicePool::GetInstance().PickOneDevice(req->task()->getDeviceIds());
+        auto device = DevicePool::GetInstance().PickOneDevice(req->task()->getDeviceIds(),
+            req->task()->id(), req->task()->getSchedulePolicy());
 
       TASK_FLOW("[" + std::to_string(req->job_id()) + "]" +
             req->task()->name() + " device pick");
@@ -59,20 +60,15 @@ int RequestResponse::InferenceRequest(RequestPtr req)
             try {
                 BufferSet buffers = req->task()->AcquireAllBuffers();
 #ifdef USE_PROFILER
+                // Start of the overall NPU task (input preprocess + PCIe + NPU execution + output postprocess),
+                // recorded as a span in ProcessResponse
                 req->CheckTimePoint(0);
-                // Start profiling for overall NPU task (input preprocess + PCIe + NPU execution + output postprocess)
-                auto& profiler = dxrt::Profiler::GetInstance();
-                std::string profile_name =
-                    "NPU Task[Job_" + std::to_string(req->job_id()) + "][" +
-                    req->task()->name() + "][Req_" +
-                    std::to_string(req->id()) + "]";
-                profiler.Start(profile_name);
 #endif
                 req->getData()->output_buffer_base = buffers.output;
                 req->getData()->encoded_inputs_ptr = buffers.encoded_input;
                 req->getData()->encoded_outputs_ptr = buffers.encoded_output;
                 // Store the BufferSet in the Request so it can be released automatically
-                req->setBufferSet(std::unique_ptr<BufferSet>(new BufferSet(buffers)));
+                req->setBufferSet(buffers);
             }
             catch (const std::exception& e) {
                 LOG_DXRT_ERR(
@@ -124,7 +120,7 @@ int RequestResponse::InferenceRequest(RequestPtr req)
                 req->getData()->encoded_outputs_ptr = nullptr;
 
                 // Store the BufferSet in the Request so it can be released automatically
-                req->setBufferSet(std::unique_ptr<BufferSet>(new BufferSet(buffers)));
+                req->setBufferSet(buffers);
             }
             catch (const std::exception& e) {
                 LOG_DXRT_ERR(
@@ -183,6 +179,7 @@ void RequestResponse::ProcessByData(int reqId, const dxrt_response_t& response,
         DXRT_ASSERT(false, "Invalid model type (normal, argmax, ppu, ppcpu)");
     }
 
+    DevicePool::GetInstance().ReportServiceTime(deviceId, req->task()->id(), response.inf_time);
     RequestResponse::ProcessResponse(req, response, 0);
 }
 
@@ -373,11 +370,11 @@ int RequestResponse::ProcessResponse(RequestPtr req, const dxrt_response_t& resp
 #ifdef USE_PROFILER
     req->CheckTimePoint(1);
     // End profiling for overall NPU task
-    auto& profiler = dxrt::Profiler::GetInstance();
-    std::string profile_name =
-        "NPU Task[Job_" + std::to_string(req->job_id()) + "][" +
-        req->task()->name() + "][Req_" + std::to_string(req->id()) + "]";
-    profiler.End(profile_name);
+    if (req->task()->processor() == Processor::NPU && req->time_point()->start.time_since_epoch().count() != 0)
+    {
+        dxrt::Profiler::GetInstance().Record(PROFILER_EVENT_NPU_TASK, req->time_point()->start, req->time_point()->end,
+            ProfilerArgs{req->job_id(), req->id(), -1, req->taskData()->profiler_name_id()});
+    }
 
 #endif
         LOG_DXRT_DBG
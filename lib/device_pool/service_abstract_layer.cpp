@@ -31,16 +31,29 @@ void ServiceLayer::SignalDeviceReset(int id)
 
 uint64_t ServiceLayer::Allocate(int deviceId, uint64_t size)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    std::lock_guard<std::mutex> lock(_syncLock);
     return _mem->Allocate(deviceId, size);
 }
 
+uint64_t ServiceLayer::TryAllocate(int deviceId, uint64_t size)
+{
+    std::lock_guard<std::mutex> lock(_syncLock);
+    return _mem->TryAllocate(deviceId, size);
+}
+
 uint64_t ServiceLayer::BackwardAllocateForTask(int deviceId, int taskId, uint64_t required)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    std::lock_guard<std::mutex> lock(_syncLock);
     return _mem->BackwardAllocateForTask(deviceId, taskId, required);
 }
 
+std::vector<uint64_t> ServiceLayer::AllocateBatch(int deviceId, int taskId, const std::vector<uint64_t>& sizes,
+    bool backward)
+{
+    std::lock_guard<std::mutex> lock(_syncLock);
+    return _mem->AllocateBatch(deviceId, taskId, sizes, backward);
+}
+
 void ServiceLayer::DeAllocate(int deviceId, int64_t addr)
 {
     std::lock_guard<std::mutex> lock(_lock);
@@ -79,9 +92,36 @@ void ServiceLayer::SignalTaskDeInit(int deviceId, int taskId, npu_bound_op bound
     _mem->DeallocateTaskMemory(deviceId, taskId);
 }
 
+constexpr int ServiceLayerInterface::MODEL_MEMORY_WAIT_MS;
+
+ModelMemoryRegion ServiceLayer::AcquireModelMemory(int deviceId, int taskId, const ModelMemoryKey& key)
+{
+    ModelMemoryRegion region;
+    {
+        // The service holds the request while another process uploads the same model
+        std::lock_guard<std::mutex> lock(_syncLock);
+        region = _mem->AcquireModelMemory(deviceId, taskId, key, MODEL_MEMORY_WAIT_MS);
+    }
+    if (region.state != ModelMemoryRegion::State::ALLOCATED && region.state != ModelMemoryRegion::State::RESIDENT)
+    {
+        LOG_DXRT_ERR("Failed to get model memory of Task " << taskId << " on device " << deviceId);
+        region.state = ModelMemoryRegion::State::FAILED;
+    }
+    return region;
+}
+
+void ServiceLayer::SignalModelMemoryReady(int deviceId, const ModelMemoryKey& key)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _mem->SignalModelMemoryReady(deviceId, key);
+}
+
 extern uint8_t DEBUG_DATA;
 // NoServiceLayer ------------------------------------------------
 
+// Without the service only this process uses the devices; tasks are told apart by id alone
+static constexpr pid_t NO_SERVICE_PID = 0;
+
 
 #ifdef __linux__
     constexpr static int HandleInferenceAcc_BUSY_VALUE = -EBUSY;  // write done, but failed to enqueue
@@ -123,8 +163,45 @@ void NoServiceLayer::SignalTaskInit(int deviceId, int taskId, npu_bound_op bound
 }
 void NoServiceLayer::SignalTaskDeInit(int deviceId, int taskId, npu_bound_op bound)
 {
-    std::ignore = taskId;
     _ptr[deviceId]->BoundOption(DX_SCHED_DELETE, bound);
+
+    {
+        std::lock_guard<std::mutex> lock(_modelMemoryLock);
+        auto mem = _mems[deviceId];
+        _modelMemory[deviceId].Release(NO_SERVICE_PID, taskId, [&mem](uint64_t addr) { mem->Deallocate(addr); });
+    }
+    _modelMemoryCV.notify_all();
+}
+
+ModelMemoryRegion NoServiceLayer::AcquireModelMemory(int deviceId, int taskId, const ModelMemoryKey& key)
+{
+    std::unique_lock<std::mutex> lock(_modelMemoryLock);
+    auto mem = _mems[deviceId];
+    auto dealloc = [&mem](uint64_t addr) { mem->Deallocate(addr); };
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(MODEL_MEMORY_WAIT_MS);
+    ModelMemoryRegion region;
+    do
+    {
+        region = _modelMemory[deviceId].Acquire(key, NO_SERVICE_PID, taskId,
+            [&mem](uint64_t size) { return mem->BackwardAllocate(size); }, dealloc);
+        if (region.state != ModelMemoryRegion::State::PENDING)
+            return region;
+        // Another task of this process is uploading the same model; the wait releases the lock
+    } while (_modelMemoryCV.wait_until(lock, deadline) == std::cv_status::no_timeout);
+
+    LOG_DXRT_ERR("Timed out waiting for model memory of Task " << taskId << " on device " << deviceId);
+    _modelMemory[deviceId].Release(NO_SERVICE_PID, taskId, dealloc);
+    region.state = ModelMemoryRegion::State::FAILED;
+    return region;
+}
+
+void NoServiceLayer::SignalModelMemoryReady(int deviceId, const ModelMemoryKey& key)
+{
+    {
+        std::lock_guard<std::mutex> lock(_modelMemoryLock);
+        _modelMemory[deviceId].MarkResident(key);
+    }
+    _modelMemoryCV.notify_all();
 }
 
 
@@ -133,6 +210,35 @@ void NoServiceLayer::SignalDeviceReset(int id) { std::ignore = id; }
 
 uint64_t NoServiceLayer::Allocate(int deviceId, uint64_t size) { return _mems[deviceId]->Allocate(size); }
 
+uint64_t NoServiceLayer::TryAllocate(int deviceId, uint64_t size)
+{
+    auto mem = _mems[deviceId];
+    if (!mem->CanAllocateContiguous(size))
+        return static_cast<uint64_t>(-1);
+    return mem->Allocate(size);
+}
+
+std::vector<uint64_t> NoServiceLayer::AllocateBatch(int deviceId, int taskId, const std::vector<uint64_t>& sizes,
+    bool backward)
+{
+    std::ignore = taskId;
+    auto mem = _mems[deviceId];
+    std::vector<uint64_t> addrs;
+    addrs.reserve(sizes.size());
+    for (uint64_t size : sizes)
+    {
+        uint64_t addr = backward ? mem->BackwardAllocate(size) : mem->Allocate(size);
+        if (static_cast<int64_t>(addr) == -1)
+        {
+            for (uint64_t done : addrs)
+                mem->Deallocate(done);
+            return {};
+        }
+        addrs.push_back(addr);
+    }
+    return addrs;
+}
+
 uint64_t NoServiceLayer::BackwardAllocateForTask(int deviceId, int taskId, uint64_t required)
 {
     std::ignore = taskId;
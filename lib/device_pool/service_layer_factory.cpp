@@ -52,6 +52,11 @@ std::shared_ptr<ServiceLayerInterface>
 ServiceLayerFactory::CreateDefaultServiceLayer()
 {
 #ifdef USE_SERVICE
+    // Simulated devices live inside this process, so there is no service to talk to
+    const char* sim = std::getenv("DXRT_SIMULATOR");
+    if (sim && *sim && std::strcmp(sim, "0") != 0) {
+        return CreateServiceLayer(false, nullptr);
+    }
     const char* env = std::getenv("DXRT_USE_SERVICE");
     bool useService = true;
     if (env) {
@@ -14,12 +14,14 @@
 #include <vector>
 #include <cstring>
 #include "dxrt/common.h"
+#include "dxrt/device_pool.h"
 #include "dxrt/device_task_layer.h"
 #include "dxrt/task_data.h"
 #include "dxrt/request_data.h"
 #include "dxrt/task.h"
 #include "dxrt/profiler.h"
 #include "dxrt/request_response_class.h"
+#include "dxrt/thread_affinity.h"
 
 namespace dxrt {
 
@@ -43,20 +45,30 @@ int StdDeviceTaskLayer::RegisterTask(TaskData* task)
     model.rmap.base = _core->info().mem_addr;
     model.weight.base = _core->info().mem_addr;
 
+    // rmap, weight and the input/output blocks of every buffer in one allocation request
+    const uint64_t aligned_in = ((static_cast<uint64_t>(task->input_size()) + 63ull) & ~63ull);
+    const uint64_t input_block = (model.output_all_offset == 0) ? aligned_in
+                                                                : static_cast<uint64_t>(model.output_all_offset);
+    std::vector<uint64_t> sizes = {model.rmap.size, model.weight.size};
+    for (int j = 0; j < DEVICE_NUM_BUF; ++j) {
+        sizes.push_back(input_block);
+        sizes.push_back(model.output_all_size);
+    }
+    const std::vector<uint64_t> offsets = _serviceLayer->AllocateBatch(id(), -1, sizes, false);
+    DXRT_ASSERT(offsets.size() == sizes.size(), "failed to allocate NPU memory for task " + std::to_string(tId));
+
     {
-        model.rmap.offset = static_cast<uint32_t>(Allocate(model.rmap.size));
-        model.weight.offset = static_cast<uint32_t>(Allocate(model.weight.size));
+        model.rmap.offset = static_cast<uint32_t>(offsets[0]);
+        model.weight.offset = static_cast<uint32_t>(offsets[1]);
         if (model.rmap.offset > model.weight.offset) {
+            uint32_t temp_addr = model.rmap.offset;
             model.rmap.offset = static_cast<uint32_t>(Allocate(model.rmap.size));
+            Deallocate(temp_addr);
         }
     }
 
     for (int j = 0; j < DEVICE_NUM_BUF; ++j) {
-        uint32_t inference_offset = 0;
-        const uint64_t aligned_in = ((static_cast<uint64_t>(task->input_size()) + 63ull) & ~63ull);
-        const uint64_t input_block = (model.output_all_offset == 0) ? aligned_in
-                                                                    : static_cast<uint64_t>(model.output_all_offset);
-        inference_offset = static_cast<uint32_t>(Allocate(input_block));
+        uint32_t inference_offset = static_cast<uint32_t>(offsets[2 + 2 * j]);
 
         dxrt_request_t inf{};
         inf.req_id = 0;
@@ -66,7 +78,7 @@ int StdDeviceTaskLayer::RegisterTask(TaskData* task)
         inf.input.size = task->input_size();
         inf.output.data = 0;
         inf.output.base = model.rmap.base;
-        inf.output.offset = static_cast<uint32_t>(Allocate(model.output_all_size));
+        inf.output.offset = static_cast<uint32_t>(offsets[3 + 2 * j]);
         inf.output.size = model.output_all_size;
 
         inf.model_type = static_cast<uint32_t>(model.type);
@@ -106,19 +118,9 @@ int StdDeviceTaskLayer::RegisterTask(TaskData* task)
     }
 
     {
-        std::vector<std::vector<uint8_t>> readData;
-        readData.emplace_back(std::vector<uint8_t>(model.rmap.size));
-        readData.emplace_back(std::vector<uint8_t>(model.weight.size));
-        dxrt_meminfo_t cmd(model.rmap);
-        dxrt_meminfo_t weight(model.weight);
-        cmd.data = reinterpret_cast<uint64_t>(readData[0].data());
-        weight.data = reinterpret_cast<uint64_t>(readData[1].data());
-        if (_core->Read(cmd) == 0) {
-            ret += memcmp(reinterpret_cast<void*>(cmd.data), readData[0].data(), cmd.size);
-        }
-        if (_core->Read(weight) == 0) {
-            ret += memcmp(reinterpret_cast<void*>(weight.data), readData[1].data(), weight.size);
-        }
+        const ModelVerifyMode verifyMode = GetModelVerifyMode();
+        ret += _core->Verify(model.rmap, verifyMode);
+        ret += _core->Verify(model.weight, verifyMode);
         DXRT_ASSERT(ret == 0, "failed to check data integrity of model parameters" + std::to_string(ret));
     }
 
@@ -150,6 +152,7 @@ void StdDeviceTaskLayer::ThreadImpl()
 {
     int ret = 0;
     LOG_DXRT_DBG << "Device " << id() << " thread start. " << std::endl;
+    ApplyThreadPlacement(ThreadRole::DEVICE_IO, id());
     while (true)
     {
         if (_stop.load()) break;
@@ -208,6 +211,7 @@ void StdDeviceTaskLayer::ThreadImpl()
                     //    DataDumpBin(req->taskData()->name() + "_output.ppu.bin", req->outputs());
                 }
 
+                DevicePool::GetInstance().ReportServiceTime(id(), req->task()->id(), response.inf_time);
                 RequestResponse::ProcessResponse(req, response, 1);
                 CallBack();
             }
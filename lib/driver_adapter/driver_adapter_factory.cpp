@@ -9,6 +9,7 @@
 
 
 #include "dxrt/driver_adapter/driver_adapter_factory.h"
+#include "dxrt/driver_adapter/simulator_driver_adapter.h"
 
 #if defined(__linux__)
   #include "dxrt/driver_adapter/linux_driver_adapter.h"
@@ -39,4 +40,8 @@ std::unique_ptr<DriverAdapter> DriverAdapterFactory::CreateForNetwork() {
 #endif
 }
 
+std::unique_ptr<DriverAdapter> DriverAdapterFactory::CreateSimulator(int id, const SimulatorConfig& config) {
+    return std::make_unique<SimulatorDriverAdapter>(id, config);
+}
+
 }  // namespace dxrt
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "dxrt/driver_adapter/simulator_driver_adapter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "dxrt/common.h"
+
+namespace dxrt {
+
+SimulatorConfig SimulatorConfig::Parse(const std::string& spec)
+{
+    SimulatorConfig config;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        std::string key = (eq == std::string::npos) ? "devices" : item.substr(0, eq);
+        std::string value = (eq == std::string::npos) ? item : item.substr(eq + 1);
+        try
+        {
+            unsigned long v = std::stoul(value);
+            if (key == "devices") config.numDevices = static_cast<int>(v);
+            else if (key == "npu_us") config.npuTimeUs = static_cast<uint32_t>(v);
+            else if (key == "pcie_mbps") config.pcieMBps = static_cast<uint32_t>(v);
+            else if (key == "queue") config.queueDepth = static_cast<int>(v);
+            else if (key == "cores") config.npuCores = static_cast<int>(v);
+            else if (key == "dma_ch") config.numDmaChannels = static_cast<int>(v);
+            else if (key == "mem_mb") config.memSizeMB = v;
+            else if (key.size() > 7 && key.compare(0, 4, "task") == 0 &&
+                     key.compare(key.size() - 3, 3, "_us") == 0)
+            {
+                uint32_t taskId = static_cast<uint32_t>(std::stoul(key.substr(4, key.size() - 7)));
+                config.taskNpuTimeUs[taskId] = static_cast<uint32_t>(v);
+            }
+            else
+            {
+                LOG_DXRT_ERR("DXRT_SIMULATOR: unknown key '" << key << "'");
+            }
+        }
+        catch (std::exception&)
+        {
+            LOG_DXRT_ERR("DXRT_SIMULATOR: invalid entry '" << item << "'");
+        }
+    }
+
+    config.numDevices = std::max(config.numDevices, 1);
+    config.queueDepth = std::max(config.queueDepth, 1);
+    config.npuCores = std::max(config.npuCores, 1);
+    config.numDmaChannels = std::min(std::max(config.numDmaChannels, 1), 3);
+    config.memSizeMB = std::max<uint64_t>(config.memSizeMB, 64);
+    return config;
+}
+
+bool SimulatorConfig::LoadFromEnv(SimulatorConfig& config)
+{
+    const char* env = getenv("DXRT_SIMULATOR");
+    if (env == nullptr || *env == '\0' || std::strcmp(env, "0") == 0)
+        return false;
+    config = Parse(env);
+    return true;
+}
+
+SimulatorDriverAdapter::SimulatorDriverAdapter(int id, const SimulatorConfig& config)
+: _id(id), _name("dxrt_sim" + std::to_string(id)), _config(config),
+  _memSize(config.memSizeMB * 1024 * 1024),
+  // Left uninitialized so the OS only commits the pages the runtime actually touches
+  _memory(new uint8_t[config.memSizeMB * 1024 * 1024]),
+  _coreCount(new std::atomic<uint32_t>[config.npuCores]),
+  _responses(config.numDmaChannels),
+  _respCv(new std::condition_variable[config.numDmaChannels])
+{
+    for (int i = 0; i < _config.npuCores; i++)
+    {
+        _coreCount[i].store(0);
+        _npuThreads.emplace_back(&SimulatorDriverAdapter::npuThread, this, i);
+    }
+    LOG_DXRT_DBG << _name << ": npu " << _config.npuTimeUs << "us x" << _config.npuCores
+        << ", pcie " << _config.pcieMBps << "MB/s x" << _config.numDmaChannels
+        << ", queue " << _config.queueDepth << std::endl;
+}
+
+SimulatorDriverAdapter::~SimulatorDriverAdapter()
+{
+    _shutdown.store(true);
+    terminate(false);
+    {
+        std::unique_lock<std::mutex> lock(_npuLock);
+        _npuCv.notify_all();
+    }
+    for (auto& t : _npuThreads)
+    {
+        if (t.joinable()) t.join();
+    }
+}
+
+int32_t SimulatorDriverAdapter::fail(int err)
+{
+#ifdef __linux__
+    // DeviceCore::Process turns -1 into -errno, like the real ioctl path
+    errno = err;
+    return -1;
+#else
+    return (err == EBUSY) ? ERROR_BUSY : -1;
+#endif
+}
+
+int32_t SimulatorDriverAdapter::IOControl(dxrt_cmd_t request, void* data, uint32_t size, uint32_t sub_cmd)
+{
+    std::ignore = size;
+    switch (request)
+    {
+        case DXRT_CMD_IDENTIFY_DEVICE:
+            return identify(static_cast<dxrt_device_info_t*>(data));
+        case DXRT_CMD_DRV_INFO:
+            return driverInfo(data, sub_cmd);
+        case DXRT_CMD_GET_STATUS:
+            return getStatus(static_cast<dxrt_device_status_t*>(data));
+        case DXRT_CMD_WRITE_MEM:
+            return transfer(static_cast<dxrt_req_meminfo_t*>(data), true);
+        case DXRT_CMD_READ_MEM:
+            return transfer(static_cast<dxrt_req_meminfo_t*>(data), false);
+        case DXRT_CMD_NPU_RUN_REQ:
+            return runRequest(static_cast<const dxrt_request_acc_t*>(data));
+        case DXRT_CMD_NPU_RUN_RESP:
+            return waitResponse(static_cast<dxrt_response_t*>(data));
+        case DXRT_CMD_EVENT:
+            return waitEvent(static_cast<dx_pcie_dev_event_t*>(data));
+        case DXRT_CMD_TERMINATE:
+            terminate(false);
+            return 0;
+        case DXRT_CMD_TERMINATE_EVENT:
+            terminate(true);
+            return 0;
+        default:
+            // START, SCHEDULE, RESET, CUSTOM, PCIE, ... have no observable effect here
+            return 0;
+    }
+}
+
+int32_t SimulatorDriverAdapter::identify(dxrt_device_info_t* info)
+{
+    if (info == nullptr) return fail(EINVAL);
+    dxrt_device_info_t devInfo{};
+    devInfo.type = DEVICE_TYPE_ACCELERATOR;
+    devInfo.variant = 200;  // M1
+    devInfo.mem_addr = SIM_MEM_ADDR;
+    devInfo.mem_size = _memSize;
+    devInfo.num_dma_ch = static_cast<uint32_t>(_config.numDmaChannels);
+    devInfo.fw_ver = 250;
+    devInfo.bd_type = 2;
+    devInfo.ddr_freq = 4200;
+    devInfo.ddr_type = 2;
+#ifdef __linux__
+    devInfo.interface = DEVICE_INTERFACE_ASIC;
+#elif _WIN32
+    devInfo.interface_value = DEVICE_INTERFACE_ASIC;
+#endif
+    std::strncpy(devInfo.fw_ver_suffix, "sim", sizeof(devInfo.fw_ver_suffix) - 1);
+    *info = devInfo;
+    return 0;
+}
+
+int32_t SimulatorDriverAdapter::driverInfo(void* data, uint32_t sub_cmd)
+{
+    // Versions at the write-channel change point so the runtime takes its current code paths
+    constexpr uint32_t SIM_DRIVER_VERSION = 2000;
+    if (data == nullptr) return fail(EINVAL);
+    switch (sub_cmd)
+    {
+        case DRVINFO_CMD_GET_RT_INFO:
+            *static_cast<uint32_t*>(data) = SIM_DRIVER_VERSION;
+            return 0;
+        case DRVINFO_CMD_GET_RT_INFO_V2:
+        {
+            dxrt_rt_drv_version_t ver{};
+            ver.driver_version = SIM_DRIVER_VERSION;
+            std::strncpy(ver.driver_version_suffix, "sim", sizeof(ver.driver_version_suffix) - 1);
+            *static_cast<dxrt_rt_drv_version_t*>(data) = ver;
+            return 0;
+        }
+        case DRVINFO_CMD_GET_PCIE_INFO:
+        {
+            deepx_pcie_info pcie{};
+            pcie.driver_version = SIM_DRIVER_VERSION;
+            pcie.speed = 3;
+            pcie.width = 4;
+            *static_cast<deepx_pcie_info*>(data) = pcie;
+            return 0;
+        }
+        default:
+            return fail(EINVAL);
+    }
+}
+
+int32_t SimulatorDriverAdapter::getStatus(dxrt_device_status_t* status)
+{
+    if (status == nullptr) return fail(EINVAL);
+    dxrt_device_status_t st{};
+    for (int i = 0; i < 3; i++)
+    {
+        st.voltage[i] = 750;
+        st.clock[i] = 1000;
+        st.temperature[i] = 45;
+    }
+    for (int i = 0; i < std::min(_config.npuCores, 4); i++)
+    {
+        st.count[i] = _coreCount[i].load(std::memory_order_relaxed);
+    }
+    *status = st;
+    return 0;
+}
+
+int32_t SimulatorDriverAdapter::transfer(dxrt_req_meminfo_t* req, bool toDevice)
+{
+    if (req == nullptr || req->data == 0) return fail(EINVAL);
+    uint64_t addr = req->base + req->offset;
+    if (addr < SIM_MEM_ADDR || addr - SIM_MEM_ADDR + req->size > _memSize)
+    {
+        LOG_DXRT_ERR(_name << ": " << (toDevice ? "write" : "read") << " out of range 0x"
+            << std::hex << addr << std::dec << " size " << req->size);
+        return fail(EFAULT);
+    }
+    uint8_t* dev = _memory.get() + (addr - SIM_MEM_ADDR);
+    void* host = reinterpret_cast<void*>(req->data);
+
+    // The channel stays busy for the whole transfer, so concurrent DMAs on one
+    // channel serialize while different channels overlap, as on the PCIe link
+    std::unique_lock<std::mutex> lock(_dmaLock[req->ch % MAX_DMA_CHANNELS]);
+    auto start = Clock::now();
+    if (toDevice)
+        std::memcpy(dev, host, req->size);
+    else
+        std::memcpy(host, dev, req->size);
+    if (_config.pcieMBps > 0)
+    {
+        // 1 MB/s moves one byte per microsecond
+        std::this_thread::sleep_until(start + std::chrono::microseconds(req->size / _config.pcieMBps));
+    }
+    return 0;
+}
+
+uint32_t SimulatorDriverAdapter::npuTimeFor(uint32_t taskId) const
+{
+    auto it = _config.taskNpuTimeUs.find(taskId);
+    return (it != _config.taskNpuTimeUs.end()) ? it->second : _config.npuTimeUs;
+}
+
+int32_t SimulatorDriverAdapter::runRequest(const dxrt_request_acc_t* req)
+{
+    if (req == nullptr) return fail(EINVAL);
+    if (_terminated.load(std::memory_order_acquire)) return fail(EPERM);
+    {
+        std::unique_lock<std::mutex> lock(_npuLock);
+        if (_inflight >= _config.queueDepth)
+        {
+            return fail(EBUSY);
+        }
+        _inflight++;
+        _pending.push_back(*req);
+    }
+    _npuCv.notify_one();
+    return 0;
+}
+
+void SimulatorDriverAdapter::npuThread(int core)
+{
+    while (true)
+    {
+        dxrt_request_acc_t req;
+        {
+            std::unique_lock<std::mutex> lock(_npuLock);
+            _npuCv.wait(lock, [this] { return !_pending.empty() || _shutdown.load(); });
+            if (_shutdown.load()) return;
+            req = _pending.front();
+            _pending.pop_front();
+        }
+
+        auto start = Clock::now();
+        std::this_thread::sleep_until(start + std::chrono::microseconds(npuTimeFor(req.task_id)));
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        _coreCount[core].fetch_add(1, std::memory_order_relaxed);
+
+        dxrt_response_t resp;
+        resp.req_id = req.req_id;
+        resp.inf_time = static_cast<uint32_t>(elapsed.count());
+        resp.model_type = static_cast<uint16_t>(req.model_type);
+        resp.proc_id = req.proc_id;
+        resp.queue = req.queue;
+        resp.dma_ch = req.dma_ch;
+        {
+            std::unique_lock<std::mutex> lock(_npuLock);
+            _inflight--;
+        }
+        int ch = static_cast<int>(static_cast<uint32_t>(req.dma_ch) % _responses.size());
+        {
+            std::unique_lock<std::mutex> lock(_respLock);
+            _responses[ch].push_back(resp);
+        }
+        _respCv[ch].notify_one();
+    }
+}
+
+int32_t SimulatorDriverAdapter::waitResponse(dxrt_response_t* resp)
+{
+    if (resp == nullptr) return fail(EINVAL);
+    // Receiver threads pass their index in req_id and only see their channel's completions
+    size_t ch = resp->req_id % _responses.size();
+    std::unique_lock<std::mutex> lock(_respLock);
+    _respCv[ch].wait(lock, [this, ch] {
+        return !_responses[ch].empty() || _terminated.load();
+    });
+    if (_terminated.load()) return fail(EPERM);
+    *resp = _responses[ch].front();
+    _responses[ch].pop_front();
+    return 0;
+}
+
+int32_t SimulatorDriverAdapter::waitEvent(dx_pcie_dev_event_t* event)
+{
+    std::unique_lock<std::mutex> lock(_respLock);
+    _eventCv.wait(lock, [this] { return _eventTerminated.load(); });
+    if (event != nullptr) event->event_type = DXRT_EVENT_NONE;
+    return fail(EPERM);
+}
+
+void SimulatorDriverAdapter::terminate(bool eventOnly)
+{
+    std::unique_lock<std::mutex> lock(_respLock);
+    _eventTerminated.store(true);
+    if (!eventOnly) _terminated.store(true);
+    _eventCv.notify_all();
+    for (size_t i = 0; i < _responses.size(); i++)
+    {
+        _respCv[i].notify_all();
+    }
+}
+
+int32_t SimulatorDriverAdapter::Write(const void* buffer, uint32_t size)
+{
+    std::ignore = buffer;
+    std::ignore = size;
+    return 0;
+}
+
+int32_t SimulatorDriverAdapter::Read(void* buffer, uint32_t size)
+{
+    std::ignore = buffer;
+    std::ignore = size;
+    return 0;
+}
+
+void* SimulatorDriverAdapter::MemoryMap(void *__addr, size_t __len, off_t __offset)
+{
+    std::ignore = __addr;
+    if (__offset < 0 || static_cast<uint64_t>(__offset) + __len > _memSize)
+        return nullptr;
+    return _memory.get() + __offset;
+}
+
+int32_t SimulatorDriverAdapter::Poll()
+{
+    return 0;
+}
+
+}  // namespace dxrt
@@ -21,6 +21,8 @@
 #include <map>
 #include <limits>
 #include <array>
+#include <chrono>
+#include <list>
 #include "memory_service.hpp"
 #include "../include/dxrt/ipc_wrapper/ipc_server_wrapper.h"
 #include "../include/dxrt/ipc_wrapper/ipc_client_wrapper.h"
@@ -54,7 +56,9 @@ enum class DXRT_Schedule
 {
     FIFO,
     RoundRobin,
-    SJF
+    SJF,
+    EDF,
+    WFQ
 };
 
 
@@ -74,6 +78,22 @@ class DxrtService
     dxrt::IPCServerMessage HandleViewMemory(const dxrt::IPCClientMessage& clientMessage);
     dxrt::IPCServerMessage HandleViewAvailableDevice(const dxrt::IPCClientMessage& clientMessage);
     dxrt::IPCServerMessage HandleGetUsage(const dxrt::IPCClientMessage& clientMessage);
+    void HandleAcquireModelMemory(const dxrt::IPCClientMessage& clientMessage);
+    bool TryAcquireModelMemory(const dxrt::IPCClientMessage& clientMessage, dxrt::IPCServerMessage& retMsg);
+    void HandleModelMemoryReady(const dxrt::IPCClientMessage& clientMessage);
+    void HandleGetMemoryBatch(const dxrt::IPCClientMessage& clientMessage);
+    bool TryAllocateBatch(const dxrt::IPCClientMessage& clientMessage, dxrt::IPCServerMessage& retMsg);
+    void RetryPendingAllocations();
+
+    // GET_MEMORY_BATCH and ACQUIRE_MODEL_MEMORY requests waiting for memory or for the upload of
+    // an identical model; retried whenever memory is freed or a model becomes resident
+    struct PendingAllocation
+    {
+        dxrt::IPCClientMessage request;
+        std::chrono::steady_clock::time_point deadline;
+    };
+    std::list<PendingAllocation> _pendingAllocs;
+    std::mutex _pendingAllocMutex;
 
     bool HandleTaskInit(const dxrt::IPCClientMessage& clientMessage);
     void HandleTaskDeInit(const dxrt::IPCClientMessage& clientMessage);
@@ -85,8 +105,10 @@ class DxrtService
 
  public:
     void Process(const dxrt::IPCClientMessage& clientMessage);
-    explicit DxrtService(DXRT_Schedule scheduler_option = DXRT_Schedule::FIFO);
-    explicit DxrtService(std::vector<std::shared_ptr<dxrt::ServiceDevice> > devices_, DXRT_Schedule scheduler_option);
+    explicit DxrtService(DXRT_Schedule scheduler_option = DXRT_Schedule::FIFO,
+        const dxrt::FairShareTable& shares = dxrt::FairShareTable());
+    DxrtService(std::vector<std::shared_ptr<dxrt::ServiceDevice> > devices_, DXRT_Schedule scheduler_option,
+        const dxrt::FairShareTable& shares);
     void onCompleteInference(const dxrt::dxrt_response_t& response, int deviceId);
     void ErrorBroadCastToClient(dxrt::dxrt_server_err_t err, uint32_t errCode, int deviceId);
 
@@ -118,8 +140,9 @@ class DxrtService
 
 };
 
-DxrtService::DxrtService(std::vector<std::shared_ptr<dxrt::ServiceDevice> > devices_, DXRT_Schedule scheduler_option)
-: _ipcServerWrapper(dxrt::IPCDefaultType()), _devices(devices_)
+DxrtService::DxrtService(std::vector<std::shared_ptr<dxrt::ServiceDevice> > devices_, DXRT_Schedule scheduler_option,
+    const dxrt::FairShareTable& shares)
+: _ipcServerWrapper(dxrt::IPCServerDefaultType()), _devices(devices_)
 {
     switch (scheduler_option)
     {
@@ -129,6 +152,12 @@ DxrtService::DxrtService(std::vector<std::shared_ptr<dxrt::ServiceDevice> > devi
         case DXRT_Schedule::SJF:
             _scheduler = make_shared<SJFSchedulerService>(devices_);
             break;
+        case DXRT_Schedule::EDF:
+            _scheduler = make_shared<DeadlineSchedulerService>(devices_);
+            break;
+        case DXRT_Schedule::WFQ:
+            _scheduler = make_shared<WeightedFairSchedulerService>(devices_, shares);
+            break;
         case DXRT_Schedule::FIFO:
         default:
             _scheduler = make_shared<FIFOSchedulerService>(devices_);
@@ -208,8 +237,8 @@ DxrtService::DxrtService(std::vector<std::shared_ptr<dxrt::ServiceDevice> > devi
     }
 }
 
-DxrtService::DxrtService(DXRT_Schedule scheduler_option)
-: DxrtService(dxrt::ServiceDevice::CheckServiceDevices(), scheduler_option)
+DxrtService::DxrtService(DXRT_Schedule scheduler_option, const dxrt::FairShareTable& shares)
+: DxrtService(dxrt::ServiceDevice::CheckServiceDevices(), scheduler_option, shares)
 {
 
 }
@@ -836,12 +865,156 @@ dxrt::IPCServerMessage DxrtService::HandleGetUsage(const dxrt::IPCClientMessage&
     double result = _devices[clientMessage.deviceId]->getUsage(clientMessage.data);
     retMsg.code = dxrt::RESPONSE_CODE::GET_USAGE_RESULT;
     retMsg.data = result * 1000;
+    retMsg.deadline = _scheduler->GetDeadlineStats(clientMessage.deviceId);
     retMsg.result = 0;
 
     retMsg.deviceId = clientMessage.deviceId;
     retMsg.msgType = clientMessage.msgType;
     return retMsg;
 }
+bool DxrtService::TryAcquireModelMemory(const dxrt::IPCClientMessage& clientMessage, dxrt::IPCServerMessage& retMsg)
+{
+    dxrt::ModelMemoryRegion region;
+    auto memService = dxrt::MemoryService::getInstance(clientMessage.deviceId);
+    if (memService != nullptr)
+    {
+        region = memService->AcquireModelMemory(dxrt::GetModelMemoryKey(clientMessage), clientMessage.pid,
+            clientMessage.taskId);
+    }
+    else
+    {
+        LOG_DXRT_S_ERR("MemoryService not found for device " + std::to_string(clientMessage.deviceId));
+    }
+
+    retMsg.code = dxrt::RESPONSE_CODE::CONFIRM_MEMORY_ALLOCATION;
+    retMsg.data = (static_cast<uint64_t>(region.rmapOffset) << 32) | (static_cast<uint64_t>(region.weightOffset) & 0xFFFFFFFFULL);
+    retMsg.deviceId = clientMessage.deviceId;
+    retMsg.msgType = clientMessage.msgType;
+    retMsg.seqId = clientMessage.seqId;
+    retMsg.result = static_cast<uint32_t>(region.state);
+    return region.state == dxrt::ModelMemoryRegion::State::ALLOCATED ||
+           region.state == dxrt::ModelMemoryRegion::State::RESIDENT;
+}
+void DxrtService::HandleAcquireModelMemory(const dxrt::IPCClientMessage& clientMessage)
+{
+    {
+        std::lock_guard<std::mutex> lock(_pidSetMutex);
+        _pid_set.insert(clientMessage.pid);
+    }
+
+    dxrt::IPCServerMessage retMsg;
+    if (TryAcquireModelMemory(clientMessage, retMsg) || clientMessage.alloc.waitMs == 0 ||
+        dxrt::MemoryService::getInstance(clientMessage.deviceId) == nullptr)
+    {
+        _ipcServerWrapper.SendToClient(retMsg);
+        return;
+    }
+
+    // Out of memory or another process is uploading the same model: answer once that changes
+    LOG_DXRT_S_DBG << "Model memory for Task " << clientMessage.taskId << ", PID " << clientMessage.pid
+                   << " waits up to " << clientMessage.alloc.waitMs << "ms" << endl;
+    std::lock_guard<std::mutex> lock(_pendingAllocMutex);
+    _pendingAllocs.push_back({clientMessage,
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(clientMessage.alloc.waitMs)});
+}
+void DxrtService::HandleModelMemoryReady(const dxrt::IPCClientMessage& clientMessage)
+{
+    auto memService = dxrt::MemoryService::getInstance(clientMessage.deviceId);
+    if (memService != nullptr)
+    {
+        memService->MarkModelMemoryResident(dxrt::GetModelMemoryKey(clientMessage));
+    }
+}
+bool DxrtService::TryAllocateBatch(const dxrt::IPCClientMessage& clientMessage, dxrt::IPCServerMessage& retMsg)
+{
+    const dxrt::IPCAllocBatch& batch = clientMessage.alloc;
+    retMsg.code = dxrt::RESPONSE_CODE::CONFIRM_MEMORY_ALLOCATION;
+    retMsg.deviceId = clientMessage.deviceId;
+    retMsg.msgType = clientMessage.msgType;
+    retMsg.seqId = clientMessage.seqId;
+    retMsg.result = static_cast<uint32_t>(-1);
+    retMsg.alloc.count = 0;
+
+    auto memService = dxrt::MemoryService::getInstance(clientMessage.deviceId);
+    if (memService == nullptr || batch.count == 0 || batch.count > dxrt::IPC_ALLOC_BATCH_MAX)
+    {
+        LOG_DXRT_S_ERR("Invalid batch allocation request: device " + std::to_string(clientMessage.deviceId) +
+                       ", count " + std::to_string(batch.count));
+        return false;
+    }
+
+    std::vector<uint64_t> sizes(batch.regions, batch.regions + batch.count);
+    std::vector<uint64_t> addrs = memService->AllocateBatch(sizes, batch.backward != 0,
+        clientMessage.pid, clientMessage.taskId);
+    if (addrs.empty())
+        return false;
+
+    retMsg.result = 0;
+    retMsg.alloc.count = batch.count;
+    retMsg.alloc.backward = batch.backward;
+    std::copy(addrs.begin(), addrs.end(), retMsg.alloc.regions);
+    return true;
+}
+void DxrtService::HandleGetMemoryBatch(const dxrt::IPCClientMessage& clientMessage)
+{
+    {
+        std::lock_guard<std::mutex> lock(_pidSetMutex);
+        _pid_set.insert(clientMessage.pid);
+    }
+
+    dxrt::IPCServerMessage retMsg;
+    const bool validCount = clientMessage.alloc.count > 0 && clientMessage.alloc.count <= dxrt::IPC_ALLOC_BATCH_MAX;
+    if (TryAllocateBatch(clientMessage, retMsg) || !validCount || clientMessage.alloc.waitMs == 0)
+    {
+        _ipcServerWrapper.SendToClient(retMsg);
+        return;
+    }
+
+    // Not enough memory now: park the request instead of making the client poll
+    LOG_DXRT_S_DBG << "Batch allocation for PID " << clientMessage.pid << " waits up to "
+                   << clientMessage.alloc.waitMs << "ms for free memory" << endl;
+    std::lock_guard<std::mutex> lock(_pendingAllocMutex);
+    _pendingAllocs.push_back({clientMessage,
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(clientMessage.alloc.waitMs)});
+}
+void DxrtService::RetryPendingAllocations()
+{
+    std::lock_guard<std::mutex> lock(_pendingAllocMutex);
+    const auto now = std::chrono::steady_clock::now();
+    // Oldest first, so an early large request is not starved by later small ones
+    for (auto it = _pendingAllocs.begin(); it != _pendingAllocs.end();)
+    {
+        dxrt::IPCServerMessage retMsg;
+        const bool isModel = it->request.code == dxrt::REQUEST_CODE::ACQUIRE_MODEL_MEMORY;
+        const bool done = isModel ? TryAcquireModelMemory(it->request, retMsg) : TryAllocateBatch(it->request, retMsg);
+        if (done || now >= it->deadline)
+        {
+            if (!done && isModel)
+            {
+                LOG_DXRT_S_ERR("Model memory for Task " + std::to_string(it->request.taskId) + ", PID " +
+                               std::to_string(it->request.pid) + " timed out");
+                // a PENDING waiter holds a reference; the task has nothing else allocated yet
+                if (retMsg.result == static_cast<uint32_t>(dxrt::ModelMemoryRegion::State::PENDING))
+                {
+                    dxrt::MemoryService::getInstance(it->request.deviceId)->DeallocateTask(it->request.pid,
+                        it->request.taskId);
+                }
+                retMsg.result = static_cast<uint32_t>(dxrt::ModelMemoryRegion::State::FAILED);
+            }
+            else if (!done)
+            {
+                LOG_DXRT_S_ERR("Batch allocation for PID " + std::to_string(it->request.pid) +
+                               " timed out waiting for free memory");
+            }
+            _ipcServerWrapper.SendToClient(retMsg);
+            it = _pendingAllocs.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
 void DxrtService::HandleDeallocateTaskMemory(const dxrt::IPCClientMessage& clientMessage)
 {
     pid_t pid = clientMessage.pid;
@@ -1009,8 +1182,13 @@ void DxrtService::Process(const dxrt::IPCClientMessage& clientMessage)
         }
         case dxrt::REQUEST_CODE::FREE_MEMORY: {
             serverMessage = HandleFreeMemory(clientMessage);
+            RetryPendingAllocations();
             break;
         }
+        case dxrt::REQUEST_CODE::GET_MEMORY_BATCH: {
+            HandleGetMemoryBatch(clientMessage);
+            return;
+        }
         case dxrt::REQUEST_CODE::REQUEST_SCHEDULE_INFERENCE: {
             HandleRequestScheduledInference(clientMessage);
             return;
@@ -1034,10 +1212,12 @@ void DxrtService::Process(const dxrt::IPCClientMessage& clientMessage)
         }
         case dxrt::REQUEST_CODE::DEALLOCATE_TASK_MEMORY: {
             HandleDeallocateTaskMemory(clientMessage);
+            RetryPendingAllocations();
             return;
         }
         case dxrt::REQUEST_CODE::PROCESS_DEINIT: {
             HandleProcessDeInit(clientMessage);
+            RetryPendingAllocations();
             break;
         }
         case dxrt::REQUEST_CODE::DEVICE_RESET: {
@@ -1061,6 +1241,17 @@ void DxrtService::Process(const dxrt::IPCClientMessage& clientMessage)
             serverMessage = HandleGetUsage(clientMessage);
             break;
         }
+        case dxrt::REQUEST_CODE::ACQUIRE_MODEL_MEMORY:
+        {
+            HandleAcquireModelMemory(clientMessage);
+            return;
+        }
+        case dxrt::REQUEST_CODE::MODEL_MEMORY_READY:
+        {
+            HandleModelMemoryReady(clientMessage);
+            RetryPendingAllocations();
+            return;
+        }
         default: {
             serverMessage.msgType = clientMessage.msgType;
             serverMessage.code = dxrt::RESPONSE_CODE::INVALID_REQUEST_CODE;
@@ -1204,6 +1395,10 @@ void DxrtService::dequeueAllClientMessageQueue(long msgType)
     dxrt::IPCClientWrapper clientWrapper(dxrt::IPCDefaultType(), msgType);
     clientWrapper.ClearMessages();  // clear remained messages
     clientWrapper.Close();  // close
+
+    // drop the shared ring connections of the async and sync clients, if they had any
+    _ipcServerWrapper.RemoveClient(msgType);
+    _ipcServerWrapper.RemoveClient(msgType + dxrt::IPCClientWrapper::MAX_PID);
 }
 
 int DxrtService::GetDeviceIdByProcId(int procId)
@@ -1396,6 +1591,12 @@ void DxrtService::handle_process_die(pid_t procId)
 
     // 2. Remove all client messages for this process
     dequeueAllClientMessageQueue(procId);
+    {
+        std::lock_guard<std::mutex> lock(_pendingAllocMutex);
+        _pendingAllocs.remove_if([procId](const PendingAllocation& pending) {
+            return pending.request.pid == procId;
+        });
+    }
 
     // 3. Collect all (deviceId, taskId) for this procId
     std::vector<std::pair<int, int>> device_task_list;
@@ -1522,6 +1723,9 @@ void DxrtService::die_check_thread()
             }
         }
 
+        // Memory of dead processes is free now; also times out requests past their deadline
+        RetryPendingAllocations();
+
         // Update device usage
         for (size_t i = 0; i < _devices.size(); i++)
         {
@@ -1568,8 +1772,11 @@ int DXRT_API dxrt_service_main(int argc, char* argv[])
 {
     cxxopts::Options options("dxrtd", "dxrtd");
     std::string scheduler_option_str;
+    std::string shares_path;
     options.add_options()
-        ("s, scheduler", "Scheduler Mode(FIFO, RoundRobin, SJF)", cxxopts::value<std::string>(scheduler_option_str));
+        ("s, scheduler", "Scheduler Mode(FIFO, RoundRobin, SJF, EDF, WFQ)", cxxopts::value<std::string>(scheduler_option_str))
+        ("w, shares", "Share file of the WFQ scheduler: '<process name | cgroup path | pid> <weight>' per line",
+            cxxopts::value<std::string>(shares_path));
 
     auto cmd = options.parse(argc, argv);
 
@@ -1590,13 +1797,33 @@ int DXRT_API dxrt_service_main(int argc, char* argv[])
 
         scheduler_option = DXRT_Schedule::SJF;
     }
+    else if (scheduler_option_str == "EDF")
+    {
+        LOG_DXRT_S << "Uses Priority / Earliest Deadline First Scheduler\n";
+        scheduler_option = DXRT_Schedule::EDF;
+    }
+    else if (scheduler_option_str == "WFQ")
+    {
+        LOG_DXRT_S << "Uses Weighted Fair Queuing Scheduler\n";
+        scheduler_option = DXRT_Schedule::WFQ;
+    }
     else
     {
         LOG_DXRT_S << "Uses Default FIFO Scheduler\n";
         scheduler_option = DXRT_Schedule::FIFO;
     }
 
-    DxrtService service(scheduler_option);
+    dxrt::FairShareTable shares;
+    if (!shares_path.empty())
+    {
+        if (shares.Load(shares_path) != 0)
+        {
+            return -1;
+        }
+        LOG_DXRT_S << "Loaded " << shares.Size() << " fair share entries from " << shares_path << "\n";
+    }
+
+    DxrtService service(scheduler_option, shares);
     service_dispose = &service;
 
 
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "fair_share_queue.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace dxrt {
+
+void FairShareQueue::Push(int procId, int reqId, uint32_t cost, uint32_t weight)
+{
+    Flow& flow = _flows[procId];
+    flow.weight = std::max(weight, 1u);
+    if (flow.requests.empty())
+    {
+        // idle flows restart at the current virtual time
+        flow.finish = std::max(flow.finish, _virtualTime);
+    }
+    flow.requests.emplace_back(reqId, cost);
+    _pending++;
+}
+
+bool FairShareQueue::Pop(int& procId, int& reqId)
+{
+    auto next = _flows.end();
+    for (auto it = _flows.begin(); it != _flows.end(); ++it)
+    {
+        if (!it->second.requests.empty() &&
+            (next == _flows.end() || it->second.finish < next->second.finish))
+        {
+            next = it;
+        }
+    }
+    if (next == _flows.end())
+    {
+        return false;
+    }
+
+    Flow& flow = next->second;
+    uint32_t cost = flow.requests.front().second;
+    procId = next->first;
+    reqId = flow.requests.front().first;
+    flow.requests.pop_front();
+    _pending--;
+
+    // start tag of the request in service is the system virtual time
+    _virtualTime = flow.finish;
+    flow.finish += static_cast<double>(cost) / flow.weight;
+    flow.charged += cost;
+    return true;
+}
+
+void FairShareQueue::Erase(int procId)
+{
+    auto it = _flows.find(procId);
+    if (it != _flows.end())
+    {
+        _pending -= it->second.requests.size();
+        _flows.erase(it);
+    }
+}
+
+double FairShareQueue::Charged(int procId) const
+{
+    auto it = _flows.find(procId);
+    return it == _flows.end() ? 0 : it->second.charged;
+}
+
+int FairShareTable::Load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        LOG_DXRT_S_ERR("Cannot open share file " + path);
+        return -1;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(file, line))
+    {
+        lineNo++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string key;
+        int64_t weight = 0;
+        if (!(fields >> key))
+        {
+            continue;
+        }
+        if (!(fields >> weight) || weight < 1 || weight > 10000)
+        {
+            LOG_DXRT_S_ERR(path + ":" + std::to_string(lineNo) + ": expected '<name|cgroup|pid> <weight 1..10000>'");
+            return -1;
+        }
+        if (key[0] == '/')
+        {
+            if (key.size() > 1 && key.back() == '/') key.pop_back();
+            _byCgroup[key] = static_cast<uint32_t>(weight);
+        }
+        else if (key.size() < 10 && std::all_of(key.begin(), key.end(), ::isdigit))
+        {
+            _byPid[std::stoi(key)] = static_cast<uint32_t>(weight);
+        }
+        else
+        {
+            _byName[key] = static_cast<uint32_t>(weight);
+        }
+    }
+    return 0;
+}
+
+uint32_t FairShareTable::Resolve(int pid) const
+{
+    auto pidIt = _byPid.find(pid);
+    if (pidIt != _byPid.end())
+    {
+        return pidIt->second;
+    }
+
+    if (!_byCgroup.empty())
+    {
+        // cgroup v2 unified hierarchy: "0::/path"
+        std::ifstream cgroupFile("/proc/" + std::to_string(pid) + "/cgroup");
+        std::string line;
+        while (std::getline(cgroupFile, line))
+        {
+            if (line.compare(0, 3, "0::") != 0)
+            {
+                continue;
+            }
+            std::string path = line.substr(3);
+            while (!path.empty())
+            {
+                auto it = _byCgroup.find(path);
+                if (it != _byCgroup.end())
+                {
+                    return it->second;
+                }
+                if (path == "/") break;
+                size_t slash = path.rfind('/');
+                path = slash == 0 ? "/" : path.substr(0, slash);
+            }
+        }
+    }
+
+    if (!_byName.empty())
+    {
+        std::ifstream commFile("/proc/" + std::to_string(pid) + "/comm");
+        std::string name;
+        if (std::getline(commFile, name))
+        {
+            auto it = _byName.find(name);
+            if (it != _byName.end())
+            {
+                return it->second;
+            }
+        }
+    }
+    return FairShareQueue::DEFAULT_WEIGHT;
+}
+
+}  // namespace dxrt
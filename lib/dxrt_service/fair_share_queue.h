@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+#include "dxrt/common.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dxrt {
+
+// Start-time fair queuing of one device's pending requests across processes.
+// Each process is a flow with a weight; dispatching a request advances the flow's virtual time by
+// cost / weight, and the backlogged flow with the smallest virtual start time is served next.
+// A flow returning from idle starts at the current virtual time, so idling does not bank credit.
+// Kept free of device state so the fairness simulator can drive it directly.
+class DXRT_API FairShareQueue
+{
+ public:
+    static constexpr uint32_t DEFAULT_WEIGHT = 100;
+
+    void Push(int procId, int reqId, uint32_t cost, uint32_t weight);
+    bool Pop(int& procId, int& reqId);
+    bool Empty() const { return _pending == 0; }
+    size_t Size() const { return _pending; }
+    void Erase(int procId);
+
+    // accumulated charge of a process in cost units (virtual time scaled back by its weight)
+    double Charged(int procId) const;
+
+ private:
+    struct Flow
+    {
+        std::deque<std::pair<int, uint32_t> > requests;  // reqId, cost
+        double finish = 0;     // virtual finish time of the last dispatched request
+        double charged = 0;
+        uint32_t weight = DEFAULT_WEIGHT;
+    };
+    std::map<int, Flow> _flows;
+    double _virtualTime = 0;
+    size_t _pending = 0;
+};
+
+// Weights of processes for the fair-share scheduler, read from a share file:
+//   # <process name | cgroup path | pid> <weight 1..10000>
+//   safety_camera                    400
+//   /system.slice/analytics.service  50
+// A cgroup entry applies to its whole subtree (the longest matching path wins), a pid entry
+// overrides everything else. Processes without an entry get FairShareQueue::DEFAULT_WEIGHT.
+class DXRT_API FairShareTable
+{
+ public:
+    int Load(const std::string& path);
+    uint32_t Resolve(int pid) const;
+    size_t Size() const { return _byName.size() + _byCgroup.size() + _byPid.size(); }
+
+ private:
+    std::map<std::string, uint32_t> _byName;
+    std::map<std::string, uint32_t> _byCgroup;
+    std::map<int, uint32_t> _byPid;
+};
+
+}  // namespace dxrt
@@ -157,6 +157,8 @@ void MemoryService::DeallocateAll(pid_t pid)
 {
     std::lock_guard<std::mutex> lk(_lock);
 
+    _modelMemory.ReleaseProcess(pid, [this](uint64_t addr) { deallocateNoLock(addr); });
+
     // Deallocate task-based memory
     auto taskIt = _taskAllocInfo.find(pid);
     if (taskIt != _taskAllocInfo.end()) {
@@ -303,6 +305,33 @@ uint64_t MemoryService::BackwardAllocateForTask(uint64_t size, pid_t pid, int ta
     return addr;
 }
 
+std::vector<uint64_t> MemoryService::AllocateBatch(const std::vector<uint64_t>& sizes, bool backward, pid_t pid, int taskId)
+{
+    std::lock_guard<std::mutex> lk(_lock);
+
+    std::vector<uint64_t> addrs;
+    addrs.reserve(sizes.size());
+    for (uint64_t size : sizes)
+    {
+        uint64_t addr = backward ? _mem->BackwardAllocate(size) : _mem->Allocate(size);
+        if (addr == static_cast<uint64_t>(-1))
+        {
+            LOG_DXRT_S_DBG << "Batch allocation of " << sizes.size() << " regions failed at size " << size
+                           << " for Task " << taskId << ", PID " << pid << endl;
+            for (uint64_t done : addrs)
+                _mem->Deallocate(done);
+            return {};
+        }
+        addrs.push_back(addr);
+    }
+
+    auto& tracked = (taskId != -1) ? _taskAllocInfo[pid][taskId] : _legacyAllocInfo[pid];
+    tracked.insert(addrs.begin(), addrs.end());
+    LOG_DXRT_S_DBG << addrs.size() << " regions are " << (backward ? "backward " : "") << "allocated for Task "
+                   << taskId << ", PID " << pid << endl;
+    return addrs;
+}
+
 bool MemoryService::DeallocateTask(pid_t pid, int taskId)
 {
     if (ENABLE_MEMORY_TRACE_LOGS) {
@@ -310,6 +339,9 @@ bool MemoryService::DeallocateTask(pid_t pid, int taskId)
     }
     std::lock_guard<std::mutex> lk(_lock);
 
+    // Shared model parameters are freed only when their last task goes away
+    _modelMemory.Release(pid, taskId, [this](uint64_t addr) { deallocateNoLock(addr); });
+
     auto pidIt = _taskAllocInfo.find(pid);
     if (pidIt == _taskAllocInfo.end())
     {
@@ -378,6 +410,8 @@ void MemoryService::DeallocateAllTasks(pid_t pid)
 {
     std::lock_guard<std::mutex> lk(_lock);
 
+    _modelMemory.ReleaseProcess(pid, [this](uint64_t addr) { deallocateNoLock(addr); });
+
     auto pidIt = _taskAllocInfo.find(pid);
     if (pidIt == _taskAllocInfo.end())
     {
@@ -419,6 +453,39 @@ bool MemoryService::IsTaskValid(pid_t pid, int taskId) const
     return true;
 }
 
+ModelMemoryRegion MemoryService::AcquireModelMemory(const ModelMemoryKey& key, pid_t pid, int taskId)
+{
+    std::lock_guard<std::mutex> lk(_lock);
+
+    ModelMemoryRegion region = _modelMemory.Acquire(key, pid, taskId,
+        [this](uint64_t size) { return _mem->BackwardAllocate(size); },
+        [this](uint64_t addr) { deallocateNoLock(addr); });
+
+    if (region.state != ModelMemoryRegion::State::FAILED)
+    {
+        // The task owns no private block yet, but it must be known for IsTaskValid/DeallocateTask;
+        // a PENDING task holds a reference too and is released like the others
+        _taskAllocInfo[pid][taskId];
+        LOG_DXRT_S_DBG << "Model memory for Task " << taskId << ", PID " << pid
+                       << (region.state == ModelMemoryRegion::State::RESIDENT ? " shared"
+                           : region.state == ModelMemoryRegion::State::PENDING ? " pending" : " allocated")
+                       << ": rmap " << hex << region.rmapOffset << ", weight " << region.weightOffset << dec << endl;
+    }
+    else if (region.state == ModelMemoryRegion::State::FAILED)
+    {
+        LOG_DXRT_S_ERR("Model memory allocation failed for Task " + std::to_string(taskId) +
+                       ", PID " + std::to_string(pid) + ", size " +
+                       std::to_string((static_cast<uint64_t>(key.rmapSize) + key.weightSize) / (1024*1024)) + "MB");
+    }
+    return region;
+}
+
+void MemoryService::MarkModelMemoryResident(const ModelMemoryKey& key)
+{
+    std::lock_guard<std::mutex> lk(_lock);
+    _modelMemory.MarkResident(key);
+}
+
 // Memory fragmentation prevention and cleanup function
 void MemoryService::OptimizeMemory()
 {
@@ -456,6 +523,7 @@ void MemoryService::PrintMemoryStatus() const
         LOG_DXRT_S << "  PID " << pid << ": " << pidPair.second.size()
                    << " tasks, " << totalAllocations << " allocations" << endl;
     }
+    LOG_DXRT_S << "  Shared model regions: " << _modelMemory.size() << endl;
 }
 
 bool MemoryService::DeallocateAllForProcess(pid_t pid)
@@ -465,6 +533,8 @@ bool MemoryService::DeallocateAllForProcess(pid_t pid)
     bool taskMemoryFound = false;
     bool legacyMemoryFound = false;
 
+    _modelMemory.ReleaseProcess(pid, [this](uint64_t addr) { deallocateNoLock(addr); });
+
     // Deallocate task-based memory
     auto taskIt = _taskAllocInfo.find(pid);
     if (taskIt != _taskAllocInfo.end()) {
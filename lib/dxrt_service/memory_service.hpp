@@ -18,6 +18,7 @@
 #include <mutex>
 //#include "dxrt/common.h"
 #include "dxrt/memory.h"
+#include "dxrt/model_memory_cache.h"
 
 namespace dxrt {
 
@@ -35,6 +36,8 @@ class MemoryService
 
     uint64_t AllocateForTask(uint64_t size, pid_t pid, int taskId);
     uint64_t BackwardAllocateForTask(uint64_t size, pid_t pid, int taskId);
+    // All of sizes or nothing, tracked per task (taskId != -1) or per pid; empty on failure
+    std::vector<uint64_t> AllocateBatch(const std::vector<uint64_t>& sizes, bool backward, pid_t pid, int taskId);
     bool DeallocateTask(pid_t pid, int taskId);
     void DeallocateAllTasks(pid_t pid);
     bool DeallocateAllForProcess(pid_t pid);
@@ -42,6 +45,10 @@ class MemoryService
 
     bool IsTaskValid(pid_t pid, int taskId) const;
 
+    // Model parameters shared by every task (of any process) that loads the same rmap/weight
+    ModelMemoryRegion AcquireModelMemory(const ModelMemoryKey& key, pid_t pid, int taskId);
+    void MarkModelMemoryResident(const ModelMemoryKey& key);
+
     void OptimizeMemory();
     void PrintMemoryStatus() const;
     int deviceId() const { return _deviceId; }
@@ -55,6 +62,9 @@ private:
 
     std::map<pid_t, std::map<int, std::set<uint64_t>>> _taskAllocInfo;
 
+    ModelMemoryCache _modelMemory;
+    void deallocateNoLock(uint64_t addr) { _mem->Deallocate(addr); }
+
     static std::vector<MemoryService*> _instances;
     mutable std::mutex _lock;
 
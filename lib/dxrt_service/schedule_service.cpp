@@ -9,6 +9,7 @@
 
 #include "dxrt/common.h"
 #include <algorithm>
+#include <chrono>
 #include <limits>
 #include <memory>
 #include <iostream>
@@ -25,6 +26,7 @@ SchedulerService::SchedulerService(std::vector<std::shared_ptr<dxrt::ServiceDevi
 :_devices(devices_)
 {
     _loads =  std::vector<std::atomic<int>>(_devices.size());
+    _deadlineStats = std::vector<dxrt::IPCDeadlineStats>(_devices.size());
 }
 
 SchedulerService::~SchedulerService()
@@ -140,6 +142,7 @@ void SchedulerService::FinishJobs(int deviceId, const dxrt::dxrt_response_t& res
 
 
         int task_id = it->second[req_id].task_id;
+        updateDeadlineStats(deviceId, it->second[req_id]);
 
         updateTaskInferenceTime(proc_id, task_id, response_data.inf_time);
         it->second.erase(req_id);
@@ -153,6 +156,36 @@ void SchedulerService::FinishJobs(int deviceId, const dxrt::dxrt_response_t& res
     }
 }
 
+void SchedulerService::updateDeadlineStats(int deviceId, const dxrt::dxrt_request_acc_t& req)
+{
+    if (req.deadline_us == 0)
+    {
+        return;
+    }
+    uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    dxrt::IPCDeadlineStats& stats = _deadlineStats[deviceId];
+    stats.requests++;
+    if (now > req.deadline_us)
+    {
+        uint64_t lateness = now - req.deadline_us;
+        stats.misses++;
+        stats.maxLatenessUs = std::max(stats.maxLatenessUs, lateness);
+        LOG_DXRT_S_DBG << "Deadline missed - Process: " << req.proc_id << " Request Id: " << req.req_id
+            << " by " << lateness << "us" << endl;
+    }
+}
+
+dxrt::IPCDeadlineStats SchedulerService::GetDeadlineStats(int deviceId)
+{
+    std::unique_lock<std::mutex> lk(_lock);
+    if (deviceId < 0 || deviceId >= static_cast<int>(_deadlineStats.size()))
+    {
+        return dxrt::IPCDeadlineStats();
+    }
+    return _deadlineStats[deviceId];
+}
+
 void SchedulerService::SetCallback(std::function<void(const dxrt::dxrt_response_t&, int)> f)
 {
     _callBack = f;
@@ -686,3 +719,124 @@ bool operator<(const SJFSchedulerService::request_elem& a, const SJFSchedulerSer
     return a.time > b.time;
 }
 
+DeadlineSchedulerService::DeadlineSchedulerService(std::vector<std::shared_ptr<dxrt::ServiceDevice>> devices_)
+: SchedulerService(devices_), _queues(devices_.size())
+{
+}
+
+DeadlineSchedulerService::~DeadlineSchedulerService() = default;
+
+void DeadlineSchedulerService::schedule(int deviceId)
+{
+    if (_queues[deviceId].empty())
+    {
+        return;
+    }
+    DeadlineSchedulerService::request_elem e = _queues[deviceId].top();
+    _queues[deviceId].pop();
+    LOG_DXRT_DBG << "EDF proc_id " << e.procId << " req_id " << e.requestId
+        << ", priority: " << e.priority << ", deadline: " << e.deadline << endl;
+    doInference(deviceId, e.procId, e.requestId);
+}
+
+void DeadlineSchedulerService::pushRequest(int deviceId, int procId, int reqId, int taskId)
+{
+    std::ignore = taskId;
+    DeadlineSchedulerService::request_elem e;
+    e.priority = 0;
+    e.deadline = std::numeric_limits<uint64_t>::max();
+    e.seq = _seq++;
+    e.procId = procId;
+    e.requestId = reqId;
+
+    auto procIt = _map.find(procId);
+    if (procIt != _map.end())
+    {
+        auto reqIt = procIt->second.find(reqId);
+        if (reqIt != procIt->second.end())
+        {
+            e.priority = reqIt->second.sched_priority;
+            if (reqIt->second.deadline_us != 0)
+            {
+                e.deadline = reqIt->second.deadline_us;
+            }
+        }
+    }
+    _queues[deviceId].push(e);
+}
+
+// priority_queue comparator: true when a is dispatched after b
+bool DeadlineSchedulerService::later::operator()(const request_elem& a, const request_elem& b) const
+{
+    if (a.priority != b.priority)
+    {
+        return a.priority < b.priority;
+    }
+    if (a.deadline != b.deadline)
+    {
+        return a.deadline > b.deadline;
+    }
+    return a.seq > b.seq;
+}
+
+WeightedFairSchedulerService::WeightedFairSchedulerService(std::vector<std::shared_ptr<dxrt::ServiceDevice>> devices_,
+    const dxrt::FairShareTable& shares)
+: InferenceTimeCheckSchedulerService(devices_), _queues(devices_.size()), _shares(shares)
+{
+}
+
+WeightedFairSchedulerService::~WeightedFairSchedulerService() = default;
+
+void WeightedFairSchedulerService::schedule(int deviceId)
+{
+    int proc_id = 0;
+    int req_id = 0;
+    if (!_queues[deviceId].Pop(proc_id, req_id))
+    {
+        return;
+    }
+    LOG_DXRT_DBG << "WFQ proc_id " << proc_id << " req_id " << req_id
+        << ", charged: " << _queues[deviceId].Charged(proc_id) << endl;
+    doInference(deviceId, proc_id, req_id);
+}
+
+void WeightedFairSchedulerService::pushRequest(int deviceId, int procId, int reqId, int taskId)
+{
+    uint32_t cost = getTaskInferenceTime(procId, taskId);
+    if (cost == 0)
+    {
+        cost = DEFAULT_COST_US;
+    }
+    _queues[deviceId].Push(procId, reqId, cost, weightOf(procId));
+}
+
+void WeightedFairSchedulerService::updateTaskInferenceTime(int procId, int taskId, uint32_t time)
+{
+    // moving average, so a process is charged what its tasks currently cost
+    auto key = std::make_pair(procId, taskId);
+    uint32_t& avg = task_time_map[key];
+    avg = (avg == 0) ? time : static_cast<uint32_t>((static_cast<uint64_t>(avg) * 7 + time) / 8);
+}
+
+void WeightedFairSchedulerService::cleanTaskInferenceTime(int procId)
+{
+    InferenceTimeCheckSchedulerService::cleanTaskInferenceTime(procId);
+    for (auto& queue : _queues)
+    {
+        queue.Erase(procId);
+    }
+    _weights.erase(procId);
+}
+
+uint32_t WeightedFairSchedulerService::weightOf(int procId)
+{
+    auto it = _weights.find(procId);
+    if (it != _weights.end())
+    {
+        return it->second;
+    }
+    uint32_t weight = _shares.Resolve(procId);
+    LOG_DXRT_S << "Fair share weight of process " << procId << ": " << weight << endl;
+    _weights[procId] = weight;
+    return weight;
+}
@@ -24,6 +24,8 @@
 #include "service_device.h"
 #include "dxrt/device.h"
 #include "service_error.h"
+#include "fair_share_queue.h"
+#include "dxrt/ipc_wrapper/ipc_message.h"
 
 class SchedulerService
 {
@@ -60,6 +62,9 @@ class SchedulerService
     void ClearRunningRequests(pid_t pid, int deviceId);
     std::vector<int> GetRunningRequestIds(pid_t pid, int deviceId);
 
+    // deadline accounting of completed requests, kept by every policy
+    dxrt::IPCDeadlineStats GetDeadlineStats(int deviceId);
+
  protected:
     virtual void schedule(int deviceId) = 0;
     virtual void pushRequest(int deviceId, int procId, int reqId, int taskId) = 0;
@@ -67,6 +72,7 @@ class SchedulerService
     virtual uint32_t getTaskInferenceTime(int procId, int taskId);
     virtual void cleanTaskInferenceTime(int procId);
     void doInference(int deviceId, int procId, int reqId);
+    void updateDeadlineStats(int deviceId, const dxrt::dxrt_request_acc_t& req);
 
     std::vector<std::atomic<int> > _loads;
     std::map<int,std::atomic<int>> _loadsProc;
@@ -82,6 +88,8 @@ class SchedulerService
     
     // Task validity verification callback
     std::function<bool(pid_t, int, int)> _taskValidator;
+
+    std::vector<dxrt::IPCDeadlineStats> _deadlineStats;  // guarded by _lock
 };
 
 class FIFOSchedulerService : public SchedulerService
@@ -142,4 +150,55 @@ class SJFSchedulerService : public InferenceTimeCheckSchedulerService
     //void updateTaskInferenceTime(int procId, int taskId, uint32_t time) override;
     std::vector<std::priority_queue<request_elem> > request_map;
     std::multimap<int, std::pair<int, int> > key_less_map;
-};
\ No newline at end of file
+};
+
+// Earliest deadline first within strict priority classes. Requests of a higher class are always
+// dispatched before pending requests of a lower class; within a class the earliest deadline goes
+// first, requests without a deadline follow in arrival order.
+class DeadlineSchedulerService : public SchedulerService
+{
+ public:
+    explicit DeadlineSchedulerService(std::vector<std::shared_ptr<dxrt::ServiceDevice>> devices_);
+    ~DeadlineSchedulerService() override;
+    struct request_elem
+    {
+       uint32_t priority;
+       uint64_t deadline;   // UINT64_MAX: none
+       uint64_t seq;
+       int procId;
+       int requestId;
+    };
+    struct later
+    {
+       bool operator()(const request_elem& a, const request_elem& b) const;
+    };
+ protected:
+    void schedule(int deviceId) override;
+    void pushRequest(int deviceId, int procId, int reqId, int taskId) override;
+
+    std::vector<std::priority_queue<request_elem, std::vector<request_elem>, later> > _queues;
+    uint64_t _seq = 0;
+};
+
+// Weighted fair sharing of each device across processes. A request is charged the measured
+// inference time of its task (moving average of task_time_map) divided by the weight of its
+// process, so a process submitting a 40 ms model does not crowd out one submitting a 2 ms model.
+class WeightedFairSchedulerService : public InferenceTimeCheckSchedulerService
+{
+ public:
+    WeightedFairSchedulerService(std::vector<std::shared_ptr<dxrt::ServiceDevice>> devices_,
+        const dxrt::FairShareTable& shares);
+    ~WeightedFairSchedulerService() override;
+    static constexpr uint32_t DEFAULT_COST_US = 1000;  // tasks not measured yet
+
+ protected:
+    void schedule(int deviceId) override;
+    void pushRequest(int deviceId, int procId, int reqId, int taskId) override;
+    void updateTaskInferenceTime(int procId, int taskId, uint32_t time) override;
+    void cleanTaskInferenceTime(int procId) override;
+    uint32_t weightOf(int procId);
+
+    std::vector<dxrt::FairShareQueue> _queues;
+    dxrt::FairShareTable _shares;
+    std::map<int, uint32_t> _weights;
+};
@@ -9,24 +9,55 @@
 
 #include "dxrt/common.h"
 #include "dxrt/fixed_size_buffer.h"
+#include "dxrt/thread_affinity.h"
+#include <cerrno>
 #include <chrono>
 #include <stdexcept>
 #include <cstring>  // for strerror
+#include <tuple>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 static constexpr int MEM_ALIGN_VALUE = 4096;
 
 namespace dxrt {
 
-FixedSizeBuffer::FixedSizeBuffer(int64_t size, int buffer_count)
+FixedSizeBuffer::FixedSizeBuffer(int64_t size, int buffer_count, int numa_node)
 :  _count(buffer_count), _size(size)
 {
     std::unique_lock<std::mutex> lock(_lock);
 
+#ifdef __linux__
+    // Fresh anonymous pages land on the node of the core that touches them first, so they are
+    // touched here from the cores of the node; heap memory may already be backed elsewhere.
+    std::vector<int> nodeCpus = GetNumaNodeCpus(numa_node);
+    _mapped = !nodeCpus.empty() && size > 0;
+    ScopedThreadPlacement placement(_mapped ? nodeCpus : std::vector<int>());
+#else
+    std::ignore = numa_node;
+#endif
+
     _pointers.reserve(_count);
     for (int i = 0; i < _count; i++)
     {
         void* ptr = nullptr;
 #ifdef __linux__
+        if (_mapped)
+        {
+            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) {
+                LOG_DXRT_ERR("Failed to mmap: error=" << errno << " (" << strerror(errno) << ")"
+                             << ", buffer_index=" << i << "/" << _count
+                             << ", size=" << size << " bytes (" << (size / 1024.0 / 1024.0) << " MB)"
+                             << ", numa_node=" << numa_node);
+                DXRT_ASSERT(false, "Memory allocation failed - check system memory availability");
+            }
+            if (placement.applied()) memset(ptr, 0, size);
+            _data.push_back(ptr);
+            _pointers.push_back(ptr);
+            continue;
+        }
         int result = posix_memalign(&ptr, MEM_ALIGN_VALUE, size);
         if (result != 0) {
             LOG_DXRT_ERR("Failed to posix_memalign: error=" << result << " (" << strerror(result) << ")" 
@@ -62,7 +93,8 @@ FixedSizeBuffer::~FixedSizeBuffer()
     for (void* ptr : _data)
     {
 #ifdef __linux__
-        free(ptr);
+        if (_mapped) munmap(ptr, _size);
+        else free(ptr);
 #elif _WIN32
         _aligned_free(ptr);
 #else
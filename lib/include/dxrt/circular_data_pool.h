@@ -9,37 +9,49 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
-#include <mutex>
 #include <vector>
 #include "dxrt/common.h"
+#include "dxrt/mpmc_queue.h"
 #include <iostream>
 
 
 namespace dxrt {
+    /**
+     * @brief Fixed-size pool of reusable objects addressed by index.
+     *
+     * Free indices are kept in a lock-free ring, so pick() and release() are O(1).
+     * The object's _use_flag stays the source of truth: an index popped from the ring
+     * is only handed out after the flag is claimed, so a stale or duplicated index is
+     * simply skipped. T must provide _use_flag, _poolFreeIds and _poolIndex (friend access).
+     */
     template <typename T>
     class DXRT_API CircularDataPool
     {
         std::vector<std::shared_ptr<T>> _dataPool;
-        size_t _headIndex = 0;
-        std::mutex _mutex;
+        // Shared with the pooled objects so a release after the pool is gone stays safe
+        std::shared_ptr<MpmcQueue<int>> _freeIds;
+        std::atomic<size_t> _headIndex{0};
 
     public:
         CircularDataPool(int count)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-
+            // Twice the pool size: an index can be queued again while a stale copy is still in the ring
+            _freeIds = std::make_shared<MpmcQueue<int>>(static_cast<size_t>(count > 0 ? count : 1) * 2);
             for(int i = 0; i < count; ++i)
             {
-                _dataPool.emplace_back(std::make_shared<T>(i));
+                auto data = std::make_shared<T>(i);
+                data->_poolFreeIds = _freeIds;
+                data->_poolIndex = i;
+                _dataPool.emplace_back(data);
+                _freeIds->TryPush(i);
             }
         }
 
         
         ~CircularDataPool()
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-
             for(auto& ptr : _dataPool)
             {
                 ptr.reset();
@@ -50,27 +62,33 @@ namespace dxrt {
 
         size_t GetSize()
         {
-            std::lock_guard<std::mutex> lock(_mutex);
             return _dataPool.size();
         }
 
         // reuse buffer pointer
         std::shared_ptr<T> pick()
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-
             if ( _dataPool.empty() ) return nullptr;
-            for (size_t i = 0; i < _dataPool.size(); ++i)
+
+            int id;
+            while (_freeIds->TryPop(id))
             {
-                std::shared_ptr<T> data = _dataPool[_headIndex];
-                _headIndex++;
-                if ( _headIndex == _dataPool.size() )
+                std::shared_ptr<T>& data = _dataPool[id];
+                bool expected = false;
+                if (data->_use_flag.compare_exchange_strong(expected, true))
                 {
-                    _headIndex = 0;
+                    return data;
                 }
+            }
+
+            // Ring exhausted (or an index was dropped): fall back to scanning the flags
+            size_t size = _dataPool.size();
+            for (size_t i = 0; i < size; ++i)
+            {
+                size_t index = _headIndex.fetch_add(1, std::memory_order_relaxed) % size;
+                std::shared_ptr<T>& data = _dataPool[index];
                 bool expected = false;
-                bool desired = true;
-                if (data->_use_flag.compare_exchange_strong(expected, desired))
+                if (data->_use_flag.compare_exchange_strong(expected, true))
                 {
                     return data;
                 }
@@ -79,9 +97,23 @@ namespace dxrt {
             return nullptr;
 
         }
+
+        /**
+         * @brief Marks obj as free and returns its index to the pool.
+         * Safe to call on an object that is not in use; the index is queued only once per pick.
+         */
+        static void release(T* obj)
+        {
+            if (obj->_use_flag.exchange(false) && obj->_poolFreeIds)
+            {
+                // A full ring only drops the hint; pick() still finds the object by scanning
+                obj->_poolFreeIds->TryPush(obj->_poolIndex);
+            }
+        }
+
         std::shared_ptr<T> GetById(int id)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
+            // _dataPool is never resized after construction, so no lock is needed
             if ( id >= 0 && id < static_cast<int>(_dataPool.size()) )
             {
                 return _dataPool[id];
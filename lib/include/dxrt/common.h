@@ -185,6 +185,38 @@ T vectorProduct(const std::vector<T>& v)
 // Environment variable getters for runtime configuration
 int GetNfhInputWorkerThreads();
 int GetNfhOutputWorkerThreads();
+int GetNfhParallelWorkerThreads();
+
+/** @brief Read-back check applied after model parameters are written to device memory (DXRT_MODEL_VERIFY) */
+enum class ModelVerifyMode
+{
+    OFF,        ///< no read-back
+    SAMPLED,    ///< read back a few windows spread over each region and compare them
+    FULL,       ///< read back and compare every byte (default)
+};
+ModelVerifyMode GetModelVerifyMode();
+
+/** @brief True when DXRT_IPC_TYPE=shm asks for the shared-memory ring transport to dxrt_service */
+bool GetIpcSharedRing();
+
+/** @brief Most queued CPU task requests merged into one ONNX Runtime run (DXRT_CPU_MICRO_BATCH, default 1 = off) */
+int GetCpuMicroBatchSize();
+/** @brief How long a CPU worker waits for more requests to fill a batch (DXRT_CPU_MICRO_BATCH_WAIT_US) */
+int GetCpuMicroBatchWaitUs();
+
+/** @brief Placement of runtime threads and per-task host buffers on multi-socket hosts (DXRT_THREAD_AFFINITY) */
+enum class ThreadAffinityMode
+{
+    OFF,    ///< leave threads and memory to the scheduler (default)
+    NUMA,   ///< device I/O threads and host buffers of a device go to the NUMA node of the card
+};
+ThreadAffinityMode GetThreadAffinityMode();
+/** @brief Cores of the device I/O threads of every device (DXRT_DEVICE_IO_CPUS), empty = NUMA node of the card */
+const std::vector<int>& GetDeviceIoCpus();
+/** @brief Cores of the NFH queue and worker pool threads (DXRT_NFH_CPUS), empty = unpinned */
+const std::vector<int>& GetNfhCpus();
+/** @brief Cores of the CPU task workers and their ONNX Runtime threads (DXRT_CPU_TASK_CPUS), empty = unpinned */
+const std::vector<int>& GetCpuTaskCpus();
 
 
 // ==================== NFH (NPU Format Handler) Configuration ====================
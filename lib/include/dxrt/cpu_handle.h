@@ -19,6 +19,7 @@
 
 #include "dxrt/common.h"
 #include "dxrt/datatype.h"
+#include "dxrt/tensor.h"
 
 #ifdef USE_ORT
 #include <onnxruntime_cxx_api.h>
@@ -30,16 +31,44 @@ class CpuHandleWorker;
 class Request;
 using RequestPtr = std::shared_ptr<Request>;
 
+#ifdef USE_ORT
+DXRT_API ONNXTensorElementDataType convertONNXTensorElementDataType(DataType dataType);
+
+// IoBinding over one set of request buffers; a tensor is only recreated and rebound
+// when its data pointer differs from the previous run on the same slot
+struct DXRT_API CpuIoBindingSlot
+{
+    explicit CpuIoBindingSlot(Ort::Session& session) : binding(session) {}
+    Ort::IoBinding binding;
+    std::vector<void*> inputPtrs;
+    std::vector<void*> outputPtrs;
+    std::vector<Ort::Value> inputValues;
+    std::vector<Ort::Value> outputValues;
+};
+
+// Bindings of one CPU worker thread, keyed by the output buffer of the request,
+// so there is one slot per task output buffer the thread has run on.
+// Batched runs bind one slot per batch size over staging buffers sized for the largest batch.
+struct DXRT_API CpuIoBindingCache
+{
+    const Ort::Session* session = nullptr;
+    std::unordered_map<const void*, std::unique_ptr<CpuIoBindingSlot>> slots;
+    std::unordered_map<int, std::unique_ptr<CpuIoBindingSlot>> batchSlots;
+    std::vector<std::vector<uint8_t>> inputStaging;
+    std::vector<std::vector<uint8_t>> outputStaging;
+};
+#endif
 
 class DXRT_API CpuHandle
 {
 public:
-    CpuHandle(void* data_, int64_t size_, std::string name_, size_t device_num_, int buffer_count_);
+    CpuHandle(const void* data_, int64_t size_, std::string name_, size_t device_num_, int buffer_count_);
     ~CpuHandle();
 #ifdef USE_ORT
     Ort::Env _env;
     Ort::SessionOptions _sessionOptions;
     std::shared_ptr<Ort::Session> _session;
+    Ort::MemoryInfo _memoryInfo{nullptr};
     
     // For DYNAMIC THREAD: store model data for worker session creation
     std::vector<uint8_t> _modelData;
@@ -47,7 +76,15 @@ public:
     
     // Create individual session for worker (DYNAMIC THREAD mode)
     std::shared_ptr<Ort::Session> CreateWorkerSession();
-    void RunWithSession(RequestPtr req, std::shared_ptr<Ort::Session> session);
+    // cache holds the bindings of the calling worker thread; without one every tensor is bound from scratch
+    void RunWithSession(RequestPtr req, std::shared_ptr<Ort::Session> session, CpuIoBindingCache* cache = nullptr);
+    // one ORT run for up to _maxBatch requests: inputs are gathered along the batch dimension and
+    // the outputs scattered back to each request
+    void RunBatchWithSession(const std::vector<RequestPtr>& reqs, std::shared_ptr<Ort::Session> session,
+        CpuIoBindingCache* cache);
+    // inputs[r][i] / outputs[r][i]: buffer of input / output i of request r, in the batch 1 layout
+    void RunBatchBuffers(Ort::Session& session, CpuIoBindingCache& cache,
+        const std::vector<std::vector<void*>>& inputs, const std::vector<std::vector<void*>>& outputs);
 
 #endif
 
@@ -82,6 +119,11 @@ public:
     // Dynamic shape output support
     std::vector<bool> _outputIsDynamic;  // Track which outputs have dynamic shapes
     bool _hasDynamicOutput = false;      // Flag if any output is dynamic
+
+    // Micro-batching: when every input and output has a symbolic leading dimension it is taken as
+    // the batch dimension, shapes above use batch 1 and the worker may merge up to _maxBatch requests
+    int _maxBatch = 1;
+    int _batchWaitUs = 0;
         
     //std::shared_ptr<Buffer> _buffer;
     void* _cpuTaskOutputBufferPtr;
@@ -96,7 +138,10 @@ public:
     // Dynamic output management functions 
     bool DetectDynamicShape(const std::vector<int64_t>& shape) const;
 #ifdef USE_ORT
-    void SetupOutputsWithBinding(RequestPtr req, Ort::IoBinding& binding);
+    CpuIoBindingSlot& GetBindingSlot(CpuIoBindingCache& cache, Ort::Session& session, const void* outputBase);
+    CpuIoBindingSlot& GetBatchSlot(CpuIoBindingCache& cache, Ort::Session& session, int count);
+    void SetupInputsWithBinding(RequestPtr req, CpuIoBindingSlot& slot);
+    void SetupOutputsWithBinding(RequestPtr req, Tensors& reqOutputs, CpuIoBindingSlot& slot);
     void UpdateRequestOutputsFromBinding(RequestPtr req, std::vector<Ort::Value> ortOutputs);
 #endif
 
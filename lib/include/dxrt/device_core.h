@@ -44,6 +44,12 @@ class DXRT_API DeviceCore {
     int Read(dxrt_meminfo_t &);
     int Read(dxrt_meminfo_t &, int ch, bool ctrlCmd = true);
     int ReadDriverData(void *ptr, uint32_t size);
+    /**
+     * @brief Reads back a region written with Write() and checks it against the host copy.
+     * @param meminfo Region as written; data points at the host copy.
+     * @return 0 if the region matches or could not be read back, -1 on mismatch.
+     */
+    int Verify(const dxrt_meminfo_t &meminfo, ModelVerifyMode mode);
     int Wait();
     void Identify(int id_, uint32_t subCmd = 0);
 
@@ -80,6 +86,10 @@ class DXRT_API DeviceCore {
     int GetReadChannel();
     int GetWriteChannel();
 
+    static constexpr uint32_t VERIFY_CHUNK_SIZE = 4 * 1024 * 1024;
+    static constexpr uint32_t VERIFY_SAMPLE_SIZE = 4 * 1024;
+    static constexpr int VERIFY_SAMPLE_COUNT = 16;
+
  private:
    int _id;
    std::unique_ptr<DriverAdapter> _adapter;
@@ -9,12 +9,16 @@
 
 // C++ headers
 #include <atomic>
+#include <condition_variable>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 // project headers
 #include "dxrt/device_core.h"
+#include "dxrt/device_schedule_policy.h"
 #include "dxrt/device_task_layer.h"
 #include "dxrt/filesys_support.h"
 #include "dxrt/nfh_layer.h"
@@ -29,6 +33,23 @@ class DXRT_API DevicePool {
     void InitTaskLayers();
     void InitNFHLayers();
     std::shared_ptr<DeviceTaskLayer> PickOneDevice(const std::vector<int> &device_ids_);
+    /**
+     * @brief Reserves a device for one request of taskId using the given scheduling policy.
+     * @param policy InferenceOption::SCHEDULE_POLICY value; unknown values use least-load.
+     */
+    std::shared_ptr<DeviceTaskLayer> PickOneDevice(const std::vector<int> &device_ids_, int taskId, uint32_t policy);
+
+    /**
+     * @brief Replaces the implementation behind a InferenceOption::SCHEDULE_POLICY value.
+     * Takes effect for the next pick; policies must be thread-safe.
+     */
+    void SetSchedulePolicy(uint32_t policy, std::shared_ptr<DeviceSchedulePolicy> impl);
+    std::shared_ptr<DeviceSchedulePolicy> GetSchedulePolicy(uint32_t policy);
+
+    /** @brief Forwards a completed request's device service time to every scheduling policy. */
+    void ReportServiceTime(int deviceId, int taskId, uint32_t serviceTimeUs);
+    /** @brief Lets every scheduling policy drop what it keeps for a released task. */
+    void RemoveTask(int taskId);
     std::shared_ptr<DeviceTaskLayer> GetDeviceTaskLayer(int deviceId);
     std::shared_ptr<DeviceCore> GetDeviceCores(int deviceId) {return _deviceCores[deviceId];}
     std::shared_ptr<NFHLayer> GetNFHLayer(int deviceId) {
@@ -70,7 +91,11 @@ class DXRT_API DevicePool {
     DevicePool& operator=(DevicePool&&) = delete;
 
 
-    size_t _curDevIdx = 0;
+    // Indexed by InferenceOption::SCHEDULE_POLICY; read with std::atomic_load so
+    // SetSchedulePolicy() can swap an entry while requests are being submitted
+    std::vector<std::shared_ptr<DeviceSchedulePolicy>> _schedulePolicies;
+    std::once_flag _policiesFlag;
+    void InitSchedulePolicies();
 
     std::once_flag _coresFlag;
     std::once_flag _taskLayersFlag;
@@ -83,13 +108,26 @@ class DXRT_API DevicePool {
 
 
 
-    std::condition_variable _deviceCV;
+    // Only used when every candidate device is full; the pick itself is lock-free.
+    // A blocked submitter waits on its own condition variable, and a completion wakes the
+    // oldest waiter whose device set holds the completed device, so waiters on other devices
+    // neither block it nor get woken by it
+    struct DeviceWaiter
+    {
+        const std::vector<int>* deviceIds = nullptr;
+        std::condition_variable cv;
+        int wokenBy = -1;  ///< device whose completion woke this waiter, -1 while waiting
+    };
+    std::list<DeviceWaiter*> _deviceWaitQueue;  // oldest first, guarded by _deviceMutex
     std::mutex _deviceMutex;
-    std::mutex _methodMutex;
-    int _currentPickDevice = 0;
-
-    int pickDeviceIndex(const std::vector<int> &device_ids);
-    std::shared_ptr<DeviceTaskLayer> WaitDevice(const std::vector<int> &device_ids);
+    std::atomic<int> _deviceWaiters{0};
+    bool wakeDeviceWaiterLocked(int devIndex);
+
+    int pickDeviceIndex(const std::vector<int> &device_ids, int taskId, DeviceSchedulePolicy &policy);
+    std::shared_ptr<DeviceTaskLayer> tryPickDevice(const std::vector<int> &device_ids, int taskId,
+        DeviceSchedulePolicy &policy);
+    std::shared_ptr<DeviceTaskLayer> WaitDevice(const std::vector<int> &device_ids, int taskId,
+        DeviceSchedulePolicy &policy);
 
     static constexpr bool USE_ONE_NFH_LAYERS = true;
 };
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include "dxrt/common.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace dxrt {
+
+/** @brief Snapshot of one candidate device handed to a DeviceSchedulePolicy. */
+struct DeviceCandidate
+{
+    int deviceId;
+    int load;
+    int fullLoad;
+};
+
+/**
+ * @brief Strategy that chooses which device serves the next NPU request.
+ *
+ * DevicePool builds the list of unblocked candidates and reserves a load credit
+ * on the device the policy returns, so Select() must be side-effect free apart
+ * from its own bookkeeping. Implementations are shared by all engines and must
+ * be thread-safe.
+ */
+class DXRT_API DeviceSchedulePolicy
+{
+ public:
+    virtual ~DeviceSchedulePolicy() = default;
+
+    /**
+     * @brief Picks one device for a request of taskId.
+     * @param candidates Unblocked devices with their current load.
+     * @param taskId Id of the task (model subgraph) being submitted.
+     * @return A deviceId from candidates with load < fullLoad, or -1 if none qualifies.
+     */
+    virtual int Select(const std::vector<DeviceCandidate>& candidates, int taskId) = 0;
+
+    /**
+     * @brief Feeds the measured service time of a completed request back to the policy.
+     * @param deviceId Device that served the request.
+     * @param taskId Task of the request.
+     * @param serviceTimeUs Device-reported inference time in microseconds.
+     */
+    virtual void OnRequestComplete(int deviceId, int taskId, uint32_t serviceTimeUs)
+    {
+        std::ignore = deviceId;
+        std::ignore = taskId;
+        std::ignore = serviceTimeUs;
+    }
+
+    /**
+     * @brief Tells the policy that taskId was released, so it can drop what it keeps for the task.
+     * @param taskId Task that no longer submits requests.
+     */
+    virtual void OnTaskRemoved(int taskId)
+    {
+        std::ignore = taskId;
+    }
+
+    virtual const char* Name() const = 0;
+};
+
+/**
+ * @brief Default policy: the device with the fewest outstanding requests wins.
+ * Ties rotate round-robin so equally loaded devices take turns.
+ */
+class DXRT_API LeastLoadSchedulePolicy : public DeviceSchedulePolicy
+{
+ public:
+    int Select(const std::vector<DeviceCandidate>& candidates, int taskId) override;
+    const char* Name() const override { return "least-load"; }
+
+ private:
+    std::atomic<size_t> _rrIndex{0};
+};
+
+/**
+ * @brief Least-expected-completion-time policy.
+ *
+ * Keeps an exponentially weighted moving average of the service time per device
+ * and per (device, task). A device is scored as load * deviceAverage + taskAverage,
+ * which estimates when the new request would finish given the work already queued
+ * there. Slower clocks, thermal throttling or a cold model show up in the measured
+ * averages, so the policy steers away from them without polling device status.
+ * Devices without samples score as idle so they get measured first.
+ */
+class DXRT_API LeastExpectedLatencySchedulePolicy : public DeviceSchedulePolicy
+{
+ public:
+    explicit LeastExpectedLatencySchedulePolicy(int maxDevices);
+
+    int Select(const std::vector<DeviceCandidate>& candidates, int taskId) override;
+    void OnRequestComplete(int deviceId, int taskId, uint32_t serviceTimeUs) override;
+    void OnTaskRemoved(int taskId) override;
+    const char* Name() const override { return "least-expected-latency"; }
+
+    /** @brief Current estimate for taskId on deviceId in microseconds (0 if unmeasured). */
+    uint32_t EstimateUs(int deviceId, int taskId) const;
+
+    // Weight of a new sample is 1 / 2^EWMA_SHIFT
+    static constexpr int EWMA_SHIFT = 3;
+    // Per-device open-addressing table of task averages; released tasks leave a tombstone
+    // that lookups probe past and inserts reuse
+    static constexpr int TASK_SLOTS = 64;
+
+ private:
+    static constexpr int EMPTY_SLOT = -1;
+    static constexpr int REMOVED_SLOT = -2;
+    struct TaskSlot
+    {
+        std::atomic<int> taskId{EMPTY_SLOT};
+        std::atomic<uint32_t> ewmaUs{0};
+    };
+    struct DeviceStats
+    {
+        std::atomic<uint32_t> ewmaUs{0};
+        TaskSlot tasks[TASK_SLOTS];
+    };
+
+    static void updateEwma(std::atomic<uint32_t>& avg, uint32_t sample);
+    const TaskSlot* findSlot(const DeviceStats& stats, int taskId) const;
+    TaskSlot* findSlot(DeviceStats& stats, int taskId);
+    TaskSlot* findOrInsertSlot(DeviceStats& stats, int taskId);
+
+    std::unique_ptr<DeviceStats[]> _stats;
+    int _maxDevices;
+    std::atomic<size_t> _rrIndex{0};
+};
+
+}  // namespace dxrt
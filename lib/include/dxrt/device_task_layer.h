@@ -50,6 +50,11 @@ class DXRT_API DeviceTaskLayer {
 
     int load();
     void pick();
+    /**
+     * @brief Reserves one load credit if the device is below getFullLoad().
+     * Lock-free; returns false without side effects when the device is full.
+     */
+    bool tryPick();
     int infCnt();
 
     // connection
@@ -69,6 +74,7 @@ class DXRT_API DeviceTaskLayer {
     void Reset(int opt);
     void ResetBuffer(int opt);
     int64_t Allocate(uint64_t size);
+    int64_t TryAllocate(uint64_t size);
     void Deallocate(uint64_t addr);
 
     void RegisterCallback(std::function<void()> f);
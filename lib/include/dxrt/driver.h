@@ -281,6 +281,10 @@ typedef struct _dxrt_request_acc_t {
     uint32_t  bandwidth = 0;    /* scheduler option - bandwith(npu_bandwidth_op) */
     uint32_t  bound = 0;        /* scheduler option - bound   (npu_bound_op) */
     uint32_t  queue = 0;
+    /* dxrt_service scheduling only; the driver reads the fields above */
+    uint32_t  sched_priority = 0;   /* priority class, higher is dispatched first */
+    uint32_t  reserved = 0;
+    uint64_t  deadline_us = 0;      /* absolute CLOCK_MONOTONIC deadline in microseconds, 0: none */
 } dxrt_request_acc_t;
 
 typedef struct _dxrt_response_t {
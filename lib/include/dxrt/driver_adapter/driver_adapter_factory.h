@@ -18,10 +18,13 @@
 
 namespace dxrt {
 
+struct SimulatorConfig;
+
 class DriverAdapterFactory {
  public:
         static std::unique_ptr<DriverAdapter> CreateForDeviceFile(const std::string& devicePath);
         static std::unique_ptr<DriverAdapter> CreateForNetwork();
+        static std::unique_ptr<DriverAdapter> CreateSimulator(int id, const SimulatorConfig& config);
 };
 
 }  // namespace dxrt
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "driver_adapter.h"
+
+namespace dxrt {
+
+/**
+ * @brief Latency model and geometry of a simulated accelerator device.
+ *
+ * Parsed from the DXRT_SIMULATOR environment variable, a comma separated list of
+ * key=value pairs, e.g. "devices=2,npu_us=1500,task0_us=800,pcie_mbps=3500".
+ * A bare number is shorthand for devices=N.
+ */
+struct DXRT_API SimulatorConfig
+{
+    int numDevices = 1;
+    uint32_t npuTimeUs = 1000;                        // npu_us: default NPU time per request
+    std::map<uint32_t, uint32_t> taskNpuTimeUs;       // task<N>_us: override for task id N
+    uint32_t pcieMBps = 3500;                         // pcie_mbps: bandwidth of each DMA channel
+    int queueDepth = 8;                               // queue: requests accepted before NPU_RUN_REQ reports busy
+    int npuCores = 3;                                 // cores: requests executed concurrently
+    int numDmaChannels = 3;                           // dma_ch: channels reported by IDENTIFY
+    uint64_t memSizeMB = 1024;                        // mem_mb: host memory backing the device
+
+    static SimulatorConfig Parse(const std::string& spec);
+
+    /** @brief Fills config from DXRT_SIMULATOR; returns false if the variable is unset. */
+    static bool LoadFromEnv(SimulatorConfig& config);
+};
+
+/**
+ * @brief Hardware-free ACC device that honours the driver command protocol.
+ *
+ * Device memory is host memory, WRITE_MEM / READ_MEM copy into it and hold their
+ * DMA channel for size / bandwidth, NPU_RUN_REQ queues the request for a pool of
+ * simulated NPU cores and NPU_RUN_RESP blocks the receiver thread of the request's
+ * DMA channel until the core finishes. Output buffers are not computed; they hold
+ * whatever the device memory contains.
+ */
+class DXRT_API SimulatorDriverAdapter : public DriverAdapter {
+
+public:
+    SimulatorDriverAdapter(int id, const SimulatorConfig& config);
+    ~SimulatorDriverAdapter() override;
+
+    // input & output control
+    int32_t IOControl(dxrt_cmd_t request, void* data, uint32_t size = 0, uint32_t sub_cmd = 0) override;
+
+    // Write Data via DMA
+    int32_t Write(const void* buffer, uint32_t size) override;
+
+    // Read Datea via DMA
+    int32_t Read(void* buffer, uint32_t size) override;
+
+    // Memory Map
+    void* MemoryMap(void *__addr, size_t __len, off_t __offset = 0) override;
+
+    // Poll
+    int32_t Poll() override;
+
+    std::string GetName() const override { return _name; }
+    int GetFd() const override { return -1; }
+
+    static constexpr uint64_t SIM_MEM_ADDR = 0x80000000ULL;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int32_t identify(dxrt_device_info_t* info);
+    int32_t driverInfo(void* data, uint32_t sub_cmd);
+    int32_t getStatus(dxrt_device_status_t* status);
+    int32_t transfer(dxrt_req_meminfo_t* req, bool toDevice);
+    int32_t runRequest(const dxrt_request_acc_t* req);
+    int32_t waitResponse(dxrt_response_t* resp);
+    int32_t waitEvent(dx_pcie_dev_event_t* event);
+    void terminate(bool eventOnly);
+    void npuThread(int core);
+    uint32_t npuTimeFor(uint32_t taskId) const;
+    static int32_t fail(int err);
+
+    int _id;
+    std::string _name;
+    SimulatorConfig _config;
+    uint64_t _memSize;
+    std::unique_ptr<uint8_t[]> _memory;
+
+    static constexpr int MAX_DMA_CHANNELS = 4;
+    std::mutex _dmaLock[MAX_DMA_CHANNELS];
+
+    std::mutex _npuLock;
+    std::condition_variable _npuCv;
+    std::deque<dxrt_request_acc_t> _pending;
+    int _inflight = 0;
+    std::vector<std::thread> _npuThreads;
+    std::unique_ptr<std::atomic<uint32_t>[]> _coreCount;
+
+    std::mutex _respLock;
+    std::vector<std::deque<dxrt_response_t>> _responses;
+    std::unique_ptr<std::condition_variable[]> _respCv;
+    std::condition_variable _eventCv;
+
+    std::atomic<bool> _terminated{false};
+    std::atomic<bool> _eventTerminated{false};
+    std::atomic<bool> _shutdown{false};
+};
+
+}  // namespace dxrt
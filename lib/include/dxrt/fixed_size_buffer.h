@@ -21,7 +21,8 @@ namespace dxrt {
 class FixedSizeBuffer
 {
  public:
-    explicit FixedSizeBuffer(int64_t size, int buffer_count);
+    // numa_node >= 0 places the buffers on that NUMA node (Linux), -1 leaves it to the allocator
+    explicit FixedSizeBuffer(int64_t size, int buffer_count, int numa_node = -1);
     void* getBuffer();
     void releaseBuffer(void* ptr);
     bool hasBuffer();
@@ -34,6 +35,7 @@ class FixedSizeBuffer
 
     int _count;
     int64_t _size;
+    bool _mapped = false;  // buffers are anonymous mappings, see the constructor
     std::mutex _lock;
     std::condition_variable _cv;
 };
@@ -17,6 +17,9 @@
 #include "dxrt/device_core.h"
 #include "dxrt/memory_interface.h"
 #include "dxrt/exception/exception.h"
+#include "dxrt/mpmc_queue.h"
+#include "dxrt/thread_affinity.h"
+#include <queue>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -27,18 +30,32 @@
 namespace dxrt {
 
 
+/**
+ * @brief Fixed set of worker threads consuming work items from a shared queue.
+ *
+ * Items go through a bounded lock-free MPMC ring; if the ring is full they spill into a
+ * mutex-protected overflow queue, which is drained before the ring is used again, so
+ * PushWork never blocks or drops work and FIFO order is kept. Idle workers spin briefly
+ * (multi-core hosts only) and then park; a push wakes one parked worker, and only when the
+ * queued items outnumber the workers that are already awake and looking for work.
+ */
 template <typename T>
 class HandlerQueueThread
 {
 public:
-    HandlerQueueThread(std::string name_, size_t numThreads, std::function<int(const T&, int)> handler_)
-    : _name(name_), _threads(), _handler(handler_), _numThreads(numThreads) {}
+    HandlerQueueThread(std::string name_, size_t numThreads, std::function<int(const T&, int)> handler_,
+                       size_t queueCapacity = DEFAULT_QUEUE_CAPACITY)
+    : _name(name_), _ring(queueCapacity), _threads(), _handler(handler_), _numThreads(numThreads),
+      _spinCount(std::thread::hardware_concurrency() > 1 ? DEFAULT_SPIN_COUNT : 0) {}
     void PushWork(const T& x);
 
     void Signal();
 
     void Start();
 
+    // where the workers run, set before Start()
+    void SetPlacement(ThreadRole role, int deviceId = -1) { _role = role; _placementDeviceId = deviceId; }
+
     void Stop() { _stop.store(true); }
 
     void UpdateQueueStats(int queueSize);
@@ -47,11 +64,21 @@ public:
     ~HandlerQueueThread();
     std::string name() const { return _name; }
 
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 1024;
+    static constexpr int DEFAULT_SPIN_COUNT = 256;
+
 protected:
 
     std::string _name;
 
-    std::queue<T> _que;
+    MpmcQueue<T> _ring;
+    std::queue<T> _spill;  // overflow when the ring is full, guarded by _spillLock
+    std::mutex _spillLock;
+    std::atomic<size_t> _spillCount{0};
+    std::atomic<int64_t> _pending{0};  // pushed but not yet popped (briefly negative while a pop overtakes its push)
+    std::atomic<int> _sleepers{0};  // workers parked on _cv
+    std::atomic<int> _searching{0};  // awake workers looking for an item
+    int _wakePending = 0;  // notifies not yet picked up by a parked worker, guarded by _lock
     std::vector<std::thread> _threads;
     std::mutex _lock;
     std::mutex _statsLock;
@@ -66,7 +93,11 @@ protected:
     std::atomic<int> _checkQueueCnt{0};
     std::atomic<int> _accumulatedQueueSize{0};
     size_t _numThreads;
+    int _spinCount;
+    ThreadRole _role = ThreadRole::NONE;
+    int _placementDeviceId = -1;
 
+    bool TryPop(T& out);
     void DoThread(int id);
     void ThreadWork(int id);
 };
@@ -80,9 +111,48 @@ void HandlerQueueThread<T>::Signal()
 template <typename T>
 void HandlerQueueThread<T>::PushWork(const T& x)
 {
-    std::unique_lock<std::mutex> lock (_lock);
-    _que.push(x);
-    _cv.notify_all();
+    // Once anything has spilled, keep spilling until the overflow is drained to preserve order
+    if (_spillCount.load(std::memory_order_acquire) != 0 || !_ring.TryPush(x))
+    {
+        std::unique_lock<std::mutex> lock(_spillLock);
+        _spill.push(x);
+        _spillCount.fetch_add(1, std::memory_order_release);
+    }
+    // seq_cst pairs with the parking worker: either it sees the item or we see it parked.
+    // Wake a parked worker only when the awake idle workers cannot cover the backlog.
+    _pending.fetch_add(1, std::memory_order_seq_cst);
+    if (_sleepers.load(std::memory_order_seq_cst) > 0 &&
+        _pending.load(std::memory_order_seq_cst) > _searching.load(std::memory_order_seq_cst))
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        if (_sleepers.load(std::memory_order_relaxed) > _wakePending &&
+            _pending.load(std::memory_order_seq_cst) > _searching.load(std::memory_order_seq_cst) + _wakePending)
+        {
+            _wakePending++;
+            _cv.notify_one();
+        }
+    }
+}
+template <typename T>
+bool HandlerQueueThread<T>::TryPop(T& out)
+{
+    if (!_ring.TryPop(out))
+    {
+        if (_spillCount.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(_spillLock);
+        if (_spill.empty())
+        {
+            return false;
+        }
+        out = std::move(_spill.front());
+        _spill.pop();
+        _spillCount.fetch_sub(1, std::memory_order_release);
+    }
+    _pending.fetch_sub(1, std::memory_order_relaxed);
+    return true;
 }
 template <typename T>
 void HandlerQueueThread<T>::ThreadWork(int id)
@@ -90,24 +160,39 @@ void HandlerQueueThread<T>::ThreadWork(int id)
     while (_stop.load(std::memory_order_acquire) == false)
     {
         T response;
+        bool popped = false;
+        _searching.fetch_add(1, std::memory_order_seq_cst);
+        for (int spin = 0; spin <= _spinCount && !popped; spin++)
         {
-            std::unique_lock<std::mutex> lk(_lock);
-            _cv.wait(
-                lk, [this] {
-                    return _que.size() || _stop.load(std::memory_order_acquire);
+            popped = TryPop(response);
+        }
+        while (!popped)
+        {
+            {
+                std::unique_lock<std::mutex> lk(_lock);
+                _searching.fetch_sub(1, std::memory_order_seq_cst);
+                _sleepers.fetch_add(1, std::memory_order_seq_cst);
+                // Sleep while the other idle workers are enough for what is queued. Every return
+                // from wait() settles one notify, also when the worker goes back to sleep because
+                // another worker took the item, or PushWork would stop waking anyone.
+                while (_pending.load(std::memory_order_seq_cst) <= _searching.load(std::memory_order_seq_cst) &&
+                       !_stop.load(std::memory_order_acquire))
+                {
+                    _cv.wait(lk);
+                    if (_wakePending > 0) _wakePending--;
                 }
-            );
-
+                _sleepers.fetch_sub(1, std::memory_order_relaxed);
+                _searching.fetch_add(1, std::memory_order_seq_cst);
+            }
 
             // stop handler
             if (_stop.load(std::memory_order_acquire))
             {
                 return;
             }
-
-            response = _que.front();
-            _que.pop();
+            popped = TryPop(response);
         }
+        _searching.fetch_sub(1, std::memory_order_seq_cst);
         _handler(response, id);
         if (_stop.load(std::memory_order_acquire))
         {
@@ -119,6 +204,7 @@ void HandlerQueueThread<T>::ThreadWork(int id)
 template <typename T>
 void HandlerQueueThread<T>::DoThread(int id)
 {
+    if (_role != ThreadRole::NONE) ApplyThreadPlacement(_role, _placementDeviceId);
     try {
         ThreadWork(id);
     } catch (dxrt::Exception& e) {
@@ -156,6 +156,15 @@ class DXRT_API InferenceEngine
      */
     int RunAsync(void *inputPtr, void *userArg=nullptr, void *outputPtr = nullptr);
 
+    /** @brief Submits an asynchronous inference request with its own service scheduling hints.
+     * @param[in] inputPtr A pointer to the input data.
+     * @param[in] schedule Priority class and relative deadline of this request (see InferenceOption::priority).
+     * @param[in] userArg An optional user-defined argument to be passed to the callback.
+     * @param[out] outputPtr An optional pointer to a pre-allocated output buffer.
+     * @return An integer jobId for this asynchronous operation.
+     */
+    int RunAsync(void *inputPtr, const RequestSchedule& schedule, void *userArg=nullptr, void *outputPtr = nullptr);
+
     /** @brief Submits an asynchronous inference request, automatically detecting if the input is for a multi-input model.
      * @param[in] inputPtrs A vector of pointers to input data.
      * @param[in] userArg An optional user-defined argument.
@@ -450,6 +459,20 @@ class DXRT_API InferenceEngine
      */
     int GetNpuInferenceTimeCnt();
 
+    /** @brief Gets the latency distribution of one pipeline stage since the engine was created.
+     * @details The stage histograms are always recorded, independent of the profiler settings.
+     * Percentiles are resolved to about 3% of the value.
+     * @param[in] stage The pipeline stage.
+     * @return Count, mean, max and p50/p90/p99/p99.9 in microseconds.
+     */
+    LatencyStats GetStageLatency(PipelineStage stage);
+
+    /** @brief Gets the latency distribution of every pipeline stage recorded since the previous call.
+     * @details Intended for periodic monitoring; the first call covers everything since the engine was created.
+     * @return One LatencyStats per stage, indexed by PipelineStage.
+     */
+    std::vector<LatencyStats> SnapshotStageLatency();
+
     /**
      *  @deprecated Use GetAllTaskOutputs() instead.
      *  @brief Get output tensors of all tasks (Legacy API)
@@ -569,6 +592,22 @@ class DXRT_API InferenceEngine
      */
     std::vector<std::string> GetOutputTensorNames() const;
 
+    /**
+     * @brief Reports which input tensors are already in the NPU memory layout.
+     * A layout-identical input needs no format conversion. When every input of an NPU task is
+     * layout-identical, packed back to back in GetInputTensorNames() order and the block starts
+     * on a 64-byte boundary, the input is DMA'd straight from the user buffer without a host copy.
+     * @return One flag per input tensor, in the order of GetInputTensorNames(). Inputs of CPU tasks report false.
+     */
+    std::vector<bool> GetInputLayoutIdentical() const;
+
+    /**
+     * @brief Reports which output tensors are produced by the NPU in the user memory layout,
+     * i.e. their decode step is a plain copy.
+     * @return One flag per output tensor, in the order of GetOutputTensorNames(). Outputs of CPU tasks report false.
+     */
+    std::vector<bool> GetOutputLayoutIdentical() const;
+
 
 
     /**
@@ -623,10 +662,15 @@ class DXRT_API InferenceEngine
     void checkService();
 
     void loadModelFromFile(const std::string& modelPath, InferenceOption &option);
-    void loadModelFromMemory(const std::string& name, const uint8_t* modelBuffer, size_t modelSize, InferenceOption &option);
+    void loadModelFromMemory(const std::string& name, const uint8_t* modelBuffer, size_t modelSize, InferenceOption &option,
+        std::shared_ptr<const ModelFile> modelFile = nullptr);
 
     int runAsync(void *inputPtr, void *userArg, void *outputPtr, int batchIndex,
-        std::function<int(TensorPtrs &outputs, void *userArg, int jobId)> batchCallback);
+        std::function<int(TensorPtrs &outputs, void *userArg, int jobId)> batchCallback,
+        const RequestSchedule& schedule);
+    int runAsyncMultiInput(const std::map<std::string, void*>& inputTensors, void *userArg, void *outputPtr,
+        const RequestSchedule& schedule);
+    RequestSchedule defaultSchedule() const { return RequestSchedule{_option.priority, _option.deadlineUs}; }
 
     void runSubBatch(std::vector<TensorPtrs>& result, int batchCount, int startIndex,
             const std::vector<void*>& inputPtrs,
@@ -694,7 +738,8 @@ class DXRT_API InferenceEngine
 
     // Helper methods for tensor-centric management
     void initializeEnvironmentVariables();
-    void initializeModel(const uint8_t* modelBuffer, size_t modelSize, int bufferCount);
+    void initializeModel(const uint8_t* modelBuffer, size_t modelSize, int bufferCount,
+        std::shared_ptr<const ModelFile> modelFile = nullptr);
     void buildTasksAndSubgraphMap(int bufferCount);
     void buildInputTensorMapping();
     void buildTaskGraph();
@@ -22,6 +22,7 @@
 #include "dxrt/request.h"
 #include "dxrt/task.h"
 #include "dxrt/driver.h"
+#include "dxrt/inference_option.h"
 
 namespace dxrt {
 class Task;
@@ -31,6 +32,8 @@ using TimePointPtr = std::shared_ptr<TimePoint>;
 
 template<typename T>
 class CircularDataPool;
+template<typename T>
+class MpmcQueue;
 class InferenceEngine;
 
 class InferenceJob
@@ -47,7 +50,7 @@ class InferenceJob
     ~InferenceJob();
 
     void SetInferenceJob(std::vector<std::shared_ptr<Task>>& tasks_, std::shared_ptr<Task> head_,
-                        std::vector<std::string> lastOutputOrder,
+                        const std::vector<std::string>& lastOutputOrder,
                         const std::vector<std::string>& modelInputNames = {});
 
     /** @brief Set inference job with multi-head support using input tasks
@@ -58,7 +61,7 @@ class InferenceJob
      */
     void SetInferenceJobMultiHead(std::vector<std::shared_ptr<Task>>& tasks_,
                                   const std::vector<std::shared_ptr<Task>>& inputTasks_,
-                                  std::vector<std::string> lastOutputOrder,
+                                  const std::vector<std::string>& lastOutputOrder,
                                   const std::vector<std::string>& modelInputNames);
 
 
@@ -101,6 +104,9 @@ class InferenceJob
     int GetBatchIndex() { return _batchIndex; }
     void SetBatchIndex(int index) { _batchIndex = index; }
 
+    // dxrt_service scheduling hints stamped on every request of this job; the deadline starts now
+    void SetRequestSchedule(const RequestSchedule& schedule);
+
  private:
     std::vector<RequestWeakPtr> _requests;
     std::unordered_map<std::string, Tensor> _tensors;
@@ -134,8 +140,11 @@ class InferenceJob
     TensorPtrs _returnOutputs = {};
     void setReturnOutputs();
     void ReleaseAllOutputBuffer();
+    void resetTaskStatus(const std::vector<std::shared_ptr<Task>>& tasks_);
     void* _outputPtr;
     std::atomic<bool> _use_flag = {false};
+    std::shared_ptr<MpmcQueue<int>> _poolFreeIds;
+    int _poolIndex = -1;
 
     // Limit access to shared resources to one thread at a time.
     // Acquire the mutex when reading or writing the _status value, and release it after the operation is complete.
@@ -149,6 +158,10 @@ class InferenceJob
     std::atomic<bool> _occupiedJob {false};
 
     int _batchIndex = -1;
+
+    uint32_t _schedPriority = 0;
+    uint64_t _deadlineUs = 0;  // absolute, steady_clock microseconds
+    uint64_t _submitNs = 0;    // LatencyClockNs at startJob, for the end-to-end stage histogram
 };
 
 using InferenceJobPtr = std::shared_ptr<InferenceJob>;
@@ -37,6 +37,11 @@ class DXRT_API InferenceOption
         NPU_02
     };
 
+    enum SCHEDULE_POLICY {
+        SCHEDULE_LEAST_LOAD = 0,
+        SCHEDULE_LEAST_EXPECTED_LATENCY
+    };
+
     /** @brief device ID list to use 
      * @details make a list which contains list of device ID to use. if it is empty(or use default value), then all devices are used.
      */
@@ -58,6 +63,34 @@ class DXRT_API InferenceOption
      */
     int bufferCount{DXRT_TASK_MAX_LOAD_VALUE};
 
+    /** @brief Select how a device is chosen for each NPU request
+     * @details SCHEDULE_LEAST_LOAD picks the device with the fewest outstanding requests.
+     * SCHEDULE_LEAST_EXPECTED_LATENCY weighs the outstanding requests by the service time measured
+     * per device and per task, which favors faster or less throttled devices.
+     */
+    uint32_t schedulePolicy = SCHEDULE_POLICY::SCHEDULE_LEAST_LOAD;
+
+    /** @brief Priority class of this engine's NPU requests in dxrt_service
+     * @details Only used when dxrtd runs the deadline scheduler (dxrtd -s EDF). Requests of a higher
+     * class are dispatched to the device before any pending request of a lower class. 0 is the default class.
+     */
+    uint32_t priority = 0;
+
+    /** @brief Relative deadline of each inference in microseconds, 0 for none
+     * @details Counted from the Run()/RunAsync() call. Within a priority class the deadline scheduler
+     * dispatches the earliest deadline first, and dxrtd counts requests that complete after their deadline.
+     */
+    uint32_t deadlineUs = 0;
+
+};
+
+/** @brief Scheduling hints of a single inference, overriding InferenceOption::priority and deadlineUs
+ * @headerfile "dxrt/dxrt_api.h"
+ */
+struct DXRT_API RequestSchedule
+{
+    uint32_t priority = 0;      ///< priority class, see InferenceOption::priority
+    uint32_t deadlineUs = 0;    ///< relative deadline in microseconds, 0 for none
 };
 
 
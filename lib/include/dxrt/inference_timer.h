@@ -11,6 +11,7 @@
 
 #include "dxrt/common.h"
 #include "dxrt/circular_buffer.h"
+#include "dxrt/latency_histogram.h"
 
 #include <mutex>
 #include <cmath>
@@ -37,6 +38,12 @@ class InferenceTimer
     void UpdateLatencyStatistics(int latency);
     void UpdateInferenceTimeStatistics(uint32_t inferenceTime);
 
+    // always-on per stage histograms, lock free on the recording side
+    void RecordStage(PipelineStage stage, uint64_t us);
+    LatencyStats GetStageLatency(PipelineStage stage) const;
+    // stats of every stage recorded since the previous call, indexed by PipelineStage
+    std::vector<LatencyStats> SnapshotStageLatency();
+
  private:
     CircularBuffer<int> _latency;
     CircularBuffer<uint32_t> _infTime;
@@ -48,6 +55,10 @@ class InferenceTimer
     int _inferenceTimeN=0;
     mutable std::mutex _lock;
 
+    LatencyHistogram _stages[static_cast<int>(PipelineStage::COUNT)];
+    std::vector<LatencyHistogram::Counts> _lastSnapshot;
+    std::mutex _snapshotLock;
+
 };
 
 }  // namespace dxrt
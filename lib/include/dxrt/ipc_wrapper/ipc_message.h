@@ -18,6 +18,7 @@
 #include "dxrt/common.h"
 #include "dxrt/driver.h"
 #include "dxrt/device_struct.h"
+#include "dxrt/model_memory_cache.h"
 
 namespace dxrt 
 {
@@ -26,7 +27,8 @@ namespace dxrt
         //SOCKET_CB = 2,          // socket read callback & write sync
         MESSAE_QUEUE = 3,       // message queue (FIFO)
         //MSG_QUEUE = 4,          // message queue (POSIX)
-        WIN_PIPE = 5            // windows named pipe
+        WIN_PIPE = 5,           // windows named pipe
+        SHARED_RING = 6         // shared memory rings negotiated over the message queue (linux)
     };
     IPC_TYPE inline IPCDefaultType()
     {
@@ -36,6 +38,23 @@ namespace dxrt
     	return IPC_TYPE::WIN_PIPE ;
 #endif
     }
+    // Transport of runtime processes talking to dxrt_service (DXRT_IPC_TYPE=shm selects the rings)
+    IPC_TYPE inline IPCClientDefaultType()
+    {
+#ifdef __linux__
+        if (GetIpcSharedRing()) return IPC_TYPE::SHARED_RING;
+#endif
+        return IPCDefaultType();
+    }
+    // dxrt_service serves ring and message queue clients at the same time
+    IPC_TYPE inline IPCServerDefaultType()
+    {
+#ifdef __linux__
+        return IPC_TYPE::SHARED_RING;
+#else
+        return IPCDefaultType();
+#endif
+    }
 
     enum class MEMORY_REQUEST_CODE : int {
         REGISTER_PROCESS = 0,      // set msg to pid
@@ -66,6 +85,9 @@ namespace dxrt
         VIEW_USED_MEMORY = 12,
         VIEW_AVAILABLE_DEVICE = 15,
         GET_USAGE = 17, 
+        ACQUIRE_MODEL_MEMORY = 19,  // rmap/weight regions shared by identical models
+        MODEL_MEMORY_READY = 20,    // uploader finished writing the regions of ACQUIRE_MODEL_MEMORY
+        GET_MEMORY_BATCH = 21,      // several regions in one round trip, see IPCAllocBatch
     
         MEMORY_ALLOCATION_AND_TRANSFER_MODEL = 100,
         COMPLETE_TRANSFER_MODEL = 101,
@@ -88,6 +110,7 @@ namespace dxrt
         CONFIRM_MEMORY_ALLOCATION = 201,
         CONFIRM_TRANSFER_INPUT_AND_RUN = 202,
         CONFIRM_MEMORY_FREE = 203,
+        CONFIRM_REGISTER_PROCESS = 204,     // shared ring segment of the client attached (result 0)
         DO_SCHEDULED_INFERENCE_CH0 = 400,
         DO_SCHEDULED_INFERENCE_CH1 = 401,
         DO_SCHEDULED_INFERENCE_CH2 = 402,
@@ -99,6 +122,27 @@ namespace dxrt
     std::string to_string(dxrt::REQUEST_CODE code);
 #pragma pack(push, 1)
 
+    static constexpr int IPC_ALLOC_BATCH_MAX = 8;
+
+    // GET_MEMORY_BATCH payload: region sizes in the request, region offsets in the reply.
+    // The service allocates all regions or none; when memory is short it keeps the request
+    // for up to waitMs and retries it whenever memory is freed before replying.
+    struct IPCAllocBatch
+    {
+        uint32_t count = 0;
+        uint32_t backward = 0;   // 1: allocate from the top of memory (model parameters)
+        uint32_t waitMs = 0;
+        uint64_t regions[IPC_ALLOC_BATCH_MAX] = { 0, };
+    };
+
+    // GET_USAGE_RESULT: deadline accounting of the requests the device completed
+    struct IPCDeadlineStats
+    {
+        uint64_t requests = 0;        // completed requests that carried a deadline
+        uint64_t misses = 0;          // ... of which completed after it
+        uint64_t maxLatenessUs = 0;   // worst completion time past a deadline
+    };
+
     struct IPCClientMessage
     {
         REQUEST_CODE code;
@@ -111,6 +155,7 @@ namespace dxrt
         
         int taskId;
         uint64_t modelMemorySize;
+        IPCAllocBatch alloc;
         
         IPCClientMessage()
         : code(REQUEST_CODE::REGISTER_PROCESS), deviceId(0), data(0), pid(0), msgType(0), seqId(0), taskId(-1), modelMemorySize(0)
@@ -128,6 +173,8 @@ namespace dxrt
         long msgType; // for message queue
         int seqId;
         dxrt::dxrt_response_t npu_resp;
+        IPCAllocBatch alloc;
+        IPCDeadlineStats deadline;
         IPCServerMessage()
         : code(RESPONSE_CODE::CLOSE), deviceId(0), result(0), data(0), msgType(0), seqId(0)
         {
@@ -167,6 +214,28 @@ namespace dxrt
 
 #pragma pack(pop)
 
+    // ACQUIRE_MODEL_MEMORY / MODEL_MEMORY_READY carry the key digest in alloc.regions[0..3] and the
+    // sizes and exact flag in npu_acc.datas; the reply carries the region state in result and
+    // (rmap offset << 32 | weight offset) in data
+    inline void SetModelMemoryKey(IPCClientMessage& msg, const ModelMemoryKey& key)
+    {
+        static_assert(sizeof(key.digest) <= sizeof(msg.alloc.regions), "model memory key does not fit");
+        memcpy(msg.alloc.regions, key.digest.data(), sizeof(key.digest));
+        msg.npu_acc.datas[0] = key.rmapSize;
+        msg.npu_acc.datas[1] = key.weightSize;
+        msg.npu_acc.datas[2] = key.exact;
+    }
+
+    inline ModelMemoryKey GetModelMemoryKey(const IPCClientMessage& msg)
+    {
+        ModelMemoryKey key;
+        memcpy(key.digest.data(), msg.alloc.regions, sizeof(key.digest));
+        key.rmapSize = msg.npu_acc.datas[0];
+        key.weightSize = msg.npu_acc.datas[1];
+        key.exact = msg.npu_acc.datas[2];
+        return key;
+    }
+
     inline DXRT_API std::ostream& operator<<(std::ostream& os, const IPCClientMessage& clientMessage)
     {
         os << "client-message code=" << clientMessage.code;
@@ -201,6 +270,9 @@ namespace dxrt
             m[dxrt::REQUEST_CODE::VIEW_USED_MEMORY] = "VIEW_USED_MEMORY";
             m[dxrt::REQUEST_CODE::VIEW_AVAILABLE_DEVICE] = "VIEW_AVAILABLE_DEVICE"; 
             m[dxrt::REQUEST_CODE::GET_USAGE] = "GET_USAGE";  
+            m[dxrt::REQUEST_CODE::ACQUIRE_MODEL_MEMORY] = "ACQUIRE_MODEL_MEMORY";
+            m[dxrt::REQUEST_CODE::MODEL_MEMORY_READY] = "MODEL_MEMORY_READY";
+            m[dxrt::REQUEST_CODE::GET_MEMORY_BATCH] = "GET_MEMORY_BATCH";
             
             m[dxrt::REQUEST_CODE::MEMORY_ALLOCATION_AND_TRANSFER_MODEL] = "MEMORY_ALLOCATION_AND_TRANSFER_MODEL";
             m[dxrt::REQUEST_CODE::COMPLETE_TRANSFER_MODEL] = "COMPLETE_TRANSFER_MODEL";
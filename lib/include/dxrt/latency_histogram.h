@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include "dxrt/common.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace dxrt {
+
+/** @brief Stages of an inference request measured by the always-on latency histograms. */
+enum class PipelineStage : int
+{
+    SUBMIT_TO_ENCODE = 0,  ///< RunAsync submit until the NPU input format encode is done (includes NFH queueing)
+    ENCODE_TO_WRITE,       ///< encode done until the input DMA write to the device is done (includes device queueing)
+    NPU,                   ///< NPU core time reported by the device
+    READ_TO_DECODE,        ///< response received until the output DMA read and format decode are done
+    CALLBACK,              ///< user callback of the job
+    END_TO_END,            ///< RunAsync submit until all tasks of the job are done, before the callback
+    COUNT
+};
+
+DXRT_API const char* PipelineStageName(PipelineStage stage);
+
+/** @brief Latency summary of one stage, all times in microseconds. */
+struct DXRT_API LatencyStats
+{
+    uint64_t count = 0;
+    double mean = 0;
+    double max = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double p999 = 0;
+};
+
+// Log-linear latency histogram in microseconds with a fixed footprint.
+// Values below 64us have their own bucket, above that every power of two is split into 32 buckets,
+// so a recorded value is off by at most ~3%; everything beyond 2^32us lands in the last bucket.
+// Record() only does relaxed atomic increments, so any number of threads can record while another
+// one reads a snapshot; a snapshot is not an atomic cut but every count in it is real.
+class DXRT_API LatencyHistogram
+{
+ public:
+    static constexpr int LINEAR_BUCKETS = 64;
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int MAX_POWER = 32;
+    static constexpr int BUCKETS = LINEAR_BUCKETS + (MAX_POWER - 6) * (1 << SUB_BUCKET_BITS);
+
+    struct Counts
+    {
+        std::vector<uint64_t> buckets;
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        // counts recorded since prev; max becomes the upper edge of the highest bucket hit
+        Counts Since(const Counts& prev) const;
+    };
+
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(uint64_t us);
+    Counts Snapshot() const;
+    LatencyStats Stats() const { return Summarize(Snapshot()); }
+    void Reset();
+
+    static LatencyStats Summarize(const Counts& counts);
+    static int BucketOf(uint64_t us);
+    static uint64_t BucketLow(int bucket);
+    static uint64_t BucketHigh(int bucket);
+
+ private:
+    std::atomic<uint64_t> _buckets[BUCKETS];
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _max;
+};
+
+// steady clock timestamp used for the stage stamps of a request, 0 means not stamped
+inline uint64_t LatencyClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace dxrt
@@ -16,6 +16,8 @@
 #include <unordered_map>
 #include <map>
 #include <queue>
+#include <set>
+#include <utility>
 
 namespace dxrt {
 
@@ -86,6 +88,9 @@ public:
 private:
     // Core memory management
     std::map<uint64_t, MemoryNode> _pool;
+    // (size, addr) of every free node in _pool, so best-fit is a lower_bound instead of a scan.
+    // Free nodes are merged with their free neighbors as soon as they are released.
+    std::set<std::pair<uint64_t, uint64_t>> _freeIndex;
     uint64_t _start = 0;
     uint64_t _cur = 0;
     uint64_t _end = 0;
@@ -98,6 +103,9 @@ private:
     // Helper functions
     uint64_t AlignSize(uint64_t size) const;
     std::map<uint64_t, MemoryNode>::iterator FindBestFit(uint64_t required);
+    std::map<uint64_t, MemoryNode>::iterator FindBestFitBackward(uint64_t required);
+    void SetFree(uint64_t addr, uint64_t size);
+    void SetBusy(uint64_t addr, uint64_t size);
     void MergeAllAdjacentFreeBlocks();
     MemoryFragmentationInfo GetFragmentationInfoNoLock() const;
 };
@@ -27,6 +27,7 @@
 
 #include "dxrt/datatype.h"
 #include "dxrt/common.h"
+#include "dxrt/model_file.h"
 
 #define MIN_COMPILER_VERSION "1.18.1"
 #define MIN_SINGLEFILE_VERSION 6
@@ -39,7 +40,7 @@ struct DXRT_API Models {
     std::string &npu()     { return _npu; }
     std::string &name()    { return _name; }  // npu task name
     std::string &str()     { return _str; }  // info json data
-    std::vector<char> &buffer()   { return _buffer; }  // binary data
+    dxrt::ModelSection &buffer()   { return _buffer; }  // binary data
     int64_t &offset() { return _offset; }
     int64_t &size()   { return _size; }
 
@@ -47,14 +48,14 @@ struct DXRT_API Models {
     const std::string &npu() const     { return _npu; }
     const std::string &name() const    { return _name; }  // npu task name
     const std::string &str() const     { return _str; }  // info json data
-    const std::vector<char> &buffer() const   { return _buffer; }  // binary data
+    const dxrt::ModelSection &buffer() const   { return _buffer; }  // binary data
     const int64_t &offset() const { return _offset; }
     const int64_t &size() const   { return _size; }
 
     std::string _npu;
     std::string _name;
     std::string _str;
-    std::vector<char> _buffer;
+    dxrt::ModelSection _buffer;
     int64_t _offset = 0;
     int64_t _size = 0;
 };
@@ -441,6 +442,8 @@ DXRT_API int ParseModel(std::string file, const ParseOptions& options);
 //DXRT_API ModelDataBase LoadModelParam(std::string file, int bufferCount);
 DXRT_API std::string LoadModelParam(ModelDataBase& modelDB, std::string file, int bufferCount = DXRT_TASK_MAX_LOAD_VALUE);
 DXRT_API std::string LoadModelParam(ModelDataBase& modelDB, const uint8_t* modelBuffer, size_t modelSize, int bufferCount = DXRT_TASK_MAX_LOAD_VALUE);
+// Sections reference the file's memory instead of being copied out of it
+DXRT_API std::string LoadModelParam(ModelDataBase& modelDB, std::shared_ptr<const ModelFile> modelFile, int bufferCount = DXRT_TASK_MAX_LOAD_VALUE);
 DXRT_API int LoadGraphInfo(deepx_graphinfo::GraphInfoDatabase& graphInfo, ModelDataBase& data);
 DXRT_API int LoadBinaryInfo(deepx_binaryinfo::BinaryInfoDatabase& binInfo,char *buffer, int fileSize);
 DXRT_API std::string LoadRmapInfo(deepx_rmapinfo::rmapInfoDatabase& rampInfo, ModelDataBase& data);
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+
+namespace dxrt {
+
+/**
+ * @brief Whole .dxnn file held in memory, either read into the heap or mapped read-only.
+ *
+ * A mapped file is backed by the page cache, so its pages can be handed back to the
+ * OS once their contents live on the device and are faulted in again from the file
+ * if they are ever read later. The file must not be truncated or rewritten in place
+ * while it is mapped.
+ */
+class DXRT_API ModelFile
+{
+ public:
+    /**
+     * @brief Loads path into memory.
+     * @param useMmap Map the file instead of reading it; falls back to reading if mapping fails.
+     * @throws FileNotFoundException if the file cannot be opened.
+     */
+    static std::shared_ptr<const ModelFile> Open(const std::string& path, bool useMmap);
+
+    /** @brief True when DXRT_MODEL_MMAP=1 asks for mapped model loading. */
+    static bool MmapEnabled();
+
+    ~ModelFile();
+    ModelFile(const ModelFile&) = delete;
+    ModelFile& operator=(const ModelFile&) = delete;
+
+    const uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+    bool isMapped() const { return _mapped; }
+
+    /** @brief Drops the resident pages fully inside [ptr, ptr + size); no-op for heap files. */
+    void ReleasePages(const uint8_t* ptr, size_t size) const;
+
+ private:
+    ModelFile() = default;
+
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;
+    std::vector<uint8_t> _heap;
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif
+};
+
+/**
+ * @brief Immutable, cheaply copyable view of one binary section of a model (rmap, weight, ...).
+ *
+ * The bytes belong to a shared backing store, either a ModelFile or a private heap copy.
+ * Copies share that store, so the parsed model and every Task built from it reference
+ * the same bytes instead of duplicating them.
+ */
+class DXRT_API ModelSection
+{
+ public:
+    ModelSection() = default;
+
+    /** @brief Owns a private copy of size bytes at src. */
+    ModelSection(const void* src, size_t size);
+
+    /** @brief Views size bytes at offset inside file; the section keeps file alive. */
+    ModelSection(std::shared_ptr<const ModelFile> file, size_t offset, size_t size);
+
+    const uint8_t* data() const { return _ptr; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    const uint8_t* begin() const { return _ptr; }
+    const uint8_t* end() const { return _ptr + _size; }
+
+    /** @brief Lets the OS reclaim the pages of a file-mapped section; no-op otherwise. */
+    void ReleasePages() const;
+
+ private:
+    std::shared_ptr<const void> _backing;
+    const ModelFile* _file = nullptr;
+    const uint8_t* _ptr = nullptr;
+    size_t _size = 0;
+};
+
+}  // namespace dxrt
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "dxrt/common.h"
+
+namespace dxrt {
+
+/** @brief Identity of a model's device-resident parameters: same key means same rmap and weight bytes. */
+struct DXRT_API ModelMemoryKey
+{
+    std::array<uint8_t, 32> digest{};   // SHA-256 of the rmap followed by the weight
+    uint32_t rmapSize = 0;
+    uint32_t weightSize = 0;
+    uint32_t exact = 0;                 // 1: digest of every byte, 0: of sampled windows only
+
+    bool operator<(const ModelMemoryKey& other) const;
+};
+
+/** @brief Device regions handed out for a model's rmap and weight. */
+struct DXRT_API ModelMemoryRegion
+{
+    enum class State : uint32_t
+    {
+        ALLOCATED = 0,  ///< fresh regions; the caller uploads them and calls MarkResident()
+        RESIDENT = 1,   ///< identical parameters are already on the device; nothing to upload
+        PENDING = 2,    ///< another loader is still uploading the same model; acquire again shortly
+        FAILED = 3,     ///< out of device memory
+    };
+
+    State state = State::FAILED;
+    int64_t rmapOffset = -1;
+    int64_t weightOffset = -1;
+};
+
+/**
+ * @brief Refcounted table of model parameter regions on one device.
+ *
+ * Tasks that load the same rmap and weight (by ModelMemoryKey) share one copy in device
+ * memory. Each (pid, task id) holding an entry is one reference. The regions are returned
+ * to the allocator when the last reference is released. The class does not lock; callers
+ * serialize access with the lock that guards their allocator.
+ */
+class DXRT_API ModelMemoryCache
+{
+ public:
+    using AllocateFunc = std::function<int64_t(uint64_t)>;
+    using DeallocateFunc = std::function<void(uint64_t)>;
+
+    /**
+     * @brief Looks up key and adds a reference for (pid, taskId), allocating on a miss.
+     *
+     * A miss allocates the weight and then the rmap region from the top of memory,
+     * keeping the rmap below the weight, and leaves the entry pending until MarkResident().
+     * (pid, taskId) becomes the loader that uploads the regions. A concurrent acquirer of the
+     * same model gets PENDING and is recorded as a user, so the regions stay alive while it
+     * waits; it calls Acquire() again until the upload is RESIDENT, and Release() if it gives up.
+     * If the loader is released before MarkResident(), the entry is dropped together with the
+     * references of its waiters, and their next Acquire() starts a new upload.
+     */
+    ModelMemoryRegion Acquire(const ModelMemoryKey& key, pid_t pid, int taskId,
+        const AllocateFunc& alloc, const DeallocateFunc& dealloc);
+
+    /** @brief Marks the regions of key as uploaded so later Acquire() calls share them. */
+    void MarkResident(const ModelMemoryKey& key);
+
+    /** @brief Drops the reference of (pid, taskId); frees entries that lose their last user. */
+    void Release(pid_t pid, int taskId, const DeallocateFunc& dealloc);
+
+    /** @brief Drops every reference held by pid (process exit or crash cleanup). */
+    void ReleaseProcess(pid_t pid, const DeallocateFunc& dealloc);
+
+    size_t size() const { return _entries.size(); }
+
+ private:
+    struct Entry
+    {
+        ModelMemoryRegion region;
+        bool resident = false;
+        std::pair<pid_t, int> loader;
+        std::set<std::pair<pid_t, int>> users;
+    };
+
+    void releaseIf(const std::function<bool(const std::pair<pid_t, int>&)>& pred, const DeallocateFunc& dealloc);
+
+    std::map<ModelMemoryKey, Entry> _entries;
+};
+
+}  // namespace dxrt
@@ -65,8 +65,34 @@ public:
         _taskBufferCount = bufferCount;
     }
 
+    /**
+     * @brief Declare that the buffer passed to ParseModel lives inside modelFile
+     * @param modelFile File whose memory the parsed sections may reference without copying
+     */
+    void SetBackingFile(std::shared_ptr<const ModelFile> modelFile)
+    {
+        _backingFile = std::move(modelFile);
+    }
+
 protected:
+    /**
+     * @brief Section of size bytes at src: a view into the backing file when src lies
+     *        inside it, otherwise a private copy (caller-owned buffers may go away)
+     */
+    ModelSection makeSection(const char* src, int64_t size) const
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(src);
+        size_t n = static_cast<size_t>(size);
+        if (_backingFile && p >= _backingFile->data() &&
+            n <= _backingFile->size() - static_cast<size_t>(p - _backingFile->data()))
+        {
+            return ModelSection(_backingFile, static_cast<size_t>(p - _backingFile->data()), n);
+        }
+        return ModelSection(src, n);
+    }
+
     int _taskBufferCount = DXRT_TASK_MAX_LOAD_VALUE;
+    std::shared_ptr<const ModelFile> _backingFile;
 };
 
 /**
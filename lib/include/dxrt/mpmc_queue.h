@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace dxrt {
+
+/**
+ * @brief Bounded lock-free multi-producer / multi-consumer FIFO ring.
+ *
+ * Each slot carries a sequence number that tells producers and consumers whether
+ * the slot is free for the current lap, so push and pop only contend on one
+ * compare-and-swap of their own cursor. Capacity is rounded up to a power of two.
+ * T must be default-constructible and move-assignable.
+ */
+template <typename T>
+class MpmcQueue
+{
+public:
+    explicit MpmcQueue(size_t capacity)
+    {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        _mask = cap - 1;
+        _cells.reset(new Cell[cap]);
+        for (size_t i = 0; i < cap; i++)
+        {
+            _cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /** @brief Appends x; returns false without blocking if the ring is full. */
+    bool TryPush(const T& x)
+    {
+        Cell* cell;
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &_cells[pos & _mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0)
+            {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = x;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Removes the oldest item into out; returns false without blocking if the ring is empty. */
+    bool TryPop(T& out)
+    {
+        Cell* cell;
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &_cells[pos & _mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0)
+            {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        // Move out so the slot does not keep shared objects alive until it is reused
+        out = std::move(cell->data);
+        cell->data = T();
+        cell->seq.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return _mask + 1; }
+
+    /** @brief Approximate number of queued items (exact only when no push/pop is in flight). */
+    size_t size() const
+    {
+        size_t enq = _enqueuePos.load(std::memory_order_acquire);
+        size_t deq = _dequeuePos.load(std::memory_order_acquire);
+        return enq > deq ? enq - deq : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    // Padding keeps the producer and consumer cursors on separate cache lines
+    // (explicit bytes rather than alignas, which heap allocation does not honor before C++17)
+    std::unique_ptr<Cell[]> _cells;
+    size_t _mask = 0;
+    char _pad0[64];
+    std::atomic<size_t> _enqueuePos{0};
+    char _pad1[64];
+    std::atomic<size_t> _dequeuePos{0};
+    char _pad2[64];
+};
+
+}  // namespace dxrt
@@ -10,6 +10,7 @@
 #pragma once
 #include <cstdint>
 #include <mutex>
+#include <vector>
 #include "dxrt/driver.h"
 #include "../include/dxrt/ipc_wrapper/ipc_client_wrapper.h"
 
@@ -49,6 +50,8 @@ public:
     explicit MultiprocessMemory();
     uint64_t Allocate(int deviceId, uint64_t required);
     uint64_t BackwardAllocate(int deviceId, uint64_t required);
+    // fails at once with -1 instead of waiting for memory to be freed
+    uint64_t TryAllocate(int deviceId, uint64_t required);
     void Deallocate(int deviceId, uint64_t addr);
     void DeallocateAll(int deviceId);
     uint64_t start();
@@ -56,6 +59,15 @@ public:
     uint64_t size();
     uint64_t AllocateForTask(int deviceId, int taskId, uint64_t required);
     uint64_t BackwardAllocateForTask(int deviceId, int taskId, uint64_t required);
+    /**
+     * @brief Allocates several regions with one service round trip per IPC_ALLOC_BATCH_MAX regions.
+     *
+     * All regions are allocated or none. When memory is short the service holds the request
+     * and retries it as memory is freed, for up to ALLOC_WAIT_MS.
+     * @param taskId owning task, or -1 for regions freed one by one with Deallocate().
+     * @return offsets in the order of sizes; empty on failure.
+     */
+    std::vector<uint64_t> AllocateBatch(int deviceId, int taskId, const std::vector<uint64_t>& sizes, bool backward);
     void SignalScheduller(int deviceId, const dxrt_request_acc_t& req);
     void SignalEndJobs(int deviceId);
     void SignalDeviceInit(int deviceId, npu_bound_op bound, int weightSize, int weightOffset, uint32_t checksum);
@@ -64,10 +76,24 @@ public:
     void SignalTaskInit(int deviceId, int taskId, npu_bound_op bound, uint64_t modelMemorySize);
     void SignalTaskDeInit(int deviceId, int taskId, npu_bound_op bound);
     void DeallocateTaskMemory(int deviceId, int taskId);
+    /**
+     * @brief Gets the shared rmap/weight regions of key in one service round trip.
+     *
+     * When memory is short or another process is still uploading the same model, the service
+     * holds the request for up to waitMs and answers as soon as that changes; a request that
+     * times out reports FAILED and leaves no reference behind.
+     */
+    ModelMemoryRegion AcquireModelMemory(int deviceId, int taskId, const ModelMemoryKey& key, uint32_t waitMs);
+    void SignalModelMemoryReady(int deviceId, const ModelMemoryKey& key);
+
+    // How long the service may hold an allocation waiting for free memory (was 20 retries x 2s)
+    static constexpr uint32_t ALLOC_WAIT_MS = 40000;
 
 private:
     void mpConnect();
     void mpConnect_once_wrapper();
+    bool sendAllocateBatch(int deviceId, int taskId, const uint64_t* sizes, uint32_t count, bool backward,
+        uint64_t* addrs, uint32_t waitMs = ALLOC_WAIT_MS);
 
     std::once_flag _connectFlag;
 
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include "dxrt/common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dxrt {
+
+/**
+ * @brief Process-wide worker pool that splits NPU format handler work into chunks.
+ *
+ * Every ParallelFor call publishes one job. Pool workers claim chunks from the active
+ * jobs in round-robin order through a per-job atomic cursor, so one large request
+ * cannot monopolize the pool while other requests are waiting. The calling thread
+ * works on its own job as well, which keeps nested calls and an empty pool deadlock-free.
+ * The pool size is set by NFH_PARALLEL_WORKER_THREADS (0 runs everything inline).
+ */
+class DXRT_API NfhWorkerPool
+{
+ public:
+    static NfhWorkerPool& GetInstance();
+
+    /**
+     * @brief Runs fn(begin, end) over [0, count) in chunks of grain items and returns when all chunks are done.
+     * Runs inline when grain >= count or the pool has no workers.
+     */
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    /**
+     * @brief Chunk size (in items) for count items of itemBytes bytes each.
+     * Chunks are never smaller than the minimum chunk size in bytes; returns count
+     * when the work is too small to be worth splitting.
+     */
+    size_t GrainFor(size_t count, size_t itemBytes) const;
+
+    size_t numThreads() const { return _threads.size(); }
+
+    ~NfhWorkerPool();
+
+ private:
+    struct Job
+    {
+        const std::function<void(size_t, size_t)>* fn = nullptr;
+        size_t count = 0;
+        size_t grain = 0;
+        size_t numChunks = 0;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+    };
+
+    explicit NfhWorkerPool(int numThreads);
+
+    bool runChunk(Job& job);
+    void removeJob(const std::shared_ptr<Job>& job);
+    void workerThread();
+
+    std::vector<std::thread> _threads;
+    std::vector<std::shared_ptr<Job>> _jobs;
+    size_t _cursor = 0;
+    std::mutex _lock;
+    std::condition_variable _cv;
+    std::condition_variable _doneCv;
+    std::atomic<bool> _stop{false};
+};
+
+}  // namespace dxrt
@@ -62,9 +62,30 @@ namespace npu_format_handler {
         static int encode_formatted_transposed(
             Bytes& input, Bytes& output, int row, int col, size_t element_size, int unit = 64);
 
+        /**
+         * @brief Transposes and aligns data in a single pass (ALIGNED layout counterpart of
+         * encode_formatted_transposed).
+         * Equivalent to bidirectional_transpose(src, temp, row, col, element_size) followed by
+         * encode(temp, dst, row * element_size, unit * element_size).
+         *
+         * @param input Input Bytes struct containing the original matrix data (row x col).
+         * input.size must be equal to row * col * element_size.
+         * @param output Output Bytes struct. Must have pre-allocated data buffer.
+         * Required size = col * cdiv(row, unit) * unit * element_size.
+         * @param row Number of rows in the original input matrix (channels).
+         * @param col Number of columns in the original input matrix.
+         * @param element_size Size of a single data element in bytes.
+         * @param unit The alignment unit in elements (typically 64).
+         * @return 0 on success, -1 on error.
+         */
+        static int encode_aligned_transposed(
+            Bytes& input, Bytes& output, int row, int col, size_t element_size, int unit = 64);
+
         /**
          * @brief Decodes aligned data from the NPU and transposes it according to the specified method,
          * storing the final result in the output buffer. (Combines Decode + Transpose)
+         * The decoded (rows x channel_for_decode) matrix is written transposed, i.e. as
+         * (channel_for_decode x rows), stripping the alignment padding in the same pass.
          * @param input Encoded NPU data (Bytes struct).
          * @param output Buffer to store the final result (Bytes struct). The function sets the calculated size in output.size.
          * @param channel_for_decode The number of channels (columns) to be used during decoding. Typically the last dimension of shape_encoded.
@@ -78,8 +99,43 @@ namespace npu_format_handler {
             std::vector<int64_t> shape_encoded,
             int transpose_type, int align_unit = 64);
 
+        /**
+         * @brief Checks whether encode_formatted_transposed gives the same bytes as the
+         * encode_formatted + in-place transpose that EncodeInputs applies to a FORMATTED
+         * CHANNEL_FIRST_TO_LAST tensor. That composition formats the channel-first data before
+         * transposing it, so the two only agree when the channel fills exactly one align unit.
+         */
+        static bool is_formatted_transposed_exact(int channel, int align_unit);
+
+        /**
+         * @brief Checks whether encode_aligned_transposed / decode_aligned_transposed give the same
+         * bytes as the transpose + encode and decode_aligned + transpose compositions of
+         * EncodeInputs / DecodeOutputs for an ALIGNED tensor with a transpose. The compositions
+         * align in elements only for 1-byte and FLOAT32 data, other types in bytes, which is the
+         * same layout only when no padding is needed.
+         */
+        static bool is_aligned_transposed_exact(int channel, deepx_rmapinfo::DataType dtype, int align_unit);
+
+        /**
+         * @brief Checks whether EncodeInputs would leave an input tensor byte-for-byte unchanged.
+         * True for plain-copy layouts, for ALIGNED tensors without transpose whose channel is already
+         * a multiple of align_unit and for FORMATTED tensors without transpose whose channel is one
+         * align_unit group (or a multiple of it on a single row), provided the encoded size equals user_size.
+         * @param tensor_info NPU tensor metadata from rmap_info.
+         * @param user_size Size of the user tensor in bytes.
+         */
+        static bool IsInputLayoutIdentical(deepx_rmapinfo::TensorInfo& tensor_info, uint64_t user_size);
+
+        /**
+         * @brief Checks whether DecodeOutputs reduces to a plain copy for an output tensor.
+         * ARGMAX and PPU outputs never qualify.
+         * @param tensor_info NPU tensor metadata from rmap_info.
+         * @param user_size Size of the user tensor in bytes.
+         */
+        static bool IsOutputLayoutIdentical(deepx_rmapinfo::TensorInfo& tensor_info, uint64_t user_size);
+
         // --- High-level NFH Processing Functions ---
-        
+
         /**
          * @brief High-level input encoding function for NPU inference requests.
          * Performs appropriate format encoding based on tensor layout and transpose settings.
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace npu_format_handler {
+namespace kernels {
+
+    /**
+     * @brief Instruction set used by the row copy kernels.
+     */
+    enum class Isa {
+        SCALAR = 0,  ///< Portable memcpy/memset fallback.
+        NEON,        ///< aarch64 Advanced SIMD (128-bit).
+        AVX2,        ///< x86-64 AVX2 (256-bit).
+        AVX512       ///< x86-64 AVX-512F/BW (512-bit, masked tails).
+    };
+
+    /**
+     * @brief Copies a 2D block of rows and zero-fills the trailing bytes of each destination row.
+     *
+     * For every row r in [0, rows):
+     *   dst[r * dst_stride + 0 .. copy_bytes)                      <- src[r * src_stride + 0 .. copy_bytes)
+     *   dst[r * dst_stride + copy_bytes .. copy_bytes + pad_bytes)  <- 0
+     *
+     * Every destination byte is written exactly once, so callers do not need to clear
+     * the output buffer beforehand. src and dst must not overlap.
+     * The result is bit-identical for every Isa.
+     */
+    void copy_rows(uint8_t* dst, size_t dst_stride,
+                   const uint8_t* src, size_t src_stride,
+                   size_t rows, size_t copy_bytes, size_t pad_bytes);
+
+    /**
+     * @brief Out-of-place transpose of a row-major (row x col) matrix into a (col x row) matrix.
+     *
+     * Cache-blocked in tiles; inside a tile, square register blocks are transposed with
+     * 128-bit SIMD micro-kernels specialized for 1-, 2- and 4-byte elements
+     * (SSE2 on x86-64, NEON on aarch64). Other element sizes use the tiled scalar path.
+     * src and dst must not overlap.
+     */
+    void transpose(const uint8_t* src, uint8_t* dst, size_t row, size_t col, size_t element_size);
+
+    /**
+     * @brief Strided transpose with destination padding, the fused form of transpose + encode/decode.
+     *
+     * Element (i, j) of the (row x col) source, whose rows start src_stride bytes apart, is written
+     * to destination row j at byte offset i * element_size; destination rows start dst_stride bytes
+     * apart. The pad_bytes after the row * element_size payload of every destination row are zeroed.
+     * - encode (transpose + pad):  src_stride = col * element_size, dst_stride = payload + pad_bytes
+     * - decode (strip + transpose): src_stride = aligned source row, dst_stride = row * element_size
+     * src and dst must not overlap.
+     */
+    void transpose_strided(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                           size_t row, size_t col, size_t element_size, size_t pad_bytes);
+
+    /**
+     * @brief In-place transpose of a row-major (row x col) matrix.
+     *
+     * Square matrices swap mirrored tiles through a register-sized scratch block.
+     * Rectangular matrices are decomposed into column-rotate / row-shuffle / column-shuffle
+     * passes that need max(row, col) elements of scratch instead of a full temporary copy.
+     * @return 0 on success, -1 if the scratch could not be allocated.
+     */
+    int transpose_inplace(uint8_t* data, size_t row, size_t col, size_t element_size);
+
+    /**
+     * @brief Returns the kernel set selected for this process.
+     * Selected once from CPUID (x86-64) or the target architecture (aarch64).
+     * Can be lowered with the DXRT_NFH_KERNEL environment variable (scalar, neon, avx2, avx512).
+     */
+    Isa active_isa();
+
+    const char* isa_name(Isa isa);
+
+}  // namespace kernels
+}  // namespace npu_format_handler
@@ -10,49 +10,118 @@
 #pragma once
 
 #include "dxrt/common.h"
+#include "dxrt/mpmc_queue.h"
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
-#include <mutex>
-#include <iostream>
-#include <condition_variable>
-#include <memory>
-
-
 
 
 namespace dxrt {
 class DeviceTaskLayer;
 
-class TaskNpuMemoryCacheManager
+/** @brief Occupancy of the per-request I/O region cache of one device. */
+struct DXRT_API NpuMemoryCacheStats
 {
-public:
-    TaskNpuMemoryCacheManager(int64_t size, int count, int64_t offset);
-    int64_t getNpuMemoryCache();
-    void returnNpuMemoryCache(int64_t addr);
-    int64_t getOffset();
-    ~TaskNpuMemoryCacheManager();
-private:
-    std::vector<int64_t> _npuMemoryCaches;
-    int64_t _npuMemoryCacheOffset;
-    std::mutex _lock;
-    std::condition_variable _cv;
+    struct SlabClass
+    {
+        int64_t size = 0;    ///< bytes per slab
+        int tasks = 0;       ///< registered tasks whose regions round up to this size
+        int slabs = 0;       ///< slabs allocated on the device
+        int inUse = 0;       ///< slabs handed out right now
+        int highWater = 0;   ///< most slabs handed out at once
+    };
+    std::vector<SlabClass> classes;
+    int64_t reservedBytes = 0;           ///< device memory held by the cache
+    int64_t reservedHighWaterBytes = 0;  ///< most device memory held by the cache at once
+    int64_t inUseBytes = 0;              ///< device memory handed out to requests
+    int64_t inUseHighWaterBytes = 0;     ///< most device memory handed out at once
+    uint64_t borrowed = 0;               ///< regions served by a slab of a larger size class
+    uint64_t trimmed = 0;                ///< idle slabs given back to the device memory pool
 };
 
+// Per-request I/O regions of all tasks on one device, shared by every engine of the process.
+// Region sizes are rounded up to size classes (64 byte steps below 512 bytes, then 8 classes per
+// power of two, so at most 12.5% is wasted) and every class keeps its idle slabs in a lock-free
+// ring: getting and returning a region is one pop or push when a slab is idle. When a class runs
+// dry a region may come from a slab of a larger class of up to twice the size, otherwise the class
+// grows by one slab without waiting for device memory, giving back idle slabs of other classes
+// first when the device is full; only when that fails too the request waits for a slab to return.
+// A registered task holds at most `count` regions at once and keeps one slab of its class in
+// reserve, everything above that is allocated on demand and can be trimmed when memory is short.
 class NpuMemoryCacheManager
 {
 public:
+    static constexpr int64_t SLAB_ALIGN = 64;
+    static constexpr int SLAB_CLASS_STEPS = 8;        // size classes per power of two
+    static constexpr int SLAB_CLASS_CAPACITY = 256;   // most slabs of one size class
+    static constexpr int64_t BORROW_RATIO = 2;        // largest slab that may serve a region, relative to its class
+    static constexpr int WAIT_POLL_MS = 10;
+
     explicit NpuMemoryCacheManager(DeviceTaskLayer* device_);
     bool registerMemoryCache(int taskId, int64_t size, int count);
     void unRegisterMemoryCache(int taskId);
     bool canGetCache(int taskId);
     int64_t getNpuMemoryCache(int taskId);
     void returnNpuMemoryCache(int taskId, int64_t addr);
+
+    // gives idle slabs above the per-task reserve back to the device memory pool, returns the bytes released
+    int64_t trim();
+    NpuMemoryCacheStats stats() const;
+    static int64_t slabSize(int64_t size);
+
 private:
-    std::unordered_map<int, std::shared_ptr<TaskNpuMemoryCacheManager> > _taskNpuMemoryCaches;
+    struct SlabClass
+    {
+        explicit SlabClass(int64_t size_) : size(size_), idle(SLAB_CLASS_CAPACITY) {}
+        const int64_t size;
+        MpmcQueue<int64_t> idle;
+        std::atomic<int> tasks{0};      // slabs kept back from trim(), changed under _slabLock
+        std::atomic<int> slabs{0};      // changed under _slabLock
+        std::atomic<int> inUse{0};
+        std::atomic<int> highWater{0};
+    };
+    struct TaskCache
+    {
+        TaskCache(SlabClass* slabClass_, int limit_) : slabClass(slabClass_), limit(limit_) {}
+        SlabClass* slabClass;
+        const int limit;
+        std::atomic<int> inUse{0};
+    };
+
+    std::shared_ptr<TaskCache> findTask(int taskId);
+    bool tryAcquire(TaskCache& task);
+    int64_t handOut(SlabClass& slabClass, int64_t addr);
+    int64_t getSlow(TaskCache& task, bool acquired);
+    int64_t borrowLocked(SlabClass& slabClass);
+    int64_t growLocked(SlabClass& slabClass, std::unique_lock<std::mutex>& lock);
+    int64_t allocateSlab(int64_t size, bool wait);
+    void addReserved(int64_t size);
+    int64_t releaseIdle(SlabClass* only);
+    void wakeWaiters();
+
+    std::unordered_map<int, std::shared_ptr<TaskCache> > _taskNpuMemoryCaches;
     SharedMutex _npuMemoryCacheLock;
     DeviceTaskLayer* _device;
+
+    // slab classes are never removed, so their pointers stay valid for the lifetime of the manager
+    std::map<int64_t, std::unique_ptr<SlabClass> > _slabClasses;
+    mutable std::mutex _slabLock;   // slow path: class list, slab counts, borrowed slabs
+    std::condition_variable _cv;
+    std::atomic<int> _waiters{0};
+    std::unordered_map<int64_t, SlabClass*> _borrowed;
+    std::unordered_map<int64_t, SlabClass*> _slabOwners;   // every slab on the device, for regions returned after their task is gone
+    std::atomic<int> _borrowedCount{0};
+    std::atomic<int64_t> _reservedBytes{0};
+    std::atomic<int64_t> _reservedHighWater{0};
+    std::atomic<int64_t> _inUseBytes{0};
+    std::atomic<int64_t> _inUseHighWater{0};
+    std::atomic<uint64_t> _borrowedTotal{0};
+    std::atomic<uint64_t> _trimmedTotal{0};
 };
 
 }  // namespace dxrt
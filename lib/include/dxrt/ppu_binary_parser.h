@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <vector>
 #include "dxrt/datatype.h"
+#include "dxrt/model_file.h"
 
 namespace dxrt {
 
@@ -71,7 +72,7 @@ struct PpuOutputSizeInfo {
  * @param outputDataType The output data type (BBOX, FACE, or POSE)
  * @return PpuOutputSizeInfo containing size information, or nullopt if parsing fails
  */
-PpuOutputSizeInfo CalculatePpuOutputSize(const std::vector<uint8_t>& ppuBinaryData, 
+PpuOutputSizeInfo CalculatePpuOutputSize(const ModelSection& ppuBinaryData, 
                                          DataType outputDataType);
 
 /**
@@ -14,7 +14,9 @@
 #include <chrono>
 #include <vector>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <atomic>
 #include "dxrt/configuration.h"
 
 #ifdef USE_PROFILER
@@ -37,6 +39,64 @@ namespace dxrt {
     };
     using TimePointPtr = std::shared_ptr<TimePoint>;
 
+    /** \brief Interned name of a profiler event (see Profiler::Intern)
+    */
+    using ProfilerEventId = uint32_t;
+
+    /** \brief Events the runtime records through Profiler::Record
+    */
+    enum ProfilerEvent : ProfilerEventId
+    {
+        PROFILER_EVENT_NONE = 0,
+        PROFILER_EVENT_NPU_TASK,              ///< request on an NPU task, buffers acquired -> response
+        PROFILER_EVENT_CPU_TASK,              ///< request on a CPU task
+        PROFILER_EVENT_NPU_INPUT_FORMAT,      ///< NPU input format handler
+        PROFILER_EVENT_NPU_OUTPUT_FORMAT,     ///< NPU output format handler
+        PROFILER_EVENT_PCIE_WRITE,
+        PROFILER_EVENT_PCIE_READ,
+        PROFILER_EVENT_NPU_CORE,              ///< NPU execution from the driver / service timestamps
+        PROFILER_EVENT_SERVICE_WAIT,          ///< wait of the service for the response
+        PROFILER_EVENT_RESPONSE_DELAY,        ///< response received -> output handler entry
+        PROFILER_EVENT_BUILTIN_COUNT
+    };
+
+    /** \brief Arguments of a recorded span, negative values (0 for task) are not set
+    */
+    struct DXRT_API ProfilerArgs
+    {
+        int32_t job = -1;
+        int32_t request = -1;
+        int32_t channel = -1;       ///< DMA channel / NPU core / worker thread
+        ProfilerEventId task = 0;   ///< interned task name
+    };
+
+    struct ProfilerRecord
+    {
+        ProfilerEventId event;
+        ProfilerArgs args;
+        int64_t startNs;
+        int64_t endNs;
+    };
+
+    /** \brief One ring entry; seq is 2 * index + 1 while record is written and 2 * index + 2 once it holds that index
+    */
+    struct ProfilerSlot
+    {
+        std::atomic<uint64_t> seq{0};
+        ProfilerRecord record;
+    };
+
+    /** \brief Events of one recording thread: single writer ring, overwritten when full
+    */
+    struct ProfilerThreadEvents
+    {
+        explicit ProfilerThreadEvents(size_t capacity) : slots(capacity) {}
+        std::vector<ProfilerSlot> slots;
+        std::atomic<uint64_t> head{0};
+        uint64_t tid = 0;
+        uint64_t owner = 0;   ///< serial of the Profiler instance the buffer is registered to
+    };
+
     /** \brief This class provides time measurement API based on timestamp.
      * \headerfile "dxrt/dxrt_api.h"
     */
@@ -121,6 +181,36 @@ namespace dxrt {
 
         std::map<std::string, std::vector<int64_t>> GetPerformanceData();
 
+        /** \brief Whether the profiler records events (callers can skip building event names when false)
+        */
+        bool IsEnabled() const { return _enabled; }
+
+        /** \brief Intern a name for Record(); the same name always returns the same id
+         * \param[in] name event or task name
+         * \return id of the name
+        */
+        ProfilerEventId Intern(const std::string& name);
+        /** \brief Record a finished span of an event without locking.
+         * Spans go to a ring buffer of the calling thread, so they cost no string building and no
+         * shared lock on the inference path. They are included in Show(), Save() and SaveTrace().
+         * \code
+         * static const auto decode = profiler.Intern("Decode");
+         * auto start = dxrt::ProfilerClock::now();
+         * decode();
+         * profiler.Record(decode, start, dxrt::ProfilerClock::now());
+         * \endcode
+         * \param[in] event id from Intern() or a dxrt::ProfilerEvent
+         * \param[in] start start of the span
+         * \param[in] end end of the span
+         * \param[in] args job / request / channel / task of the span
+        */
+        void Record(ProfilerEventId event, ProfilerClock::time_point start, ProfilerClock::time_point end,
+            const ProfilerArgs& args = ProfilerArgs());
+        /** \brief Save all events as a Chrome trace (chrome://tracing, https://ui.perfetto.dev)
+         * \param[in] file file to save
+        */
+        void SaveTrace(const std::string& file);
+
 
         
 
@@ -132,6 +222,18 @@ namespace dxrt {
         std::map<std::string, std::vector<TimePoint>> timePoints; ///< start/end time points per events
         std::map<std::string, int> idx;  ///< next array index to save data
         std::mutex _lock;
+
+        // interned names and per-thread rings of Record(), guarded by _eventLock (not taken by Record)
+        static const size_t THREAD_EVENTS = 16384;  ///< records kept per recording thread
+        std::vector<std::string> _names;
+        std::map<std::string, ProfilerEventId> _nameIds;
+        std::vector<std::shared_ptr<ProfilerThreadEvents>> _threadEvents;
+        std::mutex _eventLock;
+        std::atomic<uint64_t> _serial;  ///< changes when the rings are dropped, threads then register new ones
+        ProfilerThreadEvents* threadEvents();
+        std::vector<ProfilerRecord> collectRecords(std::vector<uint64_t>* tids = nullptr);
+        std::string legacyName(const ProfilerRecord& record);
+
         bool _save_exit;
         bool _show_exit;
         bool _enabled;
@@ -36,6 +36,8 @@ using TimePointPtr = std::shared_ptr<TimePoint>;
 
 template<typename T>
 class CircularDataPool;
+template<typename T>
+class MpmcQueue;
 class InferenceJob;
 
 class DXRT_API Request
@@ -96,12 +98,21 @@ public:
     int16_t &model_type();
     void setInputs(Tensors input);
     void setOutputs(Tensors output);
+    /**
+     * @brief Lays the input tensors out like layout, tensor i pointing at base + offsets[i].
+     * The tensors are copy-assigned over the ones of the previous request and kept by Reset(),
+     * so a pooled request reuses their name and shape storage instead of allocating.
+     */
+    void assignInputs(const Tensors& layout, const std::vector<uint64_t>& offsets, void* base);
+    void assignOutputs(const Tensors& layout, const std::vector<uint64_t>& offsets, void* base);
 
     void setNpuInferenceAcc(dxrt_request_acc_t npuInferenceAcc);
     void setInferenceJob(InferenceJob* job);  // works for start next request or complete whole inference
     void onRequestComplete(RequestPtr req);
 
     void setBufferSet(std::unique_ptr<BufferSet> buffers);
+    /** @brief Stores buffers in the request's retained BufferSet slot (no allocation after first use). */
+    void setBufferSet(const BufferSet& buffers);
     void releaseBuffers();
     bool hasBufferSet() const;
     bool isBufferReleased() const;
@@ -133,9 +144,20 @@ private:
     uint32_t _infTime;
     InferenceJob*  _job;
     std::atomic<bool> _use_flag = {false};
+    std::shared_ptr<MpmcQueue<int>> _poolFreeIds;
+    int _poolIndex = -1;
     std::mutex _reqLock;
-
+    // Set while _data.inputs / outputs were filled by assignInputs() / assignOutputs() and only
+    // describe a task layout; tensors handed in through setInputs() / setOutputs() may own their
+    // data or an ORT value, so Reset() drops those
+    bool _inputsRetained = false;
+    bool _outputsRetained = false;
+
+    // Allocated on first use and kept for the lifetime of the pooled request;
+    // _hasBufferSet tells whether it currently holds acquired buffers
     std::unique_ptr<BufferSet> _bufferSet;
+    bool _hasBufferSet = false;
+    void releaseBufferSet();
     bool _bufferReleased = false;
     bool _is_validate_request = false;
     uint32_t _validate_output_size = 0;
@@ -40,6 +40,21 @@ public:
     void* encoded_inputs_ptr;
     void* encoded_outputs_ptr;
 
+    // Source of the input DMA when the NFH encode step was skipped (zero-copy input).
+    // Points at the user input block; encoded_inputs_ptr still owns the pooled buffer.
+    void* dma_input_ptr = nullptr;
+
+    // dxrt_service scheduling hints (InferenceJob::SetRequestSchedule)
+    uint32_t sched_priority = 0;
+    uint64_t deadline_us = 0;
+
+    // stage timestamps for the latency histograms (LatencyClockNs), 0 if the stage did not run
+    uint64_t submit_ns = 0;
+    uint64_t encoded_ns = 0;
+    uint64_t written_ns = 0;
+    uint64_t response_ns = 0;
+    uint64_t decoded_ns = 0;
+
     std::vector<void*> encoded_input_ptrs;
     std::vector<void*> encoded_output_ptrs;
 
@@ -17,6 +17,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <thread>
@@ -29,6 +30,7 @@
 #include "dxrt/ipc_wrapper/ipc_message.h"
 #include "dxrt/multiprocess_memory.h"
 #include "dxrt/memory.h"
+#include "dxrt/model_memory_cache.h"
 #include "dxrt/service_util.h"
 
 #ifdef __linux__
@@ -45,14 +47,35 @@ public:
     virtual void HandleInferenceAcc(const dxrt_request_acc_t &acc, int deviceId) = 0;
     virtual void SignalDeviceReset(int id) = 0;
     virtual uint64_t Allocate(int deviceId, uint64_t size) = 0;
+    /** @brief Allocates size without waiting for memory to be freed; returns -1 when it does not fit now. */
+    virtual uint64_t TryAllocate(int deviceId, uint64_t size) = 0;
     virtual void DeAllocate(int deviceId, int64_t addr) = 0;
     virtual uint64_t BackwardAllocateForTask(int deviceId, int taskId, uint64_t required) = 0;
+    /**
+     * @brief Allocates all of sizes or none in as few service round trips as possible.
+     * @param taskId owning task, or -1 for regions released one by one with DeAllocate().
+     * @return offsets in the order of sizes; empty on failure.
+     */
+    virtual std::vector<uint64_t> AllocateBatch(int deviceId, int taskId, const std::vector<uint64_t>& sizes,
+        bool backward) = 0;
     virtual void SignalEndJobs(int id) = 0;
     virtual void CheckServiceRunning() = 0;
     virtual bool isRunOnService() const = 0;
     virtual void RegisterDeviceCore(DeviceCore *core) = 0;
     virtual void SignalTaskInit(int deviceId, int taskId, npu_bound_op bound, uint64_t modelMemorySize) = 0;
     virtual void SignalTaskDeInit(int deviceId, int taskId, npu_bound_op bound) = 0;
+    /**
+     * @brief Gets the rmap/weight regions for a task, shared with any task that loaded an identical model.
+     *
+     * ALLOCATED regions must be uploaded and then announced with SignalModelMemoryReady();
+     * RESIDENT regions already hold the parameters. The task's reference is dropped by SignalTaskDeInit().
+     * While another task uploads the same model this waits for it, up to MODEL_MEMORY_WAIT_MS, so
+     * the result is never PENDING; FAILED after the wait leaves no reference behind.
+     */
+    virtual ModelMemoryRegion AcquireModelMemory(int deviceId, int taskId, const ModelMemoryKey& key) = 0;
+    virtual void SignalModelMemoryReady(int deviceId, const ModelMemoryKey& key) = 0;
+
+    static constexpr int MODEL_MEMORY_WAIT_MS = 60000;  // upload of the same model by another task
 };
 
 class DXRT_API ServiceLayer : public ServiceLayerInterface {
@@ -61,7 +84,10 @@ public:
     void HandleInferenceAcc(const dxrt_request_acc_t &acc, int deviceId) override;
     void SignalDeviceReset(int id) override;
     uint64_t Allocate(int deviceId, uint64_t size) override;
+    uint64_t TryAllocate(int deviceId, uint64_t size) override;
     uint64_t BackwardAllocateForTask(int deviceId, int taskId, uint64_t required) override;
+    std::vector<uint64_t> AllocateBatch(int deviceId, int taskId, const std::vector<uint64_t>& sizes,
+        bool backward) override;
     void DeAllocate(int deviceId, int64_t addr) override;
     void SignalEndJobs(int id) override;
     void CheckServiceRunning() override;
@@ -69,9 +95,13 @@ public:
     void RegisterDeviceCore(DeviceCore *core) override;
     void SignalTaskInit(int deviceId, int taskId, npu_bound_op bound, uint64_t modelMemorySize) override;
     void SignalTaskDeInit(int deviceId, int taskId, npu_bound_op bound) override;
+    ModelMemoryRegion AcquireModelMemory(int deviceId, int taskId, const ModelMemoryKey& key) override;
+    void SignalModelMemoryReady(int deviceId, const ModelMemoryKey& key) override;
+
 private:
     std::shared_ptr<MultiprocessMemory> _mem;
-    std::mutex _lock;
+    std::mutex _lock;       // one-way messages
+    std::mutex _syncLock;   // request/reply round trips; an allocation waiting for memory must not block frees
 };
 
 class DXRT_API NoServiceLayer : public ServiceLayerInterface {
@@ -79,7 +109,10 @@ public:
     void HandleInferenceAcc(const dxrt_request_acc_t &acc, int deviceId) override;
     void SignalDeviceReset(int id) override;
     uint64_t Allocate(int deviceId, uint64_t size) override;
+    uint64_t TryAllocate(int deviceId, uint64_t size) override;
     uint64_t BackwardAllocateForTask(int deviceId, int taskId, uint64_t required) override;
+    std::vector<uint64_t> AllocateBatch(int deviceId, int taskId, const std::vector<uint64_t>& sizes,
+        bool backward) override;
     void DeAllocate(int deviceId, int64_t addr) override;
     void SignalEndJobs(int id) override;
     void CheckServiceRunning() override;
@@ -87,9 +120,14 @@ public:
     void RegisterDeviceCore(DeviceCore *core) override;
     void SignalTaskInit(int deviceId, int taskId, npu_bound_op bound, uint64_t modelMemorySize) override;
     void SignalTaskDeInit(int deviceId, int taskId, npu_bound_op bound) override;
+    ModelMemoryRegion AcquireModelMemory(int deviceId, int taskId, const ModelMemoryKey& key) override;
+    void SignalModelMemoryReady(int deviceId, const ModelMemoryKey& key) override;
 private:
     std::map<int, std::shared_ptr<Memory>> _mems;
     std::map<int, DeviceCore*> _ptr;
+    std::map<int, ModelMemoryCache> _modelMemory;
+    std::mutex _modelMemoryLock;
+    std::condition_variable _modelMemoryCV;  // an upload was marked resident or released
 };
 
 } // namespace dxrt
@@ -60,8 +60,8 @@ using RequestPtr = std::shared_ptr<Request>;
 class DXRT_API Task
 {
 public:
-    Task(std::string name_, rmapinfo, int bufferCount_, std::vector<std::vector<uint8_t>>&&, npu_bound_op boundOp = N_BOUND_NORMAL, bool hasPpuBinary = false);
-    Task(std::string name_, rmapinfo, int bufferCount_, std::vector<std::vector<uint8_t>>&&, npu_bound_op boundOp, const std::vector<int>& deviceIds, bool hasPpuBinary = false);
+    Task(std::string name_, rmapinfo, int bufferCount_, std::vector<ModelSection>&&, npu_bound_op boundOp = N_BOUND_NORMAL, bool hasPpuBinary = false);
+    Task(std::string name_, rmapinfo, int bufferCount_, std::vector<ModelSection>&&, npu_bound_op boundOp, const std::vector<int>& deviceIds, bool hasPpuBinary = false);
 
     Task();
     ~Task(void);
@@ -123,6 +123,8 @@ public:
     const std::vector<int>& getDeviceIds();
     CpuHandle* getCpuHandle();
     int getNpuBoundOp();
+    uint32_t getSchedulePolicy() const { return _schedulePolicy; }
+    void setSchedulePolicy(uint32_t policy) { _schedulePolicy = policy; }
 
     TaskData* getData() {return &_taskData;}
     void setLastOutput(Tensors t);
@@ -142,7 +144,7 @@ public:
     std::string _onnxFile = "";
     std::vector<int> _device_ids;
 
-    std::vector< std::vector<uint8_t> > _data;
+    std::vector<ModelSection> _data;
 
     TaskPtr _next;
     TaskPtrs _prevTasks;
@@ -174,6 +176,7 @@ public:
 
     int _completeCnt = 1;
     int _boundOp = 0;
+    uint32_t _schedulePolicy = 0;
     int64_t _tailOffset = 0;
     static int nextId;
     static std::mutex _nextIdLock;
@@ -16,6 +16,7 @@
 #include "dxrt/tensor.h"
 #include "dxrt/model.h"
 #include "dxrt/driver.h"
+#include "dxrt/model_memory_cache.h"
 #include "dxrt/util.h"
 
 namespace dxrt {
@@ -30,13 +31,15 @@ class DXRT_API TaskData
 
     int id() const{return _id;}
     std::string name() const {return _name;}
+    // task name interned for Profiler::Record
+    uint32_t profiler_name_id() const {return _profilerNameId;}
     Processor processor() const {return _processor;}
 
     const Tensors& input_tensors() const {return _inputTensors;}
     const Tensors& output_tensors() const {return _outputTensors;}
 
 
-    void set_from_npu(const std::vector<std::vector<uint8_t>>& data_, bool hasPpuBinary = false);
+    void set_from_npu(const std::vector<ModelSection>& data_, bool hasPpuBinary = false);
     void set_from_cpu(std::shared_ptr<CpuHandle> cpuHandle);
 
     Tensors inputs(void* ptr, uint64_t phyAddr = 0);
@@ -46,12 +49,26 @@ class DXRT_API TaskData
     int output_size() const {return _outputSize;}
 
     uint32_t weightChecksum();
+    // Identity under which devices share one copy of the rmap / weight with identical tasks.
+    // Large images are hashed in sampled windows, so the key is cheap and leaves mmapped pages
+    // cold; a hit on such a key has to be checked against the bytes. Computed on first use
+    ModelMemoryKey modelMemoryKey();
+    // Key over every byte, for a task whose sampled key matched a different model
+    ModelMemoryKey exactModelMemoryKey();
 
     int encoded_input_size() const {return _encodedInputSize;}
     int encoded_output_size() const {return _encodedOutputSize;}
     int get_buffer_count() const { return _bufferCount; }
     int64_t NPU_block_size() const;
 
+    // Byte alignment the user input block needs to be DMA'd without an NFH copy
+    static constexpr uint64_t ZERO_COPY_INPUT_ALIGN = 64;
+
+    // true if every input is layout-identical and the encoded input block is packed like the user block
+    bool input_zero_copy() const {return _inputZeroCopy;}
+    // true if the user input pointers of a request can be handed to the DMA as-is
+    bool can_zero_copy(Tensors& inputs) const;
+
 private:
 
    void calculate_sizes() {
@@ -75,6 +92,7 @@ private:
  public:  // TODO(ykpark): make private
     int _id;
     std::string _name = "EMPTY";
+    uint32_t _profilerNameId = 0;
     Processor _processor = Processor::NONE_PROCESSOR;
 
     rmapinfo _info;
@@ -116,14 +134,22 @@ private:
     std::vector<deepx_rmapinfo::TensorInfo> _npuInputTensorInfos;
     std::vector<deepx_rmapinfo::TensorInfo> _npuOutputTensorInfos;
 
+    // Per-tensor flags decided at load: NPU layout is byte-identical to the user layout
+    std::vector<bool> _inputLayoutIdentical;
+    std::vector<bool> _outputLayoutIdentical;
+    bool _inputZeroCopy = false;
+
     bool _isArgMax = false;
     bool _isPPU = false;
     bool _isPPCPU = false; // v8 PPCPU model type
     uint32_t _ppuBinaryOffset = 0; // v8 PPCPU: device memory offset of PPU binary
 
+    ModelMemoryKey _modelMemoryKey;
+    bool _modelMemoryKeyValid = false;
+
     // Reference to binary data (rmap, weight, ppu if exists)
     // This is set by Task and used by Device for writing to device memory
-    const std::vector<std::vector<uint8_t>>* _data = nullptr;
+    const std::vector<ModelSection>* _data = nullptr;
 
     int _bufferCount{DXRT_TASK_MAX_LOAD_VALUE};
 
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include "dxrt/common.h"
+
+#include <string>
+#include <vector>
+
+namespace dxrt {
+
+/** @brief Kinds of runtime threads the placement policy knows about. */
+enum class ThreadRole : int
+{
+    NONE = 0,   ///< left to the scheduler
+    DEVICE_IO,  ///< event, response receiver and input/output handler threads of one device
+    NFH,        ///< NPU format handler queue threads and the NFH parallel worker pool
+    CPU_TASK,   ///< CPU task workers and the ONNX Runtime threads of their sessions
+};
+
+DXRT_API const char* ThreadRoleName(ThreadRole role);
+
+/** @brief Parses a Linux cpulist such as "0-7,16-23" into sorted core ids, empty when malformed. */
+DXRT_API std::vector<int> ParseCpuList(const std::string& list);
+
+/** @brief NUMA node of the PCIe function behind /dev/dxrt<deviceId>, -1 when unknown. */
+DXRT_API int GetDeviceNumaNode(int deviceId);
+
+/** @brief Cores of a NUMA node that this process may run on, empty when unknown. */
+DXRT_API std::vector<int> GetNumaNodeCpus(int node);
+
+/**
+ * @brief Cores a thread of the role should run on, empty to leave it to the scheduler.
+ * An explicit core list of the role (DXRT_DEVICE_IO_CPUS, DXRT_NFH_CPUS, DXRT_CPU_TASK_CPUS) wins;
+ * otherwise DXRT_THREAD_AFFINITY=numa puts device I/O threads on the cores of the card's NUMA node.
+ */
+DXRT_API std::vector<int> GetThreadPlacementCpus(ThreadRole role, int deviceId = -1);
+
+/** @brief Pins the calling thread according to the placement policy, returns false when it stays unpinned. */
+DXRT_API bool ApplyThreadPlacement(ThreadRole role, int deviceId = -1);
+
+/**
+ * @brief Pins the calling thread to the given cores for the lifetime of the object and restores
+ * its previous mask afterwards. Threads created meanwhile inherit the mask, and memory first
+ * touched meanwhile is placed on the NUMA node of those cores.
+ */
+class DXRT_API ScopedThreadPlacement
+{
+ public:
+    explicit ScopedThreadPlacement(const std::vector<int>& cpus);
+    ~ScopedThreadPlacement();
+    bool applied() const { return _applied; }
+
+    ScopedThreadPlacement(const ScopedThreadPlacement&) = delete;
+    ScopedThreadPlacement& operator=(const ScopedThreadPlacement&) = delete;
+
+ private:
+    bool _applied = false;
+    std::vector<int> _previous;
+};
+
+}  // namespace dxrt
@@ -28,6 +28,7 @@
 #include <sstream>
 #include <vector>
 #include <string>
+#include <array>
 
 #define data_align(x, a) ( a*( x/a) + (int)(((x%a)>0) ? a : 0) )
 
@@ -48,6 +49,25 @@ DXRT_API void* MemAlloc(size_t size, size_t align = 8, int value = 0);
 DXRT_API void MemFree(void **p);
 DXRT_API void DisplayCountdown(int seconds, std::string str);
 
+// SHA-256 (FIPS 180-4) digest, fed in any number of parts
+class DXRT_API Sha256
+{
+ public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+    void Update(const void *data, size_t size);
+    Digest Final();
+
+ private:
+    void transform(const uint8_t *block);
+
+    uint32_t _state[8];
+    uint8_t _block[64];
+    size_t _blockSize = 0;
+    uint64_t _length = 0;
+};
+
 template< typename T >
 std::string int_to_hex(T i )
 {
@@ -18,6 +18,7 @@
 #include <string>
 #include <array>
 #include <unordered_map>
+#include <vector>
 #include <chrono>
 #include <ostream>
 #include "dxrt/common.h"
@@ -93,6 +94,7 @@ public:
 private:
     std::queue<std::shared_ptr<Request>> _queue;
     void ThreadWork(int id) override;
+    void collectBatch(std::unique_lock<std::mutex>& lk, std::vector<std::shared_ptr<Request>>& batch, int id);
 
     size_t _device_num;
     size_t _numThreads;
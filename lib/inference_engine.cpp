@@ -128,23 +128,13 @@ void InferenceEngine::loadModelFromFile(const std::string& modelPath, InferenceO
     }
     // check file header ("DXNN") - end
 
-    // load file into memory buffer
-    int fileSize = getFileSize(_modelFile);
-    std::vector<uint8_t> vbuf(fileSize);
-    uint8_t *buf = vbuf.data();
-
-    FILE *fp = fopen(_modelFile.c_str(), "rb");
-    if (!fp) {
-        throw FileNotFoundException(EXCEPTION_MESSAGE("Failed to open file: " + _modelFile));
-    }
-
-    std::ignore = fread(static_cast<void*>(buf), fileSize, 1, fp);
-    fclose(fp);
-
-    loadModelFromMemory(_modelFile, buf, fileSize, option);
+    // load file into memory (mapped with DXRT_MODEL_MMAP=1); model sections reference it without copying
+    auto modelFile = ModelFile::Open(_modelFile, ModelFile::MmapEnabled());
+    loadModelFromMemory(_modelFile, modelFile->data(), modelFile->size(), option, modelFile);
 }
 
-void InferenceEngine::loadModelFromMemory(const std::string& name, const uint8_t* modelBuffer, size_t modelSize, InferenceOption &option)
+void InferenceEngine::loadModelFromMemory(const std::string& name, const uint8_t* modelBuffer, size_t modelSize, InferenceOption &option,
+    std::shared_ptr<const ModelFile> modelFile)
 {
     // Implementation for loading model from memory buffer
     _name = name;
@@ -156,7 +146,7 @@ void InferenceEngine::loadModelFromMemory(const std::string& name, const uint8_t
     std::lock_guard<std::mutex> lock(_sInferenceEngineMutex);
 
     initializeEnvironmentVariables();
-    initializeModel(modelBuffer, modelSize, _option.bufferCount);
+    initializeModel(modelBuffer, modelSize, _option.bufferCount, modelFile);
     buildTasksAndSubgraphMap(_option.bufferCount);
 
     // Parse multi-input information from model data
@@ -469,6 +459,7 @@ TensorPtrs InferenceEngine::Run(void *inputPtr, void *userArg, void *outputPtr)
 
     infJob->SetInferenceJob(_tasks, _head, _lastOutputOrder, _modelInputOrder);
     infJob->setInferenceEngineInterface(this);
+    infJob->SetRequestSchedule(defaultSchedule());
     infJob->SetStoreResult(true);
     infJob->setCallBack(nullptr);  // inference engine callback
 
@@ -504,7 +495,31 @@ int InferenceEngine::RunAsync(void *inputPtr, void *userArg, void *outputPtr)
         return RunAsyncMultiInput(splitPtrs, userArg, outputPtr);
     }
 
-    return runAsync(inputPtr, userArg, outputPtr, -1, nullptr);
+    return runAsync(inputPtr, userArg, outputPtr, -1, nullptr, defaultSchedule());
+}
+
+int InferenceEngine::RunAsync(void *inputPtr, const RequestSchedule& schedule, void *userArg, void *outputPtr)
+{
+    if (shouldAutoSplitInput() && inputPtr != nullptr)
+    {
+        LOG_DBG("Auto-splitting single input buffer for multi-input model (async)");
+
+        auto tensorSizes = GetInputTensorSizes();
+        std::vector<std::vector<uint8_t>> splitBuffers(tensorSizes.size());
+        std::map<std::string, void*> inputTensors;
+
+        uint64_t offset = 0;
+        for (size_t i = 0; i < tensorSizes.size(); ++i)
+        {
+            splitBuffers[i].resize(tensorSizes[i]);
+            std::memcpy(splitBuffers[i].data(), static_cast<uint8_t*>(inputPtr) + offset, tensorSizes[i]);
+            inputTensors[_modelInputOrder[i]] = splitBuffers[i].data();
+            offset += tensorSizes[i];
+        }
+        return runAsyncMultiInput(inputTensors, userArg, outputPtr, schedule);
+    }
+
+    return runAsync(inputPtr, userArg, outputPtr, -1, nullptr, schedule);
 }
 
 int InferenceEngine::RunAsync(const std::vector<void*>& inputPtrs, void *userArg, void *outputPtr)
@@ -529,10 +544,17 @@ int InferenceEngine::RunAsync(const std::vector<void*>& inputPtrs, void *userArg
 
     // For single-input models or batch inference, use first pointer
     LOG_DBG("RunAsync: Using traditional single-input approach");
-    return runAsync(inputPtrs[0], userArg, outputPtr, -1, nullptr);
+    return runAsync(inputPtrs[0], userArg, outputPtr, -1, nullptr, defaultSchedule());
 }
 
 int InferenceEngine::RunAsyncMultiInput(const std::map<std::string, void*>& inputTensors, void *userArg, void *outputPtr)
+{
+    return runAsyncMultiInput(inputTensors, userArg, outputPtr, defaultSchedule());
+}
+
+// private
+int InferenceEngine::runAsyncMultiInput(const std::map<std::string, void*>& inputTensors, void *userArg, void *outputPtr,
+    const RequestSchedule& schedule)
 {
     if (_isDisposed)
     {
@@ -588,6 +610,7 @@ int InferenceEngine::RunAsyncMultiInput(const std::map<std::string, void*>& inpu
     }
 
     infJob->setInferenceEngineInterface(this);
+    infJob->SetRequestSchedule(schedule);
     infJob->setCallBack(nullptr);
 
     int jobId = infJob->startMultiInputJob(inputTensors, userArg, outputPtr);
@@ -776,7 +799,8 @@ void InferenceEngine::runSubBatch(std::vector<TensorPtrs>& result, int batchCoun
             void* userArg = userArgs.size() > 0 ? userArgs.at(i) : nullptr;
             int current_index = startIndex + i;
 
-            int job_id = runAsync(inputBuffers.at(current_index), userArg, outputBuffers.at(current_index), current_index, batch_callback);
+            int job_id = runAsync(inputBuffers.at(current_index), userArg, outputBuffers.at(current_index), current_index, batch_callback,
+                defaultSchedule());
 
             // std::cout << "runAsync index=" << current_index << std::endl;
             // std::cout << "inputPtrs size=" << inputPtrs.size() << " OutputPtrs size=" << pOutputPtrs->size() << std::endl;
@@ -806,7 +830,8 @@ void InferenceEngine::runSubBatch(std::vector<TensorPtrs>& result, int batchCoun
 
 // private
 int InferenceEngine::runAsync(void *inputPtr, void *userArg, void *outputPtr, int batchIndex,
-    std::function<int(TensorPtrs &outputs, void *userArg, int jobId)> batchCallback)
+    std::function<int(TensorPtrs &outputs, void *userArg, int jobId)> batchCallback,
+    const RequestSchedule& schedule)
 {
     if (_isDisposed)
     {
@@ -831,6 +856,7 @@ int InferenceEngine::runAsync(void *inputPtr, void *userArg, void *outputPtr, in
         infJob->SetInferenceJob(_tasks, _head, _lastOutputOrder, _modelInputOrder);
         infJob->SetBatchIndex(batchIndex);
         infJob->setInferenceEngineInterface(this);
+        infJob->SetRequestSchedule(schedule);
         infJob->setCallBack(batchCallback);
 
 
@@ -1608,6 +1634,16 @@ int InferenceEngine::GetNpuInferenceTimeCnt()
     return _inferenceTimer.GetNpuInferenceTimeCnt();
 }
 
+LatencyStats InferenceEngine::GetStageLatency(PipelineStage stage)
+{
+    return _inferenceTimer.GetStageLatency(stage);
+}
+
+std::vector<LatencyStats> InferenceEngine::SnapshotStageLatency()
+{
+    return _inferenceTimer.SnapshotStageLatency();
+}
+
 std::vector<TensorPtrs> InferenceEngine::GetAllTaskOutputs()
 {
     LOG_DXRT_DBG << "Collecting outputs from all tasks in order." << std::endl;
@@ -1693,6 +1729,65 @@ std::vector<std::string> InferenceEngine::GetOutputTensorNames() const
     return _lastOutputOrder;
 }
 
+std::vector<bool> InferenceEngine::GetInputLayoutIdentical() const
+{
+    std::vector<bool> flags;
+    flags.reserve(_modelInputOrder.size());
+
+    for (const auto& inputTensorName : _modelInputOrder)
+    {
+        bool identical = false;
+        auto taskNameIt = _inputTensorToTaskMap.find(inputTensorName);
+        if (taskNameIt != _inputTensorToTaskMap.end())
+        {
+            auto taskIt = _taskMap.find(taskNameIt->second);
+            if (taskIt != _taskMap.end() && taskIt->second->processor() == Processor::NPU)
+            {
+                TaskData* taskData = taskIt->second->getData();
+                for (size_t i = 0; i < taskData->_inputNames.size() && i < taskData->_inputLayoutIdentical.size(); i++)
+                {
+                    if (taskData->_inputNames[i] == inputTensorName)
+                    {
+                        identical = taskData->_inputLayoutIdentical[i];
+                        break;
+                    }
+                }
+            }
+        }
+        flags.push_back(identical);
+    }
+    return flags;
+}
+
+std::vector<bool> InferenceEngine::GetOutputLayoutIdentical() const
+{
+    std::vector<bool> flags;
+    flags.reserve(_lastOutputOrder.size());
+
+    for (const auto& outputTensorName : _lastOutputOrder)
+    {
+        bool identical = false;
+        bool found = false;
+        for (const auto& task : _tasks)
+        {
+            if (task->processor() != Processor::NPU) continue;
+            TaskData* taskData = task->getData();
+            for (size_t i = 0; i < taskData->_outputNames.size() && i < taskData->_outputLayoutIdentical.size(); i++)
+            {
+                if (taskData->_outputNames[i] == outputTensorName)
+                {
+                    identical = taskData->_outputLayoutIdentical[i];
+                    found = true;
+                    break;
+                }
+            }
+            if (found) break;
+        }
+        flags.push_back(identical);
+    }
+    return flags;
+}
+
 std::map<std::string, std::string> InferenceEngine::GetInputTensorToTaskMapping() const
 {
     return _inputTensorToTaskMap;
@@ -1755,6 +1850,7 @@ TensorPtrs InferenceEngine::RunMultiInput(const std::map<std::string, void*>& in
     }
 
     infJob->setInferenceEngineInterface(this);
+    infJob->SetRequestSchedule(defaultSchedule());
     infJob->setCallBack(nullptr);
 
     int jobId = infJob->startMultiInputJob(inputTensors, userArg, outputPtr);
@@ -1840,7 +1936,7 @@ bool InferenceEngine::shouldUseUserOutputBuffer() const
 }
 
 std::vector<uint8_t> InferenceEngine::GetBitmatchMask(int index) {
-    const std::vector<char>& maskBuffer = _modelData.deepx_binary.bitmatch_mask(index).buffer();
+    const ModelSection& maskBuffer = _modelData.deepx_binary.bitmatch_mask(index).buffer();
     std::vector<uint8_t> data(maskBuffer.begin(), maskBuffer.end());
     return data;
 }
@@ -1925,10 +2021,13 @@ void InferenceEngine::initializeEnvironmentVariables()
 
 
 
-void InferenceEngine::initializeModel(const uint8_t* modelBuffer, size_t modelSize, int bufferCount)
+void InferenceEngine::initializeModel(const uint8_t* modelBuffer, size_t modelSize, int bufferCount,
+    std::shared_ptr<const ModelFile> modelFile)
 {
-
-    _modelCompileType = LoadModelParam(_modelData, modelBuffer, modelSize, bufferCount);
+    if (modelFile)
+        _modelCompileType = LoadModelParam(_modelData, modelFile, bufferCount);
+    else
+        _modelCompileType = LoadModelParam(_modelData, modelBuffer, modelSize, bufferCount);
     if (_modelCompileType == "debug")
     {
             LOG << "NOTICE: Only one NPU task will run because the compile type is debug." << std::endl;
@@ -1996,7 +2095,7 @@ void InferenceEngine::buildTasksAndSubgraphMap(int bufferCount)
     for (const auto &order : orginal_task_order )
     {
         dxrt::rmap_info rmap_info;
-        std::vector<std::vector<uint8_t>> data;
+        std::vector<ModelSection> data;
         found = false;
 
         // Populate subgraph if present
@@ -2018,16 +2117,16 @@ void InferenceEngine::buildTasksAndSubgraphMap(int bufferCount)
             if ( !isSupporterModelVersion(version_str) )
                 throw InvalidModelException(EXCEPTION_MESSAGE(LogMessages::NotSupported_ModelCompilerVersion(version_str, MIN_COMPILER_VERSION)));
 
-            // Unrolled loop to avoid conditional branches and improve performance/readability
+            // Sections are shared with _modelData, not copied
             const auto& rmapBuffer = _modelData.deepx_binary.rmap(j).buffer();
-            data.emplace_back(rmapBuffer.begin(), rmapBuffer.end());
+            data.emplace_back(rmapBuffer);
             if (data.back().empty())
             {
                 throw InvalidModelException(EXCEPTION_MESSAGE("invalid model"));
             }
 
             const auto& weightBuffer = _modelData.deepx_binary.weight(j).buffer();
-            data.emplace_back(weightBuffer.begin(), weightBuffer.end());
+            data.emplace_back(weightBuffer);
 
             // weight can be empty for some models
             //if (data.back().empty())
@@ -2038,7 +2137,7 @@ void InferenceEngine::buildTasksAndSubgraphMap(int bufferCount)
                 j < _modelData.deepx_binary.ppu().size() &&
                 _modelData.deepx_binary.ppu(j).size() > 0) {
                 const auto& ppuBuffer = _modelData.deepx_binary.ppu(j).buffer();
-                data.emplace_back(ppuBuffer.begin(), ppuBuffer.end());
+                data.emplace_back(ppuBuffer);
                 LOG_DXRT_DBG << "Added PPU binary to data vector for task '" << order
                              << "', size: " << data.back().size() << " bytes" << std::endl;
             }
@@ -2054,7 +2153,7 @@ void InferenceEngine::buildTasksAndSubgraphMap(int bufferCount)
             if (cpuIterator != cpuModelIndexMap.end())
             {
                 const auto& bufferSource = _modelData.deepx_binary.cpu_models(cpuIterator->second).buffer();
-                data.emplace_back(bufferSource.begin(), bufferSource.end());
+                data.emplace_back(bufferSource);
                 found = true;
             }
         }
@@ -2085,6 +2184,7 @@ void InferenceEngine::buildTasksAndSubgraphMap(int bufferCount)
                 task = std::make_shared<Task>(order, rmap_info, bufferCount, std::move(data),
                     static_cast<npu_bound_op>(_option.boundOption), hasPpuBinary);
             }
+            task->setSchedulePolicy(_option.schedulePolicy);
             _tasks.emplace_back(task);
 
 #ifdef USE_ORT
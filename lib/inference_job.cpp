@@ -19,6 +19,7 @@
 #include "dxrt/cpu_handle.h"
 #include "dxrt/request_response_class.h"
 
+#include <chrono>
 #include <future>
 #include <memory>
 #include <unordered_map>
@@ -33,8 +34,9 @@ using std::to_string;
 namespace dxrt
 {
 
-// Build user-buffer-mapped output tensors for a tail task
-static Tensors BuildUserOutputTensorsForTailTask(
+// Map the outputs of a tail task onto the user buffer, at their model-global offsets
+static void AssignUserOutputTensorsForTailTask(
+    const RequestPtr& req,
     const TaskPtr& taskPtr,
     void* userOutputBase,
     const std::vector<std::string>& outputsOrder,
@@ -42,32 +44,51 @@ static Tensors BuildUserOutputTensorsForTailTask(
     int jobId)
 {
     std::ignore = jobId;
-    Tensors outputTensors;
     if (userOutputBase == nullptr || inferenceEngine == nullptr) {
-        return outputTensors;
+        req->setOutputs({});
+        return;
     }
 
-    for (const auto& tensor : taskPtr->outputs())
+    // Reused per submitting thread so the request is filled without allocating
+    thread_local Tensors layout;
+    thread_local std::vector<uint64_t> offsets;
+    size_t count = 0;
+    offsets.clear();
+    for (const auto& tensor : taskPtr->getData()->output_tensors())
     {
         auto it = std::find(outputsOrder.begin(), outputsOrder.end(), tensor.name());
         if (it != outputsOrder.end())
         {
             // Calculate offset for each tensor in the full user output buffer
             size_t tensorOffset = inferenceEngine->GetOutputTensorOffset(tensor.name());
-            uint8_t* tensorPtr = static_cast<uint8_t*>(userOutputBase) + tensorOffset;
-
-            Tensor outputTensor = tensor;  // copy metadata
-            outputTensor.data() = tensorPtr; // map to user buffer
-            outputTensors.push_back(outputTensor);
+            if (count < layout.size())
+                layout[count] = tensor;  // copy metadata
+            else
+                layout.push_back(tensor);
+            offsets.push_back(tensorOffset);
+            count++;
 
             LOG_DBG("[Job_" + std::to_string(jobId) + "] Task '" + taskPtr->name() +
                     "' tensor '" + tensor.name() + "' at offset: " + std::to_string(tensorOffset));
         }
     }
-
-    return outputTensors;
+    layout.erase(layout.begin() + count, layout.end());
+    req->assignOutputs(layout, offsets, userOutputBase);
 }
 
+// Stage latencies of one NPU request from the stamps taken along the device path
+static void recordRequestStages(InferenceTimer* timer, const RequestPtr& req)
+{
+    const RequestData* data = req->getData();
+    auto recordSpan = [timer](PipelineStage stage, uint64_t from, uint64_t to) {
+        if (from != 0 && to >= from)
+            timer->RecordStage(stage, (to - from) / 1000);
+    };
+    recordSpan(PipelineStage::SUBMIT_TO_ENCODE, data->submit_ns, data->encoded_ns);
+    recordSpan(PipelineStage::ENCODE_TO_WRITE, data->encoded_ns, data->written_ns);
+    timer->RecordStage(PipelineStage::NPU, req->inference_time());
+    recordSpan(PipelineStage::READ_TO_DECODE, data->response_ns, data->decoded_ns);
+}
 
 void InferenceJob::onRequestComplete(RequestPtr req)
 {
@@ -108,6 +129,11 @@ void InferenceJob::onRequestComplete(RequestPtr req)
             _infTime += req->inference_time();
     }
 
+    if (thisTask->processor() == Processor::NPU && _inferenceEnginePtr != nullptr)
+    {
+        recordRequestStages(_inferenceEnginePtr->getTimer(), req);
+    }
+
     if (!thisTask->nexts().empty())
     {
         LOG_DBG("[Job_" + std::to_string(_jobId) + "] Task '" + thisTask->name() +
@@ -151,6 +177,12 @@ void InferenceJob::onAllRequestComplete()
     _inferenceEnginePtr->getTimer()->PushInferenceTime(inference_time());
 #endif
 
+    InferenceTimer* timer = _inferenceEnginePtr->getTimer();
+    if (_submitNs != 0)
+    {
+        timer->RecordStage(PipelineStage::END_TO_END, (LatencyClockNs() - _submitNs) / 1000);
+    }
+
     // Dynamic output processing is now handled immediately in onRequestComplete()
     // No special processing needed here as _tensors already contains correct dynamic tensors
 
@@ -183,11 +215,13 @@ void InferenceJob::onAllRequestComplete()
         {
             DataDumpBin("output.bin", callbackOutputs);
         }
+        uint64_t callbackStart = LatencyClockNs();
         _inferenceEnginePtr->onInferenceComplete(callbackOutputs, _userArg, _jobId);
         if (_infEngCallback != nullptr)
         {
             _infEngCallback(callbackOutputs, _userArg, _jobId);
         }
+        timer->RecordStage(PipelineStage::CALLBACK, (LatencyClockNs() - callbackStart) / 1000);
     } catch (dxrt::Exception& e) {
         e.printTrace();
         LOG_DXRT << "callback error " << endl;
@@ -206,7 +240,7 @@ void InferenceJob::onAllRequestComplete()
 }
 
 void InferenceJob::SetInferenceJob(std::vector<std::shared_ptr<Task>>& tasks_, std::shared_ptr<Task> head_,
-                                  std::vector<std::string> lastOutputOrder,
+                                  const std::vector<std::string>& lastOutputOrder,
                                   const std::vector<std::string>& modelInputNames)
 {
     Clear();
@@ -220,10 +254,27 @@ void InferenceJob::SetInferenceJob(std::vector<std::shared_ptr<Task>>& tasks_, s
     _outputs = lastOutputOrder;
     _modelInputNames = modelInputNames;
 
-    _taskStatusMap.clear();
-
+    resetTaskStatus(tasks_);
     _outputCount.store(tasks_.size());
-    for (std::shared_ptr<Task>& it :  tasks_)
+}
+
+// Every job of an engine runs the same tasks, so the map's nodes are kept and only the
+// statuses are reset; a different task set rebuilds it
+void InferenceJob::resetTaskStatus(const std::vector<std::shared_ptr<Task>>& tasks_)
+{
+    bool sameTasks = _taskStatusMap.size() == tasks_.size();
+    for (size_t i = 0; sameTasks && i < tasks_.size(); i++)
+    {
+        auto it = _taskStatusMap.find(tasks_[i]->getData()->_name);
+        if (it == _taskStatusMap.end())
+            sameTasks = false;
+        else
+            it->second = Status::TASK_IDLE;
+    }
+    if (sameTasks) return;
+
+    _taskStatusMap.clear();
+    for (const std::shared_ptr<Task>& it : tasks_)
     {
         _taskStatusMap.insert(make_pair(it->name(), Status::TASK_IDLE));
     }
@@ -231,7 +282,7 @@ void InferenceJob::SetInferenceJob(std::vector<std::shared_ptr<Task>>& tasks_, s
 
 void InferenceJob::SetInferenceJobMultiHead(std::vector<std::shared_ptr<Task>>& tasks_,
                                            const std::vector<std::shared_ptr<Task>>& inputTasks_,
-                                           std::vector<std::string> lastOutputOrder,
+                                           const std::vector<std::string>& lastOutputOrder,
                                            const std::vector<std::string>& modelInputNames)
 {
     Clear();
@@ -246,13 +297,8 @@ void InferenceJob::SetInferenceJobMultiHead(std::vector<std::shared_ptr<Task>>&
     _outputs = lastOutputOrder;
     _modelInputNames = modelInputNames;
 
-    _taskStatusMap.clear();
-
+    resetTaskStatus(tasks_);
     _outputCount.store(tasks_.size());
-    for (std::shared_ptr<Task>& it :  tasks_)
-    {
-        _taskStatusMap.insert(make_pair(it->name(), Status::TASK_IDLE));
-    }
 
     LOG_DBG("[MULTI_HEAD] Set inference job with " + std::to_string(inputTasks_.size()) + " input tasks");
 }
@@ -268,6 +314,7 @@ int InferenceJob::startJob(void *inputPtr, void *userArg, void *outputPtr)
     setStatus(Request::Status::REQ_BUSY);
     _userArg = userArg;
     _outputPtr = outputPtr;
+    _submitNs = LatencyClockNs();
 
     // For multi-head models where model inputs are shared, add model input tensors to _tensors
     // Use the model input names provided by InferenceEngine (from graph_info)
@@ -289,15 +336,16 @@ int InferenceJob::startJob(void *inputPtr, void *userArg, void *outputPtr)
         for (const auto& modelInputName : _modelInputNames) {
             // Find tensor metadata and check if it's shared
             bool isSharedInput = false;
-            std::shared_ptr<Tensor> modelInputTensorPtr;  // Use shared_ptr to safely store tensor
+            // Points into the task's own tensor list, which outlives the job
+            const Tensor* modelInputTensorPtr = nullptr;
 
             for (const auto& t : _tasks) {
-                const Tensors& taskInputs = t->inputs();
+                const Tensors& taskInputs = t->getData()->input_tensors();
                 for (const auto& input : taskInputs) {
                     if (input.name() == modelInputName) {
                         // Save the first occurrence of this tensor's metadata
                         if (!modelInputTensorPtr) {
-                            modelInputTensorPtr = std::make_shared<Tensor>(input);  // Copy the tensor
+                            modelInputTensorPtr = &input;
                         }
 
                         // If this task is not the primary head, this is a shared input
@@ -330,6 +378,8 @@ int InferenceJob::startJob(void *inputPtr, void *userArg, void *outputPtr)
     }
 
     RequestPtr req = Request::Create(task.get(), inputPtr, first_output, userArg, _jobId);
+    req->getData()->sched_priority = _schedPriority;
+    req->getData()->deadline_us = _deadlineUs;
     req->requestor_name() = "";
     req->SetStatus(Request::Status::REQ_BUSY);
     req->setInferenceJob(this);  // on each request complete, do next request or complete whole inference
@@ -339,8 +389,7 @@ int InferenceJob::startJob(void *inputPtr, void *userArg, void *outputPtr)
         // To avoid intermediate copies, use user-provided buffer only for pure tail tasks
         if (task->is_tail()) {
             // Map all tail-task outputs to user buffer with model-global offsets
-            Tensors outputTensors = BuildUserOutputTensorsForTailTask(task, _outputPtr, _outputs, _inferenceEnginePtr, _jobId);
-            req->setOutputs(outputTensors);
+            AssignUserOutputTensorsForTailTask(req, task, _outputPtr, _outputs, _inferenceEnginePtr, _jobId);
             LOG_DBG("[Job_" + std::to_string(_jobId) + "] Head task '" + task->name() + "' is tail task, using user output buffer directly");
         } else {
             req->getData()->output_buffer_base = nullptr;
@@ -361,6 +410,7 @@ int InferenceJob::startMultiInputJob(const std::map<std::string, void*>& inputTe
     setStatus(Request::Status::REQ_BUSY);
     _userArg = userArg;
     _outputPtr = outputPtr;
+    _submitNs = LatencyClockNs();
 
     {
         std::unique_lock<std::mutex> lk(_lock);
@@ -556,6 +606,18 @@ void InferenceJob::setInferenceEngineInterface(InferenceEngine* ptr)
     _inferenceEnginePtr = ptr;
 }
 
+void InferenceJob::SetRequestSchedule(const RequestSchedule& schedule)
+{
+    _schedPriority = schedule.priority;
+    _deadlineUs = 0;
+    if (schedule.deadlineUs != 0)
+    {
+        auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        _deadlineUs = static_cast<uint64_t>(now) + schedule.deadlineUs;
+    }
+}
+
 void InferenceJob::setCallBack(std::function<int(TensorPtrs &outputs, void *userArg, int jobId)> func)
 {
     std::unique_lock<std::mutex> lk(_lock);
@@ -581,6 +643,9 @@ void InferenceJob::Clear()
     _infEngCallback = nullptr;
     _outputPtr = nullptr;
     _storeResult = false;
+    _schedPriority = 0;
+    _deadlineUs = 0;
+    _submitNs = 0;
 
     // Clear multi-head support variables
     _inputTasks.clear();
@@ -685,7 +750,7 @@ void InferenceJob::ReleaseAllOutputBuffer()
         }
     }
     _requests.clear();
-    _use_flag.store(false);
+    CircularDataPool<InferenceJob>::release(this);
     // if(head_req_id%DBG_LOG_REQ_MOD_NUM > DBG_LOG_REQ_MOD_NUM-DBG_LOG_REQ_WINDOW_NUM || head_req_id%DBG_LOG_REQ_MOD_NUM < DBG_LOG_REQ_WINDOW_NUM)
 
     (void)head_req_processed_dev_id;  // avoid 'not used' warning
@@ -807,7 +872,9 @@ void InferenceJob::processReadyTask(TaskPtr taskPtr)
             return; // Do not create Request
         }
     }
-    RequestPtr req = Request::Create(taskPtr.get(), inputTensors, {}, _userArg, _jobId);
+    RequestPtr req = Request::Create(taskPtr.get(), std::move(inputTensors), {}, _userArg, _jobId);
+    req->getData()->sched_priority = _schedPriority;
+    req->getData()->deadline_us = _deadlineUs;
     req->setInferenceJob(this);
     req->SetStatus(Request::Status::REQ_BUSY);
     req->requestor_name() = taskPtr->name();
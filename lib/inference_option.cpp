@@ -38,6 +38,8 @@ std::ostream& operator<<(std::ostream& os, const InferenceOption& option)
     os << "          inference option: ";
     vector_output_operator(os, option.devices);
     os << "/" << option.boundOption;
+    os << "/" << option.schedulePolicy;
+    os << "/" << option.priority << "/" << option.deadlineUs;
     return os;
 }
 
@@ -107,4 +107,31 @@ int InferenceTimer::GetNpuInferenceTimeCnt() const{
     return _inferenceTimeN;
 }
 
+void InferenceTimer::RecordStage(PipelineStage stage, uint64_t us)
+{
+    _stages[static_cast<int>(stage)].Record(us);
+}
+
+LatencyStats InferenceTimer::GetStageLatency(PipelineStage stage) const
+{
+    if (stage >= PipelineStage::COUNT)
+        return LatencyStats();
+    return _stages[static_cast<int>(stage)].Stats();
+}
+
+std::vector<LatencyStats> InferenceTimer::SnapshotStageLatency()
+{
+    std::unique_lock<std::mutex> lk(_snapshotLock);
+    const int count = static_cast<int>(PipelineStage::COUNT);
+    _lastSnapshot.resize(count);
+    std::vector<LatencyStats> stats(count);
+    for (int i = 0; i < count; i++)
+    {
+        LatencyHistogram::Counts now = _stages[i].Snapshot();
+        stats[i] = LatencyHistogram::Summarize(now.Since(_lastSnapshot[i]));
+        _lastSnapshot[i] = std::move(now);
+    }
+    return stats;
+}
+
 }  // namespace dxrt
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "dxrt/latency_histogram.h"
+
+#include <algorithm>
+
+namespace dxrt {
+
+constexpr int LatencyHistogram::LINEAR_BUCKETS;
+constexpr int LatencyHistogram::SUB_BUCKET_BITS;
+constexpr int LatencyHistogram::MAX_POWER;
+constexpr int LatencyHistogram::BUCKETS;
+
+const char* PipelineStageName(PipelineStage stage)
+{
+    switch (stage)
+    {
+        case PipelineStage::SUBMIT_TO_ENCODE: return "Submit->Encode";
+        case PipelineStage::ENCODE_TO_WRITE: return "Encode->Write";
+        case PipelineStage::NPU: return "NPU";
+        case PipelineStage::READ_TO_DECODE: return "Read->Decode";
+        case PipelineStage::CALLBACK: return "Callback";
+        case PipelineStage::END_TO_END: return "End-to-End";
+        default: return "Unknown";
+    }
+}
+
+static int highestBit(uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(v);
+#else
+    int bit = 0;
+    while (v >>= 1) bit++;
+    return bit;
+#endif
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+int LatencyHistogram::BucketOf(uint64_t us)
+{
+    if (us < LINEAR_BUCKETS)
+    {
+        return static_cast<int>(us);
+    }
+    int power = highestBit(us);
+    if (power >= MAX_POWER)
+    {
+        return BUCKETS - 1;
+    }
+    int sub = static_cast<int>((us >> (power - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1));
+    return LINEAR_BUCKETS + ((power - 6) << SUB_BUCKET_BITS) + sub;
+}
+
+uint64_t LatencyHistogram::BucketLow(int bucket)
+{
+    if (bucket < LINEAR_BUCKETS)
+    {
+        return static_cast<uint64_t>(bucket);
+    }
+    int power = 6 + ((bucket - LINEAR_BUCKETS) >> SUB_BUCKET_BITS);
+    uint64_t sub = static_cast<uint64_t>((bucket - LINEAR_BUCKETS) & ((1 << SUB_BUCKET_BITS) - 1));
+    return (1ULL << power) + (sub << (power - SUB_BUCKET_BITS));
+}
+
+uint64_t LatencyHistogram::BucketHigh(int bucket)
+{
+    if (bucket < LINEAR_BUCKETS)
+    {
+        return static_cast<uint64_t>(bucket);
+    }
+    int power = 6 + ((bucket - LINEAR_BUCKETS) >> SUB_BUCKET_BITS);
+    return BucketLow(bucket) + (1ULL << (power - SUB_BUCKET_BITS)) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t us)
+{
+    _buckets[BucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(us, std::memory_order_relaxed);
+    uint64_t prev = _max.load(std::memory_order_relaxed);
+    while (us > prev && !_max.compare_exchange_weak(prev, us, std::memory_order_relaxed))
+    {
+    }
+}
+
+LatencyHistogram::Counts LatencyHistogram::Snapshot() const
+{
+    Counts counts;
+    counts.buckets.resize(BUCKETS);
+    counts.count = 0;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        counts.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+        counts.count += counts.buckets[i];
+    }
+    counts.sum = _sum.load(std::memory_order_relaxed);
+    counts.max = _max.load(std::memory_order_relaxed);
+    return counts;
+}
+
+void LatencyHistogram::Reset()
+{
+    for (auto& bucket : _buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    _sum.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Counts LatencyHistogram::Counts::Since(const Counts& prev) const
+{
+    Counts delta;
+    delta.buckets.resize(BUCKETS);
+    int highest = -1;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        uint64_t before = i < static_cast<int>(prev.buckets.size()) ? prev.buckets[i] : 0;
+        delta.buckets[i] = buckets[i] > before ? buckets[i] - before : 0;
+        delta.count += delta.buckets[i];
+        if (delta.buckets[i] > 0) highest = i;
+    }
+    delta.sum = sum > prev.sum ? sum - prev.sum : 0;
+    delta.max = highest < 0 ? 0 : std::min(BucketHigh(highest), max);
+    return delta;
+}
+
+LatencyStats LatencyHistogram::Summarize(const Counts& counts)
+{
+    LatencyStats stats;
+    if (counts.count == 0 || counts.buckets.size() != static_cast<size_t>(BUCKETS))
+    {
+        return stats;
+    }
+    stats.count = counts.count;
+    stats.mean = static_cast<double>(counts.sum) / counts.count;
+    stats.max = static_cast<double>(counts.max);
+
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    double* results[] = {&stats.p50, &stats.p90, &stats.p99, &stats.p999};
+    int q = 0;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS && q < 4; i++)
+    {
+        seen += counts.buckets[i];
+        while (q < 4 && seen >= static_cast<uint64_t>(quantiles[q] * counts.count + 0.5) && seen > 0)
+        {
+            // middle of the bucket, never above the largest value seen
+            double value = (BucketLow(i) + BucketHigh(i)) / 2.0;
+            *results[q++] = std::min(value, stats.max);
+        }
+    }
+    return stats;
+}
+
+}  // namespace dxrt
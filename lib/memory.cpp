@@ -12,6 +12,7 @@
 #include "dxrt/memory.h"
 #include <iostream>
 #include <iomanip>
+#include <iterator>
 #include <mutex>
 using std::endl;
 using std::hex;
@@ -27,9 +28,7 @@ Memory::Memory(dxrt_device_info_t &info, void *data_)
     _size = info.mem_size;
     _data = reinterpret_cast<uint64_t>(data_);
     _dataEnd = _data + _size;
-    _pool[0].addr = 0;
-    _pool[0].size = _size;
-    _pool[0].status = 0;
+    SetFree(0, _size);
     _used_size = 0;
 }
 
@@ -38,25 +37,55 @@ uint64_t Memory::AlignSize(uint64_t size) const
     return (size + MemoryConfig::MEMORY_ALIGNMENT - 1) & ~(MemoryConfig::MEMORY_ALIGNMENT - 1);
 }
 
+// Smallest free node that fits; the lowest address among nodes of that size
 std::map<uint64_t, MemoryNode>::iterator Memory::FindBestFit(uint64_t required)
 {
-    auto best_it = _pool.end();
-    uint64_t best_size = UINT64_MAX;
+    auto fit = _freeIndex.lower_bound(std::make_pair(required, static_cast<uint64_t>(0)));
+    if (fit == _freeIndex.end())
+    {
+        return _pool.end();
+    }
+    return _pool.find(fit->second);
+}
 
-    for (auto it = _pool.begin(); it != _pool.end(); ++it)
+// Smallest free node that fits; the highest address among nodes of that size
+std::map<uint64_t, MemoryNode>::iterator Memory::FindBestFitBackward(uint64_t required)
+{
+    auto fit = _freeIndex.lower_bound(std::make_pair(required, static_cast<uint64_t>(0)));
+    if (fit == _freeIndex.end())
     {
-        auto &node = it->second;
-        if (node.status == 0 && node.size >= required)
-        {
-            if (node.size < best_size)
-            {
-                best_size = node.size;
-                best_it = it;
-            }
-        }
+        return _pool.end();
     }
+    auto last = _freeIndex.lower_bound(std::make_pair(fit->first + 1, static_cast<uint64_t>(0)));
+    --last;
+    return _pool.find(last->second);
+}
 
-    return best_it;
+void Memory::SetFree(uint64_t addr, uint64_t size)
+{
+    auto it = _pool.find(addr);
+    if (it != _pool.end() && it->second.status == 0)
+    {
+        _freeIndex.erase(std::make_pair(it->second.size, addr));
+    }
+    MemoryNode &node = _pool[addr];
+    node.addr = addr;
+    node.size = size;
+    node.status = 0;
+    _freeIndex.emplace(size, addr);
+}
+
+void Memory::SetBusy(uint64_t addr, uint64_t size)
+{
+    auto it = _pool.find(addr);
+    if (it != _pool.end() && it->second.status == 0)
+    {
+        _freeIndex.erase(std::make_pair(it->second.size, addr));
+    }
+    MemoryNode &node = _pool[addr];
+    node.addr = addr;
+    node.size = size;
+    node.status = 1;
 }
 
 int64_t Memory::Allocate(uint64_t required)
@@ -96,18 +125,14 @@ int64_t Memory::Allocate(uint64_t required)
 
     if (best_it != _pool.end())
     {
-        auto &node = best_it->second;
-        uint64_t addr = node.addr;
+        uint64_t addr = best_it->second.addr;
+        uint64_t size = best_it->second.size;
 
-        if (required < node.size)
+        SetBusy(addr, required);
+        if (required < size)
         {
-            _pool[addr + required].addr = addr + required;
-            _pool[addr + required].size = node.size - required;
-            _pool[addr + required].status = 0;
+            SetFree(addr + required, size - required);
         }
-        _pool[addr].addr = addr;
-        _pool[addr].size = required;
-        _pool[addr].status = 1;
         _used_size += required;
         LOG_DXRT_DBG << required << " byte Allocated (Best-Fit) 0x" <<  hex << addr << dec << endl;
         return addr;
@@ -132,22 +157,7 @@ int64_t Memory::BackwardAllocate(uint64_t required)
     required = AlignSize(required);
 
     // Best-Fit algorithm for backward allocation
-    auto best_it = _pool.end();
-    uint64_t best_size = UINT64_MAX;
-
-    for (auto it = _pool.rbegin(); it != _pool.rend(); ++it)
-    {
-        auto &node = it->second;
-        if (node.status == 0 && node.size >= required)
-        {
-            if (node.size < best_size)
-            {
-                best_size = node.size;
-                best_it = it.base();
-                --best_it;
-            }
-        }
-    }
+    auto best_it = FindBestFitBackward(required);
 
     if (best_it == _pool.end() && required >= MemoryConfig::LARGE_ALLOCATION_THRESHOLD)
     {
@@ -158,40 +168,24 @@ int64_t Memory::BackwardAllocate(uint64_t required)
             if (TryDefragmentation(required))
             {
                 // Retry after defragmentation
-                for (auto it = _pool.rbegin(); it != _pool.rend(); ++it)
-                {
-                    auto &node = it->second;
-                    if (node.status == 0 && node.size >= required)
-                    {
-                        if (node.size < best_size)
-                        {
-                            best_size = node.size;
-                            best_it = it.base();
-                            --best_it;
-                        }
-                    }
-                }
+                best_it = FindBestFitBackward(required);
             }
         }
     }
 
     if (best_it != _pool.end())
     {
-        auto &node = best_it->second;
-        uint64_t addr = node.addr;
+        uint64_t addr = best_it->second.addr;
+        uint64_t size = best_it->second.size;
 
-        if (required < node.size)
+        if (required < size)
         {
-            uint64_t remain = node.size - required;
-            _pool[addr].addr = addr;
-            _pool[addr].size = remain;
-            _pool[addr].status = 0;
+            uint64_t remain = size - required;
+            SetFree(addr, remain);
             addr += remain;
         }
 
-        _pool[addr].addr = addr;
-        _pool[addr].size = required;
-        _pool[addr].status = 1;
+        SetBusy(addr, required);
         _used_size += required;
         LOG_DXRT_DBG << required << " byte Allocated B (Best-Fit) 0x" <<  hex << addr << dec << endl;
         return addr;
@@ -253,8 +247,14 @@ void Memory::Deallocate(uint64_t addr)
     auto it = _pool.find(addr);
     if (it != _pool.end())
     {
+        if (it->second.status == 0)
+        {
+            LOG_DXRT_DBG << "0x" << hex << addr << dec << " is already free" << endl;
+            return;
+        }
         _used_size -= it->second.size;
         it->second.status = 0;
+        _freeIndex.emplace(it->second.size, addr);
         LOG_DXRT_DBG << it->second.size << " byte Deallocated 0x" << hex << addr << dec << endl;
 
         MergeAdjacentNodes(it);
@@ -278,36 +278,43 @@ void Memory::Deallocate(dxrt_request_t &inf)
     Deallocate(input);
     Deallocate(output);
 }
+// Merges a free node with its free neighbors. Free nodes are merged as soon as they are
+// released, so there is at most one free neighbor on each side.
 void Memory::MergeAdjacentNodes(std::map<uint64_t, MemoryNode>::iterator it) {
-    // LOG_DXRT_DBG << endl;
-    if (it != _pool.begin()) {
-        auto prev_it = prev(it);
-        if (prev_it->second.status == 0) {
-            uint64_t new_addr = prev_it->first;
-            uint64_t new_size = prev_it->second.size + it->second.size;
-            _pool.erase(prev_it);
-            _pool.erase(it);
-            MemoryNode& newNode = _pool[new_addr];
-            newNode.addr = new_addr;
-            newNode.size = new_size;
-            newNode.status = 0;
-            MergeAdjacentNodes(_pool.find(new_addr));
-            LOG_DXRT_DBG << *this << endl;
-            return;
+    if (it == _pool.end() || it->second.status != 0)
+    {
+        return;
+    }
+    uint64_t addr = it->first;
+    uint64_t end = addr + it->second.size;
+    auto first = it;
+    auto last = std::next(it);
+    if (it != _pool.begin())
+    {
+        auto prev_it = std::prev(it);
+        if (prev_it->second.status == 0 && prev_it->first + prev_it->second.size == addr)
+        {
+            first = prev_it;
+            addr = prev_it->first;
         }
     }
-    auto next_it = next(it);
-    if (next_it != _pool.end() && next_it->second.status == 0) {
-        uint64_t new_addr = it->first;
-        uint64_t new_size = it->second.size + next_it->second.size;
-        _pool.erase(it);
-        _pool.erase(next_it);
-        MemoryNode& newNode = _pool[new_addr];
-        newNode.addr = new_addr;
-        newNode.size = new_size;
-        newNode.status = 0;
-        MergeAdjacentNodes(_pool.find(new_addr));
+    if (last != _pool.end() && last->second.status == 0 && last->first == end)
+    {
+        end += last->second.size;
+        ++last;
     }
+    if (first == it && last == std::next(it))
+    {
+        return;
+    }
+    for (auto node = first; node != last; ++node)
+    {
+        _freeIndex.erase(std::make_pair(node->second.size, node->first));
+    }
+    // the first node of the run becomes the merged node
+    first->second.size = end - addr;
+    _pool.erase(std::next(first), last);
+    _freeIndex.emplace(end - addr, addr);
 }
 void Memory::ResetBuffer()
 {
@@ -345,27 +352,18 @@ MemoryFragmentationInfo Memory::GetFragmentationInfo() const
 }
 MemoryFragmentationInfo Memory::GetFragmentationInfoNoLock() const
 {
-    MemoryFragmentationInfo info = {0, 0, UINT64_MAX, 0, 0.0};
+    MemoryFragmentationInfo info = {0, 0, 0, 0, 0.0};
 
-    for (const auto &pair : _pool)
+    info.total_free_size = _size - _used_size;
+    info.free_block_count = _freeIndex.size();
+    if (!_freeIndex.empty())
     {
-        const auto &node = pair.second;
-        if (node.status == 0)  // free block
-        {
-            info.total_free_size += node.size;
-            info.free_block_count++;
-
-            if (node.size > info.largest_free_block)
-                info.largest_free_block = node.size;
-
-            if (node.size < info.smallest_free_block)
-                info.smallest_free_block = node.size;
-        }
+        info.smallest_free_block = _freeIndex.begin()->first;
+        info.largest_free_block = _freeIndex.rbegin()->first;
     }
 
     if (info.free_block_count == 0)
     {
-        info.smallest_free_block = 0;
         info.fragmentation_ratio = 0.0;
     }
     else if (info.total_free_size > 0)
@@ -384,15 +382,7 @@ MemoryFragmentationInfo Memory::GetFragmentationInfoNoLock() const
 bool Memory::CanAllocateContiguous(uint64_t required) const
 {
     std::unique_lock<std::mutex> lk(const_cast<std::mutex&>(_lock));
-    for (const auto &pair : _pool)
-    {
-        const auto &node = pair.second;
-        if (node.status == 0 && node.size >= required)
-        {
-            return true;
-        }
-    }
-    return false;
+    return GetLargestFreeBlock() >= required;
 }
 
 void Memory::PrintMemoryMap() const
@@ -453,70 +443,26 @@ void Memory::CompactMemory()
 
 uint64_t Memory::GetLargestFreeBlock() const
 {
-    uint64_t largest = 0;
-    for (const auto &pair : _pool)
-    {
-        const auto &node = pair.second;
-        if (node.status == 0 && node.size > largest)
-        {
-            largest = node.size;
-        }
-    }
-    return largest;
+    return _freeIndex.empty() ? 0 : _freeIndex.rbegin()->first;
 }
 
 // Merges all adjacent free blocks in the memory pool.
+// Deallocate() already merges on release, so this only finds work if the map was edited directly.
 void Memory::MergeAllAdjacentFreeBlocks()
 {
-    // A flag to track if a merge occurred during a full scan.
-    bool merged = true;
-
-    // Keep looping as long as merges are happening.
-    while (merged)
+    // nodes behind it are merged already, so only the following one can join it
+    for (auto it = _pool.begin(); it != _pool.end();)
     {
-        // Assume no merge will happen in this iteration.
-        merged = false;
-
-        // _pool is assumed to be an std::map keyed by memory address,
-        // which keeps the blocks sorted and makes finding adjacent blocks easy.
-        for (auto it = _pool.begin(); it != _pool.end(); ++it)
+        auto next_it = std::next(it);
+        if (it->second.status == 0 && next_it != _pool.end() && next_it->second.status == 0 &&
+            it->first + it->second.size == next_it->first)
         {
-            // Check if the current block is free (status == 0).
-            if (it->second.status == 0)
-            {
-                // Get an iterator to the next block in the pool.
-                auto next_it = next(it);
-
-                // [Core Condition] Check if:
-                // 1. A next block exists.
-                // 2. The next block is also free.
-                // 3. The next block is physically adjacent to the current one.
-                if (next_it != _pool.end() &&
-                    next_it->second.status == 0 &&
-                    it->first + it->second.size == next_it->first)
-                {
-                    // Calculate the combined size and store the starting address.
-                    uint64_t new_size = it->second.size + next_it->second.size;
-                    uint64_t addr = it->first;
-
-                    // Erase the two old, smaller blocks.
-                    _pool.erase(it);
-                    _pool.erase(next_it);
-
-                    // Create a new, merged block in the pool.
-                    MemoryNode& newNode = _pool[addr];
-                    newNode.addr = addr;
-                    newNode.size = new_size;
-                    newNode.status = 0; // Set its status to free.
-
-                    // A merge has occurred, so set the flag to true.
-                    merged = true;
-
-                    // Since the pool was modified, break the loop and restart the scan.
-                    break;
-                }
-            }
+            uint64_t addr = it->first;
+            MergeAdjacentNodes(it);
+            it = _pool.find(addr);
+            continue;
         }
+        ++it;
     }
 }
 
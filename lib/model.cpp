@@ -123,6 +123,15 @@ string LoadModelParam(ModelDataBase& param, const uint8_t* modelBuffer, size_t m
     throw InvalidOperationException(EXCEPTION_MESSAGE("LoadModelParam: Parser factory call failed"));
 }
 
+string LoadModelParam(ModelDataBase& param, std::shared_ptr<const ModelFile> modelFile, int bufferCount)
+{
+    auto parser = ModelParserFactory::CreateParser(modelFile->data(), modelFile->size());
+    LOG_DXRT_DBG << "Using " << parser->GetParserName() << (modelFile->isMapped() ? " (mapped)" : "") << std::endl;
+    parser->SetTaskBufferCount(bufferCount);
+    parser->SetBackingFile(modelFile);
+    return parser->ParseModel(modelFile->data(), modelFile->size(), param);
+}
+
 ostream& operator<<(ostream& os, const ModelDataBase& m)
 {
     auto graphsDb = m.deepx_graph;
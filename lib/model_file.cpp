@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "dxrt/model_file.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#elif _WIN32
+    #include <windows.h>
+#endif  // __linux__
+
+#include "dxrt/exception/exception.h"
+#include "dxrt/filesys_support.h"
+
+namespace dxrt {
+
+bool ModelFile::MmapEnabled()
+{
+    const char* env = getenv("DXRT_MODEL_MMAP");
+    return env != nullptr && (std::strcmp(env, "1") == 0 || std::strcmp(env, "true") == 0);
+}
+
+std::shared_ptr<const ModelFile> ModelFile::Open(const std::string& path, bool useMmap)
+{
+    std::shared_ptr<ModelFile> file(new ModelFile());
+    int fileSize = getFileSize(path);
+    if (fileSize < 0)
+    {
+        throw FileNotFoundException(EXCEPTION_MESSAGE("Failed to open file: " + path));
+    }
+    file->_size = static_cast<size_t>(fileSize);
+
+    if (useMmap && file->_size > 0)
+    {
+#ifdef __linux__
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            void* addr = mmap(nullptr, file->_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            // The mapping keeps its own reference to the file
+            close(fd);
+            if (addr != MAP_FAILED)
+            {
+                // Sections are consumed front to back while tasks are created
+                madvise(addr, file->_size, MADV_SEQUENTIAL);
+                file->_data = static_cast<const uint8_t*>(addr);
+                file->_mapped = true;
+                return file;
+            }
+        }
+#elif _WIN32
+        HANDLE fh = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (fh != INVALID_HANDLE_VALUE)
+        {
+            HANDLE mh = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+            void* addr = (mh != NULL) ? MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0) : NULL;
+            if (addr != NULL)
+            {
+                file->_fileHandle = fh;
+                file->_mappingHandle = mh;
+                file->_data = static_cast<const uint8_t*>(addr);
+                file->_mapped = true;
+                return file;
+            }
+            if (mh != NULL) CloseHandle(mh);
+            CloseHandle(fh);
+        }
+#endif
+        LOG_DXRT_DBG << "ModelFile: mapping " << path << " failed, reading it instead" << std::endl;
+    }
+
+    file->_heap.resize(file->_size);
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp)
+    {
+        throw FileNotFoundException(EXCEPTION_MESSAGE("Failed to open file: " + path));
+    }
+    std::ignore = fread(static_cast<void*>(file->_heap.data()), file->_size, 1, fp);
+    fclose(fp);
+    file->_data = file->_heap.data();
+    return file;
+}
+
+ModelFile::~ModelFile()
+{
+    if (!_mapped) return;
+#ifdef __linux__
+    munmap(const_cast<uint8_t*>(_data), _size);
+#elif _WIN32
+    UnmapViewOfFile(_data);
+    CloseHandle(static_cast<HANDLE>(_mappingHandle));
+    CloseHandle(static_cast<HANDLE>(_fileHandle));
+#endif
+}
+
+void ModelFile::ReleasePages(const uint8_t* ptr, size_t size) const
+{
+    if (!_mapped || size == 0 || ptr < _data || ptr + size > _data + _size) return;
+
+#ifdef __linux__
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+#elif _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    const uintptr_t page = si.dwPageSize;
+#endif
+    // Only whole pages inside the section: neighbours sharing a boundary page may still be in use
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1) & ~(page - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) & ~(page - 1);
+    if (end <= begin) return;
+
+#ifdef __linux__
+    // Clean private file pages are simply dropped and re-read from the file on the next access
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+#elif _WIN32
+    // Unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(reinterpret_cast<void*>(begin), end - begin);
+#endif
+}
+
+ModelSection::ModelSection(const void* src, size_t size)
+{
+    auto copy = std::make_shared<std::vector<uint8_t>>(size);
+    if (size > 0) std::memcpy(copy->data(), src, size);
+    _ptr = copy->data();
+    _size = size;
+    _backing = std::move(copy);
+}
+
+ModelSection::ModelSection(std::shared_ptr<const ModelFile> file, size_t offset, size_t size)
+: _file(file.get()), _ptr(file->data() + offset), _size(size)
+{
+    _backing = std::move(file);
+}
+
+void ModelSection::ReleasePages() const
+{
+    if (_file != nullptr) _file->ReleasePages(_ptr, _size);
+}
+
+}  // namespace dxrt
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "dxrt/model_memory_cache.h"
+
+#include <iostream>
+#include <tuple>
+
+namespace dxrt {
+
+bool ModelMemoryKey::operator<(const ModelMemoryKey& other) const
+{
+    return std::tie(digest, weightSize, rmapSize, exact) < std::tie(other.digest, other.weightSize, other.rmapSize, other.exact);
+}
+
+ModelMemoryRegion ModelMemoryCache::Acquire(const ModelMemoryKey& key, pid_t pid, int taskId,
+    const AllocateFunc& alloc, const DeallocateFunc& dealloc)
+{
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+    {
+        ModelMemoryRegion region = it->second.region;
+        it->second.users.emplace(pid, taskId);
+        if (!it->second.resident)
+        {
+            region.state = ModelMemoryRegion::State::PENDING;
+            return region;
+        }
+        region.state = ModelMemoryRegion::State::RESIDENT;
+        LOG_DXRT_DBG << "model memory shared with task " << taskId << ", pid " << pid
+                     << " (" << it->second.users.size() << " users)" << std::endl;
+        return region;
+    }
+
+    ModelMemoryRegion region;
+    region.weightOffset = alloc(key.weightSize);
+    if (region.weightOffset == -1)
+        return region;
+    region.rmapOffset = alloc(key.rmapSize);
+    if (region.rmapOffset > region.weightOffset)
+    {
+        int64_t temp = region.rmapOffset;
+        region.rmapOffset = alloc(key.rmapSize);
+        dealloc(static_cast<uint64_t>(temp));
+    }
+    if (region.rmapOffset == -1)
+    {
+        dealloc(static_cast<uint64_t>(region.weightOffset));
+        region.weightOffset = -1;
+        return region;
+    }
+
+    region.state = ModelMemoryRegion::State::ALLOCATED;
+    Entry& entry = _entries[key];
+    entry.region = region;
+    entry.loader = std::make_pair(pid, taskId);
+    entry.users.emplace(pid, taskId);
+    return region;
+}
+
+void ModelMemoryCache::MarkResident(const ModelMemoryKey& key)
+{
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+        it->second.resident = true;
+}
+
+void ModelMemoryCache::Release(pid_t pid, int taskId, const DeallocateFunc& dealloc)
+{
+    releaseIf([pid, taskId](const std::pair<pid_t, int>& user) {
+        return user.first == pid && user.second == taskId;
+    }, dealloc);
+}
+
+void ModelMemoryCache::ReleaseProcess(pid_t pid, const DeallocateFunc& dealloc)
+{
+    releaseIf([pid](const std::pair<pid_t, int>& user) {
+        return user.first == pid;
+    }, dealloc);
+}
+
+void ModelMemoryCache::releaseIf(const std::function<bool(const std::pair<pid_t, int>&)>& pred,
+    const DeallocateFunc& dealloc)
+{
+    for (auto it = _entries.begin(); it != _entries.end();)
+    {
+        auto& users = it->second.users;
+        bool loaderReleased = false;
+        for (auto user = users.begin(); user != users.end();)
+        {
+            if (pred(*user))
+            {
+                loaderReleased |= (*user == it->second.loader);
+                user = users.erase(user);
+            }
+            else
+            {
+                ++user;
+            }
+        }
+        // An upload that never completed is abandoned; waiters start over on their next Acquire()
+        if (users.empty() || (loaderReleased && !it->second.resident))
+        {
+            LOG_DXRT_DBG << "model memory released: rmap 0x" << std::hex << it->second.region.rmapOffset
+                         << ", weight 0x" << it->second.region.weightOffset << std::dec << std::endl;
+            dealloc(static_cast<uint64_t>(it->second.region.rmapOffset));
+            dealloc(static_cast<uint64_t>(it->second.region.weightOffset));
+            it = _entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+}  // namespace dxrt
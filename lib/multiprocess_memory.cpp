@@ -28,6 +28,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <climits>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -44,8 +45,8 @@ namespace dxrt
 {
 
     MultiprocessMemory::MultiprocessMemory()
-    : ipcClientWrapper(dxrt::IPCDefaultType(), getpid()),
-    ipcClientWrapperSync(dxrt::IPCDefaultType(), getpid() + IPCClientWrapper::MAX_PID)
+    : ipcClientWrapper(dxrt::IPCClientDefaultType(), getpid()),
+    ipcClientWrapperSync(dxrt::IPCClientDefaultType(), getpid() + IPCClientWrapper::MAX_PID)
     {
     }
 
@@ -69,31 +70,12 @@ namespace dxrt
 
     uint64_t MultiprocessMemory::Allocate(int deviceId, uint64_t required)
     {
-        mpConnect_once_wrapper();
-        dxrt::IPCClientMessage clientMessage;
-        dxrt::IPCServerMessage serverMessage;
-        bool isDone = false;
-        for (int i = 0; i < 20; i++)
-        {
-            clientMessage.code = dxrt::REQUEST_CODE::GET_MEMORY;
-            clientMessage.deviceId = deviceId;
-            clientMessage.data = required;
-            clientMessage.pid = getpid();
-
-
-            // ipcClientWrapper.SendToServer(serverMessage, clientMessage);
-            ipcClientWrapperSync.SendToServer(serverMessage, clientMessage);
-            if (serverMessage.result == 0)
-            {
-                isDone = true;
-                break;
-            }
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-        }
+        uint64_t addr = static_cast<uint64_t>(-1);
+        bool isDone = sendAllocateBatch(deviceId, -1, &required, 1, false, &addr);
 
         //DXRT_ASSERT(isDone, "ran out of NPU memory");
         if (!isDone) {
-            LOG_DXRT_ERR("Failed to allocate NPU memory " + std::to_string(required) + "byte after retries");
+            LOG_DXRT_ERR("Failed to allocate NPU memory " + std::to_string(required) + "byte after waiting for free memory");
             RuntimeEventDispatcher::GetInstance().DispatchEvent(
                 RuntimeEventDispatcher::LEVEL::CRITICAL,
                 RuntimeEventDispatcher::TYPE::DEVICE_MEMORY,
@@ -108,104 +90,48 @@ namespace dxrt
         }
         */
 
-        LOG_DXRT_DBG << std::hex << serverMessage.data << std::dec << " is allocated from service\n";
-        DXRT_ASSERT(static_cast<int64_t>(serverMessage.data) != -1, "allocate error");
-        // DXRT_ASSERT(static_cast<int64_t>(serverMessage.data) != 0,"allocate error");
-        return serverMessage.data;
+        LOG_DXRT_DBG << std::hex << addr << std::dec << " is allocated from service\n";
+        DXRT_ASSERT(static_cast<int64_t>(addr) != -1, "allocate error");
+        // DXRT_ASSERT(static_cast<int64_t>(addr) != 0,"allocate error");
+        return addr;
     }
 
-    uint64_t MultiprocessMemory::BackwardAllocate(int deviceId, uint64_t required)
+    uint64_t MultiprocessMemory::TryAllocate(int deviceId, uint64_t required)
     {
-        mpConnect_once_wrapper();
-        dxrt::IPCClientMessage clientMessage;
-        dxrt::IPCServerMessage serverMessage;
-        bool isDone = false;
-        for (int i = 0; i < 20; i++)
+        uint64_t addr = static_cast<uint64_t>(-1);
+        if (!sendAllocateBatch(deviceId, -1, &required, 1, false, &addr, 0))
         {
-
-            clientMessage.code = dxrt::REQUEST_CODE::GET_MEMORY_FOR_MODEL;
-            clientMessage.deviceId = deviceId;
-            clientMessage.data = required;
-            clientMessage.pid = getpid();
-
-
-            // ipcClientWrapper.SendToServer(serverMessage, clientMessage);
-            ipcClientWrapperSync.SendToServer(serverMessage, clientMessage);
-            if (serverMessage.result == 0)
-            {
-                isDone = true;
-                break;
-            }
-
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-        //#ifdef __linux__
-        //        sleep(5);
-        //#elif _WIN32
-        //        this_thread::sleep_for(chrono::microseconds(50));
-        //#endif
+            return static_cast<uint64_t>(-1);
         }
+        LOG_DXRT_DBG << std::hex << addr << std::dec << " is allocated from service\n";
+        return addr;
+    }
+
+    uint64_t MultiprocessMemory::BackwardAllocate(int deviceId, uint64_t required)
+    {
+        uint64_t addr = static_cast<uint64_t>(-1);
+        bool isDone = sendAllocateBatch(deviceId, -1, &required, 1, true, &addr);
         DXRT_ASSERT(isDone, "allocateB timeout");
-        LOG_DXRT_DBG << std::hex << serverMessage.data << std::dec << " is allocated from service\n";
-        DXRT_ASSERT(static_cast<int64_t>(serverMessage.data) != -1, "allocate error");
-        // DXRT_ASSERT(static_cast<int64_t>(serverMessage.data) != 0,"allocate error");
-        return serverMessage.data;
+        LOG_DXRT_DBG << std::hex << addr << std::dec << " is allocated from service\n";
+        DXRT_ASSERT(static_cast<int64_t>(addr) != -1, "allocate error");
+        // DXRT_ASSERT(static_cast<int64_t>(addr) != 0,"allocate error");
+        return addr;
     }
 
     uint64_t MultiprocessMemory::BackwardAllocateForTask(int deviceId, int taskId, uint64_t required)
     {
-        mpConnect_once_wrapper();
-        dxrt::IPCClientMessage clientMessage;
-        dxrt::IPCServerMessage serverMessage;
-        bool isDone = false;
-        for (int i = 0; i < 20; i++)
-        {
-
-            clientMessage.code = dxrt::REQUEST_CODE::GET_MEMORY_FOR_MODEL;
-            clientMessage.deviceId = deviceId;
-            clientMessage.data = required;
-            clientMessage.pid = getpid();
-            clientMessage.taskId = taskId;
-
-            //ipcClientWrapper.SendToServer(serverMessage, clientMessage);
-            ipcClientWrapperSync.SendToServer(serverMessage, clientMessage);
-            if (serverMessage.result == 0)
-            {
-                isDone = true;
-                break;
-            }
-
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-        }
+        uint64_t addr = static_cast<uint64_t>(-1);
+        bool isDone = sendAllocateBatch(deviceId, taskId, &required, 1, true, &addr);
         DXRT_ASSERT(isDone, "allocateB timeout for Task " + std::to_string(taskId));
-        LOG_DXRT_DBG << std::hex << serverMessage.data << std::dec << " is allocated from service for Task " << taskId << "\n";
-        DXRT_ASSERT(static_cast<int64_t>(serverMessage.data) != -1, "allocate error for Task " + std::to_string(taskId));
-        return serverMessage.data;
+        LOG_DXRT_DBG << std::hex << addr << std::dec << " is allocated from service for Task " << taskId << "\n";
+        DXRT_ASSERT(static_cast<int64_t>(addr) != -1, "allocate error for Task " + std::to_string(taskId));
+        return addr;
     }
 
     uint64_t MultiprocessMemory::AllocateForTask(int deviceId, int taskId, uint64_t required)
     {
-        mpConnect_once_wrapper();
-        dxrt::IPCClientMessage clientMessage;
-        dxrt::IPCServerMessage serverMessage;
-        bool isDone = false;
-        for (int i = 0; i < 20; i++)
-        {
-
-            clientMessage.code = dxrt::REQUEST_CODE::GET_MEMORY;
-            clientMessage.deviceId = deviceId;
-            clientMessage.data = required;
-            clientMessage.pid = getpid();
-            clientMessage.taskId = taskId;
-
-            // ipcClientWrapper.SendToServer(serverMessage, clientMessage);
-            ipcClientWrapperSync.SendToServer(serverMessage, clientMessage);
-            if (serverMessage.result == 0)
-            {
-                isDone = true;
-                break;
-            }
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-        }
+        uint64_t addr = static_cast<uint64_t>(-1);
+        bool isDone = sendAllocateBatch(deviceId, taskId, &required, 1, false, &addr);
 
         // DXRT_ASSERT(isDone, "ran out of NPU memory for Task " + std::to_string(taskId));
         if (!isDone) {
@@ -223,9 +149,56 @@ namespace dxrt
         }
         */
 
-        LOG_DXRT_DBG << std::hex << serverMessage.data << std::dec << " is allocated from service for Task " << taskId << "\n";
-        DXRT_ASSERT(static_cast<int64_t>(serverMessage.data) != -1, "allocate error for Task " + std::to_string(taskId));
-        return serverMessage.data;
+        LOG_DXRT_DBG << std::hex << addr << std::dec << " is allocated from service for Task " << taskId << "\n";
+        DXRT_ASSERT(static_cast<int64_t>(addr) != -1, "allocate error for Task " + std::to_string(taskId));
+        return addr;
+    }
+
+    constexpr uint32_t MultiprocessMemory::ALLOC_WAIT_MS;
+
+    bool MultiprocessMemory::sendAllocateBatch(int deviceId, int taskId, const uint64_t* sizes, uint32_t count,
+        bool backward, uint64_t* addrs, uint32_t waitMs)
+    {
+        mpConnect_once_wrapper();
+        dxrt::IPCClientMessage clientMessage;
+        dxrt::IPCServerMessage serverMessage;
+
+        clientMessage.code = dxrt::REQUEST_CODE::GET_MEMORY_BATCH;
+        clientMessage.deviceId = deviceId;
+        clientMessage.pid = getpid();
+        clientMessage.taskId = taskId;
+        clientMessage.alloc.count = count;
+        clientMessage.alloc.backward = backward ? 1 : 0;
+        clientMessage.alloc.waitMs = waitMs;
+        std::copy(sizes, sizes + count, clientMessage.alloc.regions);
+
+        // The service answers once the regions are allocated or the wait has expired
+        if (ipcClientWrapperSync.SendToServer(serverMessage, clientMessage) != 0 ||
+            serverMessage.result != 0 || serverMessage.alloc.count != count)
+        {
+            return false;
+        }
+        std::copy(serverMessage.alloc.regions, serverMessage.alloc.regions + count, addrs);
+        return true;
+    }
+
+    std::vector<uint64_t> MultiprocessMemory::AllocateBatch(int deviceId, int taskId,
+        const std::vector<uint64_t>& sizes, bool backward)
+    {
+        std::vector<uint64_t> addrs(sizes.size());
+        for (size_t done = 0; done < sizes.size(); done += IPC_ALLOC_BATCH_MAX)
+        {
+            uint32_t count = static_cast<uint32_t>(std::min<size_t>(IPC_ALLOC_BATCH_MAX, sizes.size() - done));
+            if (!sendAllocateBatch(deviceId, taskId, sizes.data() + done, count, backward, addrs.data() + done))
+            {
+                LOG_DXRT_ERR("Failed to allocate " << sizes.size() << " NPU memory regions for Task " << taskId);
+                for (size_t i = 0; i < done; i++)
+                    Deallocate(deviceId, addrs[i]);
+                return {};
+            }
+        }
+        LOG_DXRT_DBG << sizes.size() << " regions are allocated from service for Task " << taskId << "\n";
+        return addrs;
     }
 
     void MultiprocessMemory::Deallocate(int deviceId, uint64_t addr)
@@ -367,4 +340,49 @@ namespace dxrt
         ipcClientWrapper.SendToServer(clientMessage);
         return;
     }
+
+    ModelMemoryRegion MultiprocessMemory::AcquireModelMemory(int deviceId, int taskId, const ModelMemoryKey& key,
+        uint32_t waitMs)
+    {
+        mpConnect_once_wrapper();
+        dxrt::IPCClientMessage clientMessage;
+        dxrt::IPCServerMessage serverMessage;
+        ModelMemoryRegion region;
+
+        clientMessage.code = dxrt::REQUEST_CODE::ACQUIRE_MODEL_MEMORY;
+        clientMessage.deviceId = deviceId;
+        clientMessage.pid = getpid();
+        clientMessage.taskId = taskId;
+        SetModelMemoryKey(clientMessage, key);
+        clientMessage.alloc.waitMs = waitMs;
+
+        // The service answers once the regions are usable or the wait has expired
+        if (ipcClientWrapperSync.SendToServer(serverMessage, clientMessage) == 0)
+        {
+            region.state = static_cast<ModelMemoryRegion::State>(serverMessage.result);
+        }
+        if (region.state == ModelMemoryRegion::State::ALLOCATED || region.state == ModelMemoryRegion::State::RESIDENT)
+        {
+            region.rmapOffset = static_cast<int64_t>(serverMessage.data >> 32);
+            region.weightOffset = static_cast<int64_t>(serverMessage.data & 0xFFFFFFFFULL);
+        }
+        LOG_DXRT_DBG << "model memory for Task " << taskId << ": state " << static_cast<uint32_t>(region.state)
+                     << ", rmap " << std::hex << region.rmapOffset << ", weight " << region.weightOffset
+                     << std::dec << "\n";
+        return region;
+    }
+
+    void MultiprocessMemory::SignalModelMemoryReady(int deviceId, const ModelMemoryKey& key)
+    {
+        dxrt::IPCClientMessage clientMessage;
+        LOG_DXRT_DBG << "Dev Id : " << deviceId << "\n";
+
+        clientMessage.code = dxrt::REQUEST_CODE::MODEL_MEMORY_READY;
+        clientMessage.deviceId = deviceId;
+        clientMessage.pid = getpid();
+        SetModelMemoryKey(clientMessage, key);
+
+        ipcClientWrapper.SendToServer(clientMessage);
+        return;
+    }
 }  // namespace dxrt
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "dxrt/nfh_worker_pool.h"
+#include "dxrt/thread_affinity.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+namespace dxrt {
+
+namespace {
+
+// Below this many bytes per chunk the hand-off costs more than the copy it saves
+constexpr size_t NFH_MIN_CHUNK_BYTES = 128 * 1024;
+// Chunks per participating thread, so uneven chunk runtimes still balance out
+constexpr size_t NFH_CHUNKS_PER_THREAD = 4;
+
+}  // namespace
+
+NfhWorkerPool& NfhWorkerPool::GetInstance()
+{
+    static NfhWorkerPool instance(GetNfhParallelWorkerThreads());
+    return instance;
+}
+
+NfhWorkerPool::NfhWorkerPool(int numThreads)
+{
+    _threads.reserve(numThreads);
+    for (int i = 0; i < numThreads; i++)
+    {
+        _threads.emplace_back(&NfhWorkerPool::workerThread, this);
+    }
+    LOG_DXRT_DBG << "NfhWorkerPool created with " << numThreads << " threads" << std::endl;
+}
+
+NfhWorkerPool::~NfhWorkerPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _stop.store(true);
+        _cv.notify_all();
+    }
+    for (auto& t : _threads)
+    {
+        if (t.joinable()) t.join();
+    }
+}
+
+size_t NfhWorkerPool::GrainFor(size_t count, size_t itemBytes) const
+{
+    if (_threads.empty() || count == 0 || itemBytes == 0)
+        return std::max<size_t>(count, 1);
+    if (count * itemBytes < 2 * NFH_MIN_CHUNK_BYTES)
+        return count;
+
+    size_t minItems = (NFH_MIN_CHUNK_BYTES + itemBytes - 1) / itemBytes;
+    size_t targetChunks = (_threads.size() + 1) * NFH_CHUNKS_PER_THREAD;
+    size_t balanced = (count + targetChunks - 1) / targetChunks;
+    return std::min(count, std::max(minItems, balanced));
+}
+
+void NfhWorkerPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn)
+{
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    if (_threads.empty() || grain >= count)
+    {
+        fn(0, count);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->fn = &fn;
+    job->count = count;
+    job->grain = grain;
+    job->numChunks = (count + grain - 1) / grain;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _jobs.push_back(job);
+    }
+    _cv.notify_all();
+
+    // The caller drains its own job; workers only speed it up
+    while (runChunk(*job)) {}
+    removeJob(job);
+
+    std::unique_lock<std::mutex> lock(_lock);
+    _doneCv.wait(lock, [&job] {
+        return job->done.load(std::memory_order_acquire) == job->numChunks;
+    });
+}
+
+bool NfhWorkerPool::runChunk(Job& job)
+{
+    size_t chunk = job.next.fetch_add(1, std::memory_order_relaxed);
+    if (chunk >= job.numChunks) return false;
+
+    size_t begin = chunk * job.grain;
+    size_t end = std::min(job.count, begin + job.grain);
+    try
+    {
+        (*job.fn)(begin, end);
+    }
+    catch (std::exception& e)
+    {
+        LOG_DXRT_ERR("NfhWorkerPool chunk failed: " << e.what());
+    }
+    catch (...)
+    {
+        LOG_DXRT_ERR("NfhWorkerPool chunk failed: unknown error");
+    }
+
+    if (job.done.fetch_add(1, std::memory_order_acq_rel) + 1 == job.numChunks)
+    {
+        // Lock so the notify cannot slip between the waiter's predicate check and its sleep
+        std::unique_lock<std::mutex> lock(_lock);
+        _doneCv.notify_all();
+    }
+    return true;
+}
+
+void NfhWorkerPool::removeJob(const std::shared_ptr<Job>& job)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = std::find(_jobs.begin(), _jobs.end(), job);
+    if (it != _jobs.end()) _jobs.erase(it);
+}
+
+void NfhWorkerPool::workerThread()
+{
+    ApplyThreadPlacement(ThreadRole::NFH);
+    while (true)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _cv.wait(lock, [this] {
+                return !_jobs.empty() || _stop.load(std::memory_order_acquire);
+            });
+            if (_stop.load(std::memory_order_acquire)) return;
+
+            // Rotate across active jobs: one chunk per visit keeps concurrent requests progressing
+            _cursor = (_cursor + 1) % _jobs.size();
+            job = _jobs[_cursor];
+        }
+        if (!runChunk(*job))
+        {
+            removeJob(job);
+        }
+    }
+}
+
+}  // namespace dxrt
@@ -8,6 +8,8 @@
  */
 
 #include "dxrt/npu_format_handler.h"
+#include "dxrt/npu_format_kernels.h"
+#include "dxrt/nfh_worker_pool.h"
 #include <vector>
 #include <numeric>
 #include <functional>
@@ -18,6 +20,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <limits>
+#include <algorithm>
+#include <atomic>
 // High-level NFH function dependencies
 #include "dxrt/request_data.h"
 #include "dxrt/request.h"
@@ -29,6 +33,52 @@
 
 namespace npu_format_handler {
 
+namespace {
+
+// Row-block split of kernels::copy_rows over the NFH worker pool; small blocks stay on the caller
+void parallel_copy_rows(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                        size_t rows, size_t copy_bytes, size_t pad_bytes)
+{
+    auto& pool = dxrt::NfhWorkerPool::GetInstance();
+    size_t grain = pool.GrainFor(rows, copy_bytes + pad_bytes);
+    pool.ParallelFor(rows, grain, [&](size_t begin, size_t end) {
+        kernels::copy_rows(dst + begin * dst_stride, dst_stride, src + begin * src_stride, src_stride,
+                           end - begin, copy_bytes, pad_bytes);
+    });
+}
+
+// Plain copy in page-sized blocks over the NFH worker pool, for layouts that need no reformatting
+void parallel_memcpy(void* dst, const void* src, size_t size)
+{
+    constexpr size_t BLOCK = 4096;
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    auto& pool = dxrt::NfhWorkerPool::GetInstance();
+    size_t blocks = (size + BLOCK - 1) / BLOCK;
+    pool.ParallelFor(blocks, pool.GrainFor(blocks, BLOCK), [&](size_t begin, size_t end) {
+        size_t first = begin * BLOCK;
+        size_t last = std::min(size, end * BLOCK);
+        memcpy(d + first, s + first, last - first);
+    });
+}
+
+// Splits kernels::transpose_strided along destination rows (source columns)
+void parallel_transpose_strided(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                                size_t row, size_t col, size_t element_size, size_t pad_bytes)
+{
+    // Keep chunk boundaries on the transpose tile edge so every chunk runs full tiles
+    constexpr size_t TILE = 64;
+    auto& pool = dxrt::NfhWorkerPool::GetInstance();
+    size_t grain = pool.GrainFor(col, row * element_size + pad_bytes);
+    if (grain < col) grain = (grain + TILE - 1) / TILE * TILE;
+    pool.ParallelFor(col, grain, [&](size_t begin, size_t end) {
+        kernels::transpose_strided(src + begin * element_size, src_stride, dst + begin * dst_stride, dst_stride,
+                                   row, end - begin, element_size, pad_bytes);
+    });
+}
+
+}  // namespace
+
 // Helper function: Integer division rounding up
 int cdiv(int a, int b) {
     if (b == 0) {
@@ -90,12 +140,8 @@ int NpuFormatHandler::encode(Bytes& input, Bytes& output, int col, int unit) {
 
             memcpy(temp_buffer, input.data, input.size);
 
-            // Clear the output area (especially padding) before copying back
-            memset(data, 0, output.size);
-
-            for (int i = 0; i < row; ++i) {
-                memcpy(data + (size_t)i * aligned_col, temp_buffer + (size_t)i * col, col);
-            }
+            // Rows and padding are written in a single pass, no need to clear the output first
+            parallel_copy_rows(data, aligned_col, temp_buffer, col, row, col, aligned_col - col);
 
             delete[] temp_buffer;
         }
@@ -108,11 +154,8 @@ int NpuFormatHandler::encode(Bytes& input, Bytes& output, int col, int unit) {
              return -1;
          }
     } else { // Out-of-place operation
-        // Clear the output area (especially padding) before copying
-        memset(data, 0, output.size);
-        for (int i = 0; i < row; ++i) {
-            memcpy(data + (size_t)i * aligned_col, input.data + (size_t)i * col, col);
-        }
+        // Rows and padding are written in a single pass, no need to clear the output first
+        parallel_copy_rows(data, aligned_col, input.data, col, row, col, aligned_col - col);
     }
 
     return 0;
@@ -184,65 +227,31 @@ int NpuFormatHandler::encode_formatted(Bytes& input, Bytes& output, int channel,
 
     uint8_t* data = output.data;
 
-    // Zero out the buffer initially to handle padding correctly
-    memset(data, 0, output.size);
-
-    if (input.data == output.data) { // In-place
+    const uint8_t* src = input.data;
+    uint8_t* temp_buffer = nullptr;
+    if (input.data == output.data) { // In-place: snapshot the input before it is overwritten
         try {
-             uint8_t* temp_buffer = new uint8_t[input.size];
-             memcpy(temp_buffer, input.data, input.size);
-
-             for (int g = 0; g < col_group; ++g) {
-                 for (int i = 0; i < row; ++i) {
-                     // Calculate addresses relative to the start of the buffers
-                     size_t src_addr = (size_t)i * col + (size_t)g * align_unit;
-                     size_t dst_addr = (size_t)g * row * align_unit + (size_t)i * align_unit;
-
-                     // Calculate how many bytes to copy for this chunk
-                     int remaining_cols = col - g * align_unit;
-                     int copy_size = (remaining_cols < align_unit) ? remaining_cols : align_unit;
-
-                     // Ensure copy_size is not negative if col < g*unit (shouldn't happen with cdiv)
-                     if (copy_size > 0) {
-                         // Check bounds before memcpy
-                          if (src_addr + copy_size > input.size || dst_addr + copy_size > output.size) {
-                               LOG_DXRT_ERR("[encode_formatted] Internal Error: Memory access out of bounds during in-place copy.");
-                              delete[] temp_buffer; // Clean up memory
-                              return -1;
-                         }
-                         memcpy(data + dst_addr, temp_buffer + src_addr, copy_size);
-                     }
-                 }
-             }
-             delete[] temp_buffer;
+             temp_buffer = new uint8_t[input.size];
         } catch (const std::bad_alloc& e) {
              LOG_DXRT_ERR("[encode_formatted] Error: Failed to allocate temporary buffer for in-place operation: " << e.what());
              return -1;
-        } catch (const std::exception& e) {
-             LOG_DXRT_ERR("[encode_formatted] Error during in-place operation: " << e.what());
-             return -1;
-         }
-
-    } else { // Out-of-place
-        for (int g = 0; g < col_group; ++g) {
-            for (int i = 0; i < row; ++i) {
-                size_t src_addr = (size_t)i * col + (size_t)g * align_unit;
-                size_t dst_addr = (size_t)g * row * align_unit + (size_t)i * align_unit;
-                int remaining_cols = col - g * align_unit;
-                int copy_size = (remaining_cols < align_unit) ? remaining_cols : align_unit;
-
-                if (copy_size > 0) {
-                     // Check bounds before memcpy
-                     if (src_addr + copy_size > input.size || dst_addr + copy_size > output.size) {
-                          LOG_DXRT_ERR("[encode_formatted] Internal Error: Memory access out of bounds during out-of-place copy.");
-                          return -1;
-                     }
-                    memcpy(data + dst_addr, input.data + src_addr, copy_size);
-                }
-            }
         }
+        memcpy(temp_buffer, input.data, input.size);
+        src = temp_buffer;
     }
 
+    // Each group is a (row x align_unit) block: copy_size bytes from the source row, then zero padding.
+    // Every output byte is written exactly once, so the output does not need to be cleared first.
+    for (int g = 0; g < col_group; ++g) {
+        int remaining_cols = col - g * align_unit;
+        int copy_size = (remaining_cols < align_unit) ? remaining_cols : align_unit;
+
+        parallel_copy_rows(data + (size_t)g * row * align_unit, align_unit,
+                           src + (size_t)g * align_unit, col,
+                           row, copy_size, align_unit - copy_size);
+    }
+    delete[] temp_buffer;
+
     return 0;
 }
 
@@ -318,14 +327,7 @@ int NpuFormatHandler::decode(Bytes& input, Bytes& output, int col, int unit) {
              return -1;
          }
     } else { // Out-of-place
-        for (int i = 0; i < row; ++i) {
-             // Check bounds before memcpy
-             if ((size_t)i * col + col > output.size || (size_t)i * aligned_col + col > input.size) {
-                   LOG_DXRT_ERR("[decode] Internal Error: Memory access out of bounds during out-of-place copy.");
-                   return -1;
-             }
-            memcpy(data + (size_t)i * col, input.data + (size_t)i * aligned_col, col);
-        }
+        parallel_copy_rows(data, col, input.data, aligned_col, row, col, 0);
     }
 
     return 0;
@@ -367,23 +369,9 @@ void NpuFormatHandler::bidirectional_transpose(void* src, void* dst, int row, in
             return;
         }
 
-        uint8_t* dst_ptr_base = static_cast<uint8_t*>(dst);
-        const uint8_t* src_ptr_base = static_cast<const uint8_t*>(src);
-
-        for (int i = 0; i < row; i++) {
-            for (int j = 0; j < col; j++) {
-                size_t src_offset = ((size_t)i * col + j) * element_size;
-                size_t dst_offset = ((size_t)j * row + i) * element_size; // Transposed index [j][i]
-                // Basic bounds check (optional, assumes caller allocated enough space)
-                // size_t src_total_size = (size_t)row * col * element_size;
-                // size_t dst_total_size = (size_t)col * row * element_size;
-                // if (src_offset + element_size > src_total_size || dst_offset + element_size > dst_total_size) {
-                //     LOG_DXRT_ERR("[bidirectional_transpose] Warning: Potential out-of-bounds access during transpose.");
-                //     // Continue carefully or return error
-                // }
-                memcpy(dst_ptr_base + dst_offset, src_ptr_base + src_offset, element_size);
-            }
-        }
+        // Cache-blocked tiled transpose with SIMD micro-kernels for 1/2/4-byte elements
+        kernels::transpose(static_cast<const uint8_t*>(src), static_cast<uint8_t*>(dst),
+                           static_cast<size_t>(row), static_cast<size_t>(col), element_size);
     }
     catch (const std::exception& e) {
         // Catch potential exceptions from memory operations if any (though memcpy usually doesn't throw std::exception)
@@ -417,89 +405,13 @@ void NpuFormatHandler::bidirectional_transpose_inplace(void* src, int row, int c
     }
 
 
-    if (row == col) {
-        // --- Square matrix: Use existing in-place transpose logic ---
-        try {
-            uint8_t* src_ptr = static_cast<uint8_t*>(src);
-            // Temporary buffer (size of one element)
-            // std::vector<uint8_t> temp(element_size); // Option using vector
-            uint8_t* temp = new uint8_t[element_size];
-
-            for (int i = 0; i < row; ++i) {
-                // Iterate through the upper triangle only (excluding diagonal)
-                for (int j = i + 1; j < col; ++j)
-                {
-                    // Calculate offsets for elements (i, j) and (j, i)
-                    size_t offset1 = ((size_t)i * col + j) * element_size;
-                    size_t offset2 = ((size_t)j * col + i) * element_size;
-
-                    // Bounds check on original pointer access (add if necessary)
-                    // if (offset1 + element_size > total_size_bytes || offset2 + element_size > total_size_bytes) { ... }
-
-                    uint8_t* ptr1 = src_ptr + offset1;
-                    uint8_t* ptr2 = src_ptr + offset2;
-
-                    // Swap elements
-                    memcpy(temp, ptr1, element_size);
-                    memcpy(ptr1, ptr2, element_size);
-                    memcpy(ptr2, temp, element_size);
-                    // If using vector:
-                    // memcpy(temp.data(), ptr1, element_size);
-                    // memcpy(ptr1, ptr2, element_size);
-                    // memcpy(ptr2, temp.data(), element_size);
-                }
-            }
-            delete[] temp; // Free allocated memory
-        } catch (const std::bad_alloc& e) {
-            LOG_DXRT_ERR("[bidirectional_transpose_inplace] Error: Failed to allocate temporary buffer: " << e.what());
-        } catch (const std::exception& e) {
-            LOG_DXRT_ERR("[bidirectional_transpose_inplace] Error during square transpose: " << e.what());
-        }
-    } else {
-        // --- Rectangular matrix: Use temporary buffer ---
-        uint8_t* temp_buffer = nullptr;
-        try {
-            // 1. Allocate temporary buffer (full size)
-            temp_buffer = new uint8_t[total_size_bytes];
-
-            // 2. Copy from src to temp_buffer with transpose (Out-of-place transpose)
-            uint8_t* src_ptr = static_cast<uint8_t*>(src);
-            for (int i = 0; i < row; ++i) { // Iterate through original rows
-                for (int j = 0; j < col; ++j) { // Iterate through original columns
-                    size_t src_offset = ((size_t)i * col + j) * element_size;
-                    // Destination index in temp buffer is transposed (j, i)
-                    // Transposed matrix is C x R, so stride is row
-                    size_t temp_dst_offset = ((size_t)j * row + i) * element_size;
-
-                    // Bounds check
-                    if (src_offset + element_size > total_size_bytes) {
-                         throw std::runtime_error("Source read out-of-bounds during temp transpose");
-                    }
-                    if (temp_dst_offset + element_size > total_size_bytes) {
-                         throw std::runtime_error("Temp buffer write out-of-bounds during temp transpose");
-                    }
-
-                    memcpy(temp_buffer + temp_dst_offset, src_ptr + src_offset, element_size);
-                }
-            }
-
-            // 3. Copy the transposed result from temp_buffer back to the original src buffer
-            memcpy(src, temp_buffer, total_size_bytes);
-
-            // 4. Free the temporary buffer
-            delete[] temp_buffer;
-            temp_buffer = nullptr; // Reset pointer (optional)
-
-        } catch (const std::bad_alloc& e) {
-            LOG_DXRT_ERR("[bidirectional_transpose_inplace] Error: Failed to allocate temporary buffer for non-square transpose: " << e.what());
-            // temp_buffer is already null or delete[] will handle null
-            // delete[] temp_buffer; // DO NOT delete here - potential double-free
-            return; // Return on error
-        } catch (const std::exception& e) {
-            LOG_DXRT_ERR("[bidirectional_transpose_inplace] Error during non-square transpose: " << e.what());
-            delete[] temp_buffer; // Attempt to free in case it was allocated before exception
-            return; // Return on error
-        }
+    // Square: mirrored tiles are swapped through a register-sized scratch block.
+    // Rectangular: column-rotate / row-shuffle / column-shuffle passes (Catanzaro et al.) that
+    // only need max(row, col) elements of scratch, no full temporary copy.
+    if (kernels::transpose_inplace(static_cast<uint8_t*>(src), static_cast<size_t>(row),
+                                   static_cast<size_t>(col), element_size) != 0) {
+        LOG_DXRT_ERR("[bidirectional_transpose_inplace] Error: Failed to allocate work buffer for "
+                  << row << "x" << col << " transpose.");
     }
 }
 
@@ -548,60 +460,64 @@ int NpuFormatHandler::encode_formatted_transposed(
 
 
      // --- Perform Transpose and Encode Simultaneously ---
+     // Group g holds original rows [g*unit, g*unit + copy) as a (col x unit) block: one strided
+     // transpose per group reads the source once and writes payload and padding in a single pass.
      uint8_t* dst_data = static_cast<uint8_t*>(output.data);
      const uint8_t* src_data = static_cast<const uint8_t*>(input.data);
+     const size_t src_stride = (size_t)col * element_size;
+     const size_t dst_stride = (size_t)unit * element_size;
 
-     // Zero out the destination buffer first to handle padding correctly
-     memset(dst_data, 0, output.size);
+     for (int g = 0; g < col_group; ++g) {
+         int remaining_elements = enc_col - g * unit; // Remaining original rows
+         int elements_to_copy = (remaining_elements < unit) ? remaining_elements : unit;
 
-     try {
-         // Outer loops iterate through the structure of the *output* buffer
-         for (int g = 0; g < col_group; ++g) { // Index for groups of 'unit' (originally rows)
-             for (int i = 0; i < enc_row; ++i) { // Index within group (originally columns 'j')
-                 // Calculate the base offset in the destination buffer for the start of this unit-chunk
-                 // Structure is: group * rows_per_group * unit_width + row_index_in_group * unit_width
-                 size_t base_dst_offset_elements = (size_t)g * enc_row * unit + (size_t)i * unit;
-
-                 // Determine how many elements to copy in this chunk (handles boundary case)
-                 int remaining_elements = enc_col - g * unit; // Remaining original rows
-                 int elements_to_copy = (remaining_elements < unit) ? remaining_elements : unit;
-
-                 if (elements_to_copy <= 0) continue; // Should not happen if col_group is calculated correctly
-
-                 // Inner loop copies individual elements from source (transposed) to destination (formatted)
-                 for (int k = 0; k < elements_to_copy; ++k) {
-                     // Calculate the original matrix indices (orig_row, orig_col)
-                     int orig_row = g * unit + k; // Row index in the original input matrix
-                     int orig_col = i;           // Column index in the original input matrix
-
-                     // Calculate source offset in input buffer (bytes)
-                     size_t src_offset_bytes = ((size_t)orig_row * col + orig_col) * element_size;
-
-                     // Calculate destination offset in output buffer (bytes)
-                     size_t dst_offset_bytes = (base_dst_offset_elements + k) * element_size;
-
-                     // Bounds check (essential for safety)
-                     if (src_offset_bytes + element_size > input.size || dst_offset_bytes + element_size > output.size) {
-                          LOG_DXRT_ERR("[encode_formatted_transposed] Internal Error: Memory access out of bounds.");
-                          return -1;
-                     }
-
-                     // Copy the element
-                     memcpy(dst_data + dst_offset_bytes, src_data + src_offset_bytes, element_size);
-                 }
-                  // Padding is implicitly handled because the destination buffer was zeroed out,
-                  // and we only copy 'elements_to_copy' elements into the allocated 'unit' space.
-             }
-         }
-     } catch (const std::exception& e) {
-         // Catch potential memory-related exceptions, although unlikely with memcpy
-         LOG_DXRT_ERR("[encode_formatted_transposed] Error during copy: " << e.what());
-         return -1;
+         parallel_transpose_strided(src_data + (size_t)g * unit * src_stride, src_stride,
+                                    dst_data + (size_t)g * enc_row * dst_stride, dst_stride,
+                                    elements_to_copy, enc_row, element_size,
+                                    (size_t)(unit - elements_to_copy) * element_size);
      }
 
      return 0; // Success
 }
 
+int NpuFormatHandler::encode_aligned_transposed(
+    Bytes& input, Bytes& output, int row, int col, size_t element_size, int unit)
+{
+    if (input.data == nullptr || output.data == nullptr) {
+        LOG_DXRT_ERR("[encode_aligned_transposed] Error: Input or output data buffer is null.");
+        return -1;
+    }
+    if (row <= 0 || col <= 0 || element_size == 0 || unit <= 0) {
+        LOG_DXRT_ERR("[encode_aligned_transposed] Error: Invalid input parameters (row=" << row
+                  << ", col=" << col << ", element_size=" << element_size << ", unit=" << unit << ").");
+        return -1;
+    }
+    if (input.size != (uint32_t)row * col * element_size) {
+        LOG_DXRT_ERR("[encode_aligned_transposed] Error: Input size (" << input.size
+                  << ") does not match row * col * element_size (" << (uint32_t)row * col * element_size << ").");
+        return -1;
+    }
+    if (input.data == output.data) {
+        LOG_DXRT_ERR("[encode_aligned_transposed] Error: In-place operation (input == output) is not supported for this function.");
+        return -1;
+    }
+
+    // Transposed matrix is (col x row); each of its rows is padded to a multiple of unit elements
+    size_t payload = (size_t)row * element_size;
+    size_t aligned_row = (size_t)cdiv(row, unit) * unit * element_size;
+    uint32_t expected_output_size = (uint32_t)(col * aligned_row);
+    if (expected_output_size != output.size) {
+        LOG_DXRT_ERR("[encode_aligned_transposed] Warning: Output size is different than expected. "
+                  << "Expected size: " << expected_output_size << ", Provided size: " << output.size
+                  << ". Output size will be set to expected.");
+    }
+    output.size = expected_output_size;
+
+    parallel_transpose_strided(input.data, (size_t)col * element_size, output.data, aligned_row,
+                               row, col, element_size, aligned_row - payload);
+    return 0;
+}
+
 int NpuFormatHandler::decode_aligned_transposed(
     Bytes& input,
     Bytes& output,
@@ -796,65 +712,320 @@ int NpuFormatHandler::decode_aligned_transposed(
         return 0;
     }
 
-    // --- 7. Initialize Output Buffer (Optional but recommended) ---
-    // This ensures any padding areas or potentially unwritten elements are zero.
-    // memset(output.data, 0, output.size);
+    // --- 7. Strip + Transpose in a single pass ---
+    // Source: decoded_rows rows of channel_for_decode elements, each row starting
+    // decode_byte_aligned_col bytes apart. Destination: the dense transposed matrix,
+    // (channel_for_decode x decoded_rows).
+    parallel_transpose_strided(static_cast<const uint8_t*>(input.data), decode_byte_aligned_col,
+                               static_cast<uint8_t*>(output.data), decoded_rows * element_size,
+                               decoded_rows, channel_for_decode, element_size, 0);
 
-    // --- 8. Core Loop: Perform Decode and Transpose Simultaneously ---
-    uint8_t* dst_data = static_cast<uint8_t*>(output.data);
-    const uint8_t* src_data = static_cast<const uint8_t*>(input.data);
+    return 0;
+}
 
-    // Define source (decoded) and destination (transposed) logical dimensions for clarity
-    uint64_t src_logical_rows = decoded_rows;
-    uint64_t src_logical_cols = static_cast<uint64_t>(channel_for_decode);
-    //uint64_t dst_logical_rows = transpose_row;
-    uint64_t dst_logical_cols = transpose_col;
+bool NpuFormatHandler::is_formatted_transposed_exact(int channel, int align_unit)
+{
+    return channel > 0 && channel == align_unit;
+}
 
-    try {
-        // Iterate based on the indices (i, j) of the conceptually decoded matrix
-        for (uint64_t i = 0; i < src_logical_rows; ++i) {       // Index for decoded rows
-            for (uint64_t j = 0; j < src_logical_cols; ++j) {   // Index for decoded columns (channels)
-
-                // 1. Calculate Source Offset (within the encoded input buffer)
-                // Start of the i-th aligned row + offset for the j-th element
-                size_t src_offset_bytes = (size_t)i * decode_byte_aligned_col + (size_t)j * element_size;
-
-                // 2. Calculate Transposed Coordinates (based on standard matrix transpose)
-                // Source logical coordinate (r, c) = (i, j) -> Transposed logical coordinate (r_t, c_t) = (j, i)
-                uint64_t r_t = j; // Transposed row index = original column index
-                uint64_t c_t = i; // Transposed column index = original row index
-
-                // 3. Calculate Destination Offset (within the transposed output buffer)
-                // Output buffer layout is dst_logical_rows x dst_logical_cols
-                size_t dst_offset_bytes = (r_t * dst_logical_cols + c_t) * element_size;
-
-                // 4. Boundary Checks (Crucial for safety)
-                if (src_offset_bytes + element_size > input.size) {
-                     LOG_DXRT_ERR("[decode_aligned_transposed] Internal Error: Source read out of bounds. "
-                               << "Offset: " << src_offset_bytes << ", ElementSize: " << element_size << ", InputSize: " << input.size);
-                     return -1;
-                }
-                if (dst_offset_bytes + element_size > output.size) {
-                     LOG_DXRT_ERR("[decode_aligned_transposed] Internal Error: Destination write out of bounds. "
-                               << "Offset: " << dst_offset_bytes << ", ElementSize: " << element_size << ", OutputSize: " << output.size);
-                     return -1;
-                }
-
-                // 5. Copy Element
-                memcpy(dst_data + dst_offset_bytes, src_data + src_offset_bytes, element_size);
-            }
+bool NpuFormatHandler::is_aligned_transposed_exact(int channel, deepx_rmapinfo::DataType dtype, int align_unit)
+{
+    if (channel <= 0 || align_unit <= 0) return false;
+    return dxrt::GetDataSize_rmapinfo_datatype(dtype) == 1 || dtype == deepx_rmapinfo::DataType::FLOAT32 ||
+        channel % align_unit == 0;
+}
+
+bool NpuFormatHandler::IsInputLayoutIdentical(deepx_rmapinfo::TensorInfo& tensor_info, uint64_t user_size)
+{
+    if (tensor_info.memory().size() <= 0 || static_cast<uint64_t>(tensor_info.memory().size()) != user_size)
+        return false;
+
+    const auto layout = static_cast<deepx_rmapinfo::Layout>(tensor_info.layout());
+    const auto transpose = static_cast<deepx_rmapinfo::Transpose>(tensor_info.transpose());
+    const int shape_dims = tensor_info.shape_encoded().size();
+    const int channel = shape_dims > 0 ? static_cast<int>(tensor_info.shape_encoded()[shape_dims - 1]) : 0;
+    const bool channel_aligned = channel > 0 && tensor_info.align_unit() > 0 &&
+        channel % tensor_info.align_unit() == 0;
+    // encode_formatted regroups the channels into planar (row x align_unit) blocks, which keeps the
+    // layout only with a single group or a single row
+    const bool formatted_identical = channel_aligned &&
+        (channel == tensor_info.align_unit() || user_size == static_cast<uint64_t>(channel));
+
+    // Mirrors the dispatch in EncodeInputs
+    switch (layout)
+    {
+        case deepx_rmapinfo::Layout::PRE_FORMATTER:
+        case deepx_rmapinfo::Layout::PRE_IM2COL:
+            return false;
+        case deepx_rmapinfo::Layout::FORMATTED:
+            if (transpose == deepx_rmapinfo::Transpose::TRANSPOSE_NONE) return formatted_identical;
+            return transpose != deepx_rmapinfo::Transpose::CHANNEL_FIRST_TO_LAST;
+        case deepx_rmapinfo::Layout::ALIGNED:
+            return transpose == deepx_rmapinfo::Transpose::TRANSPOSE_NONE && channel_aligned;
+        default:
+            return true;
+    }
+}
+
+bool NpuFormatHandler::IsOutputLayoutIdentical(deepx_rmapinfo::TensorInfo& tensor_info, uint64_t user_size)
+{
+    const auto mem_type = static_cast<deepx_rmapinfo::MemoryType>(tensor_info.memory().type());
+    if (mem_type == deepx_rmapinfo::MemoryType::ARGMAX || mem_type == deepx_rmapinfo::MemoryType::PPU)
+        return false;
+    if (tensor_info.memory().size() <= 0 || static_cast<uint64_t>(tensor_info.memory().size()) != user_size)
+        return false;
+
+    // Mirrors the dispatch in DecodeOutputs
+    if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::ALIGNED)
+    {
+        const auto transpose = static_cast<deepx_rmapinfo::Transpose>(tensor_info.transpose());
+        const int shape_dims = tensor_info.shape_encoded().size();
+        if (transpose == deepx_rmapinfo::Transpose::TRANSPOSE_NONE)
+        {
+            return shape_dims > 0 && tensor_info.align_unit() > 0 &&
+                tensor_info.shape_encoded()[shape_dims - 1] % tensor_info.align_unit() == 0;
         }
-    } catch (const std::exception& e) {
-        // Catch potential exceptions during the copy loop (e.g., memory access errors)
-        LOG_DXRT_ERR("[decode_aligned_transposed] Error during copy loop: " << e.what());
+        return transpose != deepx_rmapinfo::Transpose::CHANNEL_LAST_TO_FIRST;
+    }
+    return true;
+}
+
+// --- High-level NFH Processing Functions Implementation ---
+
+namespace {
+
+// Encodes input tensor i of a request into its slot of the encoded input buffer
+int encode_input_tensor(dxrt::RequestData* reqData, size_t i)
+{
+    using namespace dxrt;
+
+    if (reqData->encoded_input_ptrs.size() <= i || reqData->encoded_input_ptrs[i] == nullptr)
+    {
+        LOG_DXRT_ERR("EncodeInputs: encoded_input_ptrs[" << i << "] is nullptr or out of range");
+        return -1;
+    }
+
+    Tensor& input_tensor = reqData->inputs[i];
+    deepx_rmapinfo::TensorInfo tensor_info = reqData->taskData->_npuInputTensorInfos[i];
+    int shape_dims = tensor_info.shape_encoded().size();
+
+    Bytes original_input = {
+        static_cast<uint32_t>(input_tensor.size_in_bytes()),
+        static_cast<uint8_t*>(input_tensor.data())
+    };
+    Bytes encoded_input = {
+        static_cast<uint32_t>(reqData->taskData->_encodedInputSizes[i]),
+        static_cast<uint8_t*>(reqData->encoded_input_ptrs[i])
+    };
+
+    if (original_input.data == nullptr || encoded_input.data == nullptr)
+    {
+        LOG_DXRT_ERR("EncodeInputs: null data pointer at input " << i);
         return -1;
     }
 
-    // --- 9. Return Success ---
+    if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::PRE_FORMATTER)
+    {
+        NpuFormatHandler::encode_preformatter(original_input, encoded_input, tensor_info.align_unit());
+    }
+    else if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::PRE_IM2COL)
+    {
+        NpuFormatHandler::encode_preim2col(
+            original_input, encoded_input,
+            tensor_info.shape_encoded()[shape_dims - 2],
+            tensor_info.shape_encoded()[shape_dims - 1],
+            tensor_info.align_unit()
+        );
+    }
+    else if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::FORMATTED)
+    {
+        if (tensor_info.transpose() == deepx_rmapinfo::Transpose::TRANSPOSE_NONE)
+        {
+            NpuFormatHandler::encode_formatted(
+                original_input, encoded_input,
+                tensor_info.shape_encoded()[shape_dims - 1],
+                tensor_info.align_unit()
+            );
+        }
+        else if (tensor_info.transpose() == deepx_rmapinfo::Transpose::CHANNEL_FIRST_TO_LAST)
+        {
+            int row = tensor_info.shape_encoded()[shape_dims - 1];
+            int col = 1;
+            for (int j = 0; j < shape_dims - 1; j++) col *= tensor_info.shape_encoded()[j];
+            int elem_size = dxrt::GetDataSize_rmapinfo_datatype(static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()));
+            if (NpuFormatHandler::is_formatted_transposed_exact(row, tensor_info.align_unit()))
+            {
+                // Fused: read the channel-first tensor once, write the padded channel-last layout
+                NpuFormatHandler::encode_formatted_transposed(
+                    original_input, encoded_input, row, col, elem_size, tensor_info.align_unit());
+            }
+            else
+            {
+                NpuFormatHandler::encode_formatted(original_input, encoded_input, row, tensor_info.align_unit());
+                NpuFormatHandler::bidirectional_transpose(encoded_input.data, encoded_input.data, row, col, elem_size);
+            }
+        }
+        else
+        {
+            parallel_memcpy(encoded_input.data, original_input.data, original_input.size);
+        }
+    }
+    else if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::ALIGNED)
+    {
+        // Handle ALIGNED layout with transpose options
+        if (tensor_info.transpose() == deepx_rmapinfo::Transpose::TRANSPOSE_NONE)
+        {
+            // Use encode function with channel parameter (same as decode_aligned uses)
+            int channel = tensor_info.shape_encoded()[shape_dims - 1];
+            int unit = tensor_info.align_unit(); // Use align_unit from tensor info
+            int col = channel; // Number of columns in elements
+
+            // Scale unit and col to bytes for FLOAT32 if needed
+            if (static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()) == deepx_rmapinfo::DataType::FLOAT32) {
+                // Scale unit and col to bytes for the underlying encode function
+                unit *= 4;
+                col *= 4;
+            }
+
+            NpuFormatHandler::encode(original_input, encoded_input, col, unit);
+        }
+        else if (tensor_info.transpose() == deepx_rmapinfo::Transpose::CHANNEL_FIRST_TO_LAST)
+        {
+            // Fused transpose + align: one pass from the user tensor into encoded_input
+            // where it matches the two-step layout
+            int row = tensor_info.shape_encoded()[shape_dims - 1];
+            int transpose_col = 1;
+            for (int j = 0; j < shape_dims - 1; j++)
+            {
+                transpose_col *= tensor_info.shape_encoded()[j];
+            }
+            const auto dtype = static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded());
+            int elem_size = dxrt::GetDataSize_rmapinfo_datatype(dtype);
+
+            if (NpuFormatHandler::is_aligned_transposed_exact(row, dtype, tensor_info.align_unit()))
+            {
+                NpuFormatHandler::encode_aligned_transposed(
+                    original_input, encoded_input, row, transpose_col, elem_size, tensor_info.align_unit());
+            }
+            else
+            {
+                // Transpose into encoded_input, then align it in place
+                NpuFormatHandler::bidirectional_transpose(original_input.data, encoded_input.data, row, transpose_col, elem_size);
+                Bytes temp_transposed = {original_input.size, encoded_input.data};
+                NpuFormatHandler::encode(temp_transposed, encoded_input, row, tensor_info.align_unit());
+            }
+        }
+        else
+        {
+            LOG_DXRT_ERR("Invalid transpose type for ALIGNED layout");
+            memcpy(static_cast<void*>(encoded_input.data),
+                    static_cast<const void*>(original_input.data),
+                    original_input.size);
+        }
+    }
+    else
+    {
+        parallel_memcpy(encoded_input.data, original_input.data, original_input.size);
+    }
+
     return 0;
 }
 
-// --- High-level NFH Processing Functions Implementation ---
+
+// Decodes output tensor i of a request from the encoded output buffer into the user tensor
+void decode_output_tensor(dxrt::Request* req, dxrt::RequestData* req_data, const dxrt::dxrt_response_t* response, size_t i)
+{
+    using namespace dxrt;
+
+    Tensor& output_tensor = req_data->outputs[i];
+
+    LOG_DXRT_DBG << "output_tensor[" << i << "] name: " << output_tensor.name() << std::endl;
+    LOG_DXRT_DBG << "output_tensor[" << i << "] memory_type: " << output_tensor.memory_type() << std::endl;
+    LOG_DXRT_DBG << "output_tensor[" << i << "] data(): " << output_tensor.data() << std::endl;
+    LOG_DXRT_DBG << "output_tensor[" << i << "] size_in_bytes: " << output_tensor.size_in_bytes() << std::endl;
+    LOG_DXRT_DBG << "encoded_output_ptrs.size(): " << req_data->encoded_output_ptrs.size() << std::endl;
+    if (i < req_data->encoded_output_ptrs.size()) {
+        LOG_DXRT_DBG << "encoded_output_ptrs[" << i << "]: " << (void*)req_data->encoded_output_ptrs[i] << std::endl;
+    }
+
+    if (output_tensor.memory_type() == static_cast<int>(deepx_rmapinfo::MemoryType::ARGMAX))
+    {
+        LOG_DXRT_DBG << "Processing ARGMAX tensor: " << output_tensor.name() << std::endl;
+        if (output_tensor.data() == nullptr) {
+            LOG_DXRT_ERR("ARGMAX output tensor data is nullptr for tensor: " << output_tensor.name());
+            return;
+        }
+        LOG_DXRT_DBG << "Writing argmax value " << response->argmax << " to output_tensor.data(): " << output_tensor.data() << std::endl;
+        *(static_cast<uint16_t *>(output_tensor.data())) = response->argmax;
+
+        // ARGMAX tensors don't use encoded_output_ptrs, so we skip that write
+        LOG_DXRT_DBG << "ARGMAX tensor written successfully" << std::endl;
+        if (DEBUG_DATA > 0)
+        {
+            DataDumpBin(req->taskData()->name() + "_output.argmax.bin", output_tensor.data(), static_cast<unsigned int>(output_tensor.size_in_bytes()));
+        }
+        return;
+    }
+
+    deepx_rmapinfo::TensorInfo tensor_info = req_data->taskData->_npuOutputTensorInfos[i];
+    int shape_dims = tensor_info.shape_encoded().size();
+
+    // Validate array bounds first
+    if (i >= req_data->encoded_output_ptrs.size()) {
+        LOG_DXRT_ERR("Encoded output pointer index out of bounds for tensor: " << output_tensor.name());
+        return;
+    }
+
+    Bytes encoded_output = {static_cast<uint32_t>(req_data->taskData->_encodedOutputSizes[i]), static_cast<uint8_t*>(req_data->encoded_output_ptrs[i])};
+    Bytes decoded_output = {static_cast<uint32_t>(output_tensor.size_in_bytes()), static_cast<uint8_t*>(output_tensor.data())};
+
+    // Validate pointers before processing
+    if (encoded_output.data == nullptr) {
+        LOG_DXRT_ERR("Encoded output pointer is nullptr for tensor: " << output_tensor.name());
+        return;
+    }
+    if (decoded_output.data == nullptr) {
+        LOG_DXRT_ERR("Decoded output pointer is nullptr for tensor: " << output_tensor.name());
+        return;
+    }
+
+    if (tensor_info.layout() == deepx_rmapinfo::Layout::ALIGNED)
+    {
+        if (tensor_info.transpose() == deepx_rmapinfo::Transpose::TRANSPOSE_NONE)
+        {
+            NpuFormatHandler::decode_aligned(encoded_output, decoded_output, tensor_info.shape_encoded()[shape_dims - 1], static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()), tensor_info.align_unit());
+        }
+        else if (tensor_info.transpose() == deepx_rmapinfo::Transpose::CHANNEL_LAST_TO_FIRST)
+        {
+            const auto dtype = static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded());
+            int col = tensor_info.shape_encoded()[shape_dims - 1];
+            if (NpuFormatHandler::is_aligned_transposed_exact(col, dtype, tensor_info.align_unit()))
+            {
+                // Fused strip + transpose: one pass from the NPU buffer into the user tensor
+                NpuFormatHandler::decode_aligned_transposed(
+                    encoded_output, decoded_output, col, dtype,
+                    tensor_info.shape_encoded(), tensor_info.transpose(), tensor_info.align_unit());
+            }
+            else
+            {
+                NpuFormatHandler::decode_aligned(encoded_output, decoded_output, col, dtype, tensor_info.align_unit());
+                int row = 1;
+                for (int j = 0; j < shape_dims - 1; j++) row *= tensor_info.shape_encoded()[j];
+                NpuFormatHandler::bidirectional_transpose(decoded_output.data, decoded_output.data, row, col,
+                                                          dxrt::GetDataSize_rmapinfo_datatype(dtype));
+            }
+        }
+        else
+        {
+            parallel_memcpy(decoded_output.data, encoded_output.data, encoded_output.size);
+        }
+    }
+    else
+    {
+        parallel_memcpy(decoded_output.data, encoded_output.data, encoded_output.size);
+    }
+}
+}  // namespace
 
 
 int NpuFormatHandler::EncodeInputs(void* reqDataPtr, int threadIdForProfiling)
@@ -888,150 +1059,37 @@ int NpuFormatHandler::EncodeInputs(void* reqDataPtr, int threadIdForProfiling)
             DataDumpBin(reqData->taskData->name() + "_encoder_input.bin", reqData->inputs);
         }
 
+        // Zero-copy: the user block already is the encoded block, DMA it directly
+        reqData->dma_input_ptr = nullptr;
+        if (reqData->taskData->can_zero_copy(reqData->inputs))
+        {
+            reqData->dma_input_ptr = reqData->inputs[0].data();
+            return 0;
+        }
+
 #ifdef USE_PROFILER
         auto& profiler = dxrt::Profiler::GetInstance();
-        std::string profile_name = "NPU Input Format Handler[Job_" + std::to_string(reqData->jobId) +
-                                   "][" + reqData->taskData->name() +
-                                   "][Req_" + std::to_string(reqData->requestId) + "]" +
-                                   (threadIdForProfiling >= 0 ? "(" + std::to_string(threadIdForProfiling) + ")" : "");
-        profiler.Start(profile_name);
+        dxrt::ProfilerClock::time_point profile_start;
+        if (profiler.IsEnabled()) profile_start = dxrt::ProfilerClock::now();
 #endif
 
-        for (size_t i = 0; i < input_count; i++)
-        {
-            if (reqData->encoded_input_ptrs.size() <= i || reqData->encoded_input_ptrs[i] == nullptr)
-            {
-                LOG_DXRT_ERR("EncodeInputs: encoded_input_ptrs[" << i << "] is nullptr or out of range");
-                return -1;
-            }
-
-            Tensor& input_tensor = reqData->inputs[i];
-            deepx_rmapinfo::TensorInfo tensor_info = reqData->taskData->_npuInputTensorInfos[i];
-            int shape_dims = tensor_info.shape_encoded().size();
-
-            Bytes original_input = {
-                static_cast<uint32_t>(input_tensor.size_in_bytes()),
-                static_cast<uint8_t*>(input_tensor.data())
-            };
-            Bytes encoded_input = {
-                static_cast<uint32_t>(reqData->taskData->_encodedInputSizes[i]),
-                static_cast<uint8_t*>(reqData->encoded_input_ptrs[i])
-            };
-
-            if (original_input.data == nullptr || encoded_input.data == nullptr)
+        // Tensors are independent: spread them over the NFH worker pool when they are large enough
+        std::atomic<int> result{0};
+        auto& pool = dxrt::NfhWorkerPool::GetInstance();
+        size_t grain = pool.GrainFor(input_count, reqData->taskData->_encodedInputSize / input_count);
+        pool.ParallelFor(input_count, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
             {
-                LOG_DXRT_ERR("EncodeInputs: null data pointer at input " << i);
-                return -1;
+                if (encode_input_tensor(reqData, i) != 0) result.store(-1);
             }
-
-            if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::PRE_FORMATTER)
-            {
-                NpuFormatHandler::encode_preformatter(original_input, encoded_input, tensor_info.align_unit());
-            }
-            else if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::PRE_IM2COL)
-            {
-                NpuFormatHandler::encode_preim2col(
-                    original_input, encoded_input,
-                    tensor_info.shape_encoded()[shape_dims - 2],
-                    tensor_info.shape_encoded()[shape_dims - 1],
-                    tensor_info.align_unit()
-                );
-            }
-            else if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::FORMATTED)
-            {
-                if (tensor_info.transpose() == deepx_rmapinfo::Transpose::TRANSPOSE_NONE)
-                {
-                    NpuFormatHandler::encode_formatted(
-                        original_input, encoded_input,
-                        tensor_info.shape_encoded()[shape_dims - 1],
-                        tensor_info.align_unit()
-                    );
-                }
-                else if (tensor_info.transpose() == deepx_rmapinfo::Transpose::CHANNEL_FIRST_TO_LAST)
-                {
-                    NpuFormatHandler::encode_formatted(
-                        original_input, encoded_input,
-                        tensor_info.shape_encoded()[shape_dims - 1],
-                        tensor_info.align_unit()
-                    );
-
-                    Bytes temp_input = {original_input.size, encoded_input.data};
-                    int row = tensor_info.shape_encoded()[shape_dims - 1];
-                    int col = 1;
-                    for (int j = 0; j < shape_dims - 1; j++) col *= tensor_info.shape_encoded()[j];
-                    int elem_size = dxrt::GetDataSize_rmapinfo_datatype(static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()));
-                    NpuFormatHandler::bidirectional_transpose(temp_input.data, encoded_input.data, row, col, elem_size);
-                }
-                else
-                {
-                    memcpy(static_cast<void*>(encoded_input.data), static_cast<const void*>(original_input.data), original_input.size);
-                }
-            }
-            else if (static_cast<deepx_rmapinfo::Layout>(tensor_info.layout()) == deepx_rmapinfo::Layout::ALIGNED)
-            {
-                // Handle ALIGNED layout with transpose options
-                if (tensor_info.transpose() == deepx_rmapinfo::Transpose::TRANSPOSE_NONE)
-                {
-                    // Use encode function with channel parameter (same as decode_aligned uses)
-                    int channel = tensor_info.shape_encoded()[shape_dims - 1];
-                    int unit = tensor_info.align_unit(); // Use align_unit from tensor info
-                    int col = channel; // Number of columns in elements
-
-                    // Scale unit and col to bytes for FLOAT32 if needed
-                    if (static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()) == deepx_rmapinfo::DataType::FLOAT32) {
-                        // Scale unit and col to bytes for the underlying encode function
-                        unit *= 4;
-                        col *= 4;
-                    }
-
-                    NpuFormatHandler::encode(original_input, encoded_input, col, unit);
-                }
-                else if (tensor_info.transpose() == deepx_rmapinfo::Transpose::CHANNEL_FIRST_TO_LAST)
-                {
-                    // First apply transpose, then encode with aligned format
-                    int row = tensor_info.shape_encoded()[shape_dims - 1];
-                    int transpose_col = 1;
-                    for (int j = 0; j < shape_dims - 1; j++)
-                    {
-                        transpose_col *= tensor_info.shape_encoded()[j];
-                    }
-                    int elem_size = dxrt::GetDataSize_rmapinfo_datatype(static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()));
-
-                    // Apply transpose first (from original_input to encoded_input buffer)
-                    NpuFormatHandler::bidirectional_transpose(original_input.data, encoded_input.data, row, transpose_col, elem_size);
-
-                    // Then encode with aligned format (in-place on encoded_input buffer)
-                    Bytes temp_transposed = {original_input.size, encoded_input.data};
-                    int channel = tensor_info.shape_encoded()[shape_dims - 1];
-                    int unit = tensor_info.align_unit(); // Use align_unit from tensor info
-                    int col = channel; // Number of columns in elements
-
-                    // Scale unit and col to bytes for FLOAT32 if needed
-                    if (static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()) == deepx_rmapinfo::DataType::FLOAT32) {
-                        // Scale unit and col to bytes for the underlying encode function
-                        unit *= 4;
-                        col *= 4;
-                    }
-
-                    NpuFormatHandler::encode(temp_transposed, encoded_input, col, unit);
-                }
-                else
-                {
-                    LOG_DXRT_ERR("Invalid transpose type for ALIGNED layout");
-                    memcpy(static_cast<void*>(encoded_input.data),
-                            static_cast<const void*>(original_input.data),
-                            original_input.size);
-                }
-            }
-            else
-            {
-                memcpy(static_cast<void*>(encoded_input.data), static_cast<const void*>(original_input.data), original_input.size);
-            }
-        }
+        });
 
 #ifdef USE_PROFILER
-        profiler.End(profile_name);
+        profiler.Record(dxrt::PROFILER_EVENT_NPU_INPUT_FORMAT, profile_start, dxrt::ProfilerClock::now(),
+            dxrt::ProfilerArgs{reqData->jobId, reqData->requestId, threadIdForProfiling,
+                reqData->taskData->profiler_name_id()});
 #endif
+        if (result.load() != 0) return -1;
     }
     else
     {
@@ -1063,93 +1121,25 @@ int NpuFormatHandler::DecodeOutputs(const void* reqPtr, const void* responsePtr,
         {
 #ifdef USE_PROFILER
             auto& profiler = dxrt::Profiler::GetInstance();
-            std::string profile_name = "NPU Output Format Handler[Job_" + std::to_string(req->job_id()) +
-                                       "][" + req->taskData()->name() +
-                                       "][Req_" + std::to_string(req->id()) + "]" +
-                                       (threadIdForProfiling >= 0 ? "(" + std::to_string(threadIdForProfiling) + ")" : "");
-            profiler.Start(profile_name);
+            dxrt::ProfilerClock::time_point profile_start;
+            if (profiler.IsEnabled()) profile_start = dxrt::ProfilerClock::now();
 #endif
-            for (size_t i = 0; i < req_data->outputs.size(); i++)
+            // Output tensors are independent: spread them over the NFH worker pool when they are large enough
+            size_t output_count = req_data->outputs.size();
+            if (output_count > 0)
             {
-                Tensor& output_tensor = req_data->outputs[i];
-
-                LOG_DXRT_DBG << "output_tensor[" << i << "] name: " << output_tensor.name() << std::endl;
-                LOG_DXRT_DBG << "output_tensor[" << i << "] memory_type: " << output_tensor.memory_type() << std::endl;
-                LOG_DXRT_DBG << "output_tensor[" << i << "] data(): " << output_tensor.data() << std::endl;
-                LOG_DXRT_DBG << "output_tensor[" << i << "] size_in_bytes: " << output_tensor.size_in_bytes() << std::endl;
-                LOG_DXRT_DBG << "encoded_output_ptrs.size(): " << req_data->encoded_output_ptrs.size() << std::endl;
-                if (i < req_data->encoded_output_ptrs.size()) {
-                    LOG_DXRT_DBG << "encoded_output_ptrs[" << i << "]: " << (void*)req_data->encoded_output_ptrs[i] << std::endl;
-                }
-
-                if (output_tensor.memory_type() == static_cast<int>(deepx_rmapinfo::MemoryType::ARGMAX))
-                {
-                    LOG_DXRT_DBG << "Processing ARGMAX tensor: " << output_tensor.name() << std::endl;
-                    if (output_tensor.data() == nullptr) {
-                        LOG_DXRT_ERR("ARGMAX output tensor data is nullptr for tensor: " << output_tensor.name());
-                        continue;
-                    }
-                    LOG_DXRT_DBG << "Writing argmax value " << response->argmax << " to output_tensor.data(): " << output_tensor.data() << std::endl;
-                    *(static_cast<uint16_t *>(output_tensor.data())) = response->argmax;
-
-                    // ARGMAX tensors don't use encoded_output_ptrs, so we skip that write
-                    LOG_DXRT_DBG << "ARGMAX tensor written successfully" << std::endl;
-                    if (DEBUG_DATA > 0)
-                    {
-                        DataDumpBin(req->taskData()->name() + "_output.argmax.bin", output_tensor.data(), static_cast<unsigned int>(output_tensor.size_in_bytes()));
-                    }
-                    continue;
-                }
-
-                deepx_rmapinfo::TensorInfo tensor_info = req_data->taskData->_npuOutputTensorInfos[i];
-                int shape_dims = tensor_info.shape_encoded().size();
-
-                // Validate array bounds first
-                if (i >= req_data->encoded_output_ptrs.size()) {
-                    LOG_DXRT_ERR("Encoded output pointer index out of bounds for tensor: " << output_tensor.name());
-                    continue;
-                }
-
-                Bytes encoded_output = {static_cast<uint32_t>(req_data->taskData->_encodedOutputSizes[i]), static_cast<uint8_t*>(req_data->encoded_output_ptrs[i])};
-                Bytes decoded_output = {static_cast<uint32_t>(output_tensor.size_in_bytes()), static_cast<uint8_t*>(output_tensor.data())};
-
-                // Validate pointers before processing
-                if (encoded_output.data == nullptr) {
-                    LOG_DXRT_ERR("Encoded output pointer is nullptr for tensor: " << output_tensor.name());
-                    continue;
-                }
-                if (decoded_output.data == nullptr) {
-                    LOG_DXRT_ERR("Decoded output pointer is nullptr for tensor: " << output_tensor.name());
-                    continue;
-                }
-
-                if (tensor_info.layout() == deepx_rmapinfo::Layout::ALIGNED)
-                {
-                    if (tensor_info.transpose() == deepx_rmapinfo::Transpose::TRANSPOSE_NONE)
-                    {
-                        NpuFormatHandler::decode_aligned(encoded_output, decoded_output, tensor_info.shape_encoded()[shape_dims - 1], static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()), tensor_info.align_unit());
-                    }
-                    else if (tensor_info.transpose() == deepx_rmapinfo::Transpose::CHANNEL_LAST_TO_FIRST)
-                    {
-                        NpuFormatHandler::decode_aligned(encoded_output, decoded_output, tensor_info.shape_encoded()[shape_dims - 1], static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()), tensor_info.align_unit());
-                        Bytes transposed_output = {encoded_output.size, decoded_output.data};
-                        int col = tensor_info.shape_encoded()[shape_dims - 1];
-                        int row = 1; for (int j = 0; j < shape_dims - 1; j++) row *= tensor_info.shape_encoded()[j];
-                        int elem_size = dxrt::GetDataSize_rmapinfo_datatype(static_cast<deepx_rmapinfo::DataType>(tensor_info.dtype_encoded()));
-                        NpuFormatHandler::bidirectional_transpose(transposed_output.data, decoded_output.data, row, col, elem_size);
-                    }
-                    else
+                auto& pool = dxrt::NfhWorkerPool::GetInstance();
+                size_t grain = pool.GrainFor(output_count, req_data->taskData->_encodedOutputSize / output_count);
+                pool.ParallelFor(output_count, grain, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++)
                     {
-                        memcpy(static_cast<void*>(decoded_output.data), static_cast<const void*>(encoded_output.data), encoded_output.size);
+                        decode_output_tensor(req.get(), req_data, response, i);
                     }
-                }
-                else
-                {
-                    memcpy(static_cast<void*>(decoded_output.data), static_cast<const void*>(encoded_output.data), encoded_output.size);
-                }
+                });
             }
 #ifdef USE_PROFILER
-            profiler.End(profile_name);
+            profiler.Record(dxrt::PROFILER_EVENT_NPU_OUTPUT_FORMAT, profile_start, dxrt::ProfilerClock::now(),
+                dxrt::ProfilerArgs{req->job_id(), req->id(), threadIdForProfiling, req->taskData()->profiler_name_id()});
 #endif
         }
         else
@@ -0,0 +1,761 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "dxrt/npu_format_kernels.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "dxrt/common.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define DXRT_NFH_X86 1
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define DXRT_NFH_TARGET_AVX2
+        #define DXRT_NFH_TARGET_AVX512
+    #else
+        #define DXRT_NFH_TARGET_AVX2 __attribute__((target("avx2")))
+        #define DXRT_NFH_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define DXRT_NFH_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace npu_format_handler {
+namespace kernels {
+
+using RowCopyFn = void (*)(uint8_t*, size_t, const uint8_t*, size_t, size_t, size_t, size_t);
+
+// --- Scalar (reference) kernel ---
+static void copy_rows_scalar(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                             size_t rows, size_t copy_bytes, size_t pad_bytes)
+{
+    for (size_t r = 0; r < rows; ++r) {
+        memcpy(dst, src, copy_bytes);
+        if (pad_bytes > 0) {
+            memset(dst + copy_bytes, 0, pad_bytes);
+        }
+        dst += dst_stride;
+        src += src_stride;
+    }
+}
+
+#ifdef DXRT_NFH_X86
+// --- AVX2 kernel: 32-byte unaligned loads/stores, overlapping vector for the row tail ---
+DXRT_NFH_TARGET_AVX2
+static inline void copy_span_avx2(uint8_t* dst, const uint8_t* src, size_t n)
+{
+    if (n < 32) {
+        memcpy(dst, src, n);
+        return;
+    }
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    }
+    if (i < n) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + n - 32),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + n - 32)));
+    }
+}
+
+DXRT_NFH_TARGET_AVX2
+static inline void zero_span_avx2(uint8_t* dst, size_t n)
+{
+    if (n < 32) {
+        memset(dst, 0, n);
+        return;
+    }
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), zero);
+    }
+    if (i < n) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + n - 32), zero);
+    }
+}
+
+DXRT_NFH_TARGET_AVX2
+static void copy_rows_avx2(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                           size_t rows, size_t copy_bytes, size_t pad_bytes)
+{
+    const size_t row_bytes = copy_bytes + pad_bytes;
+    if (copy_bytes < 32 && row_bytes >= 32) {
+        // Narrow rows (e.g. 3-channel pixels padded to 64): one masked 32-byte vector carries
+        // both the payload and the first padding bytes. The full-width load may only read
+        // bytes that still belong to the source block.
+        alignas(32) uint8_t mask_bytes[32];
+        for (size_t i = 0; i < 32; ++i) {
+            mask_bytes[i] = (i < copy_bytes) ? 0xFF : 0x00;
+        }
+        const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(mask_bytes));
+        const uint8_t* src_end = src + (rows - 1) * src_stride + copy_bytes;
+
+        for (size_t r = 0; r < rows; ++r) {
+            if (src + 32 <= src_end) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_and_si256(v, mask));
+                zero_span_avx2(dst + 32, row_bytes - 32);
+            } else {
+                memcpy(dst, src, copy_bytes);
+                zero_span_avx2(dst + copy_bytes, pad_bytes);
+            }
+            dst += dst_stride;
+            src += src_stride;
+        }
+        return;
+    }
+
+    for (size_t r = 0; r < rows; ++r) {
+        copy_span_avx2(dst, src, copy_bytes);
+        zero_span_avx2(dst + copy_bytes, pad_bytes);
+        dst += dst_stride;
+        src += src_stride;
+    }
+}
+
+// --- AVX-512 kernel: each 64-byte chunk of a row is one masked load (payload) + one masked store
+//     (payload + padding); lanes past the payload load as zero, so padding costs no extra pass ---
+DXRT_NFH_TARGET_AVX512
+static inline __mmask64 lane_mask_avx512(size_t begin, size_t end)
+{
+    if (end <= begin) return 0;
+    size_t n = end - begin;
+    return (n >= 64) ? ~static_cast<__mmask64>(0) : ((static_cast<__mmask64>(1) << n) - 1);
+}
+
+DXRT_NFH_TARGET_AVX512
+static void copy_rows_avx512(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                             size_t rows, size_t copy_bytes, size_t pad_bytes)
+{
+    const size_t row_bytes = copy_bytes + pad_bytes;
+    // Row = [pure payload chunks][one mixed chunk: payload tail + first padding][pure padding chunks]
+    // All masks are the same for every row, so they are computed once.
+    const size_t mixed_begin = copy_bytes - copy_bytes % 64;
+    const size_t mixed_end = (mixed_begin + 64 < row_bytes) ? mixed_begin + 64 : row_bytes;
+    const __mmask64 mixed_load = lane_mask_avx512(mixed_begin, copy_bytes);
+    const __mmask64 mixed_store = lane_mask_avx512(mixed_begin, mixed_end);
+    const size_t zero_bytes = row_bytes - mixed_end;
+    const size_t zero_body = zero_bytes - zero_bytes % 64;
+    const __mmask64 zero_tail = lane_mask_avx512(zero_body, zero_bytes);
+    const __m512i zero = _mm512_setzero_si512();
+
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t i = 0; i < mixed_begin; i += 64) {
+            _mm512_storeu_si512(dst + i, _mm512_loadu_si512(src + i));
+        }
+        if (mixed_store) {
+            __m512i v = _mm512_maskz_loadu_epi8(mixed_load, src + mixed_begin);
+            _mm512_mask_storeu_epi8(dst + mixed_begin, mixed_store, v);
+        }
+        uint8_t* pad = dst + mixed_end;
+        for (size_t i = 0; i < zero_body; i += 64) {
+            _mm512_storeu_si512(pad + i, zero);
+        }
+        if (zero_tail) {
+            _mm512_mask_storeu_epi8(pad + zero_body, zero_tail, zero);
+        }
+        dst += dst_stride;
+        src += src_stride;
+    }
+}
+
+static bool cpu_has_avx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static bool cpu_has_avx512bw()
+{
+#ifdef _MSC_VER
+    if (!cpu_has_avx2()) return false;
+    if ((_xgetbv(0) & 0xE6) != 0xE6) return false;
+    int info[4];
+    __cpuidex(info, 7, 0);
+    bool avx512f = (info[1] & (1 << 16)) != 0;
+    bool avx512bw = (info[1] & (1 << 30)) != 0;
+    return avx512f && avx512bw;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+}
+#endif  // DXRT_NFH_X86
+
+#ifdef DXRT_NFH_NEON
+// --- NEON kernel: 16-byte loads/stores, overlapping vector for the row tail ---
+static inline void copy_span_neon(uint8_t* dst, const uint8_t* src, size_t n)
+{
+    if (n < 16) {
+        memcpy(dst, src, n);
+        return;
+    }
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        vst1q_u8(dst + i, vld1q_u8(src + i));
+    }
+    if (i < n) {
+        vst1q_u8(dst + n - 16, vld1q_u8(src + n - 16));
+    }
+}
+
+static inline void zero_span_neon(uint8_t* dst, size_t n)
+{
+    if (n < 16) {
+        memset(dst, 0, n);
+        return;
+    }
+    const uint8x16_t zero = vdupq_n_u8(0);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        vst1q_u8(dst + i, zero);
+    }
+    if (i < n) {
+        vst1q_u8(dst + n - 16, zero);
+    }
+}
+
+static void copy_rows_neon(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                           size_t rows, size_t copy_bytes, size_t pad_bytes)
+{
+    for (size_t r = 0; r < rows; ++r) {
+        copy_span_neon(dst, src, copy_bytes);
+        zero_span_neon(dst + copy_bytes, pad_bytes);
+        dst += dst_stride;
+        src += src_stride;
+    }
+}
+#endif  // DXRT_NFH_NEON
+
+static Isa detect_isa()
+{
+#if defined(DXRT_NFH_X86)
+    if (cpu_has_avx512bw()) return Isa::AVX512;
+    if (cpu_has_avx2()) return Isa::AVX2;
+    return Isa::SCALAR;
+#elif defined(DXRT_NFH_NEON)
+    return Isa::NEON;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+static Isa select_isa()
+{
+    Isa best = detect_isa();
+    const char* env_value = std::getenv("DXRT_NFH_KERNEL");
+    if (env_value == nullptr) {
+        return best;
+    }
+
+    std::string requested(env_value);
+    Isa isa = best;
+    if (requested == "scalar") isa = Isa::SCALAR;
+    else if (requested == "neon") isa = Isa::NEON;
+    else if (requested == "avx2") isa = Isa::AVX2;
+    else if (requested == "avx512") isa = Isa::AVX512;
+    else {
+        std::cout << "[DXRT] Invalid DXRT_NFH_KERNEL value, using " << isa_name(best) << std::endl;
+        return best;
+    }
+
+    // never go above what the CPU supports (NEON and x86 kernels are mutually exclusive)
+    bool supported = (isa == Isa::SCALAR) || (isa == best) ||
+                     (isa == Isa::AVX2 && best == Isa::AVX512);
+    if (!supported) {
+        std::cout << "[DXRT] DXRT_NFH_KERNEL=" << requested << " is not supported on this CPU, using "
+                  << isa_name(best) << std::endl;
+        return best;
+    }
+    std::cout << "[DXRT] Using DXRT_NFH_KERNEL=" << requested << " from environment" << std::endl;
+    return isa;
+}
+
+static RowCopyFn kernel_for(Isa isa)
+{
+    switch (isa) {
+#ifdef DXRT_NFH_X86
+        case Isa::AVX512: return copy_rows_avx512;
+        case Isa::AVX2: return copy_rows_avx2;
+#endif
+#ifdef DXRT_NFH_NEON
+        case Isa::NEON: return copy_rows_neon;
+#endif
+        default: return copy_rows_scalar;
+    }
+}
+
+Isa active_isa()
+{
+    static const Isa isa = select_isa();
+    return isa;
+}
+
+const char* isa_name(Isa isa)
+{
+    switch (isa) {
+        case Isa::NEON: return "neon";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+void copy_rows(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+               size_t rows, size_t copy_bytes, size_t pad_bytes)
+{
+    static const RowCopyFn kernel = kernel_for(active_isa());
+
+    if (rows == 0) return;
+
+    // dense on both sides: one contiguous block, libc memcpy is already optimal
+    if (pad_bytes == 0 && dst_stride == copy_bytes && src_stride == copy_bytes) {
+        memcpy(dst, src, rows * copy_bytes);
+        return;
+    }
+    kernel(dst, dst_stride, src, src_stride, rows, copy_bytes, pad_bytes);
+}
+
+// ==================== Transpose ====================
+
+// Tile edge in elements. A 64x64 tile of 4-byte elements is 16 KiB, so the source
+// and destination tiles stay in L1 while the micro-kernels walk them.
+static constexpr size_t TRANSPOSE_TILE = 64;
+
+// Register block: one 128-bit vector per row, i.e. (16 / sizeof(T)) x (16 / sizeof(T)) elements.
+template <typename T>
+struct TransposeBlock {
+    static constexpr size_t LANES = 16 / sizeof(T);
+
+    static void scalar(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                       size_t rows, size_t cols)
+    {
+        for (size_t i = 0; i < rows; ++i) {
+            const T* s = reinterpret_cast<const T*>(src + i * src_stride);
+            for (size_t j = 0; j < cols; ++j) {
+                T v;
+                memcpy(&v, s + j, sizeof(T));
+                memcpy(dst + j * dst_stride + i * sizeof(T), &v, sizeof(T));
+            }
+        }
+    }
+
+    // Transposes one LANES x LANES block. All rows are loaded before anything is stored,
+    // so src == dst (a diagonal block of an in-place transpose) is allowed.
+    static void simd(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride);
+};
+
+// The 128-bit block transpose is log2(LANES) rounds of the same "perfect shuffle":
+// out[2i] = interleave_low(in[i], in[i + LANES/2]), out[2i+1] = interleave_high(...).
+#if defined(DXRT_NFH_X86)
+#define DXRT_NFH_TRANSPOSE_SIMD 1
+#define DXRT_NFH_DEFINE_BLOCK(T, LO, HI)                                                     \
+    template <>                                                                             \
+    void TransposeBlock<T>::simd(const uint8_t* src, size_t src_stride,                     \
+                                 uint8_t* dst, size_t dst_stride)                           \
+    {                                                                                       \
+        __m128i a[LANES], b[LANES];                                                         \
+        for (size_t i = 0; i < LANES; ++i)                                                  \
+            a[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * src_stride)); \
+        for (size_t n = LANES; n > 1; n >>= 1) {                                            \
+            for (size_t i = 0; i < LANES / 2; ++i) {                                        \
+                b[2 * i] = LO(a[i], a[i + LANES / 2]);                                      \
+                b[2 * i + 1] = HI(a[i], a[i + LANES / 2]);                                  \
+            }                                                                               \
+            for (size_t i = 0; i < LANES; ++i) a[i] = b[i];                                 \
+        }                                                                                   \
+        for (size_t i = 0; i < LANES; ++i)                                                  \
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * dst_stride), a[i]);       \
+    }
+DXRT_NFH_DEFINE_BLOCK(uint8_t, _mm_unpacklo_epi8, _mm_unpackhi_epi8)
+DXRT_NFH_DEFINE_BLOCK(uint16_t, _mm_unpacklo_epi16, _mm_unpackhi_epi16)
+DXRT_NFH_DEFINE_BLOCK(uint32_t, _mm_unpacklo_epi32, _mm_unpackhi_epi32)
+#undef DXRT_NFH_DEFINE_BLOCK
+#elif defined(DXRT_NFH_NEON)
+#define DXRT_NFH_TRANSPOSE_SIMD 1
+#define DXRT_NFH_DEFINE_BLOCK(T, VT, LD, ST, LO, HI)                                        \
+    template <>                                                                             \
+    void TransposeBlock<T>::simd(const uint8_t* src, size_t src_stride,                     \
+                                 uint8_t* dst, size_t dst_stride)                           \
+    {                                                                                       \
+        VT a[LANES], b[LANES];                                                              \
+        for (size_t i = 0; i < LANES; ++i)                                                  \
+            a[i] = LD(reinterpret_cast<const T*>(src + i * src_stride));                    \
+        for (size_t n = LANES; n > 1; n >>= 1) {                                            \
+            for (size_t i = 0; i < LANES / 2; ++i) {                                        \
+                b[2 * i] = LO(a[i], a[i + LANES / 2]);                                      \
+                b[2 * i + 1] = HI(a[i], a[i + LANES / 2]);                                  \
+            }                                                                               \
+            for (size_t i = 0; i < LANES; ++i) a[i] = b[i];                                 \
+        }                                                                                   \
+        for (size_t i = 0; i < LANES; ++i)                                                  \
+            ST(reinterpret_cast<T*>(dst + i * dst_stride), a[i]);                           \
+    }
+DXRT_NFH_DEFINE_BLOCK(uint8_t, uint8x16_t, vld1q_u8, vst1q_u8, vzip1q_u8, vzip2q_u8)
+DXRT_NFH_DEFINE_BLOCK(uint16_t, uint16x8_t, vld1q_u16, vst1q_u16, vzip1q_u16, vzip2q_u16)
+DXRT_NFH_DEFINE_BLOCK(uint32_t, uint32x4_t, vld1q_u32, vst1q_u32, vzip1q_u32, vzip2q_u32)
+#undef DXRT_NFH_DEFINE_BLOCK
+#endif
+
+// Zero-fills the pad_bytes that follow the payload of destination rows [jb, je).
+static inline void pad_rows(uint8_t* dst, size_t dst_stride, size_t payload, size_t jb, size_t je, size_t pad_bytes)
+{
+    if (pad_bytes == 0) return;
+    for (size_t j = jb; j < je; ++j) {
+        memset(dst + j * dst_stride + payload, 0, pad_bytes);
+    }
+}
+
+// Tiles are walked column-tile major so the padding of a destination row is written
+// right after its last payload element, while the row is still in cache.
+template <typename T>
+static void transpose_tiled(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                            size_t row, size_t col, size_t pad_bytes, bool use_simd)
+{
+    constexpr size_t L = TransposeBlock<T>::LANES;
+
+    for (size_t jb = 0; jb < col; jb += TRANSPOSE_TILE) {
+        const size_t je = (jb + TRANSPOSE_TILE < col) ? jb + TRANSPOSE_TILE : col;
+        for (size_t ib = 0; ib < row; ib += TRANSPOSE_TILE) {
+            const size_t ie = (ib + TRANSPOSE_TILE < row) ? ib + TRANSPOSE_TILE : row;
+            for (size_t i = ib; i < ie; i += L) {
+                const size_t rows = (i + L <= ie) ? L : ie - i;
+                for (size_t j = jb; j < je; j += L) {
+                    const size_t cols = (j + L <= je) ? L : je - j;
+                    const uint8_t* s = src + i * src_stride + j * sizeof(T);
+                    uint8_t* d = dst + j * dst_stride + i * sizeof(T);
+#ifdef DXRT_NFH_TRANSPOSE_SIMD
+                    if (use_simd && rows == L && cols == L) {
+                        TransposeBlock<T>::simd(s, src_stride, d, dst_stride);
+                        continue;
+                    }
+#endif
+                    TransposeBlock<T>::scalar(s, src_stride, d, dst_stride, rows, cols);
+                }
+            }
+        }
+        pad_rows(dst, dst_stride, row * sizeof(T), jb, je, pad_bytes);
+    }
+    (void)use_simd;
+}
+
+// Generic element size (e.g. 8-byte or packed structures): same tiling, memcpy per element.
+static void transpose_tiled_bytes(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                                  size_t row, size_t col, size_t element_size, size_t pad_bytes)
+{
+    for (size_t jb = 0; jb < col; jb += TRANSPOSE_TILE) {
+        const size_t je = (jb + TRANSPOSE_TILE < col) ? jb + TRANSPOSE_TILE : col;
+        for (size_t ib = 0; ib < row; ib += TRANSPOSE_TILE) {
+            const size_t ie = (ib + TRANSPOSE_TILE < row) ? ib + TRANSPOSE_TILE : row;
+            for (size_t i = ib; i < ie; ++i) {
+                for (size_t j = jb; j < je; ++j) {
+                    memcpy(dst + j * dst_stride + i * element_size, src + i * src_stride + j * element_size, element_size);
+                }
+            }
+        }
+        pad_rows(dst, dst_stride, row * element_size, jb, je, pad_bytes);
+    }
+}
+
+void transpose_strided(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                       size_t row, size_t col, size_t element_size, size_t pad_bytes)
+{
+    const bool use_simd = active_isa() != Isa::SCALAR;
+    switch (element_size) {
+        case 1: transpose_tiled<uint8_t>(src, src_stride, dst, dst_stride, row, col, pad_bytes, use_simd); break;
+        case 2: transpose_tiled<uint16_t>(src, src_stride, dst, dst_stride, row, col, pad_bytes, use_simd); break;
+        case 4: transpose_tiled<uint32_t>(src, src_stride, dst, dst_stride, row, col, pad_bytes, use_simd); break;
+        default: transpose_tiled_bytes(src, src_stride, dst, dst_stride, row, col, element_size, pad_bytes); break;
+    }
+}
+
+void transpose(const uint8_t* src, uint8_t* dst, size_t row, size_t col, size_t element_size)
+{
+    if (row == 1 || col == 1) {
+        // a vector is its own transpose in row-major order
+        memcpy(dst, src, row * col * element_size);
+        return;
+    }
+    transpose_strided(src, col * element_size, dst, row * element_size, row, col, element_size, 0);
+}
+
+// Square in-place: diagonal register blocks are transposed in place, mirrored off-diagonal
+// blocks (A at [i][j], B at [j][i]) are exchanged through a stack scratch block.
+template <typename T>
+static void transpose_square_inplace(uint8_t* data, size_t n, bool use_simd)
+{
+    constexpr size_t L = TransposeBlock<T>::LANES;
+    const size_t stride = n * sizeof(T);
+    const size_t full = n - n % L;
+    alignas(16) uint8_t scratch[L * L * sizeof(T)];
+    const size_t scratch_stride = L * sizeof(T);
+
+    for (size_t ib = 0; ib < full; ib += TRANSPOSE_TILE) {
+        const size_t ie = (ib + TRANSPOSE_TILE < full) ? ib + TRANSPOSE_TILE : full;
+        for (size_t jb = ib; jb < full; jb += TRANSPOSE_TILE) {
+            const size_t je = (jb + TRANSPOSE_TILE < full) ? jb + TRANSPOSE_TILE : full;
+            for (size_t i = ib; i < ie; i += L) {
+                for (size_t j = (jb == ib) ? i : jb; j < je; j += L) {
+                    uint8_t* a = data + i * stride + j * sizeof(T);
+                    uint8_t* b = data + j * stride + i * sizeof(T);
+#ifdef DXRT_NFH_TRANSPOSE_SIMD
+                    if (use_simd) {
+                        if (i == j) {
+                            TransposeBlock<T>::simd(a, stride, a, stride);
+                            continue;
+                        }
+                        TransposeBlock<T>::simd(a, stride, scratch, scratch_stride);
+                        TransposeBlock<T>::simd(b, stride, a, stride);
+                        for (size_t r = 0; r < L; ++r) {
+                            memcpy(b + r * stride, scratch + r * scratch_stride, scratch_stride);
+                        }
+                        continue;
+                    }
+#endif
+                    if (i == j) {
+                        TransposeBlock<T>::scalar(a, stride, scratch, scratch_stride, L, L);
+                    } else {
+                        TransposeBlock<T>::scalar(a, stride, scratch, scratch_stride, L, L);
+                        TransposeBlock<T>::scalar(b, stride, a, stride, L, L);
+                        a = b;
+                    }
+                    for (size_t r = 0; r < L; ++r) {
+                        memcpy(a + r * stride, scratch + r * scratch_stride, scratch_stride);
+                    }
+                }
+            }
+        }
+    }
+
+    // ragged border (last n % L rows/columns): plain element swaps
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = (i < full) ? full : i + 1; j < n; ++j) {
+            T* p = reinterpret_cast<T*>(data + i * stride) + j;
+            T* q = reinterpret_cast<T*>(data + j * stride) + i;
+            T tmp;
+            memcpy(&tmp, p, sizeof(T));
+            memcpy(p, q, sizeof(T));
+            memcpy(q, &tmp, sizeof(T));
+        }
+    }
+    (void)use_simd;
+}
+
+static void transpose_square_inplace_bytes(uint8_t* data, size_t n, size_t element_size)
+{
+    uint8_t tmp[64];
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            uint8_t* p = data + (i * n + j) * element_size;
+            uint8_t* q = data + (j * n + i) * element_size;
+            for (size_t off = 0; off < element_size; off += sizeof(tmp)) {
+                size_t len = (element_size - off < sizeof(tmp)) ? element_size - off : sizeof(tmp);
+                memcpy(tmp, p + off, len);
+                memcpy(p + off, q + off, len);
+                memcpy(q + off, tmp, len);
+            }
+        }
+    }
+}
+
+// Rectangular in-place transpose, decomposed into three passes that each permute only
+// within a column or only within a row (Catanzaro et al., "A Decomposition for In-place
+// Matrix Transposition"). On an M x N grid with g = gcd(M, N), b = N / g, the element at
+// (i, j) ends at (r', c') where r' * N + c' = j * M + i:
+//   1. column rotation (g > 1 only): (i, j) -> ((i + j / b) % M, j)
+//   2. row shuffle:                  (f, j) -> (f, (j * M + i) % N)
+//   3. column shuffle:               (f, c') -> (r', c')
+// Running the inverse passes in reverse order on the same grid transposes an N x M matrix,
+// which keeps the grid wide (M <= N) for both directions. Row passes are sequential;
+// column passes run on blocks of N / M columns so that every gathered source row
+// contributes a contiguous run. Scratch is N elements, never a full copy of the matrix.
+
+// Writes a (rows x w) scratch block back into columns [c0, c0 + w) of a row-major matrix.
+template <typename T>
+static inline void store_block(T* A, size_t N, size_t c0, const T* block, size_t rows, size_t w)
+{
+    if (w == 1) {
+        for (size_t r = 0; r < rows; ++r) A[r * N + c0] = block[r];
+        return;
+    }
+    for (size_t r = 0; r < rows; ++r) {
+        memcpy(&A[r * N + c0], &block[r * w], w * sizeof(T));
+    }
+}
+
+template <typename T>
+static void c2r_rotate(T* A, T* tmp, size_t M, size_t N, size_t b, size_t W, bool inverse)
+{
+    for (size_t c0 = 0; c0 < N; c0 += W) {
+        const size_t w = (c0 + W <= N) ? W : N - c0;
+        for (size_t f = 0; f < M; ++f) {
+            size_t q = c0 / b;
+            size_t t = c0 % b;
+            for (size_t k = 0; k < w; ++k) {
+                const size_t src = (f >= q) ? f - q : f + M - q;
+                if (inverse) tmp[src * w + k] = A[f * N + c0 + k];
+                else         tmp[f * w + k] = A[src * N + c0 + k];
+                if (++t == b) { t = 0; ++q; }
+            }
+        }
+        store_block(A, N, c0, tmp, M, w);
+    }
+}
+
+template <typename T>
+static void c2r_row_shuffle(T* A, T* tmp, size_t M, size_t N, size_t g, size_t b, bool inverse)
+{
+    const size_t m_mod_n = M % N;
+    for (size_t f = 0; f < M; ++f) {
+        T* row = A + f * N;
+        size_t jr = 0;  // (j * M) % N
+        size_t j = 0;
+        for (size_t q = 0; q < g; ++q) {
+            const size_t i_mod_n = ((f >= q) ? f - q : f + M - q) % N;
+            for (size_t t = 0; t < b; ++t, ++j) {
+                size_t dst = jr + i_mod_n;
+                if (dst >= N) dst -= N;
+                if (inverse) tmp[j] = row[dst];
+                else         tmp[dst] = row[j];
+                jr += m_mod_n;
+                if (jr >= N) jr -= N;
+            }
+        }
+        memcpy(row, tmp, N * sizeof(T));
+    }
+}
+
+template <typename T>
+static void c2r_column_shuffle(T* A, T* tmp, size_t M, size_t N, size_t b, size_t W, bool inverse)
+{
+    const size_t n_mod_m = N % M;
+    const size_t n_div_m = N / M;
+    for (size_t c0 = 0; c0 < N; c0 += W) {
+        const size_t w = (c0 + W <= N) ? W : N - c0;
+        // (i0, j0) = source coordinate of (r, c0), advanced by N positions per row
+        size_t i0 = c0 % M;
+        size_t j0 = c0 / M;
+        for (size_t r = 0; r < M; ++r) {
+            size_t i = i0;
+            size_t q = j0 / b;
+            size_t t = j0 % b;
+            for (size_t k = 0; k < w; ++k) {
+                size_t src = i + q;
+                if (src >= M) src -= M;
+                if (inverse) tmp[src * w + k] = A[r * N + c0 + k];
+                else         tmp[r * w + k] = A[src * N + c0 + k];
+                if (++i == M) {
+                    i = 0;
+                    if (++t == b) { t = 0; ++q; }
+                }
+            }
+            i0 += n_mod_m;
+            j0 += n_div_m;
+            if (i0 >= M) { i0 -= M; ++j0; }
+        }
+        store_block(A, N, c0, tmp, M, w);
+    }
+}
+
+template <typename T>
+static int transpose_rect_inplace(uint8_t* data, size_t row, size_t col)
+{
+    const bool inverse = row > col;
+    const size_t M = inverse ? col : row;
+    const size_t N = inverse ? row : col;
+    size_t g = M, rem = N;
+    while (rem != 0) { size_t t = g % rem; g = rem; rem = t; }
+    const size_t b = N / g;
+    const size_t W = N / M;  // columns per block: W * M <= N
+
+    std::vector<T> scratch;
+    try {
+        scratch.resize(N);
+    } catch (const std::bad_alloc&) {
+        return -1;
+    }
+    T* A = reinterpret_cast<T*>(data);
+    T* tmp = scratch.data();
+
+    if (!inverse) {
+        if (g > 1) c2r_rotate(A, tmp, M, N, b, W, false);
+        c2r_row_shuffle(A, tmp, M, N, g, b, false);
+        c2r_column_shuffle(A, tmp, M, N, b, W, false);
+    } else {
+        c2r_column_shuffle(A, tmp, M, N, b, W, true);
+        c2r_row_shuffle(A, tmp, M, N, g, b, true);
+        if (g > 1) c2r_rotate(A, tmp, M, N, b, W, true);
+    }
+    return 0;
+}
+
+template <size_t N>
+struct ElementBytes {
+    uint8_t b[N];
+};
+
+int transpose_inplace(uint8_t* data, size_t row, size_t col, size_t element_size)
+{
+    const bool use_simd = active_isa() != Isa::SCALAR;
+    if (row == 1 || col == 1) {
+        return 0;
+    }
+    if (row == col) {
+        switch (element_size) {
+            case 1: transpose_square_inplace<uint8_t>(data, row, use_simd); break;
+            case 2: transpose_square_inplace<uint16_t>(data, row, use_simd); break;
+            case 4: transpose_square_inplace<uint32_t>(data, row, use_simd); break;
+            default: transpose_square_inplace_bytes(data, row, element_size); break;
+        }
+        return 0;
+    }
+    switch (element_size) {
+        case 1: return transpose_rect_inplace<uint8_t>(data, row, col);
+        case 2: return transpose_rect_inplace<uint16_t>(data, row, col);
+        case 4: return transpose_rect_inplace<uint32_t>(data, row, col);
+        case 8: return transpose_rect_inplace<uint64_t>(data, row, col);
+        case 3: return transpose_rect_inplace<ElementBytes<3>>(data, row, col);
+        default: break;
+    }
+
+    // Uncommon element size: transpose out of place through a temporary copy
+    uint8_t* temp_buffer = new (std::nothrow) uint8_t[row * col * element_size];
+    if (temp_buffer == nullptr) {
+        return -1;
+    }
+    transpose_tiled_bytes(data, col * element_size, temp_buffer, row * element_size, row, col, element_size, 0);
+    memcpy(data, temp_buffer, row * col * element_size);
+    delete[] temp_buffer;
+    return 0;
+}
+
+}  // namespace kernels
+}  // namespace npu_format_handler
@@ -7,8 +7,11 @@
  * Unauthorized sharing or usage is strictly prohibited by law.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <mutex>
 #include <iostream>
@@ -21,45 +24,30 @@ using std::endl;
 
 namespace dxrt {
 
-TaskNpuMemoryCacheManager::TaskNpuMemoryCacheManager(int64_t size, int count, int64_t offset)
-{
-
-    LOG_DXRT_DBG << "init: " << offset << " is inited" << endl;
-    _npuMemoryCacheOffset = offset;
-    for (int i = 0; i < count; i++)
-    {
-        _npuMemoryCaches.push_back(offset + size * i);
-        LOG_DXRT_DBG << " init: " << _npuMemoryCaches.back() << " is pushed" << endl;
-    }
+constexpr int64_t NpuMemoryCacheManager::SLAB_ALIGN;
+constexpr int NpuMemoryCacheManager::SLAB_CLASS_STEPS;
+constexpr int NpuMemoryCacheManager::SLAB_CLASS_CAPACITY;
+constexpr int64_t NpuMemoryCacheManager::BORROW_RATIO;
+constexpr int NpuMemoryCacheManager::WAIT_POLL_MS;
 
-
-}
-TaskNpuMemoryCacheManager::~TaskNpuMemoryCacheManager()
+static int highestBit(uint64_t v)
 {
-    _cv.notify_all();
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(v);
+#else
+    int bit = 0;
+    while (v >>= 1) bit++;
+    return bit;
+#endif
 }
 
-int64_t TaskNpuMemoryCacheManager::getOffset()
-{
-    return _npuMemoryCacheOffset;
-}
-void TaskNpuMemoryCacheManager::returnNpuMemoryCache(int64_t addr)
+template <typename T>
+static void raiseTo(std::atomic<T>& highWater, T value)
 {
-    std::unique_lock<std::mutex> lock(_lock);
-    _npuMemoryCaches.push_back(addr);
-    _cv.notify_one();
-}
-int64_t TaskNpuMemoryCacheManager::getNpuMemoryCache()
-{
-    std::unique_lock<std::mutex> lock(_lock);
-    _cv.wait(lock, [this] {
-        return _npuMemoryCaches.empty() == false;
-    });
-
-
-    int64_t retval = _npuMemoryCaches.back();
-    _npuMemoryCaches.pop_back();
-    return retval;
+    T prev = highWater.load(std::memory_order_relaxed);
+    while (value > prev && !highWater.compare_exchange_weak(prev, value, std::memory_order_relaxed))
+    {
+    }
 }
 
 NpuMemoryCacheManager::NpuMemoryCacheManager(DeviceTaskLayer* device_)
@@ -67,26 +55,97 @@ NpuMemoryCacheManager::NpuMemoryCacheManager(DeviceTaskLayer* device_)
 {
 }
 
+int64_t NpuMemoryCacheManager::slabSize(int64_t size)
+{
+    int64_t aligned = (std::max<int64_t>(size, 1) + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1);
+    int power = highestBit(static_cast<uint64_t>(aligned));
+    int64_t step = static_cast<int64_t>(1) << (power - highestBit(SLAB_CLASS_STEPS));
+    if (step <= SLAB_ALIGN)
+    {
+        return aligned;
+    }
+    return (aligned + step - 1) & ~(step - 1);
+}
 
 bool NpuMemoryCacheManager::registerMemoryCache(int taskId, int64_t size, int count)
 {
-    UniqueLock lock(_npuMemoryCacheLock);
+    if (count < 1)
+    {
+        return false;
+    }
+    {
+        SharedLock lock(_npuMemoryCacheLock);
+        if (_taskNpuMemoryCaches.find(taskId) != _taskNpuMemoryCaches.end())
+        {
+            return true;
+        }
+    }
 
+    int64_t slab = slabSize(size);
+    SlabClass* slabClass = nullptr;
+    bool grow = false;
+    {
+        std::lock_guard<std::mutex> slabLock(_slabLock);
+        auto& entry = _slabClasses[slab];
+        if (!entry)
+        {
+            entry.reset(new SlabClass(slab));
+        }
+        slabClass = entry.get();
+        // one slab per registered task stays allocated, so every task can always make progress
+        if (slabClass->slabs.load() <= slabClass->tasks.load())
+        {
+            if (slabClass->slabs.load() >= SLAB_CLASS_CAPACITY)
+            {
+                return false;
+            }
+            slabClass->slabs.fetch_add(1);
+            grow = true;
+        }
+        slabClass->tasks.fetch_add(1);
+    }
 
-    int64_t offset = _device->Allocate(size * count);
+    // the allocation may wait for device memory, so no lock is held that other tasks need for
+    // getting or returning their regions
+    if (grow)
+    {
+        int64_t addr = allocateSlab(slab, true);
+        if (addr == -1)
+        {
+            std::lock_guard<std::mutex> slabLock(_slabLock);
+            slabClass->tasks.fetch_sub(1);
+            slabClass->slabs.fetch_sub(1);
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> slabLock(_slabLock);
+            _slabOwners[addr] = slabClass;
+        }
+        addReserved(slab);
+        slabClass->idle.TryPush(addr);
+        wakeWaiters();
+    }
 
-    if (offset != -1)
+    bool registered = false;
     {
-        LOG_DXRT_DBG << "init: " << offset << " is inited" << endl;
-        _taskNpuMemoryCaches.emplace(taskId,
-            std::make_shared<TaskNpuMemoryCacheManager>(size, count, offset));
-        return true;
+        UniqueLock lock(_npuMemoryCacheLock);
+        registered = _taskNpuMemoryCaches.emplace(taskId, std::make_shared<TaskCache>(slabClass, count)).second;
     }
-    else
+    if (!registered)
     {
-        return false;
+        // registered by another thread meanwhile, whose reserve is enough for the task
+        {
+            std::lock_guard<std::mutex> slabLock(_slabLock);
+            slabClass->tasks.fetch_sub(1);
+        }
+        releaseIdle(slabClass);
+        return true;
     }
+    LOG_DXRT_DBG << "task " << taskId << ": up to " << count << " regions of " << size
+                 << " bytes in " << slab << " bytes slabs" << endl;
+    return true;
 }
+
 void NpuMemoryCacheManager::unRegisterMemoryCache(int taskId)
 {
     UniqueLock lock(_npuMemoryCacheLock);
@@ -96,36 +155,299 @@ void NpuMemoryCacheManager::unRegisterMemoryCache(int taskId)
     {
         return;
     }
-    _device->Deallocate(it->second->getOffset());
+    SlabClass* slabClass = it->second->slabClass;
     _taskNpuMemoryCaches.erase(it);
+    {
+        std::lock_guard<std::mutex> slabLock(_slabLock);
+        slabClass->tasks.fetch_sub(1);
+    }
+    // the slabs other tasks of the class still reserve stay cached for them
+    releaseIdle(slabClass);
+
+    LOG_DXRT_DBG << "task " << taskId << " released, cache holds " << _reservedBytes.load()
+                 << " bytes (high water " << _reservedHighWater.load() << " bytes, "
+                 << _borrowedTotal.load() << " borrowed, " << _trimmedTotal.load() << " trimmed)" << endl;
 }
+
 bool NpuMemoryCacheManager::canGetCache(int taskId)
 {
     SharedLock lock(_npuMemoryCacheLock);
 
     return _taskNpuMemoryCaches.find(taskId) != _taskNpuMemoryCaches.end();
 }
-int64_t NpuMemoryCacheManager::getNpuMemoryCache(int taskId)
+
+std::shared_ptr<NpuMemoryCacheManager::TaskCache> NpuMemoryCacheManager::findTask(int taskId)
 {
     SharedLock lock(_npuMemoryCacheLock);
     auto it = _taskNpuMemoryCaches.find(taskId);
-    if (it != _taskNpuMemoryCaches.end())
+    if (it == _taskNpuMemoryCaches.end())
     {
-        auto manager =  it->second;
-        lock.unlock();
-        return manager->getNpuMemoryCache();
+        return nullptr;
     }
-    return -1;
+    return it->second;
+}
+
+int64_t NpuMemoryCacheManager::getNpuMemoryCache(int taskId)
+{
+    auto task = findTask(taskId);
+    if (task == nullptr)
+    {
+        return -1;
+    }
+    bool acquired = tryAcquire(*task);
+    int64_t addr = -1;
+    if (acquired && task->slabClass->idle.TryPop(addr))
+    {
+        return handOut(*task->slabClass, addr);
+    }
+    return getSlow(*task, acquired);
 }
+
 void NpuMemoryCacheManager::returnNpuMemoryCache(int taskId, int64_t addr)
 {
-    SharedLock lock(_npuMemoryCacheLock);
-    auto it = _taskNpuMemoryCaches.find(taskId);
-    if (it != _taskNpuMemoryCaches.end())
+    auto task = findTask(taskId);
+    SlabClass* slabClass = task ? task->slabClass : nullptr;
+    if (_borrowedCount.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> lock(_slabLock);
+        auto it = _borrowed.find(addr);
+        if (it != _borrowed.end())
+        {
+            slabClass = it->second;
+            _borrowed.erase(it);
+            _borrowedCount.fetch_sub(1, std::memory_order_release);
+        }
+    }
+    if (task)
+    {
+        task->inUse.fetch_sub(1, std::memory_order_release);
+    }
+    else if (slabClass == nullptr)
+    {
+        // the task was unregistered while the region was out: it still counts in its class
+        std::lock_guard<std::mutex> lock(_slabLock);
+        auto it = _slabOwners.find(addr);
+        if (it != _slabOwners.end())
+        {
+            slabClass = it->second;
+        }
+    }
+    if (slabClass == nullptr)
+    {
+        _device->Deallocate(addr);
+        return;
+    }
+
+    slabClass->inUse.fetch_sub(1, std::memory_order_relaxed);
+    _inUseBytes.fetch_sub(slabClass->size, std::memory_order_relaxed);
+    // a class without tasks keeps nothing
+    if (slabClass->tasks.load() == 0 || !slabClass->idle.TryPush(addr))
+    {
+        {
+            std::lock_guard<std::mutex> lock(_slabLock);
+            slabClass->slabs.fetch_sub(1);
+            _slabOwners.erase(addr);
+        }
+        _reservedBytes.fetch_sub(slabClass->size);
+        _trimmedTotal.fetch_add(1);
+        _device->Deallocate(addr);
+    }
+    wakeWaiters();
+}
+
+int64_t NpuMemoryCacheManager::trim()
+{
+    return releaseIdle(nullptr);
+}
+
+NpuMemoryCacheStats NpuMemoryCacheManager::stats() const
+{
+    NpuMemoryCacheStats stats;
+    {
+        std::lock_guard<std::mutex> lock(_slabLock);
+        for (const auto& entry : _slabClasses)
+        {
+            const SlabClass& slabClass = *entry.second;
+            NpuMemoryCacheStats::SlabClass s;
+            s.size = slabClass.size;
+            s.tasks = slabClass.tasks.load();
+            s.slabs = slabClass.slabs.load();
+            s.inUse = slabClass.inUse.load();
+            s.highWater = slabClass.highWater.load();
+            stats.classes.push_back(s);
+        }
+    }
+    stats.reservedBytes = _reservedBytes.load();
+    stats.reservedHighWaterBytes = _reservedHighWater.load();
+    stats.inUseBytes = _inUseBytes.load();
+    stats.inUseHighWaterBytes = _inUseHighWater.load();
+    stats.borrowed = _borrowedTotal.load();
+    stats.trimmed = _trimmedTotal.load();
+    return stats;
+}
+
+bool NpuMemoryCacheManager::tryAcquire(TaskCache& task)
+{
+    int cur = task.inUse.load(std::memory_order_relaxed);
+    while (cur < task.limit)
+    {
+        if (task.inUse.compare_exchange_weak(cur, cur + 1, std::memory_order_acquire))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t NpuMemoryCacheManager::handOut(SlabClass& slabClass, int64_t addr)
+{
+    raiseTo(slabClass.highWater, slabClass.inUse.fetch_add(1, std::memory_order_relaxed) + 1);
+    raiseTo(_inUseHighWater, _inUseBytes.fetch_add(slabClass.size, std::memory_order_relaxed) + slabClass.size);
+    return addr;
+}
+
+int64_t NpuMemoryCacheManager::getSlow(TaskCache& task, bool acquired)
+{
+    SlabClass& slabClass = *task.slabClass;
+    std::unique_lock<std::mutex> lock(_slabLock);
+    // registered before looking again, so a slab returned from now on wakes this thread
+    _waiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    int64_t addr = -1;
+    for (;;)
+    {
+        if (!acquired)
+        {
+            acquired = tryAcquire(task);
+        }
+        if (acquired)
+        {
+            if (slabClass.idle.TryPop(addr))
+            {
+                addr = handOut(slabClass, addr);
+                break;
+            }
+            addr = borrowLocked(slabClass);
+            if (addr != -1)
+            {
+                break;
+            }
+            addr = growLocked(slabClass, lock);
+            if (addr != -1)
+            {
+                break;
+            }
+        }
+        _cv.wait_for(lock, std::chrono::milliseconds(WAIT_POLL_MS));
+    }
+    _waiters.fetch_sub(1);
+    return addr;
+}
+
+int64_t NpuMemoryCacheManager::borrowLocked(SlabClass& slabClass)
+{
+    for (auto it = _slabClasses.upper_bound(slabClass.size);
+         it != _slabClasses.end() && it->first <= slabClass.size * BORROW_RATIO; ++it)
+    {
+        int64_t addr = -1;
+        if (it->second->idle.TryPop(addr))
+        {
+            _borrowed[addr] = it->second.get();
+            _borrowedCount.fetch_add(1, std::memory_order_release);
+            _borrowedTotal.fetch_add(1, std::memory_order_relaxed);
+            return handOut(*it->second, addr);
+        }
+    }
+    return -1;
+}
+
+int64_t NpuMemoryCacheManager::growLocked(SlabClass& slabClass, std::unique_lock<std::mutex>& lock)
+{
+    if (slabClass.slabs.load() >= SLAB_CLASS_CAPACITY)
+    {
+        return -1;
+    }
+    // holds the place of the new slab while the lock is released for the allocation
+    slabClass.slabs.fetch_add(1);
+    lock.unlock();
+    int64_t addr = allocateSlab(slabClass.size, false);
+    lock.lock();
+    if (addr == -1)
+    {
+        slabClass.slabs.fetch_sub(1);
+        return -1;
+    }
+    _slabOwners[addr] = &slabClass;
+    addReserved(slabClass.size);
+    return handOut(slabClass, addr);
+}
+
+int64_t NpuMemoryCacheManager::allocateSlab(int64_t size, bool wait)
+{
+    int64_t addr = _device->TryAllocate(size);
+    if (addr == -1 && trim() > 0)
+    {
+        addr = _device->TryAllocate(size);
+    }
+    if (addr == -1 && wait)
+    {
+        addr = _device->Allocate(size);
+    }
+    return addr;
+}
+
+void NpuMemoryCacheManager::addReserved(int64_t size)
+{
+    raiseTo(_reservedHighWater, _reservedBytes.fetch_add(size) + size);
+}
+
+int64_t NpuMemoryCacheManager::releaseIdle(SlabClass* only)
+{
+    std::vector<std::pair<int64_t, int64_t> > released;
     {
-        return it->second->returnNpuMemoryCache(addr);
+        std::lock_guard<std::mutex> lock(_slabLock);
+        for (auto& entry : _slabClasses)
+        {
+            SlabClass& slabClass = *entry.second;
+            if (only != nullptr && only != &slabClass)
+            {
+                continue;
+            }
+            int64_t addr = -1;
+            while (slabClass.slabs.load() > slabClass.tasks.load() && slabClass.idle.TryPop(addr))
+            {
+                slabClass.slabs.fetch_sub(1);
+                _slabOwners.erase(addr);
+                released.emplace_back(addr, slabClass.size);
+            }
+        }
     }
+
+    int64_t bytes = 0;
+    for (const auto& slab : released)
+    {
+        _device->Deallocate(slab.first);
+        bytes += slab.second;
+    }
+    if (!released.empty())
+    {
+        _reservedBytes.fetch_sub(bytes);
+        _trimmedTotal.fetch_add(released.size());
+        LOG_DXRT_DBG << "trimmed " << released.size() << " idle slabs, " << bytes << " bytes" << endl;
+    }
+    return bytes;
 }
 
+void NpuMemoryCacheManager::wakeWaiters()
+{
+    // pairs with the fence in getSlow(): either the waiter sees the slab or this sees the waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiters.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(_slabLock);
+        _cv.notify_all();
+    }
+}
 
 }  // namespace dxrt
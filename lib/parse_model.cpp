@@ -296,7 +296,7 @@
 
     for (auto &order : tempTaskOrder) {
         dxrt::rmapinfo rmapInfo;
-        vector<vector<uint8_t>> data;
+        vector<ModelSection> data;
 #ifdef USE_ORT
         bool is_cpu_model = false;
 #endif
@@ -310,24 +310,16 @@
         for (size_t j = 0; j < modelData.deepx_binary.rmap_info().size(); j++) {
             if (order == modelData.deepx_binary.rmap_info(j).name()) {
                 rmapInfo = modelData.deepx_rmap.rmap_info(j);
-                data.emplace_back(vector<uint8_t>(rmapInfo.model_memory().rmap().size()));
-                auto& firstMemBuffer = modelData.deepx_binary.rmap(j).buffer();
-                memcpy(data.back().data(), firstMemBuffer.data(), firstMemBuffer.size());
+                data.emplace_back(modelData.deepx_binary.rmap(j).buffer());
                 DXRT_ASSERT(0 < data.back().size(), "invalid model - rmap size is zero");
-                data.emplace_back(vector<uint8_t>(rmapInfo.model_memory().weight().size()));
-                auto& weightBuffer = modelData.deepx_binary.weight(j).buffer();
                 // Weight can be empty for some models
-                if (data.back().size() > 0) {
-                    memcpy(data.back().data(), weightBuffer.data(), weightBuffer.size());
-                }
+                data.emplace_back(modelData.deepx_binary.weight(j).buffer());
 
                 // v8: Add PPU binary if exists (for PPCPU type)
                 if (modelData.deepx_binary._dxnnFileFormatVersion == 8 &&
                     j < modelData.deepx_binary.ppu().size() &&
                     modelData.deepx_binary.ppu(j).size() > 0) {
-                    data.emplace_back(vector<uint8_t>(modelData.deepx_binary.ppu(j).size()));
-                    auto& ppuBuffer = modelData.deepx_binary.ppu(j).buffer();
-                    memcpy(data.back().data(), ppuBuffer.data(), ppuBuffer.size());
+                    data.emplace_back(modelData.deepx_binary.ppu(j).buffer());
                     LOG_DXRT_DBG << "Added PPU binary to data vector for task '" << order
                                  << "', size: " << data.back().size() << " bytes" << std::endl;
                 }
@@ -341,7 +333,7 @@
             for (size_t j=0; j < modelData.deepx_binary.cpu_models().size(); j++) {
                 if (order == modelData.deepx_binary.cpu_models(j).name()) {
                     const auto& bufferSource = modelData.deepx_binary.cpu_models(j).buffer();
-                    data.emplace_back(bufferSource.begin(), bufferSource.end());
+                    data.emplace_back(bufferSource);
                     found = true;
                     is_cpu_model = true;
                     break;
@@ -457,7 +449,7 @@
      for (auto &order : taskOrder )
      {
          dxrt::rmapinfo rmapInfo;
-         vector<vector<uint8_t>> data;
+         vector<ModelSection> data;
  #ifdef USE_ORT
          bool is_cpu_model = false;
  #endif
@@ -480,24 +472,17 @@
                      }
                  }
 
-                data.emplace_back(vector<uint8_t>(rmapInfo.model_memory().rmap().size()));
-                auto& firstMemBuffer = modelData.deepx_binary.rmap(j).buffer();
-                memcpy(data.back().data(), firstMemBuffer.data(), firstMemBuffer.size());
+                data.emplace_back(modelData.deepx_binary.rmap(j).buffer());
                 DXRT_ASSERT(0 < data.back().size(), "invalid model - rmap size is zero");
 
-                data.emplace_back(vector<uint8_t>(rmapInfo.model_memory().weight().size()));
-                auto& weightBuffer = modelData.deepx_binary.weight(j).buffer();
-                if (data.back().size() > 0) {
-                    memcpy(data.back().data(), weightBuffer.data(), weightBuffer.size());
-                }
+                // Weight can be empty for some models
+                data.emplace_back(modelData.deepx_binary.weight(j).buffer());
 
                 // v8: Add PPU binary if exists (for PPCPU type)
                 if (modelData.deepx_binary._dxnnFileFormatVersion == 8 &&
                     j < modelData.deepx_binary.ppu().size() &&
                     modelData.deepx_binary.ppu(j).size() > 0) {
-                    data.emplace_back(vector<uint8_t>(modelData.deepx_binary.ppu(j).size()));
-                    auto& ppuBuffer = modelData.deepx_binary.ppu(j).buffer();
-                    memcpy(data.back().data(), ppuBuffer.data(), ppuBuffer.size());
+                    data.emplace_back(modelData.deepx_binary.ppu(j).buffer());
                     LOG_DXRT_DBG << "Added PPU binary to data vector for task '" << order
                                  << "', size: " << data.back().size() << " bytes" << std::endl;
                 }
@@ -513,7 +498,7 @@
                  if (order == modelData.deepx_binary.cpu_models(j).name())
                  {
                      const auto& bufferSource = modelData.deepx_binary.cpu_models(j).buffer();
-                     data.emplace_back(bufferSource.begin(), bufferSource.end());
+                     data.emplace_back(bufferSource);
 
                      found = true;
                      is_cpu_model = true;
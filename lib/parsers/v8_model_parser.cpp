@@ -42,19 +42,9 @@ std::string V8ModelParser::ParseModel(const std::string& filePath, ModelDataBase
         throw FileNotFoundException(EXCEPTION_MESSAGE("Invalid model path : " + filePath));
     }
 
-    int fileSize = getFileSize(filePath);
-    std::vector<char> vbuf(fileSize);
-    char *buf = vbuf.data();
-
-    FILE *fp = fopen(filePath.c_str(), "rb");
-    if (!fp) {
-        throw FileNotFoundException(EXCEPTION_MESSAGE("Failed to open file: " + filePath));
-    }
-
-    std::ignore = fread(static_cast<void*>(buf), fileSize, 1, fp);
-    fclose(fp);
-
-    return V8ModelParser::ParseModel((const uint8_t*)buf, fileSize, modelData);
+    auto modelFile = ModelFile::Open(filePath, ModelFile::MmapEnabled());
+    SetBackingFile(modelFile);
+    return V8ModelParser::ParseModel(modelFile->data(), modelFile->size(), modelData);
 }
 
 std::string V8ModelParser::ParseModel(const uint8_t* modelBuffer, size_t modelSize, ModelDataBase& modelData) {
@@ -337,8 +327,7 @@ int V8ModelParser::LoadBinaryInfo(deepx_binaryinfo::BinaryInfoDatabase& param, c
 
     // [Buffer] - CPU Binary Data
     for (size_t i = 0; i < param.cpu_models().size(); i++) {
-        param.cpu_models(i)._buffer.resize(param.cpu_models(i).size());
-        memcpy(param.cpu_models(i)._buffer.data(), buffer + (offset + param.cpu_models(i).offset()), param.cpu_models(i).size());
+        param.cpu_models(i)._buffer = makeSection(buffer + (offset + param.cpu_models(i).offset()), param.cpu_models(i).size());
     }
 
     // [Buffer] - Graph Info.
@@ -349,14 +338,12 @@ int V8ModelParser::LoadBinaryInfo(deepx_binaryinfo::BinaryInfoDatabase& param, c
 
     // [Buffer] - RMAP Binary Data
     for (size_t i = 0; i < param.rmap().size(); i++) {
-        param.rmap(i)._buffer.resize(param.rmap(i).size());
-        memcpy(param.rmap(i)._buffer.data(), buffer + (offset + param.rmap(i).offset()), param.rmap(i).size());
+        param.rmap(i)._buffer = makeSection(buffer + (offset + param.rmap(i).offset()), param.rmap(i).size());
     }
 
     // [Buffer] - Weight Binary Data
     for (size_t i = 0; i < param.weight().size(); i++) {
-        param.weight(i)._buffer.resize(param.weight(i).size());
-        memcpy(param.weight(i)._buffer.data(), buffer + (offset + param.weight(i).offset()), param.weight(i).size());
+        param.weight(i)._buffer = makeSection(buffer + (offset + param.weight(i).offset()), param.weight(i).size());
     }
 
     // [Buffer] - RMAP Info.
@@ -369,14 +356,12 @@ int V8ModelParser::LoadBinaryInfo(deepx_binaryinfo::BinaryInfoDatabase& param, c
 
     // [Buffer] - Bitmatch Mask.
     for (size_t i = 0; i < param.bitmatch_mask().size(); i++) {
-        param.bitmatch_mask(i)._buffer.resize(param.bitmatch_mask(i).size());
-        memcpy(param.bitmatch_mask(i)._buffer.data(), buffer + (offset + param.bitmatch_mask(i).offset()), param.bitmatch_mask(i).size());
+        param.bitmatch_mask(i)._buffer = makeSection(buffer + (offset + param.bitmatch_mask(i).offset()), param.bitmatch_mask(i).size());
     }
 
     // [Buffer] - PPU Binary Data (v8 new)
     for (size_t i = 0; i < param.ppu().size(); i++) {
-        param.ppu(i)._buffer.resize(param.ppu(i).size());
-        memcpy(param.ppu(i)._buffer.data(), buffer + (offset + param.ppu(i).offset()), param.ppu(i).size());
+        param.ppu(i)._buffer = makeSection(buffer + (offset + param.ppu(i).offset()), param.ppu(i).size());
         LOG_DXRT_DBG << "V8: PPU binary loaded - index: " << i 
                      << ", size: " << param.ppu(i).size() << " bytes" << std::endl;
     }
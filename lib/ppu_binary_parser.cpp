@@ -29,7 +29,7 @@ uint32_t GetPpuBoxDataSize(DataType dataType)
     }
 }
 
-PpuOutputSizeInfo CalculatePpuOutputSize(const std::vector<uint8_t>& ppuBinaryData, 
+PpuOutputSizeInfo CalculatePpuOutputSize(const ModelSection& ppuBinaryData, 
                                          DataType outputDataType)
 {
     PpuOutputSizeInfo sizeInfo = {0, 0, 0};
@@ -11,6 +11,9 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <fstream>
+#include <functional>
+#include <thread>
 #include "dxrt/device.h"
 #include "dxrt/request.h"
 #include "dxrt/task.h"
@@ -25,6 +28,11 @@
 #include "dxrt/exception/exception.h"
 #include "resource/log_messages.h"
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #define PROFILER_FORCE_SHOW_DURATIONS 1
 
 using std::cout;
@@ -44,6 +52,29 @@ using rapidjson::Writer;
 namespace dxrt
 {
     Profiler* Profiler::_staticInstance = nullptr;
+    const size_t Profiler::THREAD_EVENTS;
+
+    namespace {
+        std::atomic<uint64_t> profilerSerial{0};
+
+        uint64_t currentThreadId()
+        {
+#ifdef __linux__
+            return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+            return std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xFFFFFFFF;
+#endif
+        }
+
+        int64_t toNs(ProfilerClock::time_point tp)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+        }
+
+        // Chrome trace tracks of the device side spans, one per channel
+        const uint64_t NPU_CORE_TRACK = 1000000;
+        const uint64_t SERVICE_WAIT_TRACK = 1000100;
+    }  // namespace
 
     Profiler& Profiler::GetInstance()
     {
@@ -59,9 +90,18 @@ namespace dxrt
 
 
     Profiler::Profiler()
-    : _save_exit(SAVE_PROFILER_DATA), _show_exit(SHOW_PROFILER_DATA), _enabled(USE_PROFILER)
+    : _serial(++profilerSerial), _save_exit(SAVE_PROFILER_DATA), _show_exit(SHOW_PROFILER_DATA), _enabled(USE_PROFILER)
     {
         LOG_DXRT_DBG << endl;
+        // order of dxrt::ProfilerEvent
+        const char* builtins[PROFILER_EVENT_BUILTIN_COUNT] = {
+            "", "NPU Task", "CPU Task", "NPU Input Format Handler", "NPU Output Format Handler",
+            "PCIe Write", "PCIe Read", "NPU Core", "Service Process Wait", "Framework Response Handling Delay"
+        };
+        for (const char* name : builtins)
+        {
+            Intern(name);
+        }
     }
 
     void Profiler::SetSettings(Configuration::ATTRIBUTE attrib, bool enabled)
@@ -80,11 +120,12 @@ namespace dxrt
     Profiler::~Profiler()
     {
         LOG_DXRT_DBG << endl;
-        if (!timePoints.empty())
+        if (!timePoints.empty() || !collectRecords().empty())
         {
             if (_save_exit)
             {
                 Save("profiler.json");
+                SaveTrace("profiler_trace.json");
             }
 
             if (_show_exit)
@@ -189,6 +230,119 @@ namespace dxrt
         }
     }
 
+    ProfilerEventId Profiler::Intern(const string &name)
+    {
+        std::unique_lock<std::mutex> lk(_eventLock);
+        auto it = _nameIds.find(name);
+        if (it != _nameIds.end())
+        {
+            return it->second;
+        }
+        ProfilerEventId id = static_cast<ProfilerEventId>(_names.size());
+        _names.push_back(name);
+        _nameIds.emplace(name, id);
+        return id;
+    }
+
+    ProfilerThreadEvents* Profiler::threadEvents()
+    {
+        thread_local std::shared_ptr<ProfilerThreadEvents> events;
+        uint64_t serial = _serial.load(std::memory_order_acquire);
+        if (!events || events->owner != serial)
+        {
+            events = std::make_shared<ProfilerThreadEvents>(THREAD_EVENTS);
+            events->tid = currentThreadId();
+            events->owner = serial;
+            std::unique_lock<std::mutex> lk(_eventLock);
+            _threadEvents.push_back(events);
+        }
+        return events.get();
+    }
+
+    void Profiler::Record(ProfilerEventId event, ProfilerClock::time_point start, ProfilerClock::time_point end,
+        const ProfilerArgs& args)
+    {
+        if (_enabled == false)
+            return;
+
+        // single writer per ring: only the owning thread advances head; the slot's seq lets
+        // collectRecords() tell a slot being overwritten from one it can copy
+        ProfilerThreadEvents* events = threadEvents();
+        uint64_t head = events->head.load(std::memory_order_relaxed);
+        ProfilerSlot& slot = events->slots[head % events->slots.size()];
+        slot.seq.store(2 * head + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.record.event = event;
+        slot.record.args = args;
+        slot.record.startNs = toNs(start);
+        slot.record.endNs = toNs(end);
+        slot.seq.store(2 * head + 2, std::memory_order_release);
+        events->head.store(head + 1, std::memory_order_release);
+    }
+
+    vector<ProfilerRecord> Profiler::collectRecords(vector<uint64_t>* tids)
+    {
+        vector<ProfilerRecord> records;
+        std::unique_lock<std::mutex> lk(_eventLock);
+        for (auto& events : _threadEvents)
+        {
+            uint64_t head = events->head.load(std::memory_order_acquire);
+            uint64_t capacity = events->slots.size();
+            for (uint64_t i = (head > capacity) ? head - capacity : 0; i < head; i++)
+            {
+                // the writer keeps going while we copy: skip a slot that is being written, or
+                // that already holds a later record, before or after the copy
+                const ProfilerSlot& slot = events->slots[i % capacity];
+                const uint64_t expected = 2 * i + 2;
+                if (slot.seq.load(std::memory_order_acquire) != expected)
+                    continue;
+                ProfilerRecord record = slot.record;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) != expected)
+                    continue;
+                records.push_back(record);
+                if (tids) tids->push_back(events->tid);
+            }
+        }
+        return records;
+    }
+
+    // name the event had when it was recorded by Start()/End(), e.g. "PCIe Write[Job_1][npu_0][Req_7](2)"
+    string Profiler::legacyName(const ProfilerRecord& record)
+    {
+        std::unique_lock<std::mutex> lk(_eventLock);
+        const ProfilerArgs& args = record.args;
+        string base = record.event < _names.size() ? _names[record.event] : "Unknown";
+        string task = (args.task != 0 && args.task < _names.size()) ? _names[args.task] : "";
+        if (record.event == PROFILER_EVENT_CPU_TASK)
+        {
+            base = task;
+        }
+
+        string name = base;
+        if (args.job >= 0) name += "[Job_" + std::to_string(args.job) + "]";
+        if (!task.empty()) name += "[" + task + "]";
+        if (args.request >= 0) name += "[Req_" + std::to_string(args.request) + "]";
+        if (args.channel >= 0)
+        {
+            switch (record.event)
+            {
+                case PROFILER_EVENT_CPU_TASK:
+                    name += "_t" + std::to_string(args.channel);
+                    break;
+                case PROFILER_EVENT_NPU_CORE:
+                case PROFILER_EVENT_SERVICE_WAIT:
+                case PROFILER_EVENT_RESPONSE_DELAY:
+                    name += "_" + std::to_string(args.channel);
+                    break;
+                default:
+                    name += "(" + std::to_string(args.channel) + ")";
+                    break;
+            }
+        }
+        return name;
+    }
+
     uint64_t Profiler::Get(const string &x)
     {
         if (_enabled == false) return 0;
@@ -260,7 +414,15 @@ namespace dxrt
             return;
         std::unique_lock<std::mutex> lk(_lock);
         LOG_DXRT_DBG << "profiler" << endl;
-        if (!timePoints.empty())
+        std::map<string, vector<TimePoint>> allTimePoints = timePoints;
+        for (const auto& record : collectRecords())
+        {
+            TimePoint tp;
+            tp.start = ProfilerClock::time_point(std::chrono::nanoseconds(record.startNs));
+            tp.end = ProfilerClock::time_point(std::chrono::nanoseconds(record.endNs));
+            allTimePoints[legacyName(record)].push_back(tp);
+        }
+        if (!allTimePoints.empty())
         {
             cout << "  -------------------------------------------------------------------------------" << endl;
             cout << "  |           Name                 |  min (us)    |  max (us)    | average (us) |" << endl;
@@ -269,7 +431,7 @@ namespace dxrt
             // Group by base name (before first bracket)
             std::map<string, std::vector<TimePoint>> groupedTimePoints;
             std::map<string, vector<TimePoint>>::iterator iter;
-            for (iter = timePoints.begin(); iter != timePoints.end(); ++iter)
+            for (iter = allTimePoints.begin(); iter != allTimePoints.end(); ++iter)
             {
                 string fullName = iter->first;
                 string baseName = fullName;
@@ -340,13 +502,21 @@ namespace dxrt
             return;
 
         std::unique_lock<std::mutex> lk(_lock);
-        if (timePoints.empty())
+        std::map<string, vector<TimePoint>> allTimePoints = timePoints;
+        for (const auto& record : collectRecords())
+        {
+            TimePoint tp;
+            tp.start = ProfilerClock::time_point(std::chrono::nanoseconds(record.startNs));
+            tp.end = ProfilerClock::time_point(std::chrono::nanoseconds(record.endNs));
+            allTimePoints[legacyName(record)].push_back(tp);
+        }
+        if (allTimePoints.empty())
             return;
         Document document;
         document.SetObject();
         Document::AllocatorType& allocator = document.GetAllocator();
         // Loop through the collected profiler data
-        for (const auto& entry : timePoints) {
+        for (const auto& entry : allTimePoints) {
             const std::string& name = entry.first;
             const std::vector<TimePoint>& tps = entry.second;
             // cout << name << endl;
@@ -382,6 +552,135 @@ namespace dxrt
         }
     }
 
+    void Profiler::SaveTrace(const string &filename)
+    {
+        if (_enabled == false)
+            return;
+
+        std::unique_lock<std::mutex> lk(_lock);
+        vector<uint64_t> tids;
+        vector<ProfilerRecord> records = collectRecords(&tids);
+        if (records.empty() && timePoints.empty())
+            return;
+        vector<string> names;
+        {
+            std::unique_lock<std::mutex> eventLk(_eventLock);
+            names = _names;
+        }
+#ifdef __linux__
+        int pid = static_cast<int>(getpid());
+#else
+        int pid = 0;
+#endif
+
+        StringBuffer buffer;
+        Writer<StringBuffer> writer(buffer);
+        auto writeEvent = [&](const char* name, const char* phase, double tsUs, uint64_t tid) {
+            writer.Key("name"); writer.String(name);
+            writer.Key("ph"); writer.String(phase);
+            writer.Key("ts"); writer.Double(tsUs);
+            writer.Key("pid"); writer.Int(pid);
+            writer.Key("tid"); writer.Uint64(tid);
+        };
+        auto writeArgs = [&](const ProfilerArgs& args) {
+            writer.Key("args");
+            writer.StartObject();
+            if (args.job >= 0) { writer.Key("job"); writer.Int(args.job); }
+            if (args.request >= 0) { writer.Key("request"); writer.Int(args.request); }
+            if (args.channel >= 0) { writer.Key("channel"); writer.Int(args.channel); }
+            if (args.task != 0 && args.task < names.size()) { writer.Key("task"); writer.String(names[args.task].c_str()); }
+            writer.EndObject();
+        };
+
+        writer.StartObject();
+        writer.Key("displayTimeUnit"); writer.String("ms");
+        writer.Key("traceEvents");
+        writer.StartArray();
+
+        std::map<uint64_t, string> virtualTracks;
+        for (size_t i = 0; i < records.size(); i++)
+        {
+            const ProfilerRecord& r = records[i];
+            if (r.startNs == 0 || r.endNs < r.startNs)
+                continue;
+            const char* name = r.event < names.size() ? names[r.event].c_str() : "Unknown";
+            double startUs = r.startNs / 1000.0;
+            double durUs = (r.endNs - r.startNs) / 1000.0;
+
+            if (r.event == PROFILER_EVENT_NPU_TASK)
+            {
+                // requests overlap on the thread that completes them: async span per request
+                for (int edge = 0; edge < 2; edge++)
+                {
+                    writer.StartObject();
+                    writeEvent(name, edge == 0 ? "b" : "e", edge == 0 ? startUs : startUs + durUs, tids[i]);
+                    writer.Key("cat"); writer.String("request");
+                    writer.Key("id"); writer.Int(r.args.request);
+                    if (edge == 0) writeArgs(r.args);
+                    writer.EndObject();
+                }
+                continue;
+            }
+
+            uint64_t tid = tids[i];
+            if ((r.event == PROFILER_EVENT_NPU_CORE || r.event == PROFILER_EVENT_SERVICE_WAIT) && r.args.channel >= 0)
+            {
+                // device side spans on a track per core
+                bool core = r.event == PROFILER_EVENT_NPU_CORE;
+                tid = (core ? NPU_CORE_TRACK : SERVICE_WAIT_TRACK) + r.args.channel;
+                virtualTracks[tid] = string(core ? "NPU Core " : "Service Wait ") + std::to_string(r.args.channel);
+            }
+            writer.StartObject();
+            writeEvent(name, "X", startUs, tid);
+            writer.Key("dur"); writer.Double(durUs);
+            writeArgs(r.args);
+            writer.EndObject();
+        }
+
+        // Start()/End() events keep their full names
+        int legacyId = 0;
+        for (const auto& entry : timePoints)
+        {
+            for (const auto& tp : entry.second)
+            {
+                if (tp.start.time_since_epoch().count() == 0 || tp.end.time_since_epoch().count() == 0)
+                    continue;
+                legacyId++;
+                for (int edge = 0; edge < 2; edge++)
+                {
+                    writer.StartObject();
+                    writeEvent(entry.first.c_str(), edge == 0 ? "b" : "e",
+                        toNs(edge == 0 ? tp.start : tp.end) / 1000.0, 0);
+                    writer.Key("cat"); writer.String("event");
+                    writer.Key("id"); writer.Int(legacyId);
+                    writer.EndObject();
+                }
+            }
+        }
+
+        for (const auto& track : virtualTracks)
+        {
+            writer.StartObject();
+            writeEvent("thread_name", "M", 0, track.first);
+            writer.Key("args");
+            writer.StartObject();
+            writer.Key("name"); writer.String(track.second.c_str());
+            writer.EndObject();
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+
+        std::ofstream outFile(filename);
+        if (outFile.is_open()) {
+            outFile << buffer.GetString();
+            outFile.close();
+            cout << "Profiler trace has been written to " << filename << endl;
+        } else {
+            LOG_DXRT_ERR("Failed to open output file");
+        }
+    }
+
     void Profiler::Flush()
     {
         if (_enabled == false) return;
@@ -389,16 +688,27 @@ namespace dxrt
         std::unique_lock<std::mutex> lk(_lock);
         timePoints.clear();
         idx.clear();
+
+        // threads register fresh rings on their next Record()
+        std::unique_lock<std::mutex> eventLk(_eventLock);
+        _threadEvents.clear();
+        _serial.store(++profilerSerial, std::memory_order_release);
     }
 
     std::map<string, std::vector<int64_t>> Profiler::GetPerformanceData()
     {
 
         std::unique_lock<std::mutex> lk(_lock);
-        if (timePoints.empty())
-            return {};
-        
         std::map<string, std::vector<int64_t>> data;
+        for (const auto& record : collectRecords())
+        {
+            if (record.event != PROFILER_EVENT_NPU_CORE && record.event != PROFILER_EVENT_NPU_TASK) continue;
+            if (record.startNs == 0 || record.endNs == 0) continue;
+            data[record.event == PROFILER_EVENT_NPU_CORE ? "NPU Core" : "NPU Task"].push_back(
+                (record.endNs - record.startNs) / 1000000);
+        }
+        if (timePoints.empty())
+            return data;
         
         for (const auto& entry : timePoints) {
             const std::string& mName = entry.first;
@@ -66,8 +66,8 @@ RequestPtr Request::Create(Task *task_, Tensors inputs_, Tensors outputs_, void
     req->_data.inputs.clear();
     req->_data.outputs.clear();
 
-    req->setInputs(inputs_);
-    req->setOutputs(outputs_);
+    req->setInputs(std::move(inputs_));
+    req->setOutputs(std::move(outputs_));
     req->_userArg = userArg;
     req->latency_valid() = true;
     req->latency() = 0;
@@ -78,6 +78,14 @@ RequestPtr Request::Create(Task *task_, Tensors inputs_, Tensors outputs_, void
     req->_modelType = task_->getData()->_npuModel.type;
     req->_data.encoded_inputs_ptr = nullptr;
     req->_data.encoded_outputs_ptr = nullptr;
+    req->_data.dma_input_ptr = nullptr;
+    req->_data.sched_priority = 0;
+    req->_data.deadline_us = 0;
+    req->_data.submit_ns = LatencyClockNs();
+    req->_data.encoded_ns = 0;
+    req->_data.written_ns = 0;
+    req->_data.response_ns = 0;
+    req->_data.decoded_ns = 0;
     return req;
 }
 
@@ -88,14 +96,15 @@ RequestPtr Request::Create(Task *task_, void *input, void *output, void *userArg
     req->_data.taskData = task_->getData();
     req->_is_validate_request = false;
 
+    TaskData* taskData = task_->getData();
     if (input == nullptr)
         req->setInputs({});
     else
-        req->setInputs(task_->inputs(input)); // TODO: check to move to device?
+        req->assignInputs(taskData->_inputTensors, taskData->_inputOffsets, input);
     if (output == nullptr)
         req->setOutputs({});
     else
-        req->setOutputs(task_->outputs(output));  // TODO: move to device?
+        req->assignOutputs(taskData->_outputTensors, taskData->_outputOffsets, output);
     req->_userArg = userArg;
     req->latency_valid() = true;
     req->latency() = 0;
@@ -106,6 +115,14 @@ RequestPtr Request::Create(Task *task_, void *input, void *output, void *userArg
     req->_modelType = task_->getData()->_npuModel.type;
     req->_data.encoded_inputs_ptr = nullptr;
     req->_data.encoded_outputs_ptr = nullptr;
+    req->_data.dma_input_ptr = nullptr;
+    req->_data.sched_priority = 0;
+    req->_data.deadline_us = 0;
+    req->_data.submit_ns = LatencyClockNs();
+    req->_data.encoded_ns = 0;
+    req->_data.written_ns = 0;
+    req->_data.response_ns = 0;
+    req->_data.decoded_ns = 0;
 
     return req;
 }
@@ -293,8 +310,11 @@ void Request::Reset()
     releaseBuffers();
 
     _data.taskData = nullptr;
-    setInputs({});
-    setOutputs({});
+    {
+        std::unique_lock<std::mutex> lk(_reqLock);
+        if (!_inputsRetained) _data.inputs.clear();
+        if (!_outputsRetained) _data.outputs.clear();
+    }
 
     _data.encoded_input_ptrs.clear();
     _data.encoded_output_ptrs.clear();
@@ -303,9 +323,7 @@ void Request::Reset()
 
     _data.encoded_inputs_ptr = nullptr;
     _data.encoded_outputs_ptr = nullptr;
-
-    _data.inputs = {};
-    _data.outputs = {};
+    _data.dma_input_ptr = nullptr;
 
     _userArg = nullptr;
 
@@ -314,21 +332,61 @@ void Request::Reset()
     SetStatus(Status::REQ_IDLE);
 
     _task = nullptr;
-    _use_flag = false;
+    CircularDataPool<Request>::release(this);
     _bufferReleased = false;
 }
 
 void Request::setInputs(Tensors input)
 {
     std::unique_lock<std::mutex> lk(_reqLock);
-    _data.inputs.clear();
-    _data.inputs = input;
+    // Move so a freshly built tensor list is adopted instead of copied element by element
+    _data.inputs = std::move(input);
+    _inputsRetained = false;
 }
 void Request::setOutputs(Tensors output)
 {
     std::unique_lock<std::mutex> lk(_reqLock);
-    _data.outputs.clear();
-    _data.outputs = output;
+    _data.outputs = std::move(output);
+    _outputsRetained = false;
+}
+
+// Tensor copy-assignment reuses the name and shape buffers of the target, so once the list has
+// held this layout nothing is allocated; only a longer layout appends new tensors
+static void assignTensors(Tensors& tensors, const Tensors& layout, const std::vector<uint64_t>& offsets, void* base)
+{
+    if (tensors.size() > layout.size())
+    {
+        tensors.erase(tensors.begin() + layout.size(), tensors.end());
+    }
+    for (size_t i = 0; i < layout.size(); i++)
+    {
+        if (i < tensors.size())
+            tensors[i] = layout[i];
+        else
+            tensors.push_back(layout[i]);
+        // like TaskData::outputs(nullptr), no base keeps the layout's own pointers
+        if (base != nullptr)
+        {
+            tensors[i].data() = static_cast<void*>(static_cast<uint8_t*>(base) + offsets[i]);
+            tensors[i].phy_addr() = offsets[i];
+        }
+    }
+}
+
+void Request::assignInputs(const Tensors& layout, const std::vector<uint64_t>& offsets, void* base)
+{
+    std::unique_lock<std::mutex> lk(_reqLock);
+    // Tensors from setInputs() may own their data; never copy-assign over those
+    if (!_inputsRetained) _data.inputs.clear();
+    assignTensors(_data.inputs, layout, offsets, base);
+    _inputsRetained = true;
+}
+void Request::assignOutputs(const Tensors& layout, const std::vector<uint64_t>& offsets, void* base)
+{
+    std::unique_lock<std::mutex> lk(_reqLock);
+    if (!_outputsRetained) _data.outputs.clear();
+    assignTensors(_data.outputs, layout, offsets, base);
+    _outputsRetained = true;
 }
 
 
@@ -409,19 +467,40 @@ const RequestData* Request::getData() const
 }
 
 void Request::setBufferSet(std::unique_ptr<BufferSet> buffers)
+{
+    if (buffers)
+    {
+        setBufferSet(*buffers);
+        return;
+    }
+    releaseBufferSet();
+}
+
+void Request::setBufferSet(const BufferSet& buffers)
 {
     // Release existing buffer if present (but don't set _bufferReleased)
-    if (_bufferSet && _task) {
+    releaseBufferSet();
+    if (!_bufferSet)
+    {
+        _bufferSet.reset(new BufferSet());
+    }
+    *_bufferSet = buffers;
+    _hasBufferSet = true;
+    // _bufferReleased is set to true only when releaseBuffers() is called
+}
+
+void Request::releaseBufferSet()
+{
+    if (_hasBufferSet && _task) {
         try {
             _task->ReleaseAllBuffers(*_bufferSet);
-            LOG_DXRT_DBG << "Released existing buffers for request " << id() << std::endl;
+            LOG_DXRT_DBG << "Released buffers for request " << id() << std::endl;
         }
         catch (const std::exception& e) {
-            LOG_DXRT_ERR("Error releasing existing buffers for request " << id() << ": " << e.what());
+            LOG_DXRT_ERR("Error releasing buffers for request " << id() << ": " << e.what());
         }
+        _hasBufferSet = false;
     }
-    _bufferSet = std::move(buffers);
-    // _bufferReleased is set to true only when releaseBuffers() is called
 }
 
 void Request::releaseBuffers()
@@ -431,22 +510,13 @@ void Request::releaseBuffers()
         return;
     }
 
-    if (_bufferSet && _task) {
-        try {
-            _task->ReleaseAllBuffers(*_bufferSet);
-            LOG_DXRT_DBG << "Released buffers for request " << id() << std::endl;
-        }
-        catch (const std::exception& e) {
-            LOG_DXRT_ERR("Error releasing buffers for request " << id() << ": " << e.what());
-        }
-        _bufferSet.reset();
-    }
+    releaseBufferSet();
     _bufferReleased = true;
 }
 
 bool Request::hasBufferSet() const
 {
-    return _bufferSet != nullptr;
+    return _hasBufferSet;
 }
 
 bool Request::isBufferReleased() const
@@ -469,7 +539,7 @@ RequestPtr Request::CreateValidateRequest(Task* task_, void* input, void* output
     if (input == nullptr)
         req->setInputs({});
     else
-        req->setInputs(task_->inputs(input)); // TODO: check to move to device?
+        req->assignInputs(task_->getData()->_inputTensors, task_->getData()->_inputOffsets, input);
 
     req->_userArg = nullptr;
     req->latency_valid() = true;
@@ -482,6 +552,14 @@ RequestPtr Request::CreateValidateRequest(Task* task_, void* input, void* output
     req->_modelType = task_->getData()->_npuModel.type;
     req->_data.encoded_inputs_ptr = input;
     req->_data.encoded_outputs_ptr = output;
+    req->_data.dma_input_ptr = nullptr;
+    req->_data.sched_priority = 0;
+    req->_data.deadline_us = 0;
+    req->_data.submit_ns = LatencyClockNs();
+    req->_data.encoded_ns = 0;
+    req->_data.written_ns = 0;
+    req->_data.response_ns = 0;
+    req->_data.decoded_ns = 0;
 
     req->_is_validate_request = true;
     req->_validate_output_ptr = output;
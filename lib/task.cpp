@@ -20,6 +20,7 @@
 #include "dxrt/exception/exception.h"
 #include "dxrt/objects_pool.h"
 #include "dxrt/fixed_size_buffer.h"
+#include "dxrt/thread_affinity.h"
 #include "dxrt/configuration.h"
 #include "dxrt/device_task_layer.h"
 #ifdef USE_SERVICE
@@ -64,14 +65,30 @@ static std::vector<int> makeList(int n)
     return vec;
 }
 
+// NUMA node shared by all devices of a task, -1 when placement is off or the devices sit on different nodes
+static int devicesNumaNode(const std::vector<int>& deviceIds)
+{
+    if (GetThreadAffinityMode() != ThreadAffinityMode::NUMA) return -1;
+    int node = -1;
+    for (size_t i = 0; i < deviceIds.size(); i++)
+    {
+        auto device = DevicePool::GetInstance().GetDeviceTaskLayer(deviceIds[i]);
+        if (device == nullptr) return -1;
+        int deviceNode = GetDeviceNumaNode(device->id());
+        if (deviceNode < 0 || (i > 0 && deviceNode != node)) return -1;
+        node = deviceNode;
+    }
+    return node;
+}
+
 // Constructor 1: Default devices + hasPpuBinary
-Task::Task(std::string name_, rmapinfo rmapInfo_, int bufferCount_, std::vector<std::vector<uint8_t>>&& data_, npu_bound_op boundOp, bool hasPpuBinary)
+Task::Task(std::string name_, rmapinfo rmapInfo_, int bufferCount_, std::vector<ModelSection>&& data_, npu_bound_op boundOp, bool hasPpuBinary)
 : Task(name_, rmapInfo_, bufferCount_, std::move(data_), boundOp, makeList(DevicePool::GetInstance().GetDeviceCount()), hasPpuBinary)
 {
 }
 
 // Constructor 2: Specific devices + hasPpuBinary
-Task::Task(std::string name_, rmapinfo rmapInfo_, int bufferCount_, std::vector<std::vector<uint8_t>>&& data_,
+Task::Task(std::string name_, rmapinfo rmapInfo_, int bufferCount_, std::vector<ModelSection>&& data_,
     npu_bound_op boundOp, const std::vector<int>& deviceIds, bool hasPpuBinary)
 : _taskData(getNextId(), name_, rmapInfo_, bufferCount_), _data(std::move(data_)), _boundOp(boundOp)
 {
@@ -109,6 +126,12 @@ Task::Task(std::string name_, rmapinfo rmapInfo_, int bufferCount_, std::vector<
             InitializeTaskWithService(deviceId);
 
         }
+        // Parameters are resident on every device now; mapped pages can go back to the OS
+        // (a later read, e.g. device recovery, faults them in again from the model file)
+        for (const auto& section : _data)
+        {
+            section.ReleasePages();
+        }
         LOG_DXRT_DBG << "NPU Task created" << endl;
     }
     else
@@ -157,6 +180,7 @@ Task::~Task(void)
             // Release device-local resources
             device->Release(getData());
         }
+        DevicePool::GetInstance().RemoveTask(id());
 
         LOG_DXRT_DBG << "Task " << id() << " Done (NPU)" << endl;
     }
@@ -398,7 +422,8 @@ void Task::SetEncodedInputBuffer(int size)
     if (_taskData._processor == Processor::NPU)
     {
         LOG_DXRT_DBG << "Task "<< id() <<" Encoded Input Buffer Count : " << size << std::endl;
-        _taskEncodedInputBuffer = std::make_shared<FixedSizeBuffer>(_taskData.encoded_input_size(), size);
+        _taskEncodedInputBuffer = std::make_shared<FixedSizeBuffer>(_taskData.encoded_input_size(), size,
+            devicesNumaNode(_device_ids));
     }
     else
         LOG_DXRT_DBG << "CPU Task "<< id() <<" does not have a buffer"<< std::endl;
@@ -459,16 +484,17 @@ void Task::SetOutputBuffer(int size)
 {
     std::lock_guard<std::mutex> lock(_bufferMutex);
     LOG_DXRT_DBG << "Task "<< id() <<" Output Buffer Count : " << size << std::endl;
+    int numaNode = devicesNumaNode(_device_ids);
     if (_taskData._processor == Processor::NPU)
     {
-        _taskOutputBuffer = std::make_shared<FixedSizeBuffer>(_taskData.output_size(), size);
-        _taskEncodedOutputBuffer = std::make_shared<FixedSizeBuffer>(_taskData.encoded_output_size(), size);
+        _taskOutputBuffer = std::make_shared<FixedSizeBuffer>(_taskData.output_size(), size, numaNode);
+        _taskEncodedOutputBuffer = std::make_shared<FixedSizeBuffer>(_taskData.encoded_output_size(), size, numaNode);
         LOG_DXRT_DBG << "Task "<< id() <<" Output Buffer Size : " << _taskData.output_size() << std::endl;
         LOG_DXRT_DBG << "Task "<< id() <<" Encoded Output Buffer Size : " << _taskData.encoded_output_size() << std::endl;
     }
     else
     {
-        _taskOutputBuffer = std::make_shared<FixedSizeBuffer>(_taskData.output_size(), size);
+        _taskOutputBuffer = std::make_shared<FixedSizeBuffer>(_taskData.output_size(), size, numaNode);
     }
 }
 
@@ -17,6 +17,7 @@
 #include "dxrt/util.h"
 #include "dxrt/buffer.h"
 #include "dxrt/ppu_binary_parser.h"
+#include "dxrt/npu_format_handler.h"
 #include <limits>
 #include <cstdint>
 #include <sstream>
@@ -55,11 +56,11 @@ deepx_rmapinfo::Layout LayoutFromPpuType(int ppuType)
 namespace dxrt {
 
 TaskData::TaskData(int id_, std::string name_, rmapinfo info_, int bufferCount_)
-: _id(id_), _name(name_), _info(info_), _bufferCount(bufferCount_)
+: _id(id_), _name(name_), _profilerNameId(Profiler::GetInstance().Intern(name_)), _info(info_), _bufferCount(bufferCount_)
 {
 }
 
-void TaskData::set_from_npu(const std::vector<std::vector<uint8_t>>& data_, bool hasPpuBinary)
+void TaskData::set_from_npu(const std::vector<ModelSection>& data_, bool hasPpuBinary)
 {
     using std::endl;
     using std::vector;
@@ -450,6 +451,27 @@ void TaskData::set_from_npu(const std::vector<std::vector<uint8_t>>& data_, bool
         _npuModel.npu_id = 0;
     }
 
+    // Decide once which tensors can bypass the format handler
+    _inputZeroCopy = _numInputs > 0 && _encodedInputSize == _inputSize;
+    for (int i = 0; i < _numInputs; i++)
+    {
+        uint64_t userSize = _inputTensors[i].size_in_bytes();
+        bool identical = npu_format_handler::NpuFormatHandler::IsInputLayoutIdentical(_npuInputTensorInfos[i], userSize);
+        _inputLayoutIdentical.push_back(identical);
+        if (!identical || _encodedInputOffsets[i] != _inputOffsets[i])
+            _inputZeroCopy = false;
+    }
+    for (int i = 0; i < _numOutputs; i++)
+    {
+        uint64_t userSize = 1;
+        for (auto dim : _outputShapes[i]) userSize *= (dim < 0 ? 0 : dim);  // dynamic shapes never qualify
+        userSize *= GetDataSize_Datatype(_outputDataTypes[i]);
+        bool identical = !_isPPU && !_isArgMax &&
+            npu_format_handler::NpuFormatHandler::IsOutputLayoutIdentical(_npuOutputTensorInfos[i], userSize);
+        _outputLayoutIdentical.push_back(identical);
+    }
+    LOG_DXRT_DBG << "NPU Task: zero-copy input " << (_inputZeroCopy ? "enabled" : "disabled") << endl;
+
     _outputMemSize = std::max(static_cast<uint32_t>(0), _npuModel.output_all_size);
     //_memUsage = rmapSize + weightSize + (static_cast<uint64_t>(_encodedInputSize) * DXRT_TASK_MAX_LOAD) + (static_cast<uint64_t>(_outputMemSize) * DXRT_TASK_MAX_LOAD);
     _memUsage = rmapSize + weightSize + (static_cast<uint64_t>(data_align(_encodedInputSize, 64)) * _bufferCount) + (static_cast<uint64_t>(_outputMemSize) * _bufferCount);
@@ -525,6 +547,23 @@ Tensors TaskData::outputs(void* ptr, uint64_t phyAddr)
     }
 }
 
+bool TaskData::can_zero_copy(Tensors& inputs) const
+{
+    if (!_inputZeroCopy || inputs.size() != static_cast<size_t>(_numInputs))
+        return false;
+
+    // The DMA reads the whole input block from one pointer, so the tensors must be packed in place
+    const uint8_t* base = static_cast<const uint8_t*>(inputs[0].data());
+    if (base == nullptr || reinterpret_cast<uintptr_t>(base) % ZERO_COPY_INPUT_ALIGN != 0)
+        return false;
+    for (int i = 0; i < _numInputs; i++)
+    {
+        if (static_cast<const uint8_t*>(inputs[i].data()) != base + _inputOffsets[i])
+            return false;
+    }
+    return true;
+}
+
 uint32_t TaskData::weightChecksum()
 {
     uint32_t value = 0;
@@ -538,6 +577,61 @@ uint32_t TaskData::weightChecksum()
     return value;
 }
 
+namespace {
+// Windows of a model image hashed into its sampled ModelMemoryKey: the head, the tail and evenly
+// spread ones in between. Smaller images are hashed whole
+constexpr uint64_t MODEL_KEY_SAMPLE_SIZE = 4 * 1024;
+constexpr uint64_t MODEL_KEY_SAMPLE_COUNT = 64;
+
+// returns true when the whole image went into the digest
+bool hashModelImage(Sha256& sha, const dxrt_meminfo_t& image, bool exact)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(image.data);
+    const uint64_t size = image.size;
+    if (exact || size <= MODEL_KEY_SAMPLE_SIZE * MODEL_KEY_SAMPLE_COUNT)
+    {
+        sha.Update(data, size);
+        return true;
+    }
+    for (uint64_t i = 0; i < MODEL_KEY_SAMPLE_COUNT; i++)
+    {
+        sha.Update(data + (size - MODEL_KEY_SAMPLE_SIZE) * i / (MODEL_KEY_SAMPLE_COUNT - 1), MODEL_KEY_SAMPLE_SIZE);
+    }
+    return false;
+}
+}  // namespace
+
+ModelMemoryKey TaskData::modelMemoryKey()
+{
+    if (!_modelMemoryKeyValid)
+    {
+        // A cryptographic digest: an exact key is trusted as is, a sampled one only picks the
+        // candidate that the caller compares with the device copy
+        Sha256 sha;
+        bool whole = hashModelImage(sha, _npuModel.rmap, false);
+        whole = hashModelImage(sha, _npuModel.weight, false) && whole;
+        _modelMemoryKey.digest = sha.Final();
+        _modelMemoryKey.rmapSize = _npuModel.rmap.size;
+        _modelMemoryKey.weightSize = _npuModel.weight.size;
+        _modelMemoryKey.exact = whole ? 1 : 0;
+        _modelMemoryKeyValid = true;
+    }
+    return _modelMemoryKey;
+}
+
+ModelMemoryKey TaskData::exactModelMemoryKey()
+{
+    ModelMemoryKey key;
+    Sha256 sha;
+    hashModelImage(sha, _npuModel.rmap, true);
+    hashModelImage(sha, _npuModel.weight, true);
+    key.digest = sha.Final();
+    key.rmapSize = _npuModel.rmap.size;
+    key.weightSize = _npuModel.weight.size;
+    key.exact = 1;
+    return key;
+}
+
 int64_t TaskData::NPU_block_size() const
 {
     int64_t block_size = 0;
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#include "dxrt/thread_affinity.h"
+#include "dxrt/driver.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#endif
+
+namespace dxrt {
+
+const char* ThreadRoleName(ThreadRole role)
+{
+    switch (role)
+    {
+        case ThreadRole::NONE: return "none";
+        case ThreadRole::DEVICE_IO: return "device-io";
+        case ThreadRole::NFH: return "nfh";
+        case ThreadRole::CPU_TASK: return "cpu-task";
+    }
+    return "unknown";
+}
+
+std::vector<int> ParseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) continue;
+        size_t dash = item.find('-');
+        std::string first = item.substr(0, dash);
+        std::string last = dash == std::string::npos ? first : item.substr(dash + 1);
+        if (first.empty() || last.empty() ||
+            first.find_first_not_of("0123456789") != std::string::npos ||
+            last.find_first_not_of("0123456789") != std::string::npos ||
+            first.size() > 6 || last.size() > 6)
+        {
+            return {};
+        }
+        int begin = std::stoi(first);
+        int end = std::stoi(last);
+#ifdef __linux__
+        if (begin > end || end >= CPU_SETSIZE) return {};
+#else
+        if (begin > end) return {};
+#endif
+        for (int cpu = begin; cpu <= end; cpu++) cpus.push_back(cpu);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+#ifdef __linux__
+static bool readLine(const std::string& path, std::string& line)
+{
+    std::ifstream file(path);
+    return file && std::getline(file, line);
+}
+
+// cores the process was allowed to run on before any thread was pinned (taskset, cgroup cpusets)
+static const std::vector<int>& processCpus()
+{
+    static const std::vector<int> cpus = [] {
+        std::vector<int> allowed;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                if (CPU_ISSET(cpu, &set)) allowed.push_back(cpu);
+        }
+        return allowed;
+    }();
+    return cpus;
+}
+// taken when the library is loaded, before any runtime thread exists
+static const std::vector<int>& sProcessCpus = processCpus();
+
+static std::vector<int> allowedOnly(const std::vector<int>& cpus)
+{
+    const std::vector<int>& allowed = processCpus();
+    if (allowed.empty()) return cpus;
+    std::vector<int> result;
+    std::set_intersection(cpus.begin(), cpus.end(), allowed.begin(), allowed.end(), std::back_inserter(result));
+    return result;
+}
+
+static bool setThreadCpus(const std::vector<int>& cpus)
+{
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (ret != 0)
+    {
+        LOG_DXRT_DBG << "pthread_setaffinity_np failed: " << ret << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static std::vector<int> getThreadCpus()
+{
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+#endif
+
+int GetDeviceNumaNode(int deviceId)
+{
+#ifdef __linux__
+    static std::mutex lock;
+    static std::map<int, int> nodes;
+    std::lock_guard<std::mutex> lk(lock);
+    auto it = nodes.find(deviceId);
+    if (it != nodes.end()) return it->second;
+
+    // the character device leads to its PCIe function through /sys/dev/char/<major>:<minor>/device
+    int node = -1;
+    struct stat st;
+    std::string devFile = "/dev/" + std::string(DEVICE_FILE) + std::to_string(deviceId);
+    if (deviceId >= 0 && stat(devFile.c_str(), &st) == 0 && S_ISCHR(st.st_mode))
+    {
+        std::string path = "/sys/dev/char/" + std::to_string(major(st.st_rdev)) + ":" +
+            std::to_string(minor(st.st_rdev)) + "/device/numa_node";
+        std::string line;
+        if (readLine(path, line)) node = std::atoi(line.c_str());
+        if (node < 0) node = -1;
+    }
+    LOG_DXRT_DBG << devFile << " NUMA node " << node << std::endl;
+    nodes[deviceId] = node;
+    return node;
+#else
+    std::ignore = deviceId;
+    return -1;
+#endif
+}
+
+std::vector<int> GetNumaNodeCpus(int node)
+{
+#ifdef __linux__
+    if (node < 0) return {};
+    std::string line;
+    if (!readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", line)) return {};
+    return allowedOnly(ParseCpuList(line));
+#else
+    std::ignore = node;
+    return {};
+#endif
+}
+
+std::vector<int> GetThreadPlacementCpus(ThreadRole role, int deviceId)
+{
+#ifdef __linux__
+    switch (role)
+    {
+        case ThreadRole::DEVICE_IO:
+            if (!GetDeviceIoCpus().empty()) return allowedOnly(GetDeviceIoCpus());
+            if (GetThreadAffinityMode() == ThreadAffinityMode::NUMA) return GetNumaNodeCpus(GetDeviceNumaNode(deviceId));
+            return {};
+        case ThreadRole::NFH:
+            return allowedOnly(GetNfhCpus());
+        case ThreadRole::CPU_TASK:
+            return allowedOnly(GetCpuTaskCpus());
+        case ThreadRole::NONE:
+            break;
+    }
+#else
+    std::ignore = role;
+    std::ignore = deviceId;
+#endif
+    return {};
+}
+
+bool ApplyThreadPlacement(ThreadRole role, int deviceId)
+{
+#ifdef __linux__
+    std::vector<int> cpus = GetThreadPlacementCpus(role, deviceId);
+    if (cpus.empty())
+    {
+        // a thread started from a pinned thread inherits its mask, give it the whole process back
+        bool active = GetThreadAffinityMode() != ThreadAffinityMode::OFF || !GetDeviceIoCpus().empty() ||
+            !GetNfhCpus().empty() || !GetCpuTaskCpus().empty();
+        if (active) setThreadCpus(sProcessCpus);
+        return false;
+    }
+    if (!setThreadCpus(cpus)) return false;
+    LOG_DXRT_DBG << ThreadRoleName(role) << " thread of device " << deviceId << " pinned to "
+                 << cpus.size() << " cores from " << cpus.front() << std::endl;
+    return true;
+#else
+    std::ignore = role;
+    std::ignore = deviceId;
+    return false;
+#endif
+}
+
+ScopedThreadPlacement::ScopedThreadPlacement(const std::vector<int>& cpus)
+{
+#ifdef __linux__
+    if (cpus.empty()) return;
+    _previous = getThreadCpus();
+    _applied = !_previous.empty() && setThreadCpus(cpus);
+#else
+    std::ignore = cpus;
+#endif
+}
+
+ScopedThreadPlacement::~ScopedThreadPlacement()
+{
+#ifdef __linux__
+    if (_applied) setThreadCpus(_previous);
+#endif
+}
+
+}  // namespace dxrt
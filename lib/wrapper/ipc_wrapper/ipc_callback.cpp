@@ -73,6 +73,9 @@ std::ostream& operator<< (std::ostream& os, RESPONSE_CODE code)
         case RESPONSE_CODE::CONFIRM_MEMORY_FREE:
             os << "CONFIRM_MEMORY_FREE";
             break;
+        case RESPONSE_CODE::CONFIRM_REGISTER_PROCESS:
+            os << "CONFIRM_REGISTER_PROCESS";
+            break;
         case RESPONSE_CODE::DO_SCHEDULED_INFERENCE_CH0:
             os << "DO_SCHEDULED_INFERENCE_CH0";
             break;
@@ -184,6 +187,9 @@ switch (code)
         REQUEST_CODE_MACRO(VIEW_USED_MEMORY)
         REQUEST_CODE_MACRO(VIEW_AVAILABLE_DEVICE)
         REQUEST_CODE_MACRO(GET_USAGE)
+        REQUEST_CODE_MACRO(ACQUIRE_MODEL_MEMORY)
+        REQUEST_CODE_MACRO(MODEL_MEMORY_READY)
+        REQUEST_CODE_MACRO(GET_MEMORY_BATCH)
 
         REQUEST_CODE_MACRO(MEMORY_ALLOCATION_AND_TRANSFER_MODEL)
         REQUEST_CODE_MACRO(COMPLETE_TRANSFER_MODEL)
@@ -11,6 +11,7 @@
 #include "../../include/dxrt/ipc_wrapper/ipc_client_wrapper.h"
 #ifdef __linux__
 #include "message_queue/ipc_mq_client_linux.h"
+#include "shared_ring/ipc_ring_client_linux.h"
 #elif _WIN32
 #include "windows_pipe/ipc_pipe_client_windows.h"
 #endif
@@ -32,6 +33,10 @@ IPCClientWrapper::IPCClientWrapper(IPC_TYPE type, long msgType)
     {
         _ipcClient = std::make_shared<IPCMessageQueueClientLinux>(msgType);
     }
+    else if (type == IPC_TYPE::SHARED_RING)
+    {
+        _ipcClient = std::make_shared<IPCSharedRingClientLinux>(msgType);
+    }
 
 #elif _WIN32
     if (type == IPC_TYPE::WIN_PIPE)
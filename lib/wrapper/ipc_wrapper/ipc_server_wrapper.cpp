@@ -11,6 +11,7 @@
 
 #ifdef __linux__
 	#include "message_queue/ipc_mq_server_linux.h"
+	#include "shared_ring/ipc_ring_server_linux.h"
 #elif _WIN32
 	#include "windows_pipe/ipc_pipe_server_windows.h"
 #endif
@@ -24,6 +25,10 @@ IPCServerWrapper::IPCServerWrapper(IPC_TYPE type)
     {
         _ipcServer = std::make_shared<IPCMessageQueueServerLinux>();
     }
+    else if (type == IPC_TYPE::SHARED_RING)
+    {
+        _ipcServer = std::make_shared<IPCSharedRingServerLinux>();
+    }
 #elif _WIN32
     if (type == IPC_TYPE::WIN_PIPE)
     {
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+#ifdef __linux__ // all or nothing
+
+#include "ipc_ring_client_linux.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <chrono>
+#include <new>
+
+namespace dxrt {
+
+namespace {
+constexpr int RING_WAIT_TIMEOUT_MS = 100;
+}  // namespace
+
+IPCSharedRingClientLinux::IPCSharedRingClientLinux(long msgType)
+: _mq(msgType), _msgType(msgType), _receiveCB(nullptr)
+{
+    LOG_DXRT_I_DBG << "IPCSharedRingClientLinux::Constructor (msgType=" << msgType << ")" << std::endl;
+}
+
+IPCSharedRingClientLinux::~IPCSharedRingClientLinux()
+{
+    LOG_DXRT_I_DBG << "IPCSharedRingClientLinux::Destructor" << std::endl;
+    if (_segment != nullptr)
+    {
+        Close();
+    }
+}
+
+// Intitialize IPC
+int32_t IPCSharedRingClientLinux::Initialize()
+{
+    LOG_DXRT_I_DBG << "IPCSharedRingClientLinux::Initialize" << std::endl;
+    int32_t ret = _mq.Initialize();
+    if (ret != 0 || _segment != nullptr)
+    {
+        return ret;
+    }
+    if (!connect())
+    {
+        LOG_DXRT_I_DBG << "IPCSharedRingClientLinux: rings not available, using message queue" << std::endl;
+    }
+    return 0;
+}
+
+bool IPCSharedRingClientLinux::connect()
+{
+    auto server = static_cast<IPCRingServerSegment*>(
+        IPCRingMapSegment(IPCRingServerSegmentName(), sizeof(IPCRingServerSegment), false));
+    if (server == nullptr)
+    {
+        return false;
+    }
+    // A segment left behind by a service that crashed has nobody reading the message queue either
+    if (server->magic != IPC_RING_MAGIC || server->version != IPC_RING_VERSION ||
+        !IPCRingPeerAlive(server->serverPid.load()))
+    {
+        IPCRingUnmapSegment(server, sizeof(IPCRingServerSegment));
+        return false;
+    }
+
+    std::string name = IPCRingClientSegmentName(_msgType);
+    void* addr = IPCRingMapSegment(name, sizeof(IPCRingClientSegment), true);
+    if (addr == nullptr)
+    {
+        IPCRingUnmapSegment(server, sizeof(IPCRingServerSegment));
+        return false;
+    }
+    auto segment = new (addr) IPCRingClientSegment();
+    segment->magic = IPC_RING_MAGIC;
+    segment->version = IPC_RING_VERSION;
+    segment->clientMessageSize = sizeof(IPCClientMessage);
+    segment->serverMessageSize = sizeof(IPCServerMessage);
+
+    IPCClientMessage request;
+    request.code = REQUEST_CODE::REGISTER_PROCESS;
+    request.pid = getpid();
+    request.data = IPC_RING_MAGIC;
+    request.modelMemorySize = sizeof(IPCRingClientSegment);
+    IPCServerMessage response;
+    _mq.SendToServer(response, request);
+
+    // The service keeps its own mapping; the name is not needed any more either way
+    shm_unlink(name.c_str());
+
+    if (response.code != RESPONSE_CODE::CONFIRM_REGISTER_PROCESS || response.result != 0)
+    {
+        IPCRingUnmapSegment(segment, sizeof(IPCRingClientSegment));
+        IPCRingUnmapSegment(server, sizeof(IPCRingServerSegment));
+        return false;
+    }
+    _segment = segment;
+    _server = server;
+    LOG_DXRT_I_DBG << "IPCSharedRingClientLinux: connected over shared rings (msgType=" << _msgType << ")" << std::endl;
+    return true;
+}
+
+void IPCSharedRingClientLinux::disconnect()
+{
+    if (_segment == nullptr)
+    {
+        return;
+    }
+    _segment->clientClosed.store(1);
+    _server->serverBell.Ring();
+    IPCRingUnmapSegment(_segment, sizeof(IPCRingClientSegment));
+    IPCRingUnmapSegment(_server, sizeof(IPCRingServerSegment));
+    _segment = nullptr;
+    _server = nullptr;
+}
+
+int32_t IPCSharedRingClientLinux::SendToServer(IPCServerMessage& outServerMessage, IPCClientMessage& clientMessage)
+{
+    if (_segment == nullptr)
+    {
+        return _mq.SendToServer(outServerMessage, clientMessage);
+    }
+    // if there is a callback, replies are delivered to it, same as the message queue client
+    if (_receiveCB != nullptr)
+    {
+        return -1;
+    }
+    clientMessage.seqId = 0;
+    if (SendToServer(clientMessage) != 0)
+    {
+        return -1;
+    }
+    return ReceiveFromServer(outServerMessage);
+}
+
+int32_t IPCSharedRingClientLinux::SendToServer(IPCClientMessage& clientMessage)
+{
+    if (_segment == nullptr)
+    {
+        return _mq.SendToServer(clientMessage);
+    }
+
+    std::lock_guard<std::mutex> lock(_funcLock);
+    clientMessage.msgType = _msgType;
+    while (!_segment->toServer.TryPush(clientMessage))
+    {
+        // Full ring: the service is behind, give it time to drain
+        if (_segment->serverClosed.load() != 0 || !IPCRingPeerAlive(_segment->serverPid.load()))
+        {
+            LOG_DXRT_I_ERR("IPCSharedRingClientLinux: service is gone, message dropped");
+            return -1;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    _server->serverBell.Ring();
+    return 0;
+}
+
+int32_t IPCSharedRingClientLinux::ReceiveFromServer(IPCServerMessage& serverMessage)
+{
+    if (_segment == nullptr)
+    {
+        return _mq.ReceiveFromServer(serverMessage);
+    }
+
+    auto& ring = _segment->toClient;
+    while (true)
+    {
+        for (int i = 0, spin = IPCRingSpinCount(); i < spin; i++)
+        {
+            if (ring.TryPop(serverMessage))
+            {
+                return 0;
+            }
+            IPCRingCpuRelax();
+        }
+
+        _segment->clientBell.Wait([&] {
+            return _stop.load() || !ring.Empty() || _segment->serverClosed.load() != 0;
+        }, RING_WAIT_TIMEOUT_MS);
+
+        if (ring.TryPop(serverMessage))
+        {
+            return 0;
+        }
+        if (_stop.load())
+        {
+            return -1;
+        }
+        if (_segment->serverClosed.load() != 0 || !IPCRingPeerAlive(_segment->serverPid.load()))
+        {
+            LOG_DXRT_I_ERR("IPCSharedRingClientLinux: service is gone");
+            return -1;
+        }
+    }
+}
+
+// register receive message callback function
+int32_t IPCSharedRingClientLinux::RegisterReceiveCB(
+        std::function<int32_t(IPCServerMessage&, void*)> receiveCB,
+        void* usrData)
+{
+    if (_segment == nullptr)
+    {
+        return _mq.RegisterReceiveCB(receiveCB, usrData);
+    }
+
+    // nullptr means callback release, thread remains
+    if (receiveCB == nullptr)
+    {
+        _receiveCB = nullptr;
+        _usrData = nullptr;
+        return 0;
+    }
+
+    stopThread();
+
+    _receiveCB = receiveCB;
+    _usrData = usrData;
+    _threadRunning.store(true);
+    _thread = std::thread(IPCSharedRingClientLinux::ThreadFunc, this);
+    LOG_DXRT_I_DBG << "IPCSharedRingClientLinux: Created Callback Thread" << std::endl;
+    return 0;
+}
+
+void IPCSharedRingClientLinux::stopThread()
+{
+    if (!_threadRunning.load())
+    {
+        return;
+    }
+    _threadRunning.store(false);
+    _stop.store(true);
+    // Wait() re-checks _stop after registering, so a single ring cannot be missed
+    _segment->clientBell.Ring();
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+    _stop.store(false);
+    _receiveCB = nullptr;
+    LOG_DXRT_I_DBG << "IPCSharedRingClientLinux: Thread stopped" << std::endl;
+}
+
+// close the connection
+int32_t IPCSharedRingClientLinux::Close()
+{
+    if (_segment == nullptr)
+    {
+        return _mq.Close();
+    }
+    stopThread();
+    disconnect();
+    LOG_DXRT_I_DBG << "IPCSharedRingClientLinux::Close" << std::endl;
+    return _mq.Close();
+}
+
+void IPCSharedRingClientLinux::ThreadFunc(IPCSharedRingClientLinux* ringClient)
+{
+    IPCServerMessage serverMessage;
+    while (ringClient->_threadRunning.load())
+    {
+        if (ringClient->ReceiveFromServer(serverMessage) != 0)
+        {
+            if (ringClient->_threadRunning.load())
+            {
+                LOG_DXRT_I_ERR("IPCSharedRingClientLinux: ReceiveFromServer fail");
+            }
+            break;
+        }
+        if (ringClient->_receiveCB == nullptr)
+        {
+            LOG_DXRT_I_ERR("Receive callback is null, skipping message");
+            continue;
+        }
+        ringClient->_receiveCB(serverMessage, ringClient->_usrData);
+    }
+
+    // Deliver what the service queued before the stop, as the message queue client does
+    while (ringClient->_receiveCB != nullptr && ringClient->_segment->toClient.TryPop(serverMessage))
+    {
+        ringClient->_receiveCB(serverMessage, ringClient->_usrData);
+    }
+    LOG_DXRT_I_DBG << "IPCSharedRingClientLinux::Thread Finished" << std::endl;
+}
+
+}  // namespace dxrt
+#endif  // __linux__
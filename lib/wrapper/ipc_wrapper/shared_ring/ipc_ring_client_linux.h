@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "dxrt/common.h"
+#include "../../../include/dxrt/ipc_wrapper/ipc_client.h"
+#include "../message_queue/ipc_mq_client_linux.h"
+#include "ipc_ring_linux.h"
+
+namespace dxrt
+{
+
+/**
+ * @brief Client transport over a pair of shared-memory rings, negotiated with the service.
+ *
+ * Initialize() creates the client segment and offers it to the service with a
+ * REGISTER_PROCESS request on the message queue. When the service confirms, all traffic of
+ * this connection moves to the rings; when the service is older or the segment cannot be
+ * set up, every call is forwarded to the message queue client unchanged.
+ */
+class IPCSharedRingClientLinux : public IPCClient
+{
+ private:
+    IPCMessageQueueClientLinux _mq;
+    long _msgType;
+    IPCRingClientSegment* _segment = nullptr;   // nullptr: not negotiated, _mq carries the traffic
+    IPCRingServerSegment* _server = nullptr;
+    void* _usrData = nullptr;
+    std::thread _thread;
+    std::atomic<bool> _threadRunning{false};
+    std::atomic<bool> _stop{false};         // wakes a ReceiveFromServer() blocked in the callback thread
+    std::function<int32_t(IPCServerMessage&, void*)> _receiveCB;
+    std::mutex _funcLock;
+
+    bool connect();
+    void disconnect();
+    void stopThread();
+
+ public:
+    explicit IPCSharedRingClientLinux(long msgType);
+    virtual ~IPCSharedRingClientLinux();
+
+    // Intitialize IPC
+    int32_t Initialize() override;
+
+    // Send message to server
+    int32_t SendToServer(IPCClientMessage& clientMessage) override;
+
+    // Send message to server
+    int32_t SendToServer(IPCServerMessage& outResponseServerMessage, IPCClientMessage& inRequestClientMessage) override;
+
+    // Receive message from server
+    int32_t ReceiveFromServer(IPCServerMessage& serverMessage) override;
+
+    // register receive message callback function
+    int32_t RegisterReceiveCB(std::function<int32_t(IPCServerMessage&,void*)> receiveCB, void* usrData) override;
+
+    // close the connection
+    int32_t Close() override;
+
+    bool IsRingConnected() const { return _segment != nullptr; }
+
+    static void ThreadFunc(IPCSharedRingClientLinux* ringClient);
+};
+
+}  // namespace dxrt
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+#ifdef __linux__ // all or nothing
+
+#include "ipc_ring_linux.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <thread>
+
+std::string getErrorString(int error_code);
+
+namespace dxrt {
+
+// The words live in memory shared between processes, so the non-private futex ops are required
+void IPCRingDoorbell::Ring()
+{
+    if (waiters.load() == 0 || signaled.exchange(1) != 0) return;
+    seq.fetch_add(1);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+void IPCRingDoorbell::wait(uint32_t observed, int timeoutMs)
+{
+    struct timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq), FUTEX_WAIT, observed, &timeout, nullptr, 0);
+}
+
+std::string IPCRingClientSegmentName(long msgType)
+{
+    return "/dxrt_ipc_" + std::to_string(msgType);
+}
+
+const char* IPCRingServerSegmentName()
+{
+    return "/dxrt_ipc_service";
+}
+
+void* IPCRingMapSegment(const std::string& name, size_t size, bool create)
+{
+    int fd;
+    if (create)
+    {
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    }
+    else
+    {
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+    }
+    if (fd < 0)
+    {
+        if (create) LOG_DXRT_I_ERR("[IPCRing] shm_open " + name + " failed" + getErrorString(errno));
+        return nullptr;
+    }
+
+    struct stat st;
+    bool ok = true;
+    if (create)
+    {
+        // umask would otherwise keep processes of other users from connecting
+        fchmod(fd, 0666);
+        ok = (ftruncate(fd, static_cast<off_t>(size)) == 0);
+    }
+    else
+    {
+        ok = (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= size);
+    }
+
+    void* addr = ok ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (addr == MAP_FAILED)
+    {
+        LOG_DXRT_I_ERR("[IPCRing] mapping " + name + " failed" + getErrorString(errno));
+        if (create) shm_unlink(name.c_str());
+        return nullptr;
+    }
+    return addr;
+}
+
+void IPCRingUnmapSegment(void* addr, size_t size)
+{
+    if (addr != nullptr) munmap(addr, size);
+}
+
+bool IPCRingPeerAlive(int32_t pid)
+{
+    if (pid <= 0) return false;
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+void IPCRingCpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+int IPCRingSpinCount()
+{
+    // Long enough to catch a reply that is already on its way (a few microseconds)
+    static const int count = std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+    return count;
+}
+
+}  // namespace dxrt
+#endif  // __linux__
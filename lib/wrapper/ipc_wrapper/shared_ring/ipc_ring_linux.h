@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#include "dxrt/common.h"
+#include "../../../include/dxrt/ipc_wrapper/ipc_message.h"
+
+namespace dxrt
+{
+
+/**
+ * @brief Futex-backed wake-up word shared between processes.
+ *
+ * Producers publish into a ring first and call Ring() afterwards. Ring() only enters the
+ * kernel when the consumer announced that it is about to sleep and nobody woke it since,
+ * so a busy consumer costs the producers no syscalls and a burst of messages wakes a
+ * sleeping consumer once.
+ */
+struct IPCRingDoorbell
+{
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint32_t> waiters{0};
+    std::atomic<uint32_t> signaled{0};     // a wake-up is on its way to the current waiters
+
+    void Ring();
+
+    /**
+     * @brief Blocks until Ring() is called, hasWork() turns true or timeoutMs passes.
+     *
+     * hasWork() is evaluated after the consumer is registered as a waiter, which closes the
+     * window between the consumer's last empty poll and a producer ringing the bell.
+     */
+    template <typename Pred>
+    void Wait(Pred hasWork, int timeoutMs)
+    {
+        waiters.fetch_add(1);
+        uint32_t observed = seq.load();
+        // a Ring() after this point wakes the kernel again; one before it already moved seq
+        signaled.store(0);
+        if (!hasWork()) wait(observed, timeoutMs);
+        waiters.fetch_sub(1);
+    }
+
+ private:
+    void wait(uint32_t observed, int timeoutMs);
+};
+
+/**
+ * @brief Single-producer single-consumer ring of fixed-size messages in shared memory.
+ *
+ * head is owned by the consumer and tail by the producer; each lives on its own cache line.
+ * T is copied as raw bytes, the same way the message queue transport copies it.
+ */
+template <typename T, uint32_t N>
+struct IPCShmRing
+{
+    static_assert((N & (N - 1)) == 0, "ring capacity must be a power of two");
+
+    alignas(64) std::atomic<uint32_t> head{0};
+    alignas(64) std::atomic<uint32_t> tail{0};
+    alignas(64) uint8_t slots[N][sizeof(T)];
+
+    bool TryPush(const T& item)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N) return false;
+        memcpy(slots[t & (N - 1)], &item, sizeof(T));
+        // seq_cst pairs with the consumer's waiter registration in IPCRingDoorbell::Wait()
+        tail.store(t + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    bool TryPop(T& item)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        memcpy(&item, slots[h & (N - 1)], sizeof(T));
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // seq_cst: used by consumers as the re-check inside IPCRingDoorbell::Wait()
+    bool Empty() const
+    {
+        return head.load() == tail.load();
+    }
+};
+
+static constexpr uint32_t IPC_RING_MAGIC = 0x44585249;  // "DXRI"
+static constexpr uint32_t IPC_RING_VERSION = 1;
+static constexpr uint32_t IPC_RING_CAPACITY = 256;
+
+/** @brief Per-client segment: one ring per direction plus the client's doorbell. */
+struct IPCRingClientSegment
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t clientMessageSize;
+    uint32_t serverMessageSize;
+    std::atomic<int32_t> serverPid;        // set by the service when it attaches
+    std::atomic<uint32_t> clientClosed;
+    std::atomic<uint32_t> serverClosed;
+    IPCRingDoorbell clientBell;            // rung by the service after pushing to toClient
+    IPCShmRing<IPCClientMessage, IPC_RING_CAPACITY> toServer;
+    IPCShmRing<IPCServerMessage, IPC_RING_CAPACITY> toClient;
+};
+
+/** @brief Service segment: the doorbell every client rings after pushing to its toServer ring. */
+struct IPCRingServerSegment
+{
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<int32_t> serverPid;
+    IPCRingDoorbell serverBell;
+};
+
+/** @brief Name of the shared memory object of the client connection msgType. */
+std::string IPCRingClientSegmentName(long msgType);
+
+/** @brief Name of the shared memory object published by the service. */
+const char* IPCRingServerSegmentName();
+
+/**
+ * @brief Creates (create == true) or opens a shared memory object of size bytes and maps it.
+ * @return mapped address, or nullptr on failure. A created object is zero-filled and
+ *         readable and writable by every user, like the message queues.
+ */
+void* IPCRingMapSegment(const std::string& name, size_t size, bool create);
+
+void IPCRingUnmapSegment(void* addr, size_t size);
+
+/** @brief True while pid exists; used to stop waiting on a peer that crashed. */
+bool IPCRingPeerAlive(int32_t pid);
+
+/** @brief Hint to the CPU inside short polling loops. */
+void IPCRingCpuRelax();
+
+/**
+ * @brief Polls a consumer makes before sleeping on its doorbell.
+ *
+ * Zero on a single CPU, where spinning only delays the peer that would fill the ring.
+ */
+int IPCRingSpinCount();
+
+}  // namespace dxrt
@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+#ifdef __linux__ // all or nothing
+
+#include "ipc_ring_server_linux.h"
+#include "../message_queue/ipc_mq_client_linux.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <chrono>
+#include <new>
+
+namespace dxrt {
+
+namespace {
+constexpr int RING_WAIT_TIMEOUT_MS = 100;
+}  // namespace
+
+IPCSharedRingServerLinux::Connection::~Connection()
+{
+    IPCRingUnmapSegment(segment, sizeof(IPCRingClientSegment));
+}
+
+IPCSharedRingServerLinux::IPCSharedRingServerLinux()
+{
+    LOG_DXRT_I_DBG << "IPCSharedRingServerLinux::Constructor" << std::endl;
+}
+
+IPCSharedRingServerLinux::~IPCSharedRingServerLinux()
+{
+    LOG_DXRT_I_DBG << "IPCSharedRingServerLinux::Destructor" << std::endl;
+    Close();
+}
+
+// Intitialize IPC Server
+// return error code
+int32_t IPCSharedRingServerLinux::Initialize()
+{
+    LOG_DXRT_I_DBG << "IPCSharedRingServerLinux::Initialize" << std::endl;
+    int32_t ret = _mq.Initialize();
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    void* addr = IPCRingMapSegment(IPCRingServerSegmentName(), sizeof(IPCRingServerSegment), true);
+    if (addr == nullptr)
+    {
+        LOG_DXRT_I_ERR("IPCSharedRingServerLinux: shared rings disabled, serving message queue clients only");
+        // A private doorbell still lets the pump thread wake ReceiveFromClient()
+        _server = new IPCRingServerSegment();
+        _serverShared = false;
+    }
+    else
+    {
+        _server = new (addr) IPCRingServerSegment();
+        _serverShared = true;
+    }
+    _server->version = IPC_RING_VERSION;
+    _server->serverPid.store(getpid());
+    _server->magic = IPC_RING_MAGIC;
+
+    _closing.store(false);
+    _pumpThread = std::thread(IPCSharedRingServerLinux::PumpThreadFunc, this);
+    return 0;
+}
+
+// listen
+int32_t IPCSharedRingServerLinux::Listen()
+{
+    return _mq.Listen();
+}
+
+int32_t IPCSharedRingServerLinux::Select(int64_t& connectedFd)
+{
+    return _mq.Select(connectedFd);
+}
+
+std::shared_ptr<IPCSharedRingServerLinux::Connection> IPCSharedRingServerLinux::attach(const IPCClientMessage& request)
+{
+    if (!_serverShared || request.modelMemorySize != sizeof(IPCRingClientSegment))
+    {
+        return nullptr;
+    }
+    auto segment = static_cast<IPCRingClientSegment*>(
+        IPCRingMapSegment(IPCRingClientSegmentName(request.msgType), sizeof(IPCRingClientSegment), false));
+    if (segment == nullptr)
+    {
+        return nullptr;
+    }
+    auto conn = std::make_shared<Connection>();
+    conn->msgType = request.msgType;
+    conn->pid = request.pid;
+    conn->segment = segment;
+    if (segment->magic != IPC_RING_MAGIC || segment->version != IPC_RING_VERSION ||
+        segment->clientMessageSize != sizeof(IPCClientMessage) ||
+        segment->serverMessageSize != sizeof(IPCServerMessage))
+    {
+        return nullptr;
+    }
+    segment->serverPid.store(getpid());
+
+    std::lock_guard<std::mutex> lock(_connLock);
+    _connections[request.msgType] = conn;
+    _connVersion++;
+    LOG_DXRT_I_DBG << "IPCSharedRingServerLinux: client msgType=" << request.msgType << " attached" << std::endl;
+    return conn;
+}
+
+std::shared_ptr<IPCSharedRingServerLinux::Connection> IPCSharedRingServerLinux::findConnection(long msgType)
+{
+    std::lock_guard<std::mutex> lock(_connLock);
+    auto it = _connections.find(msgType);
+    return it == _connections.end() ? nullptr : it->second;
+}
+
+void IPCSharedRingServerLinux::detach(const std::shared_ptr<Connection>& conn)
+{
+    std::lock_guard<std::mutex> lock(_connLock);
+    auto it = _connections.find(conn->msgType);
+    if (it != _connections.end() && it->second == conn)
+    {
+        _connections.erase(it);
+        _connVersion++;
+        // A client unlinks its segment name once registered; one that crashed before that would
+        // leave /dxrt_ipc_<msgType> behind in /dev/shm. A live pid may be a new process reusing
+        // the msgType, whose segment must stay.
+        if (conn->segment->clientClosed.load() == 0 && !IPCRingPeerAlive(conn->pid))
+        {
+            shm_unlink(IPCRingClientSegmentName(conn->msgType).c_str());
+        }
+        LOG_DXRT_I_DBG << "IPCSharedRingServerLinux: client msgType=" << conn->msgType << " detached" << std::endl;
+    }
+}
+
+bool IPCSharedRingServerLinux::hasPending()
+{
+    if (_mqPending.load() > 0 || _connVersion.load() != _pollVersion)
+    {
+        return true;
+    }
+    for (auto& conn : _pollList)
+    {
+        if (!conn->segment->toServer.Empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IPCSharedRingServerLinux::pollOnce(IPCClientMessage& clientMessage)
+{
+    uint32_t version = _connVersion.load();
+    if (version != _pollVersion)
+    {
+        std::lock_guard<std::mutex> lock(_connLock);
+        _pollList.clear();
+        for (auto& entry : _connections)
+        {
+            _pollList.push_back(entry.second);
+        }
+        _pollVersion = _connVersion.load();
+    }
+
+    // Round robin over the rings, with the message queue as one more source, so that one busy
+    // client cannot starve the others
+    size_t sources = _pollList.size() + 1;
+    for (size_t i = 0; i < sources; i++)
+    {
+        size_t index = (_pollNext + i) % sources;
+        if (index == _pollList.size())
+        {
+            if (_mqPending.load() == 0)
+            {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(_mqLock);
+            if (_mqMessages.empty())
+            {
+                continue;
+            }
+            clientMessage = _mqMessages.front();
+            _mqMessages.pop_front();
+            _mqPending--;
+        }
+        else
+        {
+            auto& conn = _pollList[index];
+            if (!conn->segment->toServer.TryPop(clientMessage))
+            {
+                if (conn->segment->clientClosed.load() != 0)
+                {
+                    detach(conn);
+                }
+                continue;
+            }
+            clientMessage.msgType = conn->msgType;
+        }
+        _pollNext = index + 1;
+        return true;
+    }
+    return false;
+}
+
+// ReceiveFromClient
+// return 0: received, -1: server closed
+int32_t IPCSharedRingServerLinux::ReceiveFromClient(IPCClientMessage& clientMessage)
+{
+    if (_server == nullptr)
+    {
+        return -1;
+    }
+    while (true)
+    {
+        for (int i = 0, spin = IPCRingSpinCount(); i < spin; i++)
+        {
+            if (pollOnce(clientMessage))
+            {
+                return 0;
+            }
+            IPCRingCpuRelax();
+        }
+
+        _server->serverBell.Wait([this] { return _closing.load() || hasPending(); }, RING_WAIT_TIMEOUT_MS);
+
+        if (pollOnce(clientMessage))
+        {
+            return 0;
+        }
+        if (_closing.load())
+        {
+            return -1;
+        }
+    }
+}
+
+// SendToClient
+int32_t IPCSharedRingServerLinux::SendToClient(IPCServerMessage& serverMessage)
+{
+    auto conn = findConnection(serverMessage.msgType);
+    if (conn == nullptr)
+    {
+        return _mq.SendToClient(serverMessage);
+    }
+
+    std::lock_guard<std::mutex> lock(conn->sendLock);
+    IPCRingClientSegment* segment = conn->segment;
+    while (!segment->toClient.TryPush(serverMessage))
+    {
+        // Full ring: block like msgsnd() does, but not for a client that is gone
+        if (segment->clientClosed.load() != 0 || !IPCRingPeerAlive(conn->pid))
+        {
+            LOG_DXRT_I_ERR("IPCSharedRingServerLinux: client msgType=" + std::to_string(conn->msgType) +
+                           " is gone, message dropped");
+            return -1;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    segment->clientBell.Ring();
+    return 0;
+}
+
+int32_t IPCSharedRingServerLinux::RegisterReceiveCB(std::function<int32_t(IPCClientMessage&,void*,int32_t)> receiveCB, void* usrData)
+{
+    (void)receiveCB;
+    (void)usrData;
+    LOG_DXRT_I_ERR("IPCSharedRingServerLinux: receive callback is not supported, use ReceiveFromClient");
+    return -1;
+}
+
+int32_t IPCSharedRingServerLinux::RemoveClient(long msgType)
+{
+    auto conn = findConnection(msgType);
+    if (conn == nullptr)
+    {
+        return -1;
+    }
+    detach(conn);
+    return 0;
+}
+
+// Close
+int32_t IPCSharedRingServerLinux::Close()
+{
+    if (_server == nullptr || _closing.exchange(true))
+    {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_connLock);
+        for (auto& entry : _connections)
+        {
+            entry.second->segment->serverClosed.store(1);
+            entry.second->segment->clientBell.Ring();
+        }
+    }
+
+    // A CLOSE request ends the pump thread's pending msgrcv() before the queues are deleted
+    if (_pumpThread.joinable())
+    {
+        IPCMessageQueueClientLinux wakeup(getpid());  // Initialize() drains its msgType only
+        IPCClientMessage closeMessage;
+        closeMessage.code = REQUEST_CODE::CLOSE;
+        if (wakeup.Initialize() == 0 && wakeup.SendToServer(closeMessage) == 0)
+        {
+            _pumpThread.join();
+        }
+        else
+        {
+            _pumpThread.detach();
+        }
+    }
+    _mq.Close();
+
+    {
+        std::lock_guard<std::mutex> lock(_connLock);
+        _connections.clear();
+        _connVersion++;
+    }
+    _pollList.clear();
+
+    _server->magic = 0;
+    if (_serverShared)
+    {
+        shm_unlink(IPCRingServerSegmentName());
+        IPCRingUnmapSegment(_server, sizeof(IPCRingServerSegment));
+    }
+    else
+    {
+        delete _server;
+    }
+    _server = nullptr;
+    LOG_DXRT_I_DBG << "IPCSharedRingServerLinux::Close" << std::endl;
+    return 0;
+}
+
+void IPCSharedRingServerLinux::PumpThreadFunc(IPCSharedRingServerLinux* ringServer)
+{
+    while (!ringServer->_closing.load())
+    {
+        IPCClientMessage clientMessage;
+        if (ringServer->_mq.ReceiveFromClient(clientMessage) != 0 || ringServer->_closing.load())
+        {
+            if (ringServer->_closing.load())
+            {
+                break;
+            }
+            // interrupted by a signal, or the queue was recreated
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        if (clientMessage.code == REQUEST_CODE::REGISTER_PROCESS && clientMessage.data == IPC_RING_MAGIC)
+        {
+            // The reply goes over the message queue: the client reads its ring only once confirmed
+            IPCServerMessage serverMessage;
+            serverMessage.code = RESPONSE_CODE::CONFIRM_REGISTER_PROCESS;
+            serverMessage.msgType = clientMessage.msgType;
+            serverMessage.seqId = clientMessage.seqId;
+            serverMessage.result = ringServer->attach(clientMessage) != nullptr ? 0 : static_cast<uint32_t>(-1);
+            ringServer->_mq.SendToClient(serverMessage);
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(ringServer->_mqLock);
+            ringServer->_mqMessages.push_back(clientMessage);
+            ringServer->_mqPending++;
+        }
+        ringServer->_server->serverBell.Ring();
+    }
+    LOG_DXRT_I_DBG << "IPCSharedRingServerLinux: Pump Thread Finished" << std::endl;
+}
+
+}  // namespace dxrt
+#endif  // __linux__
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2018- DEEPX Ltd.
+ * All rights reserved.
+ *
+ * This software is the property of DEEPX and is provided exclusively to customers
+ * who are supplied with DEEPX NPU (Neural Processing Unit).
+ * Unauthorized sharing or usage is strictly prohibited by law.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dxrt/common.h"
+#include "../../../include/dxrt/ipc_wrapper/ipc_server.h"
+#include "../message_queue/ipc_mq_server_linux.h"
+#include "ipc_ring_linux.h"
+
+namespace dxrt
+{
+
+/**
+ * @brief Service transport that serves shared-ring clients and message queue clients together.
+ *
+ * A pump thread reads the message queue. REGISTER_PROCESS requests offering a ring segment
+ * are answered there; every other message is handed to ReceiveFromClient() through a local
+ * queue. ReceiveFromClient() polls that queue and the toServer rings of all attached clients
+ * and sleeps on the service doorbell when everything is empty. SendToClient() picks the
+ * ring of the addressed connection when it has one and the message queue otherwise.
+ */
+class IPCSharedRingServerLinux : public IPCServer
+{
+ private:
+    struct Connection
+    {
+        long msgType = 0;
+        pid_t pid = 0;
+        IPCRingClientSegment* segment = nullptr;
+        std::mutex sendLock;    // several service threads reply to the same client
+        ~Connection();
+    };
+
+    IPCMessageQueueServerLinux _mq;
+    IPCRingServerSegment* _server = nullptr;
+    bool _serverShared = false;             // false: shm unavailable, _server is a private doorbell
+    std::thread _pumpThread;
+    std::atomic<bool> _closing{false};
+
+    std::mutex _mqLock;
+    std::deque<IPCClientMessage> _mqMessages;
+    std::atomic<size_t> _mqPending{0};
+
+    std::mutex _connLock;
+    std::map<long, std::shared_ptr<Connection>> _connections;
+    std::atomic<uint32_t> _connVersion{0};
+
+    // owned by the thread calling ReceiveFromClient()
+    std::vector<std::shared_ptr<Connection>> _pollList;
+    uint32_t _pollVersion = static_cast<uint32_t>(-1);
+    size_t _pollNext = 0;
+
+    std::shared_ptr<Connection> attach(const IPCClientMessage& request);
+    std::shared_ptr<Connection> findConnection(long msgType);
+    void detach(const std::shared_ptr<Connection>& conn);
+    bool pollOnce(IPCClientMessage& clientMessage);
+    bool hasPending();
+
+ public:
+    IPCSharedRingServerLinux();
+    virtual ~IPCSharedRingServerLinux();
+
+    // Intitialize IPC Server
+    // return error code
+    int32_t Initialize() override;
+
+    // listen
+    int32_t Listen() override;
+
+    // Select
+    int32_t Select(int64_t& connectedFd) override;
+
+    // ReceiveFromClient
+    int32_t ReceiveFromClient(IPCClientMessage& clientMessage) override;
+
+    // SendToClient
+    int32_t SendToClient(IPCServerMessage& serverMessage) override;
+
+    // register receive message callback function
+    int32_t RegisterReceiveCB(std::function<int32_t(IPCClientMessage&,void*,int32_t)> receiveCB, void* usrData) override;
+
+    // remove client connection
+    int32_t RemoveClient(long msgType) override;
+
+    // Close
+    int32_t Close() override;
+
+    static void PumpThreadFunc(IPCSharedRingServerLinux* ringServer);
+};
+
+}  // namespace dxrt
@@ -983,6 +983,7 @@ PYBIND11_MODULE(_pydxrt, m) {
         .def_readwrite("useORT", &InferenceOption::useORT)
         .def_readwrite("bufferCount", &InferenceOption::bufferCount)
         .def_readwrite("boundOption", &InferenceOption::boundOption)
+        .def_readwrite("schedulePolicy", &InferenceOption::schedulePolicy)
         .def_property("devices",
             [](const InferenceOption &opt) { return py::cast(opt.devices); }, // Getter
             [](InferenceOption &opt, const std::vector<int> &new_devices) { opt.devices = new_devices; } // Setter
@@ -1039,6 +1040,8 @@ PYBIND11_MODULE(_pydxrt, m) {
         .def("get_input_tensor_count", &InferenceEngine::GetInputTensorCount)
         .def("get_input_tensor_names", &InferenceEngine::GetInputTensorNames)
         .def("get_output_tensor_names", &InferenceEngine::GetOutputTensorNames)
+        .def("get_input_layout_identical", &InferenceEngine::GetInputLayoutIdentical)
+        .def("get_output_layout_identical", &InferenceEngine::GetOutputLayoutIdentical)
         .def("get_input_tensor_to_task_mapping", &InferenceEngine::GetInputTensorToTaskMapping)
         .def("get_task_order", &InferenceEngine::GetTaskOrder)
         .def("run_async", [](InferenceEngine &ie, const std::vector<py::array> &inputs_py, const py::object &userArg_py, const py::object &outputArg_py) {
@@ -1054,6 +1054,15 @@ class InferenceEngine:
         """Returns the names of all output tensors in the order they are produced."""
         return self.engine.get_output_tensor_names()
 
+    def get_input_layout_identical(self) -> List[bool]:
+        """Returns, per input tensor, whether it already matches the NPU layout.
+        A 64-byte aligned input buffer whose tensors all qualify is DMA'd without a host copy."""
+        return self.engine.get_input_layout_identical()
+
+    def get_output_layout_identical(self) -> List[bool]:
+        """Returns, per output tensor, whether the NPU produces it in the user layout."""
+        return self.engine.get_output_layout_identical()
+
     def get_input_tensor_to_task_mapping(self) -> Dict[str, str]:
         """Returns the mapping from input tensor names to their target tasks."""
         return self.engine.get_input_tensor_to_task_mapping()
@@ -34,6 +34,14 @@ class InferenceOption:
         NPU_12 = 5 
         NPU_02 = 6 
 
+    class SCHEDULE_POLICY(Enum):
+        """
+        Defines how a device is chosen for each NPU request.
+        The values should correspond to the C++ enum/integer values.
+        """
+        LEAST_LOAD = 0
+        LEAST_EXPECTED_LATENCY = 1
+
     DXRT_TASK_MAX_LOAD_DEFAULT = 6
     DXRT_TASK_MAX_LOAD_LIMIT = 100
 
@@ -72,6 +80,26 @@ class InferenceOption:
             raise TypeError("bound_option must be an instance of InferenceOption.BOUND_OPTION.")
         self.instance.boundOption = value.value
 
+    @property
+    def schedule_policy(self) -> SCHEDULE_POLICY:
+        """
+        Gets or sets the device scheduling policy.
+        Uses the SCHEDULE_POLICY enum for clarity.
+        """
+        try:
+            return self.SCHEDULE_POLICY(self.instance.schedulePolicy)
+        except ValueError:
+            raise ValueError(
+                f"Invalid schedulePolicy value {self.instance.schedulePolicy} received from C++. "
+                f"Ensure it's defined in InferenceOption.SCHEDULE_POLICY enum."
+            )
+
+    @schedule_policy.setter
+    def schedule_policy(self, value: SCHEDULE_POLICY) -> None:
+        if not isinstance(value, self.SCHEDULE_POLICY):
+            raise TypeError("schedule_policy must be an instance of InferenceOption.SCHEDULE_POLICY.")
+        self.instance.schedulePolicy = value.value
+
     @property
     def devices(self) -> List[int]:
         """
@@ -102,7 +130,8 @@ class InferenceOption:
         return (f"InferenceOption(use_ort={self.use_ort}, "
                 f"bound_option={self.bound_option.name if self.bound_option else 'None'}, "
                 f"devices={self.devices})"
-                f"buffer_count={self.buffer_count})")
+                f"buffer_count={self.buffer_count}, "
+                f"schedule_policy={self.schedule_policy.name})")
     
     def set_use_ort(self, use_ort):
         if not isinstance(use_ort, bool):